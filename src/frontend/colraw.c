@@ -0,0 +1,490 @@
+/*************
+ * Columnar raw file format
+ ************/
+
+/*
+ * A columnar raw file has the same ascii header as a binary raw file,
+ * but the "Binary:" line is replaced by
+ *
+ *   Columnar: <double|single> chunks=<n> columns=<m> index=<offset>
+ *
+ * followed by the data in chunks of up to chunkrows data points.  Within a
+ * chunk every column (a real vector, or the real and the imaginary part
+ * of a complex vector) is stored on its own, each value XOR'ed with the
+ * previous one of the column.  For smooth waveforms sign, exponent and
+ * the leading mantissa bytes cancel.  Each value is stored as a control
+ * byte, holding the number of leading and trailing zero bytes of the XOR
+ * result, followed by the remaining bytes.  Option 'rawsingle' stores
+ * single precision values.
+ *
+ * After the chunks an index follows, offset bytes after the start of the
+ * first chunk: "NGCI", and for every chunk its number of points, the
+ * first and last value of the scale, the offset of the chunk and the
+ * sizes of its columns.  So a reader may pick single vectors and scale
+ * windows without reading the rest of the file.  Like the binary raw
+ * format, numbers are stored in native byte order.
+ *
+ * The chunks= and index= fields are filled in when the plot is finished,
+ * so the file has to be seekable.
+ */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cpdefs.h"
+#include "ngspice/ftedefs.h"
+#include "ngspice/dvec.h"
+
+#include <stdint.h>
+
+#include "colraw.h"
+#include "variable.h"
+
+#if defined(_MSC_VER)
+#define colraw_tell(fp) _ftelli64(fp)
+#define colraw_seek(fp, pos) _fseeki64(fp, pos, SEEK_SET)
+#elif defined(__MINGW32__)
+#define colraw_tell(fp) ftello64(fp)
+#define colraw_seek(fp, pos) fseeko64(fp, pos, SEEK_SET)
+#else
+#define colraw_tell(fp) ((int64_t) ftello(fp))
+#define colraw_seek(fp, pos) fseeko(fp, (off_t) (pos), SEEK_SET)
+#endif
+
+/* data points per chunk: about 4 MB of doubles, at least 64 points */
+#define CHUNK_DOUBLES 524288
+#define CHUNK_MINROWS 64
+#define CHUNK_MAXROWS 8192
+
+#define CTRL_ZERO 0xff          /* value equals the previous one */
+
+struct colraw_chunk {
+    uint32_t rows;
+    double first, last;         /* scale range */
+    int64_t offset;
+};
+
+struct colraw {
+    FILE *fp;
+    int64_t linepos;            /* file position of the "Columnar:" line */
+    int64_t datapos;            /* file position of the first chunk */
+    int64_t offset;             /* bytes of chunk data so far */
+    int ncols;
+    int chunkrows;
+    int rows;                   /* points in the current chunk */
+    bool single;
+    double *buf;                /* current chunk, column after column */
+    unsigned char *enc;         /* one encoded column */
+    int nchunks, maxchunks;
+    struct colraw_chunk *chunks;
+    uint32_t *sizes;            /* nchunks x ncols encoded column sizes */
+};
+
+
+static size_t
+encode_column(unsigned char *out, const double *val, int n, bool single)
+{
+    unsigned char *start = out;
+    int nbytes = single ? 4 : 8;
+    uint64_t prev = 0;
+    int i, k;
+
+    for (i = 0; i < n; i++) {
+        uint64_t bits, x;
+        int lead, trail;
+
+        if (single) {
+            float f = (float) val[i];
+            uint32_t b;
+            memcpy(&b, &f, 4);
+            bits = b;
+        } else {
+            memcpy(&bits, &val[i], 8);
+        }
+        x = bits ^ prev;
+        prev = bits;
+
+        if (x == 0) {
+            *out++ = CTRL_ZERO;
+            continue;
+        }
+        for (lead = 0; !((x >> (8 * (nbytes - 1 - lead))) & 0xff); lead++)
+            ;
+        for (trail = 0; !((x >> (8 * trail)) & 0xff); trail++)
+            ;
+        *out++ = (unsigned char) ((lead << 4) | trail);
+        for (k = nbytes - 1 - lead; k >= trail; k--)
+            *out++ = (unsigned char) (x >> (8 * k));
+    }
+
+    return (size_t) (out - start);
+}
+
+
+static bool
+decode_column(const unsigned char *in, size_t size, double *val, int n, bool single)
+{
+    const unsigned char *end = in + size;
+    int nbytes = single ? 4 : 8;
+    uint64_t prev = 0;
+    int i, k;
+
+    for (i = 0; i < n; i++) {
+        uint64_t x = 0;
+
+        if (in >= end)
+            return FALSE;
+        if (*in == CTRL_ZERO) {
+            in++;
+        } else {
+            int lead = *in >> 4, trail = *in & 0xf;
+            in++;
+            if (lead + trail >= nbytes || in + (nbytes - lead - trail) > end)
+                return FALSE;
+            for (k = nbytes - 1 - lead; k >= trail; k--)
+                x |= (uint64_t) *in++ << (8 * k);
+        }
+        prev ^= x;
+
+        if (single) {
+            uint32_t b = (uint32_t) prev;
+            float f;
+            memcpy(&f, &b, 4);
+            val[i] = f;
+        } else {
+            memcpy(&val[i], &prev, 8);
+        }
+    }
+
+    return in == end;
+}
+
+
+static void
+write_line(struct colraw *cr)
+{
+    fprintf(cr->fp, "Columnar: %s chunks=%-10d columns=%-10d index=%-20lld\n",
+            cr->single ? "single" : "double", cr->nchunks, cr->ncols,
+            (long long) cr->offset);
+}
+
+
+/* TRUE if variable filetype asks for the columnar format */
+bool
+colraw_filetype(void)
+{
+    char buf[BSIZE_SP];
+
+    return cp_getvar("filetype", CP_STRING, buf, sizeof(buf)) && eq(buf, "columnar");
+}
+
+
+/* Start the data section of a plot with ncols columns per point,
+   returns NULL if the file is not seekable */
+struct colraw *
+colraw_begin(FILE *fp, int ncols)
+{
+    struct colraw *cr;
+    int64_t linepos;
+
+    fflush(fp);
+    if ((linepos = colraw_tell(fp)) < 0)
+        return NULL;
+
+    cr = TMALLOC(struct colraw, 1);
+    cr->fp = fp;
+    cr->linepos = linepos;
+    cr->ncols = ncols;
+    cr->single = cp_getvar("rawsingle", CP_BOOL, NULL, 0);
+    cr->chunkrows = CHUNK_DOUBLES / MAX(ncols, 1);
+    if (cr->chunkrows < CHUNK_MINROWS)
+        cr->chunkrows = CHUNK_MINROWS;
+    if (cr->chunkrows > CHUNK_MAXROWS)
+        cr->chunkrows = CHUNK_MAXROWS;
+    cr->buf = TMALLOC(double, (size_t) cr->chunkrows * (size_t) ncols);
+    cr->enc = TMALLOC(unsigned char, (size_t) cr->chunkrows * 9);
+
+    write_line(cr);
+    fflush(fp);
+    cr->datapos = colraw_tell(fp);
+
+    return cr;
+}
+
+
+static void
+write_chunk(struct colraw *cr)
+{
+    struct colraw_chunk *ch;
+    uint32_t *sizes;
+    int i;
+
+    if (cr->rows == 0)
+        return;
+
+    if (cr->nchunks == cr->maxchunks) {
+        cr->maxchunks = cr->maxchunks ? 2 * cr->maxchunks : 64;
+        cr->chunks = TREALLOC(struct colraw_chunk, cr->chunks, cr->maxchunks);
+        cr->sizes = TREALLOC(uint32_t, cr->sizes, (size_t) cr->maxchunks * (size_t) cr->ncols);
+    }
+    ch = &cr->chunks[cr->nchunks];
+    sizes = &cr->sizes[(size_t) cr->nchunks * (size_t) cr->ncols];
+    cr->nchunks++;
+
+    ch->rows = (uint32_t) cr->rows;
+    ch->first = cr->buf[0];
+    ch->last = cr->buf[cr->rows - 1];
+    ch->offset = cr->offset;
+
+    for (i = 0; i < cr->ncols; i++) {
+        size_t n = encode_column(cr->enc, cr->buf + (size_t) i * (size_t) cr->chunkrows,
+                                 cr->rows, cr->single);
+        fwrite(cr->enc, 1, n, cr->fp);
+        sizes[i] = (uint32_t) n;
+        cr->offset += (int64_t) n;
+    }
+
+    cr->rows = 0;
+}
+
+
+/* add a data point, scale first */
+void
+colraw_add_row(struct colraw *cr, const double *row)
+{
+    int i;
+
+    for (i = 0; i < cr->ncols; i++)
+        cr->buf[(size_t) i * (size_t) cr->chunkrows + (size_t) cr->rows] = row[i];
+
+    if (++cr->rows == cr->chunkrows)
+        write_chunk(cr);
+}
+
+
+/* Write the last chunk and the index, fill in the "Columnar:" line.
+   The file position is left at the end of the index. */
+void
+colraw_end(struct colraw *cr)
+{
+    int64_t endpos;
+    int i;
+
+    write_chunk(cr);
+
+    fwrite("NGCI", 1, 4, cr->fp);
+    for (i = 0; i < cr->nchunks; i++) {
+        struct colraw_chunk *ch = &cr->chunks[i];
+        fwrite(&ch->rows, sizeof(uint32_t), 1, cr->fp);
+        fwrite(&ch->first, sizeof(double), 1, cr->fp);
+        fwrite(&ch->last, sizeof(double), 1, cr->fp);
+        fwrite(&ch->offset, sizeof(int64_t), 1, cr->fp);
+        fwrite(&cr->sizes[(size_t) i * (size_t) cr->ncols], sizeof(uint32_t),
+               (size_t) cr->ncols, cr->fp);
+    }
+
+    fflush(cr->fp);
+    endpos = colraw_tell(cr->fp);
+    colraw_seek(cr->fp, cr->linepos);
+    write_line(cr);
+    fflush(cr->fp);
+    colraw_seek(cr->fp, endpos);
+
+    tfree(cr->buf);
+    tfree(cr->enc);
+    tfree(cr->chunks);
+    tfree(cr->sizes);
+    tfree(cr);
+}
+
+
+/* Is vector v selected by variable rawvectors?  "out" selects v(out). */
+static bool
+colraw_selected(struct dvec *v, struct variable *sel)
+{
+    for (; sel; sel = sel->va_next) {
+        const char *want = sel->va_string;
+        size_t n;
+        if (sel->va_type != CP_STRING)
+            continue;
+        if (cieq(v->v_name, want))
+            return TRUE;
+        n = strlen(want);
+        if (v->v_name[0] && v->v_name[1] == '(' &&
+            cieqn(v->v_name + 2, want, n) &&
+            v->v_name[n + 2] == ')' && v->v_name[n + 3] == '\0')
+            return TRUE;
+    }
+    return FALSE;
+}
+
+
+/* Read the data of plot pl, whose vectors have been set up from the
+   header.  'line' is the "Columnar:" line just read from fp.
+   Only the vectors listed in variable 'rawvectors' (default all) and the
+   points with rawstart <= scale <= rawstop are loaded, chunks outside are
+   skipped.  Returns 0 on success, fp is left at the end of the plot. */
+int
+colraw_read(FILE *fp, const char *line, struct plot *pl, bool complex)
+{
+    struct colraw cr;
+    struct variable *sel = NULL, *selbuf = NULL;
+    struct dvec *v, **pv;
+    char prec[16];
+    long long index;
+    double start = -HUGE_VAL, stop = HUGE_VAL;
+    double *col = NULL, *scale = NULL;
+    unsigned char *enc = NULL;
+    char *keep = NULL;
+    int *colidx = NULL;
+    int64_t endpos;
+    int nvars, nkeep, vi, i, j, count, err = 1;
+
+    memset(&cr, 0, sizeof(cr));
+    if (sscanf(line, "%*s %15s chunks=%d columns=%d index=%lld",
+               prec, &cr.nchunks, &cr.ncols, &index) != 4 || index < 0) {
+        fprintf(cp_err, "Error: bad Columnar: line\n");
+        return 1;
+    }
+    cr.single = cieq(prec, "single");
+
+    for (nvars = 0, v = pl->pl_dvecs; v; v = v->v_next)
+        nvars++;
+    if (cr.ncols != (complex ? 2 : 1) * nvars) {
+        fprintf(cp_err, "Error: %d columns for %d vectors\n", cr.ncols, nvars);
+        return 1;
+    }
+
+    /* read the index */
+    cr.datapos = colraw_tell(fp);
+    if (colraw_seek(fp, cr.datapos + index) != 0)
+        goto done;
+    {
+        char magic[4];
+        if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, "NGCI", 4))
+            goto done;
+    }
+    cr.chunks = TMALLOC(struct colraw_chunk, MAX(cr.nchunks, 1));
+    cr.sizes = TMALLOC(uint32_t, (size_t) MAX(cr.nchunks, 1) * (size_t) cr.ncols);
+    for (i = 0; i < cr.nchunks; i++) {
+        struct colraw_chunk *ch = &cr.chunks[i];
+        if (fread(&ch->rows, sizeof(uint32_t), 1, fp) != 1 ||
+            fread(&ch->first, sizeof(double), 1, fp) != 1 ||
+            fread(&ch->last, sizeof(double), 1, fp) != 1 ||
+            fread(&ch->offset, sizeof(int64_t), 1, fp) != 1 ||
+            fread(&cr.sizes[(size_t) i * (size_t) cr.ncols], sizeof(uint32_t),
+                  (size_t) cr.ncols, fp) != (size_t) cr.ncols)
+            goto done;
+        cr.chunkrows = MAX(cr.chunkrows, (int) ch->rows);
+    }
+    endpos = colraw_tell(fp);
+
+    /* the selection */
+    if (cp_getvar("rawvectors", CP_LIST, &sel, 0)) {
+        ;
+    } else if (cp_getvar("rawvectors", CP_STRING, NULL, 0)) {
+        char buf[BSIZE_SP];
+        cp_getvar("rawvectors", CP_STRING, buf, sizeof(buf));
+        selbuf = var_alloc_string(NULL, copy(buf), NULL);
+        sel = selbuf;
+    }
+    cp_getvar("rawstart", CP_REAL, &start, 0);
+    cp_getvar("rawstop", CP_REAL, &stop, 0);
+
+    /* the points in the scale window, chunk by chunk */
+    keep = TMALLOC(char, (size_t) MAX(cr.nchunks, 1) * (size_t) MAX(cr.chunkrows, 1));
+    scale = TMALLOC(double, MAX(cr.chunkrows, 1));
+    col = TMALLOC(double, MAX(cr.chunkrows, 1));
+    enc = TMALLOC(unsigned char, (size_t) MAX(cr.chunkrows, 1) * 9);
+    count = 0;
+    for (i = 0; i < cr.nchunks; i++) {
+        struct colraw_chunk *ch = &cr.chunks[i];
+        char *k = keep + (size_t) i * (size_t) cr.chunkrows;
+        if (MAX(ch->first, ch->last) < start || MIN(ch->first, ch->last) > stop)
+            continue;
+        if (start == -HUGE_VAL && stop == HUGE_VAL) {
+            memset(k, 1, ch->rows);
+            count += (int) ch->rows;
+            continue;
+        }
+        if (colraw_seek(fp, cr.datapos + ch->offset) != 0 ||
+            fread(enc, 1, cr.sizes[(size_t) i * (size_t) cr.ncols], fp) !=
+                cr.sizes[(size_t) i * (size_t) cr.ncols] ||
+            !decode_column(enc, cr.sizes[(size_t) i * (size_t) cr.ncols],
+                           scale, (int) ch->rows, cr.single))
+            goto done;
+        for (j = 0; j < (int) ch->rows; j++)
+            if ((k[j] = (char) (scale[j] >= start && scale[j] <= stop)) != 0)
+                count++;
+    }
+
+    /* drop the vectors not selected, the scale is always loaded,
+       note the file column of the others */
+    colidx = TMALLOC(int, nvars);
+    for (i = 0, nkeep = 0, pv = &pl->pl_dvecs; *pv; i++) {
+        v = *pv;
+        if (i > 0 && sel && !colraw_selected(v, sel)) {
+            *pv = v->v_next;
+            dvec_free(v);
+        } else {
+            colidx[nkeep++] = i;
+            pv = &v->v_next;
+        }
+    }
+
+    /* read the columns of the vectors left */
+    for (v = pl->pl_dvecs, vi = 0; v; v = v->v_next, vi++) {
+        int part, parts = complex ? 2 : 1;
+
+        dvec_realloc(v, count, NULL);
+        if (v->v_numdims <= 1) {
+            v->v_numdims = 1;
+            v->v_dims[0] = count;
+        }
+
+        for (part = 0; part < parts; part++) {
+            int c = colidx[vi] * parts + part, n = 0;
+
+            for (i = 0; i < cr.nchunks; i++) {
+                struct colraw_chunk *ch = &cr.chunks[i];
+                uint32_t *sizes = &cr.sizes[(size_t) i * (size_t) cr.ncols];
+                char *k = keep + (size_t) i * (size_t) cr.chunkrows;
+                int64_t off = ch->offset;
+
+                if (!memchr(k, 1, ch->rows))
+                    continue;
+                for (j = 0; j < c; j++)
+                    off += sizes[j];
+                if (colraw_seek(fp, cr.datapos + off) != 0 ||
+                    fread(enc, 1, sizes[c], fp) != sizes[c] ||
+                    !decode_column(enc, sizes[c], col, (int) ch->rows, cr.single))
+                    goto done;
+                for (j = 0; j < (int) ch->rows; j++) {
+                    if (!k[j])
+                        continue;
+                    if (!complex)
+                        v->v_realdata[n++] = col[j];
+                    else if (part == 0)
+                        v->v_compdata[n++].cx_real = col[j];
+                    else
+                        v->v_compdata[n++].cx_imag = col[j];
+                }
+            }
+        }
+    }
+
+    colraw_seek(fp, endpos);
+    err = 0;
+
+done:
+    if (err)
+        fprintf(cp_err, "Error: bad columnar data\n");
+    if (selbuf)
+        free_struct_variable(selbuf);
+    tfree(cr.chunks);
+    tfree(cr.sizes);
+    tfree(keep);
+    tfree(colidx);
+    tfree(scale);
+    tfree(col);
+    tfree(enc);
+    return err;
+}
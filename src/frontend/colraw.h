@@ -0,0 +1,18 @@
+/*************
+ * Header file for colraw.c
+ ************/
+
+#ifndef ngspice_COLRAW_H
+#define ngspice_COLRAW_H
+
+
+struct colraw;
+
+bool colraw_filetype(void);
+struct colraw *colraw_begin(FILE *fp, int ncols);
+void colraw_add_row(struct colraw *cr, const double *row);
+void colraw_end(struct colraw *cr);
+int colraw_read(FILE *fp, const char *line, struct plot *pl, bool complex);
+
+
+#endif
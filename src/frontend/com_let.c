@@ -11,6 +11,7 @@
 #include "com_display.h"
 #include "com_let.h"
 #include "completion.h"
+#include "rawfile.h"
 
 /* Range of index values, such as 2:3 */
 typedef struct index_range {
@@ -218,10 +219,12 @@ void com_let(wordlist *wl)
             else { /* Something not OK, so free and allocate again */
                 int n_elem_alloc = vec_src->v_alloc_length;
                 if (isreal(vec_dst)) {
-                    tfree(vec_dst->v_realdata);
+                    if (!raw_unmap(vec_dst->v_realdata))
+                        tfree(vec_dst->v_realdata);
                 }
                 else { /* complex */
-                    tfree(vec_dst->v_compdata);
+                    if (!raw_unmap(vec_dst->v_compdata))
+                        tfree(vec_dst->v_compdata);
                 }
                 if (isreal(vec_src)) {
                     vec_dst->v_realdata = TMALLOC(double, n_elem_alloc);
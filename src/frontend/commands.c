@@ -74,6 +74,7 @@
 #include "breakp.h"
 #include "breakp2.h"
 #include "aspice.h"
+#include "mcrun.h"
 #include "com_history.h"
 #include "com_cdump.h"
 #include "linear.h"
@@ -357,6 +358,10 @@ struct comm spcp_coms[] = {
       { 0, 0, 0, 0 }, E_DEFHMASK, 0, 0,
         NULL,
         ": Re-source the actual circuit deck for MC simulation." },
+    { "mcrun", com_mcrun, TRUE, FALSE,
+      { 0, 0, 0, 0 }, E_DEFHMASK, 1, 2,
+      NULL,
+      "runs [workers] : Do Monte-Carlo runs in parallel worker processes." } ,
     { "dump", com_dump, TRUE, FALSE,
       { 0, 0, 0, 0 }, E_DEFHMASK, 0, 0,
       NULL,
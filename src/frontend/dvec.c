@@ -7,6 +7,8 @@
 #include "ngspice/ngspice.h"
 #include "ngspice/dvec.h"
 
+#include "rawfile.h"
+
 #if defined SHARED_MODULE
 
 /*Use Windows threads if on W32 without pthreads*/
@@ -106,6 +108,33 @@ struct dvec *dvec_alloc(/* NOT const -- assigned to char */ char *name,
 } /* end of function dvec_alloc */
 
 
+/* Data of a vector may point into a raw file mapped by 'load',
+ * see raw_map() in rawfile.c.  Copy them to the heap before resizing.
+ */
+static void dvec_unmap(struct dvec *v)
+{
+    if (isreal(v)) {
+        if (raw_mapped(v->v_realdata)) {
+            double *data = TMALLOC(double, v->v_alloc_length);
+            memcpy(data, v->v_realdata,
+                    (size_t) v->v_alloc_length * sizeof(double));
+            raw_unmap(v->v_realdata);
+            v->v_realdata = data;
+        }
+    }
+    else {
+        if (raw_mapped(v->v_compdata)) {
+            ngcomplex_t *data = TMALLOC(ngcomplex_t, v->v_alloc_length);
+            memcpy(data, v->v_compdata,
+                    (size_t) v->v_alloc_length * sizeof(ngcomplex_t));
+            raw_unmap(v->v_compdata);
+            v->v_compdata = data;
+        }
+    }
+} /* end of function dvec_unmap */
+
+
+
 /* Resize dvec to length if storage is NULL or replace
  * its existing allocation with storage if not
  */
@@ -113,19 +142,23 @@ void dvec_realloc(struct dvec *v, int length, void *storage)
 {
     if (isreal(v)) {
         if (storage) {
-            tfree(v->v_realdata);
+            if (!raw_unmap(v->v_realdata))
+                tfree(v->v_realdata);
             v->v_realdata = (double *) storage;
         }
         else {
+            dvec_unmap(v);
             v->v_realdata = TREALLOC(double, v->v_realdata, length);
         }
     }
     else {
         if (storage) {
-            tfree(v->v_compdata);
+            if (!raw_unmap(v->v_compdata))
+                tfree(v->v_compdata);
             v->v_compdata = (ngcomplex_t *) storage;
         }
         else {
+            dvec_unmap(v);
             v->v_compdata = TREALLOC(ngcomplex_t, v->v_compdata, length);
         }
     }
@@ -144,6 +177,7 @@ void dvec_extend(struct dvec *v, int length)
 #if defined SHARED_MODULE
     mutex_lock(&vecreallocMutex);
 #endif
+    dvec_unmap(v);
     if (isreal(v)) {
         v->v_realdata = TREALLOC(double, v->v_realdata, length);
     }
@@ -180,10 +214,12 @@ void dvec_free(struct dvec *v)
         txfree(v->v_name);
     }
     if (v->v_realdata) {
-        txfree(v->v_realdata);
+        if (!raw_unmap(v->v_realdata))
+            txfree(v->v_realdata);
     }
     else if (v->v_compdata) { /* if data real, not complex */
-        txfree(v->v_compdata);
+        if (!raw_unmap(v->v_compdata))
+            txfree(v->v_compdata);
     }
     txfree(v);
 } /* end of function dvec_free */
@@ -21,6 +21,7 @@ Author: 1985 Wayne A. Christopher
 #include "ngspice/osdiitf.h"
 #include "runcoms.h"
 #include "inpcom.h"
+#include "inpcache.h"
 #include "circuits.h"
 #include "completion.h"
 #include "variable.h"
@@ -528,7 +529,14 @@ inp_spsource(FILE *fp, bool comfile, char *filename, bool intfile)
        inp_source() called with fp: load circuit netlist from file, */
     /* called with *fp == NULL and intfile: we want to load circuit from circarray */
     if (fp || intfile) {
-        deck = inp_readall(fp, dir_name, filename, comfile, intfile, &expr_w_temper);
+        /* with variable 'deckcache', try the deck stored by an earlier run */
+        if (!comfile && !intfile)
+            deck = inp_cache_load(filename, &expr_w_temper);
+        if (!deck) {
+            deck = inp_readall(fp, dir_name, filename, comfile, intfile, &expr_w_temper);
+            if (!comfile && !intfile)
+                inp_cache_save(deck, expr_w_temper);
+        }
 
         /* files starting with *ng_script are user supplied command files */
         if (deck && ciprefix("*ng_script", deck->line))
@@ -2335,15 +2343,20 @@ inp_parse_temper_trees(struct circ *circ)
 {
     struct pt_temper *d;
 
+    /* d->wl is "name param = ...", it names the streams of gauss() */
     for(d = circ->devtlist; d; d = d->next) {
         char *expression = d->expression;
+        INPrndstream(d->wl->wl_word, d->wl->wl_next->wl_word);
         INPgetTree(&expression, &d->pt, circ->ci_ckt, NULL);
     }
 
     for(d = circ->modtlist; d; d = d->next) {
         char *expression = d->expression;
+        INPrndstream(d->wl->wl_word, d->wl->wl_next->wl_word);
         INPgetTree(&expression, &d->pt, circ->ci_ckt, NULL);
     }
+
+    INPrndstream(NULL, NULL);
 }
 
 
@@ -2504,46 +2517,62 @@ inp_savecurrents(struct card *deck, struct card *options, wordlist *wl, wordlist
 }
 
 
+/* random variates from stream rs if given (variable rndstream),
+   else from the global generator */
+static double
+rnd_gauss(struct rndstream *rs)
+{
+    return rs ? rndstream_gauss(rs) : gauss1();
+}
+
+
 static double
-agauss(double nominal_val, double abs_variation, double sigma)
+rnd_drand(struct rndstream *rs)
+{
+    return rs ? 2.0 * rndstream_uniform(rs) - 1.0 : drand();
+}
+
+
+static double
+agauss(struct rndstream *rs, double nominal_val, double abs_variation, double sigma)
 {
     double stdvar;
     if (abs_variation <= 0 || sigma <= 0)
         return nominal_val;
     stdvar = abs_variation / sigma;
-    return (nominal_val + stdvar * gauss1());
+    return (nominal_val + stdvar * rnd_gauss(rs));
 }
 
 
 static double
-gauss(double nominal_val, double rel_variation, double sigma)
+gauss(struct rndstream *rs, double nominal_val, double rel_variation, double sigma)
 {
     double stdvar;
     if (rel_variation <= 0 || sigma <= 0)
         return nominal_val;
     stdvar = nominal_val * rel_variation / sigma;
-    return (nominal_val + stdvar * gauss1());
+    return (nominal_val + stdvar * rnd_gauss(rs));
 }
 
 
 static double
-unif(double nominal_val, double rel_variation)
+unif(struct rndstream *rs, double nominal_val, double rel_variation)
 {
-    return (nominal_val + nominal_val * rel_variation * drand());
+    return (nominal_val + nominal_val * rel_variation * rnd_drand(rs));
 }
 
 
 static double
-aunif(double nominal_val, double abs_variation)
+aunif(struct rndstream *rs, double nominal_val, double abs_variation)
 {
-    return (nominal_val + abs_variation * drand());
+    return (nominal_val + abs_variation * rnd_drand(rs));
 }
 
 
 static double
-limit(double nominal_val, double abs_variation)
+limit(struct rndstream *rs, double nominal_val, double abs_variation)
 {
-    return (nominal_val + (drand() > 0 ? abs_variation : -1. * abs_variation));
+    return (nominal_val + (rnd_drand(rs) > 0 ? abs_variation : -1. * abs_variation));
 }
 
 
@@ -2559,6 +2588,8 @@ limit(double nominal_val, double abs_variation)
  * check for agauss(x,y,z), and replace it by a suitable return value
  * of agauss()
  * agauss  in .param lines has been treated already
+ * With variable rndstream set, the values of each function in a B-line
+ * come from a stream named after the B source instance.
  */
 static void
 eval_agauss(struct card *deck, char *fcn)
@@ -2588,6 +2619,15 @@ eval_agauss(struct card *deck, char *fcn)
         if (*curr_line != 'b')
             continue;
 
+        struct rndstream stream, *rs = NULL;
+        if (search_identifier(curr_line, fcn, curr_line) &&
+            rndstream_init(&stream, 0, rndstream_hash(fcn))) {
+            char *instname = copy_substring(curr_line, skip_non_ws(curr_line));
+            stream.name = rndstream_hash(instname);
+            tfree(instname);
+            rs = &stream;
+        }
+
         while ((ap = search_identifier(curr_line, fcn, curr_line)) != NULL) {
             char *lparen, *begstr, *contstr = NULL, *new_line, *midstr;
             char *tmp1str, *tmp2str, *delstr;
@@ -2626,22 +2666,22 @@ eval_agauss(struct card *deck, char *fcn)
                 delstr = tmp2str = gettok_np(&tmp1str);
                 z = INPevaluate(&tmp2str, &nerror, 1);
                 tfree(delstr);
-                val = agauss(x, y, z);
+                val = agauss(rs, x, y, z);
             }
             else if (cieq(fcn, "gauss")) {
                 delstr = tmp2str = gettok_np(&tmp1str);
                 z = INPevaluate(&tmp2str, &nerror, 1);
                 tfree(delstr);
-                val = gauss(x, y, z);
+                val = gauss(rs, x, y, z);
             }
             else if (cieq(fcn, "aunif")) {
-                val = aunif(x, y);
+                val = aunif(rs, x, y);
             }
             else if (cieq(fcn, "unif")) {
-                val = unif(x, y);
+                val = unif(rs, x, y);
             }
             else if (cieq(fcn, "limit")) {
-                val = limit(x, y);
+                val = limit(rs, x, y);
             }
             else {
                 fprintf(cp_err, "ERROR: Unknown function %s, cannot evaluate\n", fcn);
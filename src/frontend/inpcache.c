@@ -0,0 +1,654 @@
+/* ngspice file inpcache.c
+   Cache of the preprocessed input deck
+   License: BSD 3-clause
+ */
+
+/*
+ * With variable 'deckcache' set to a directory, inp_spsource() stores the
+ * deck returned by inp_readall() into a binary file in this directory.  A
+ * later 'source' of the same netlist, in this or another ngspice session,
+ * loads the deck from there and skips reading the netlist, its .include
+ * and .lib files and all of the preprocessing of inp_readall().
+ *
+ * The file name is a hash of the netlist path, the working directory, the
+ * ngspice version and the variables changing the preprocessing, among them
+ * 'sourcepath', which decides where .include and .lib files are found.
+ * The file holds the resolved path, size and content hash of every file
+ * read for the deck, and is used only if none of them has changed.  The deck itself follows,
+ * card by card, with the source file names in a table of their own.
+ * The values of the environment variables of '.include $VAR/...' paths
+ * are kept as well, and checked as the files are.
+ *
+ * Subcircuit expansion and numparam evaluation are done on every load, so
+ * .param values and 'alterparam' still apply as with a netlist read anew.
+ */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cpextern.h"
+#include "ngspice/fteext.h"
+#include "ngspice/ifsim.h"
+#include "ngspice/inpdefs.h"
+#include "ngspice/hash.h"
+#include "ngspice/wordlist.h"
+#include "inpcache.h"
+#include "inpcom.h"
+#include "inpcompat.h"
+#include "inp.h"
+#include "variable.h"
+#include "../misc/util.h" /* ngdirname() */
+
+#include <stdint.h>
+
+#if !defined(__MINGW32__) && !defined(_MSC_VER)
+#include <unistd.h>
+#endif
+
+
+#define DECK_MAGIC      "NGDECK\r\n"
+#define DECK_VERSION    2
+
+#define FNV_INIT        0xcbf29ce484222325ULL
+#define FNV_PRIME       0x100000001b3ULL
+
+extern int dynmaxline;
+extern wordlist *sourceinfo;
+extern int add_to_sourcepath(const char *filepath, const char *path);
+
+struct deckbuf {
+    char *data;
+    size_t len;             /* bytes written, or bytes of the file read */
+    size_t size;            /* bytes allocated */
+    size_t pos;             /* read position */
+};
+
+/* a file read for the deck */
+struct deckfile {
+    char *name;             /* as given to inp_read() */
+    char *path;             /* resolved, to hash its contents */
+    struct deckfile *next;
+};
+
+static char *cache_file = NULL;     /* cache of the deck being read */
+static struct deckfile *files = NULL, *files_end = NULL;
+static wordlist *envs = NULL;       /* environment variables of the paths */
+
+
+static uint64_t
+fnv_add(uint64_t h, const void *data, size_t n)
+{
+    const unsigned char *p = data;
+
+    while (n--) {
+        h ^= *p++;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+
+static uint64_t
+fnv_str(uint64_t h, const char *s)
+{
+    /* include the terminating '\0' to separate the strings */
+    return fnv_add(h, s, strlen(s) + 1);
+}
+
+
+/* Hash the contents of a file, eight bytes at a time. */
+static bool
+file_hash(const char *path, uint64_t *hash, int64_t *size)
+{
+    static char buf[1 << 16];
+    uint64_t h = FNV_INIT;
+    int64_t len = 0;
+    size_t n, i;
+    FILE *fp = fopen(path, "rb");
+
+    if (!fp)
+        return FALSE;
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        for (i = 0; i + 8 <= n; i += 8) {
+            uint64_t w;
+            memcpy(&w, buf + i, 8);
+            h = (h ^ w) * FNV_PRIME;
+            h ^= h >> 29;
+        }
+        h = fnv_add(h, buf + i, n - i);
+        len += (int64_t) n;
+    }
+
+    fclose(fp);
+
+    *hash = h;
+    *size = len;
+    return TRUE;
+}
+
+
+static uint64_t
+hash_var(uint64_t h, char *name)
+{
+    char buf[BSIZE_SP];
+    struct variable *v;
+    int i;
+
+    h = fnv_str(h, name);
+    if (cp_getvar(name, CP_BOOL, NULL, 0))
+        return fnv_str(h, "on");
+    if (cp_getvar(name, CP_NUM, &i, 0))
+        return fnv_add(h, &i, sizeof(int));
+    if (cp_getvar(name, CP_STRING, buf, sizeof(buf) - 1))
+        return fnv_str(h, buf);
+    if (cp_getvar(name, CP_LIST, &v, 0))
+        for (; v; v = v->va_next)
+            if (v->va_type == CP_STRING)
+                h = fnv_str(h, v->va_string);
+    return h;
+}
+
+
+/* The directories of variable sourcepath as the search for .include and
+   .lib files sees them: inp_read() appends the directory of the netlist
+   before it reads it, and a directory listed twice is searched once.  So
+   the sourcepath growing with every 'source' keeps the key. */
+static uint64_t
+hash_sourcepath(uint64_t h, const char *filename)
+{
+    struct variable *v = NULL, *w, *u;
+    char *dir = ngdirname(filename);
+    bool hasdir = FALSE;
+
+    h = fnv_str(h, "sourcepath");
+    if (cp_getvar("sourcepath", CP_LIST, &v, 0))
+        for (w = v; w; w = w->va_next) {
+            if (w->va_type != CP_STRING)
+                continue;
+            for (u = v; u != w; u = u->va_next)
+                if (u->va_type == CP_STRING && eq(u->va_string, w->va_string))
+                    break;
+            if (u != w)
+                continue;
+            h = fnv_str(h, w->va_string);
+            hasdir = hasdir || eq(w->va_string, dir);
+        }
+    if (!hasdir)
+        h = fnv_str(h, dir);
+
+    tfree(dir);
+    return h;
+}
+
+
+/* Name of the cache file for netlist 'filename' in directory 'dir' */
+static char *
+cache_name(const char *dir, const char *filename)
+{
+    /* variables read by inp_readall() */
+    static char *vars[] = {
+        "addcontrol", "enable_noisy_r", "mingwpath", "ngbehavior",
+        "no_auto_braces", "no_auto_gnd", "probe_alli_nox",
+        "ps_global_tmodels", "rawfile", "soacheck", "wnflag"
+    };
+    char *path, *full, cwd[4096];
+    uint64_t h = FNV_INIT;
+    int i, n = DECK_VERSION;
+
+    path = inp_pathresolve(filename);
+    if (!path)
+        return NULL;
+#if defined(_WIN32)
+    full = _fullpath(NULL, path, 0);
+#else
+    full = realpath(path, NULL);
+#endif
+    tfree(path);
+    if (!full)
+        return NULL;
+
+    h = fnv_add(h, &n, sizeof(int));
+    h = fnv_str(h, ft_sim->version);
+    h = fnv_str(h, full);
+    free(full);
+    if (getcwd(cwd, sizeof(cwd)))
+        h = fnv_str(h, cwd);
+    for (i = 0; i < (int) (sizeof(vars) / sizeof(vars[0])); i++)
+        h = hash_var(h, vars[i]);
+    h = hash_sourcepath(h, filename);
+
+    return tprintf("%s/%016llx.ngdeck", dir, (unsigned long long) h);
+}
+
+
+static void
+files_free(void)
+{
+    while (files) {
+        struct deckfile *next = files->next;
+        tfree(files->name);
+        tfree(files->path);
+        tfree(files);
+        files = next;
+    }
+    files_end = NULL;
+    wl_free(envs);
+    envs = NULL;
+}
+
+
+static void
+put(struct deckbuf *db, const void *data, size_t n)
+{
+    if (db->len + n > db->size) {
+        db->size = MAX(2 * db->size, db->len + n + 4096);
+        db->data = TREALLOC(char, db->data, db->size);
+    }
+    memcpy(db->data + db->len, data, n);
+    db->len += n;
+}
+
+
+static void
+put_int(struct deckbuf *db, int i)
+{
+    put(db, &i, sizeof(int));
+}
+
+
+/* a string, or NULL */
+static void
+put_str(struct deckbuf *db, const char *s)
+{
+    if (!s) {
+        put_int(db, -1);
+        return;
+    }
+    put_int(db, (int) strlen(s));
+    put(db, s, strlen(s));
+}
+
+
+static bool
+get(struct deckbuf *db, void *data, size_t n)
+{
+    if (db->pos + n > db->len)
+        return FALSE;
+    memcpy(data, db->data + db->pos, n);
+    db->pos += n;
+    return TRUE;
+}
+
+
+static bool
+get_int(struct deckbuf *db, int *i)
+{
+    return get(db, i, sizeof(int));
+}
+
+
+static bool
+get_str(struct deckbuf *db, char **s)
+{
+    int n;
+
+    *s = NULL;
+    if (!get_int(db, &n) || n < -1 || (n > 0 && db->pos + (size_t) n > db->len))
+        return FALSE;
+    if (n >= 0) {
+        *s = TMALLOC(char, n + 1);
+        memcpy(*s, db->data + db->pos, (size_t) n);
+        (*s)[n] = '\0';
+        db->pos += (size_t) n;
+    }
+    return TRUE;
+}
+
+
+/* Record a file read by inp_read() while a deck for the cache is read. */
+void
+inp_cache_file(const char *name)
+{
+    struct deckfile *f;
+
+    if (!cache_file || !name)
+        return;
+
+    f = TMALLOC(struct deckfile, 1);
+    f->name = copy(name);
+    f->path = inp_pathresolve(name);
+    if (files_end)
+        files_end->next = f;
+    else
+        files = f;
+    files_end = f;
+}
+
+
+/* Record an environment variable expanded in the path of a file read
+   by inp_read() while a deck for the cache is read. */
+void
+inp_cache_env(const char *name)
+{
+    wordlist *wl;
+
+    if (!cache_file || !name)
+        return;
+
+    for (wl = envs; wl; wl = wl->wl_next)
+        if (eq(wl->wl_word, name))
+            return;
+    envs = wl_cons(copy(name), envs);
+}
+
+
+/* Check the environment variables of the cache against the current ones */
+static bool
+envs_check(struct deckbuf *db)
+{
+    int nenvs, i;
+
+    if (!get_int(db, &nenvs) || nenvs < 0)
+        return FALSE;
+
+    for (i = 0; i < nenvs; i++) {
+        char *name, *value, *s;
+        bool ok;
+
+        if (!get_str(db, &name) || !name)
+            return FALSE;
+        if (!get_str(db, &value)) {
+            tfree(name);
+            return FALSE;
+        }
+        s = getenv(name);
+        ok = value ? (s && eq(s, value)) : !s;
+        tfree(name);
+        tfree(value);
+        if (!ok)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+
+/* Check the files of the cache against the ones on disk */
+static bool
+files_check(struct deckbuf *db, int nfiles, wordlist **names)
+{
+    int i;
+
+    for (i = 0; i < nfiles; i++) {
+        char *name, *path;
+        uint64_t hash, h;
+        int64_t size, n;
+        bool ok;
+
+        if (!get_str(db, &name))
+            return FALSE;
+        if (!get_str(db, &path) || !path ||
+            !get(db, &size, sizeof(size)) || !get(db, &hash, sizeof(hash))) {
+            tfree(name);
+            tfree(path);
+            return FALSE;
+        }
+
+        ok = file_hash(path, &h, &n) && n == size && h == hash;
+        tfree(path);
+        if (!ok) {
+            tfree(name);
+            return FALSE;
+        }
+        *names = wl_cons(name, *names);
+    }
+
+    *names = wl_reverse(*names);
+    return TRUE;
+}
+
+
+static struct card *
+cache_read(struct deckbuf *db, bool *expr_w_temper_p)
+{
+    char magic[sizeof(DECK_MAGIC) - 1];
+    int version, nfiles, nsources, ncards, temper, probe_alli, i;
+    wordlist *names = NULL, *wl;
+    char **sources = NULL;
+    struct card *deck = NULL, *end = NULL;
+
+    if (!get(db, magic, sizeof(magic)) ||
+        memcmp(magic, DECK_MAGIC, sizeof(magic)) != 0 ||
+        !get_int(db, &version) || version != DECK_VERSION ||
+        !get_int(db, &nfiles) || nfiles < 1)
+        return NULL;
+
+    if (!files_check(db, nfiles, &names) || !envs_check(db))
+        goto fail;
+
+    if (!get_int(db, &temper) || !get_int(db, &probe_alli) ||
+        !get_int(db, &nsources) || nsources < 0)
+        goto fail;
+    sources = TMALLOC(char *, nsources + 1);
+    for (i = 0; i < nsources; i++)
+        if (!get_str(db, &sources[i]) || !sources[i])
+            goto fail;
+
+    if (!get_int(db, &ncards) || ncards < 1)
+        goto fail;
+    for (i = 0; i < ncards; i++) {
+        struct card *c = TMALLOC(struct card, 1);
+        int src;
+
+        if (end)
+            end->nextcard = c;
+        else
+            deck = c;
+        end = c;
+
+        if (!get_int(db, &c->linenum) || !get_int(db, &c->linenum_orig) ||
+            !get_int(db, &src) || src < -1 || src >= nsources ||
+            !get(db, &c->w, sizeof(float)) || !get(db, &c->l, sizeof(float)) ||
+            !get(db, &c->nf, sizeof(float)) || !get_int(db, &c->compmod) ||
+            !get_str(db, &c->line) || !c->line || !get_str(db, &c->error))
+            goto fail;
+        c->linesource = src < 0 ? NULL : sources[src];
+    }
+
+    /* the source file names live as long as the circuit, as in inp_read() */
+    for (i = 0; i < nsources; i++)
+        wl_append_word(&sourceinfo, &sourceinfo, sources[i]);
+    tfree(sources);
+
+    for (wl = names; wl; wl = wl->wl_next)
+        add_to_sourcepath(wl->wl_word, NULL);
+    wl_free(names);
+
+    /* as inp_check_syntax() does for '.probe alli' */
+    cp_remvar("probe_alli_given");
+    if (probe_alli) {
+        bool bi = TRUE;
+        cp_vset("probe_alli_given", CP_BOOL, &bi);
+    }
+
+    set_compat_mode();
+    print_compat_mode();
+    dynmaxline = ncards;
+    if (expr_w_temper_p)
+        *expr_w_temper_p = temper != 0;
+
+    return deck;
+
+fail:
+    if (sources) {
+        for (i = 0; i < nsources; i++)
+            tfree(sources[i]);
+        tfree(sources);
+    }
+    wl_free(names);
+    line_free_x(deck, FALSE);
+    return NULL;
+}
+
+
+/* Load the deck of netlist 'filename' from the cache.
+   Returns NULL if there is none, or it is out of date.  The deck
+   then read with inp_readall() is to be given to inp_cache_save(). */
+struct card *
+inp_cache_load(const char *filename, bool *expr_w_temper_p)
+{
+    char dir[BSIZE_SP];
+    struct deckbuf db = { NULL, 0, 0, 0 };
+    struct card *deck = NULL;
+    FILE *fp;
+
+    tfree(cache_file);
+    files_free();
+
+    if (!filename || !cp_getvar("deckcache", CP_STRING, dir, sizeof(dir) - 1))
+        return NULL;
+
+    cache_file = cache_name(dir, filename);
+    if (!cache_file)
+        return NULL;
+
+    fp = fopen(cache_file, "rb");
+    if (!fp)
+        return NULL;
+
+    for (;;) {
+        size_t n;
+        if (db.len == db.size) {
+            db.size = MAX(2 * db.size, 1 << 16);
+            db.data = TREALLOC(char, db.data, db.size);
+        }
+        n = fread(db.data + db.len, 1, db.size - db.len, fp);
+        if (n == 0)
+            break;
+        db.len += n;
+    }
+    fclose(fp);
+
+    deck = cache_read(&db, expr_w_temper_p);
+    tfree(db.data);
+
+    if (deck) {
+        tfree(cache_file);
+        /* as inp_readall() does, 'ngspice -a' applies to the first netlist */
+        if (cp_getvar("addcontrol", CP_BOOL, NULL, 0))
+            cp_remvar("addcontrol");
+        if (ft_ngdebug)
+            printf("Deck of %s loaded from cache\n", filename);
+    }
+    return deck;
+}
+
+
+/* Store the deck read by inp_readall() after a miss of inp_cache_load(). */
+void
+inp_cache_save(struct card *deck, bool expr_w_temper)
+{
+    struct deckbuf db = { NULL, 0, 0, 0 };
+    NGHASHPTR srcindex;
+    struct deckfile *f;
+    struct card *c;
+    wordlist *wl;
+    int nfiles = 0, nsources = 0, ncards = 0;
+    char *tmp;
+    FILE *fp;
+
+    if (!cache_file)
+        return;
+
+    /* decks from 'listing r', and command scripts, are not processed */
+    if (!deck || ciprefix("* expanded deck of", deck->line) ||
+        ciprefix("*ng_script", deck->line))
+        goto done;
+
+    put(&db, DECK_MAGIC, sizeof(DECK_MAGIC) - 1);
+    put_int(&db, DECK_VERSION);
+
+    for (f = files; f; f = f->next)
+        nfiles++;
+    put_int(&db, nfiles);
+    for (f = files; f; f = f->next) {
+        uint64_t hash;
+        int64_t size;
+
+        if (!f->path || !file_hash(f->path, &hash, &size))
+            goto done;
+        put_str(&db, f->name);
+        put_str(&db, f->path);
+        put(&db, &size, sizeof(size));
+        put(&db, &hash, sizeof(hash));
+    }
+
+    put_int(&db, wl_length(envs));
+    for (wl = envs; wl; wl = wl->wl_next) {
+        put_str(&db, wl->wl_word);
+        put_str(&db, getenv(wl->wl_word));
+    }
+
+    put_int(&db, expr_w_temper ? 1 : 0);
+    put_int(&db, cp_getvar("probe_alli_given", CP_BOOL, NULL, 0) ? 1 : 0);
+
+    /* table of the source file names, index + 1 is kept in the hash */
+    srcindex = nghash_init_pointer(NGHASH_MIN_SIZE);
+    for (c = deck; c; c = c->nextcard) {
+        ncards++;
+        if (c->linesource && !nghash_find(srcindex, c->linesource))
+            nghash_insert(srcindex, c->linesource,
+                          (void *) (intptr_t) ++nsources);
+    }
+    put_int(&db, nsources);
+    {
+        char **table = TMALLOC(char *, nsources);
+        void *key;
+        intptr_t i;
+
+        for (i = (intptr_t) nghash_enumeratek(srcindex, &key, TRUE); i;
+             i = (intptr_t) nghash_enumeratek(srcindex, &key, FALSE))
+            table[i - 1] = key;
+        for (i = 0; i < nsources; i++)
+            put_str(&db, table[i]);
+        tfree(table);
+    }
+
+    put_int(&db, ncards);
+    for (c = deck; c; c = c->nextcard) {
+        put_int(&db, c->linenum);
+        put_int(&db, c->linenum_orig);
+        put_int(&db, c->linesource ?
+                (int) (intptr_t) nghash_find(srcindex, c->linesource) - 1 : -1);
+        put(&db, &c->w, sizeof(float));
+        put(&db, &c->l, sizeof(float));
+        put(&db, &c->nf, sizeof(float));
+        put_int(&db, c->compmod);
+        put_str(&db, c->line);
+        put_str(&db, c->error);
+    }
+    nghash_free(srcindex, NULL, NULL);
+
+    /* write to a temporary file first, a concurrent reader sees either
+       the old or the new cache */
+    tmp = tprintf("%s.%d.tmp", cache_file, (int) getpid());
+    fp = fopen(tmp, "wb");
+    if (fp) {
+        bool ok = fwrite(db.data, 1, db.len, fp) == db.len;
+        ok = (fclose(fp) == 0) && ok;
+#if defined(_WIN32)
+        if (ok)
+            remove(cache_file);
+#endif
+        if (!ok || rename(tmp, cache_file) != 0) {
+            fprintf(cp_err, "Warning: cannot write deck cache %s\n", cache_file);
+            remove(tmp);
+        }
+    } else {
+        fprintf(cp_err, "Warning: cannot write deck cache %s\n", tmp);
+    }
+    tfree(tmp);
+
+done:
+    tfree(db.data);
+    tfree(cache_file);
+    files_free();
+}
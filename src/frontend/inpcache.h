@@ -0,0 +1,13 @@
+/*************
+ * Header file for inpcache.c
+ ************/
+
+#ifndef ngspice_INPCACHE_H
+#define ngspice_INPCACHE_H
+
+struct card *inp_cache_load(const char *filename, bool *expr_w_temper_p);
+void inp_cache_save(struct card *deck, bool expr_w_temper);
+void inp_cache_file(const char *name);
+void inp_cache_env(const char *name);
+
+#endif
@@ -27,6 +27,7 @@ Author: 1985 Wayne A. Christopher
 #include "ngspice/ftedefs.h"
 #include "ngspice/fteext.h"
 #include "ngspice/fteinp.h"
+#include "ngspice/hash.h"
 #include "numparam/general.h"
 
 #include "com_set.h"
@@ -43,6 +44,7 @@ Author: 1985 Wayne A. Christopher
 
 #include "../misc/util.h" /* ngdirname() */
 #include "inpcom.h"
+#include "inpcache.h"
 #include "ngspice/stringskip.h"
 #include "ngspice/stringutil.h"
 #include "ngspice/wordlist.h"
@@ -84,6 +86,7 @@ static int num_libraries;
 struct names {
     char *names[N_SUBCKT_W_PARAMS];
     int num_names;
+    NGHASHPTR hash;         /* the names, for find_name() */
 };
 
 struct function_env
@@ -617,6 +620,7 @@ static struct names *new_names(void)
 {
     struct names *p = TMALLOC(struct names, 1);
     p->num_names = 0;
+    p->hash = nghash_init(NGHASH_MIN_SIZE);
 
     return p;
 }
@@ -627,6 +631,7 @@ static void delete_names(struct names *p)
     int i;
     for (i = 0; i < p->num_names; i++)
         tfree(p->names[i]);
+    nghash_free(p->hash, NULL, NULL);
     tfree(p);
 }
 
@@ -1352,6 +1357,7 @@ static struct inp_read_t inp_read(FILE* fp, int call_depth, const char* dir_name
     else {
         sourcelineinfo = copy(file_name);
         add_to_sourcepath(sourcelineinfo, NULL);
+        inp_cache_file(file_name);
     }
 
     wl_append_word(&sourceinfo, &sourceinfo, sourcelineinfo);
@@ -1873,14 +1879,11 @@ static struct inp_read_t inp_read(FILE* fp, int call_depth, const char* dir_name
          * code above) */
         shell_eol_continuation = chk_for_line_continuation(buffer);
 
-        {
-            end = insert_new_line(
-                    end, copy(buffer), line_number++, line_number_orig++, sourcelineinfo);
-            if (!cc)
-                cc = end;
-        }
-
-        tfree(buffer);
+        /* the card takes over 'buffer' */
+        end = insert_new_line(
+                end, buffer, line_number++, line_number_orig++, sourcelineinfo);
+        if (!cc)
+            cc = end;
     } /* end while ((buffer = readline(fp)) != NULL) */
 
     if (!cc) /* No stuff here */
@@ -2141,6 +2144,7 @@ static char *inp_pathresolve_at(const char *name, const char *dir)
             secenv = TRUE;
         }
         if (envvar && !secenv) {
+            inp_cache_env(envvar + 1);
             s = getenv(envvar + 1);
             if (s) {
                 cp_vset(s, CP_STRING, envvar + 1);
@@ -2154,6 +2158,8 @@ static char *inp_pathresolve_at(const char *name, const char *dir)
             controlled_exit(EXIT_BAD);
         }
         else if (envvar && envvar2) {
+            inp_cache_env(envvar + 1);
+            inp_cache_env(envvar2 + 1);
             s = getenv(envvar + 1);
             s1 = getenv(envvar2 + 1);
             if (s && s1) {
@@ -2171,8 +2177,10 @@ static char *inp_pathresolve_at(const char *name, const char *dir)
             controlled_exit(EXIT_BAD);
         }
         else if (envvar && !envvar2 && secenv) {
+            inp_cache_env(envvar + 1);
             s = getenv(envvar + 1);/* skip "$" */
             envvar2 = copy(tmpcurr);
+            inp_cache_env(envvar2 + 2);
             s1 = getenv(envvar2 + 2);/* skip "$/" */
             if (s && s1) {
                 char* newname = tprintf("%s/%s", s, s1);
@@ -2191,6 +2199,7 @@ static char *inp_pathresolve_at(const char *name, const char *dir)
 
         /* no directory separator found, just use the env entry (must include file name) */
         envvar = tmpnam;
+        inp_cache_env(envvar + 1);
         s = getenv(envvar + 1);/* skip '$' */
         if (s) {
             cp_vset(s, CP_STRING, envvar + 1);
@@ -2283,44 +2292,49 @@ static char *inp_pathresolve_at(const char *name, const char *dir)
 
 static char *readline(FILE *fd)
 {
-    int c;
-    int memlen;
-    char *strptr;
-    int strlen;
+    char buf[4 * STRGROW];
+    char *strptr = NULL;
+    size_t len = 0, memlen = 0;
 
-    strlen = 0;
-    memlen = STRGROW;
-    strptr = TMALLOC(char, memlen);
-    memlen -= 1; /* Save constant -1's in while loop */
+    /* read in chunks with fgets(), which is much faster than getc() per
+       character, and ends a chunk at '\n' */
+    while (fgets(buf, sizeof(buf), fd)) {
+        char *s = buf;
+        size_t n;
 
-    while ((c = getc(fd)) != EOF) {
-
-        if (strlen == 0 && (c == '\t' || c == ' ')) /* Leading spaces away */
-            continue;
+        if (len == 0) /* Leading spaces away */
+            while (*s == '\t' || *s == ' ' || *s == '\r')
+                s++;
 
-        if (c == '\r')
-            continue;
-        strptr[strlen++] = (char) c;
+        n = strlen(s);
+        if (len + n + 1 > memlen) {
+            memlen = MAX(2 * memlen, len + n + 1);
+            memlen = MAX(memlen, STRGROW);
+            strptr = TREALLOC(char, strptr, memlen);
+        }
 
-        if (strlen >= memlen) {
-            memlen += STRGROW;
-            if ((strptr = TREALLOC(char, strptr, memlen + 1)) == NULL)
-                return (NULL);
+        if (!memchr(s, '\r', n)) {
+            memcpy(strptr + len, s, n);
+            len += n;
+        }
+        else {
+            for (; *s; s++)
+                if (*s != '\r')
+                    strptr[len++] = *s;
         }
 
-        if (c == '\n')
+        if (len > 0 && strptr[len - 1] == '\n')
             break;
     }
 
-    if (!strlen) {
+    if (!len) {
         tfree(strptr);
         return (NULL);
     }
 
-    // strptr[strlen] = '\0';
     /* Trim the string */
-    strptr = TREALLOC(char, strptr, strlen + 1);
-    strptr[strlen] = '\0';
+    strptr = TREALLOC(char, strptr, len + 1);
+    strptr[len] = '\0';
 
     return (strptr);
 }
@@ -3078,16 +3092,13 @@ struct nlist {
     char **names;
     int num_names;
     int size;
+    NGHASHPTR hash;         /* the names, for nlist_find() */
 };
 
 
 static const char *nlist_find(const struct nlist *nlist, const char *name)
 {
-    int i;
-    for (i = 0; i < nlist->num_names; i++)
-        if (strcmp(nlist->names[i], name) == 0)
-            return nlist->names[i];
-    return NULL;
+    return nghash_find(nlist->hash, (void *) name);
 }
 
 #if 0 /* see line 2452 */
@@ -3113,6 +3124,7 @@ static void nlist_adjoin(struct nlist *nlist, char *name)
         nlist->names = TREALLOC(char *, nlist->names, nlist->size *= 2);
 
     nlist->names[nlist->num_names++] = name;
+    nghash_insert(nlist->hash, name, name);
 }
 
 
@@ -3122,6 +3134,7 @@ static struct nlist *nlist_allocate(int size)
 
     t->names = TMALLOC(char *, size);
     t->size = size;
+    t->hash = nghash_init(size);
 
     return t;
 }
@@ -3133,12 +3146,14 @@ static void nlist_destroy(struct nlist *nlist)
     for (i = 0; i < nlist->num_names; i++)
         tfree(nlist->names[i]);
 
+    nghash_free(nlist->hash, NULL, NULL);
     tfree(nlist->names);
     tfree(nlist);
 }
 
 
-static void get_subckts_for_subckt(struct card *start_card, char *subckt_name,
+/* subckts is a hash table of the .subckt lines of the deck, by name */
+static void get_subckts_for_subckt(NGHASHPTR subckts, char *subckt_name,
         struct nlist *used_subckts, struct nlist *used_models,
         bool has_models)
 {
@@ -3148,7 +3163,8 @@ static void get_subckts_for_subckt(struct card *start_card, char *subckt_name,
     bool found_subckt = FALSE;
     int i, fence;
 
-    for (card = start_card; card; card = card->nextcard) {
+    /* start at the (first) definition of subckt_name */
+    for (card = nghash_find(subckts, subckt_name); card; card = card->nextcard) {
 
         char *line = card->line;
 
@@ -3194,7 +3210,7 @@ static void get_subckts_for_subckt(struct card *start_card, char *subckt_name,
     // now make recursive call on instances just found above
     fence = used_subckts->num_names;
     for (i = first_new_subckt; i < fence; i++)
-        get_subckts_for_subckt(start_card, used_subckts->names[i],
+        get_subckts_for_subckt(subckts, used_subckts->names[i],
                 used_subckts, used_models, has_models);
 }
 
@@ -3209,14 +3225,22 @@ void comment_out_unused_subckt_models(struct card *start_card)
 {
     struct card *card;
     struct nlist *used_subckts, *used_models;
+    NGHASHPTR subckts;
     int i = 0, fence;
     bool processing_subckt = FALSE, remove_subckt = FALSE, has_models = FALSE;
     int skip_control = 0, nested_subckt = 0;
 
     used_subckts = nlist_allocate(100);
     used_models = nlist_allocate(100);
+    subckts = nghash_init(NGHASH_MIN_SIZE);
 
     for (card = start_card; card; card = card->nextcard) {
+        if (ciprefix(".subckt", card->line) || ciprefix(".macro", card->line)) {
+            char *subckt_name = get_subckt_model_name(card->line);
+            if (!nghash_find(subckts, subckt_name))
+                nghash_insert(subckts, subckt_name, card);
+            tfree(subckt_name);
+        }
         if (ciprefix(".model", card->line))
             has_models = TRUE;
         if (ciprefix(".cmodel", card->line))
@@ -3282,9 +3306,11 @@ void comment_out_unused_subckt_models(struct card *start_card)
 
     fence = used_subckts->num_names;
     for (i = 0; i < fence; i++)
-        get_subckts_for_subckt(start_card, used_subckts->names[i],
+        get_subckts_for_subckt(subckts, used_subckts->names[i],
                 used_subckts, used_models, has_models);
 
+    nghash_free(subckts, NULL, NULL);
+
     /* comment out any unused subckts, currently only at top level */
     for (card = start_card; card; card = card->nextcard) {
 
@@ -3650,18 +3676,14 @@ static void add_name(struct names *p, char *name)
     }
 
     p->names[p->num_names++] = name;
+    if (!nghash_find(p->hash, name))
+        nghash_insert(p->hash, name, name);
 }
 
 
-static char **find_name(struct names *p, char *name)
+static char *find_name(struct names *p, char *name)
 {
-    int i;
-
-    for (i = 0; i < p->num_names; i++)
-        if (strcmp(p->names[i], name) == 0)
-            return &p->names[i];
-
-    return NULL;
+    return nghash_find(p->hash, name);
 }
 
 
@@ -9278,11 +9300,7 @@ static char inp_get_elem_ident(char *type)
 static struct card_assoc *find_subckt_1(
         struct nscope *scope, const char *name)
 {
-    struct card_assoc *p = scope->subckts;
-    for (; p; p = p->next)
-        if (eq(name, p->name))
-            break;
-    return p;
+    return nghash_find(scope->subckt_hash, (void *) name);
 }
 
 
@@ -9312,6 +9330,9 @@ static void add_subckt(struct nscope *scope, struct card *subckt_line)
     entry->line = subckt_line;
     entry->next = scope->subckts;
     scope->subckts = entry;
+    /* the last definition is found, as in the list */
+    nghash_delete(scope->subckt_hash, name);
+    nghash_insert(scope->subckt_hash, name, entry);
 }
 
 
@@ -9322,18 +9343,57 @@ struct modellist {
     bool used;
     char elemb;
     struct modellist *next;
+    struct modellist *next_base;    /* next in list with the same base name */
+    int seq;                        /* position, counting from the list end */
 };
 
 
+/* copy of a model name without a model binning extension '\.[0-9]+' */
+static char *model_base_name(const char *name)
+{
+    const char *dot = strrchr(name, '.');
+    const char *p;
+
+    if (dot && dot > name && dot[1]) {
+        for (p = dot + 1; isdigit_c(*p); p++)
+            ;
+        if (*p == '\0')
+            return copy_substring(name, dot);
+    }
+    return copy(name);
+}
+
+
+/* The models of a scope with the same base name are chained by next_base,
+   in list order, the head is in model_hash.  A model matching name by
+   model_name_match() has base name name, or is name itself. */
 static struct modellist *inp_find_model_1(
         struct nscope *scope, const char *name)
 {
-    struct modellist *p = scope->models;
-    for (; p; p = p->next) {
-        if (model_name_match(name, p->modelname))
+    struct modellist *p, *found = NULL;
+    char *base;
+
+    if (!scope->model_hash)
+        return NULL;
+
+    for (p = nghash_find(scope->model_hash, (void *) name); p; p = p->next_base)
+        if (model_name_match(name, p->modelname)) {
+            found = p;
             break;
-    }
-    return p;
+        }
+
+    /* name with a bin number, the first in list order wins */
+    base = model_base_name(name);
+    if (strcmp(base, name) != 0)
+        for (p = nghash_find(scope->model_hash, base); p; p = p->next_base)
+            if (model_name_match(name, p->modelname)) {
+                if (!found || p->seq > found->seq)
+                    found = p;
+                break;
+            }
+    tfree(base);
+
+    return found;
 }
 
 
@@ -9359,6 +9419,8 @@ struct nscope *inp_add_levels(struct card *deck)
     root->next = NULL;
     root->subckts = NULL;
     root->models = NULL;
+    root->subckt_hash = nghash_init(NGHASH_MIN_SIZE);
+    root->model_hash = NULL;
 
     struct nscope *lvl = root;
 
@@ -9387,6 +9449,8 @@ struct nscope *inp_add_levels(struct card *deck)
                 scope->next = lvl;
                 scope->subckts = NULL;
                 scope->models = NULL;
+                scope->subckt_hash = nghash_init(NGHASH_MIN_SIZE);
+                scope->model_hash = NULL;
                 lvl = card->level = scope;
             }
             else if (ciprefix(".ends", curr_line)) {
@@ -9423,6 +9487,9 @@ void inp_rem_levels(struct nscope *root)
         tfree(p);
         p = pn;
     }
+    nghash_free(root->subckt_hash, NULL, NULL);
+    if (root->model_hash)
+        nghash_free(root->model_hash, NULL, NULL);
     tfree(root);
 }
 
@@ -9438,6 +9505,10 @@ static void rem_unused_xxx(struct nscope *level)
         m = next_m;
     }
     level->models = NULL;
+    if (level->model_hash) {
+        nghash_free(level->model_hash, NULL, NULL);
+        level->model_hash = NULL;
+    }
 
     struct card_assoc *p = level->subckts;
     for (; p; p = p->next)
@@ -9447,11 +9518,22 @@ static void rem_unused_xxx(struct nscope *level)
 
 static void mark_all_binned(struct nscope *scope, char *name)
 {
-    struct modellist *p = scope->models;
+    struct modellist *p;
+    char *base;
 
-    for (; p; p = p->next)
+    if (!scope->model_hash)
+        return;
+
+    for (p = nghash_find(scope->model_hash, name); p; p = p->next_base)
         if (model_name_match(name, p->modelname))
             p->used = TRUE;
+
+    base = model_base_name(name);
+    if (strcmp(base, name) != 0)
+        for (p = nghash_find(scope->model_hash, base); p; p = p->next_base)
+            if (model_name_match(name, p->modelname))
+                p->used = TRUE;
+    tfree(base);
 }
 
 
@@ -9499,6 +9581,13 @@ void inp_rem_unused_models(struct nscope *root, struct card *deck)
             modl_new->used = FALSE;
             modl_new->next = card->level->models;
             card->level->models = modl_new;
+            if (!card->level->model_hash)
+                card->level->model_hash = nghash_init(NGHASH_MIN_SIZE);
+            modl_new->seq = modl_new->next ? modl_new->next->seq + 1 : 0;
+            char *base = model_base_name(modl_new->modelname);
+            modl_new->next_base = nghash_delete(card->level->model_hash, base);
+            nghash_insert(card->level->model_hash, base, modl_new);
+            tfree(base);
             tfree(model_type);
         }
     }
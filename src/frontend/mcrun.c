@@ -0,0 +1,331 @@
+/*************
+ * Monte-Carlo runs in parallel worker processes
+ ************/
+
+/*
+ * mcrun runs [workers]
+ *
+ * Repeat the current circuit 'runs' times, the way a .control loop with
+ * 'setseed', 'mc_source' and 'run' does, but distribute the runs over
+ * forked worker processes.  Every worker has its own copy of the circuit
+ * and of the numparam data, so agauss() and friends are evaluated
+ * independently.  Run k is seeded with rndseed + k, the results do not
+ * depend on the number of workers.  Variable rndrun is set to the run
+ * number, for the counter based random streams of 'set rndstream'.
+ *
+ * The .measure results of every run are sent back through a pipe, printed
+ * as one table and stored in a new plot 'mc', one vector per .measure
+ * statement, with the run number as scale.  Failed measurements are NaN.
+ */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cpdefs.h"
+#include "ngspice/ftedefs.h"
+#include "ngspice/dvec.h"
+#include "ngspice/fteinp.h"
+
+#include "mcrun.h"
+#include "inp.h"
+#include "runcoms.h"
+#include "runcoms2.h"
+#include "postcoms.h"
+#include "numparam/numpaif.h"
+#include "ngspice/randnumb.h"
+#include "../misc/misc_time.h"
+
+
+#if defined(HAVE_SYS_WAIT_H) && !defined(SHARED_MODULE)
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+
+#ifdef USE_OMP
+#include <pthread.h>
+#endif
+
+
+/* names of the .measure results of the current circuit */
+static int
+mc_measure_names(char ***names)
+{
+    struct card *meas_card;
+    int count = 0;
+
+    *names = NULL;
+    for (meas_card = ft_curckt->ci_meas; meas_card; meas_card = meas_card->nextcard) {
+        char *line = nexttok(meas_card->line); /* discard .meas */
+        char *an_type = gettok(&line);
+        char *resname = gettok(&line);
+
+        tfree(an_type);
+        if (!resname)
+            continue;
+        *names = TREALLOC(char *, *names, count + 1);
+        (*names)[count++] = resname;
+    }
+
+    return count;
+}
+
+
+struct mc_job {
+    int first, step, runs, seed;
+    char **names;
+    int count;
+    FILE *out;
+};
+
+
+/* do the runs first, first + step, ... and write "run index value" lines
+   for the measurements found */
+static void *
+mc_runs(void *arg)
+{
+    struct mc_job *job = (struct mc_job *) arg;
+    int k, i;
+
+    for (k = job->first; k < job->runs; k += job->step) {
+        int newseed = job->seed + k;
+        int run = k + 1;
+
+        cp_vset("rndseed", CP_NUM, &newseed);
+        cp_vset("rndrun", CP_NUM, &run);
+        com_sseed(NULL);
+        com_mc_source(NULL);
+        com_run(NULL);
+
+        for (i = 0; i < job->count; i++) {
+            int found = 0;
+            double value = nupa_get_param(job->names[i], &found);
+            if (found)
+                fprintf(job->out, "%d %d %.17g\n", k, i, value);
+        }
+        fflush(job->out);
+
+        com_destroy(NULL);
+        com_remcirc(NULL);
+    }
+
+    return NULL;
+}
+
+
+/* worker process */
+static void
+mc_worker(struct mc_job *job)
+{
+    int nthreads = 1;
+
+    /* the tables of the single runs are not wanted */
+    if (!freopen("/dev/null", "w", stdout))
+        _exit(EXIT_BAD);
+
+    /* the workers are the parallelism */
+    cp_vset("num_threads", CP_NUM, &nthreads);
+
+#ifdef USE_OMP
+    /* The OpenMP thread pool of the parent process does not survive fork(),
+       a parallel region entered from the forked thread would wait for it
+       forever.  A new thread starts without a pool. */
+    {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, mc_runs, job) != 0)
+            _exit(EXIT_BAD);
+        pthread_join(tid, NULL);
+    }
+#else
+    mc_runs(job);
+#endif
+
+    fclose(job->out);
+    _exit(EXIT_NORMAL);
+}
+
+
+/* stop and reap the workers started so far */
+static void
+mc_kill(pid_t *pids, FILE **pipes, int workers)
+{
+    int w;
+
+    for (w = 0; w < workers; w++) {
+        kill(pids[w], SIGKILL);
+        fclose(pipes[w]);
+        waitpid(pids[w], NULL, 0);
+    }
+}
+
+
+void
+com_mcrun(wordlist *wl)
+{
+    int runs, workers, seed, count, i, k, w;
+    char **names;
+    double **results;
+    pid_t *pids;
+    FILE **pipes;
+    char buf[BSIZE_SP];
+    struct dvec *v;
+
+    if (!ft_curckt) {
+        fprintf(cp_err, "Error: there is no circuit loaded.\n");
+        return;
+    }
+
+    runs = atoi(wl->wl_word);
+    if (runs <= 0) {
+        fprintf(cp_err, "Error: bad number of runs %s\n", wl->wl_word);
+        return;
+    }
+
+    if (wl->wl_next)
+        workers = atoi(wl->wl_next->wl_word);
+    else
+        workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers <= 0)
+        workers = 1;
+    if (workers > runs)
+        workers = runs;
+
+    if (!cp_getvar("rndseed", CP_NUM, &seed, 0))
+        seed = 1;
+
+    count = mc_measure_names(&names);
+    if (count == 0) {
+        fprintf(cp_err, "Error: mcrun needs .measure statements in the circuit.\n");
+        return;
+    }
+
+    pids = TMALLOC(pid_t, workers);
+    pipes = TMALLOC(FILE *, workers);
+
+    /* do not let the workers inherit pending output */
+    fflush(NULL);
+
+    for (w = 0; w < workers; w++) {
+        int fd[2];
+
+        if (pipe(fd) < 0) {
+            perror("mcrun");
+            break;
+        }
+        pids[w] = fork();
+        if (pids[w] < 0) {
+            perror("mcrun");
+            close(fd[0]);
+            close(fd[1]);
+            break;
+        }
+        if (pids[w] == 0) {
+            close(fd[0]);
+            for (i = 0; i < w; i++)
+                fclose(pipes[i]);
+            struct mc_job job = { w, workers, runs, seed, names, count, NULL };
+            job.out = fdopen(fd[1], "w");
+            if (!job.out)
+                _exit(EXIT_BAD);
+            mc_worker(&job);
+        }
+        close(fd[1]);
+        pipes[w] = fdopen(fd[0], "r");
+        if (!pipes[w]) {
+            perror("mcrun");
+            close(fd[0]);
+            kill(pids[w], SIGKILL);
+            waitpid(pids[w], NULL, 0);
+            break;
+        }
+    }
+
+    if (w < workers) {
+        fprintf(cp_err, "Error: could not start the mcrun workers.\n");
+        mc_kill(pids, pipes, w);
+        for (i = 0; i < count; i++)
+            tfree(names[i]);
+        tfree(names);
+        tfree(pids);
+        tfree(pipes);
+        return;
+    }
+
+    results = TMALLOC(double *, count);
+    for (i = 0; i < count; i++) {
+        results[i] = TMALLOC(double, runs);
+        for (k = 0; k < runs; k++)
+            results[i][k] = NAN;
+    }
+
+    /* the results are small, reading the pipes one after the other does
+       not hold up the workers */
+    for (w = 0; w < workers; w++) {
+        while (fgets(buf, sizeof(buf), pipes[w])) {
+            double value;
+            if (sscanf(buf, "%d %d %lf", &k, &i, &value) == 3 &&
+                k >= 0 && k < runs && i >= 0 && i < count)
+                results[i][k] = value;
+        }
+        fclose(pipes[w]);
+        waitpid(pids[w], NULL, 0);
+    }
+
+    /* one table of all runs */
+    fprintf(cp_out, "\n%-8s %-12s", "run", "seed");
+    for (i = 0; i < count; i++)
+        fprintf(cp_out, " %-16s", names[i]);
+    fprintf(cp_out, "\n");
+    for (k = 0; k < runs; k++) {
+        fprintf(cp_out, "%-8d %-12d", k + 1, seed + k);
+        for (i = 0; i < count; i++)
+            if (isnan(results[i][k]))
+                fprintf(cp_out, " %-16s", "failed");
+            else
+                fprintf(cp_out, " %-16.9e", results[i][k]);
+        fprintf(cp_out, "\n");
+    }
+    fprintf(cp_out, "\n");
+
+    /* and a plot for post-processing */
+    if (runs > 0) {
+        plot_cur = plot_alloc("mc");
+        plot_cur->pl_next = plot_list;
+        plot_list = plot_cur;
+        plot_cur->pl_title = copy(ft_curckt->ci_name);
+        plot_cur->pl_name = copy("Monte-Carlo runs");
+        plot_cur->pl_date = copy(datestring());
+
+        v = dvec_alloc(copy("run"), SV_NOTYPE, VF_REAL | VF_PERMANENT,
+                       runs, NULL);
+        for (k = 0; k < runs; k++)
+            v->v_realdata[k] = k + 1;
+        vec_new(v);
+
+        for (i = 0; i < count; i++) {
+            v = dvec_alloc(copy(names[i]), SV_NOTYPE, VF_REAL | VF_PERMANENT,
+                           runs, results[i]);
+            results[i] = NULL;
+            vec_new(v);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        tfree(results[i]);
+        tfree(names[i]);
+    }
+    tfree(results);
+    tfree(names);
+    tfree(pids);
+    tfree(pipes);
+}
+
+#else
+
+void
+com_mcrun(wordlist *wl)
+{
+    NG_IGNORE(wl);
+    fprintf(cp_err, "Error: mcrun is not available on this system.\n");
+}
+
+#endif
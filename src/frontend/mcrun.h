@@ -0,0 +1,12 @@
+/*************
+ * Header file for mcrun.c
+ ************/
+
+#ifndef ngspice_MCRUN_H
+#define ngspice_MCRUN_H
+
+
+void com_mcrun(wordlist *wl);
+
+
+#endif
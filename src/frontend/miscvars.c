@@ -31,6 +31,8 @@ char *ft_setkwords[] = {
     "askquit",
     "brief",
     "bypass",
+    "checkpoint",
+    "checkpointinterval",
     "chgtol",
     "color<num>",
     "cpdebug",
@@ -40,6 +42,7 @@ char *ft_setkwords[] = {
     "curplotname",
     "curplottitle",
     "debug",
+    "deckcache",
     "defad",
     "defas",
     "defl",
@@ -67,6 +70,8 @@ char *ft_setkwords[] = {
     "history",
     "ignoreeof",
     "interactive",
+    "interpgrid",
+    "interporder",
     "itl1",
     "itl2",
     "itl3",
@@ -84,6 +89,7 @@ char *ft_setkwords[] = {
     "noasciiplotvalue",
     "nobreak",
     "noclobber",
+    "noexprtape",
     "node",
     "noglob",
     "nogrid",
@@ -101,15 +107,25 @@ char *ft_setkwords[] = {
     "pivrel",
     "pivtol",
     "plots",
+    "plottol",
     "pointchars",
     "polydegree",
     "polysteps",
     "program",
     "prompt",
+    "rawasync",
     "rawfile",
     "rawfileprec",
+    "rawmmap",
+    "rawmmapdir",
+    "rawsingle",
+    "rawstart",
+    "rawstop",
+    "rawvectors",
     "renumber",
     "rhost",
+    "rndrun",
+    "rndstream",
     "rprogram",
     "slowplot",
     "sourcepath",
@@ -58,6 +58,8 @@ typedef struct {                /* the input scanner data structure */
     int hs_compatibility;       /* allow extra keywords */
     int linecount;              /* number of lines in deck */
     char* cardline;             /* line of card treated currently */
+    unsigned int rndname;       /* hash of the random stream name */
+    unsigned int rndcount;      /* random functions called for it */
 } dico_t;
 
 
@@ -75,3 +77,4 @@ entry_t *entrynb(dico_t *dico, char *s);
 entry_t *attrib(dico_t *, NGHASHPTR htable, char *t, char op);
 void del_attrib(void *);
 void nupa_copy_inst_entry(char *param_name, entry_t *proto);
+void nupa_rndstream(dico_t *, const char *scope, const char *name, const char *name_end);
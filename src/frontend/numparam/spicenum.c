@@ -685,6 +685,8 @@ nupa_eval(struct card *card)
     if (c == 'P') {                     /* evaluate parameters */
         nupa_assignment(dicoS, dicoS->dynrefptr[linenum], 'N');
     } else if (c == 'B') {              /* substitute braces line */
+        /* random functions are drawn for the instance */
+        nupa_rndstream(dicoS, NULL, s, skip_non_ws(s));
         /* nupa_substitute() may reallocate line buffer. */
 
         err = nupa_substitute(dicoS, dicoS->dynrefptr[linenum], &card->line);
@@ -42,46 +42,89 @@ ternary_fcn(double conditional, double if_value, double else_value)
 }
 
 
+/* Name the random stream for the random functions of the following
+   expressions: scope.name, or name if there is no scope.  With variable
+   rndstream set, the n-th random function evaluated for it gets the
+   n-th counter based stream of that name, see randnumb.c. */
+void
+nupa_rndstream(dico_t *dico, const char *scope, const char *name, const char *name_end)
+{
+    char *full;
+
+    if (scope)
+        full = tprintf("%s.%.*s", scope, (int) (name_end - name), name);
+    else
+        full = copy_substring(name, name_end);
+
+    dico->rndname = rndstream_hash(full);
+    dico->rndcount = 0;
+    tfree(full);
+}
+
+
 static double
-agauss(double nominal_val, double abs_variation, double sigma)
+rnd_gauss(dico_t *dico)
+{
+    struct rndstream rs;
+
+    if (!rndstream_init(&rs, dico->rndname, dico->rndcount++))
+        return gauss1();
+    return rndstream_gauss(&rs);
+}
+
+
+/* uniform in [-1 .. +1[ */
+static double
+rnd_drand(dico_t *dico)
+{
+    struct rndstream rs;
+
+    if (!rndstream_init(&rs, dico->rndname, dico->rndcount++))
+        return drand();
+    return 2.0 * rndstream_uniform(&rs) - 1.0;
+}
+
+
+static double
+agauss(dico_t *dico, double nominal_val, double abs_variation, double sigma)
 {
     double stdvar;
     if (abs_variation <= 0 || sigma <= 0)
         return nominal_val;
     stdvar = abs_variation / sigma;
-    return (nominal_val + stdvar * gauss1());
+    return (nominal_val + stdvar * rnd_gauss(dico));
 }
 
 
 static double
-gauss(double nominal_val, double rel_variation, double sigma)
+gauss(dico_t *dico, double nominal_val, double rel_variation, double sigma)
 {
     double stdvar;
     if (rel_variation <= 0 || sigma <= 0)
         return nominal_val;
     stdvar = nominal_val * rel_variation / sigma;
-    return (nominal_val + stdvar * gauss1());
+    return (nominal_val + stdvar * rnd_gauss(dico));
 }
 
 
 static double
-unif(double nominal_val, double rel_variation)
+unif(dico_t *dico, double nominal_val, double rel_variation)
 {
-    return (nominal_val + nominal_val * rel_variation * drand());
+    return (nominal_val + nominal_val * rel_variation * rnd_drand(dico));
 }
 
 
 static double
-aunif(double nominal_val, double abs_variation)
+aunif(dico_t *dico, double nominal_val, double abs_variation)
 {
-    return (nominal_val + abs_variation * drand());
+    return (nominal_val + abs_variation * rnd_drand(dico));
 }
 
 
 static double
-limit(double nominal_val, double abs_variation)
+limit(dico_t *dico, double nominal_val, double abs_variation)
 {
-    return (nominal_val + (drand() > 0 ? abs_variation : -1. * abs_variation));
+    return (nominal_val + (rnd_drand(dico) > 0 ? abs_variation : -1. * abs_variation));
 }
 
 /* The list of built-in functions. Patch 'mathfunction', here to get more ...
@@ -275,6 +318,8 @@ initdico(dico_t *dico)
     else
         dico->hs_compatibility = 0;
     dico->cardline = NULL;
+    dico->rndname = 0;
+    dico->rndcount = 0;
 }
 
 
@@ -1010,15 +1055,15 @@ formula(dico_t *dico, const char *s, const char *s_end, bool *perror)
                     if (fu == XFU_TERNARY_FCN)
                         u = ternary_fcn(v, w, u);
                     else if (fu == XFU_AGAUSS)
-                        u = agauss(v, w, u);
+                        u = agauss(dico, v, w, u);
                     else if (fu == XFU_GAUSS)
-                        u = gauss(v, w, u);
+                        u = gauss(dico, v, w, u);
                     else if (fu == XFU_UNIF)
-                        u = unif(v, u);
+                        u = unif(dico, v, u);
                     else if (fu == XFU_AUNIF)
-                        u = aunif(v, u);
+                        u = aunif(dico, v, u);
                     else if (fu == XFU_LIMIT)
-                        u = limit(v, u);
+                        u = limit(dico, v, u);
                     else
                         u = mathfunction(fu, v, u);
                 }
@@ -1494,6 +1539,10 @@ nupa_assignment(dico_t *dico, const char *s, char mode)
             break;
         }
 
+        /* random functions are drawn for the parameter */
+        nupa_rndstream(dico, dico->stack_depth > 0 ? dico->inst_name[dico->stack_depth] : NULL,
+                       t_p, t_p + strlen(t_p));
+
         /* assignment expressions */
         while ((p < s_end) && (*p != '='))
             p++;
@@ -28,6 +28,8 @@ Modified: 2000 AlansFixes, 2013/2015 patch by Krzysztof Blaszkowski
 #include "ngspice/cktdefs.h"
 #include "breakp2.h"
 #include "runcoms.h"
+#include "colraw.h"
+#include "rawasync.h"
 #include "plotting/graf.h"
 #include "../misc/misc_time.h"
 
@@ -58,13 +60,16 @@ static void fileEnd(runDesc *run);
 static void plotInit(runDesc *run);
 static void plotAddRealValue(dataDesc *desc, double value);
 static void plotAddComplexValue(dataDesc *desc, IFcomplex value);
+static void plotCompress(runDesc *run);
 static void plotEnd(runDesc *run);
 static bool parseSpecial(char *name, char *dev, char *param, char *ind);
 static bool name_eq(char *n1, char *n2);
 static bool getSpecial(dataDesc *desc, runDesc *run, IFvalue *val);
+static int specialValues(runDesc *run, int param, IFvalue *value);
 static void freeRun(runDesc *run);
-static int InterpFileAdd(runDesc *plotPtr, IFvalue *refValue, IFvalue *valuePtr);
-static int InterpPlotAdd(runDesc *plotPtr, IFvalue *refValue, IFvalue *valuePtr);
+static void resampleInit(runDesc *run);
+static int resampleAdd(runDesc *run, IFvalue *refValue, IFvalue *valuePtr);
+static void resampleEnd(runDesc *run);
 static inline int vlength2delta(int len);
 
 /*Output data to spice module*/
@@ -73,6 +78,7 @@ static inline int vlength2delta(int len);
 #elif defined SHARED_MODULE
 extern int sh_ExecutePerLoop(void);
 extern int sh_vecinit(runDesc *run);
+extern int sh_vecend(void);
 #endif
 
 /*Suppressing progress info in -o option */
@@ -92,11 +98,18 @@ int fixme_inoise_type = SV_NOTYPE;
 static clock_t lastclock, currclock, startclock;
 static double *rowbuf;
 static size_t column, rowbuflen;
+static struct colraw *colout;   /* columnar raw file, see colraw.c */
+static struct rawasync *asyncout; /* writer thread, see rawasync.c */
+static unsigned char *rowcplx;  /* ascii values of the row are complex */
+static int rownum, nvalue;
 
 static bool shouldstop = FALSE; /* Tell simulator to stop next time it asks. */
 
-static bool interpolated = FALSE;
-static double *valueold, *valuenew;
+static bool interpolated = FALSE;   /* see resampleAdd() */
+
+static double plottol = 0.0;    /* see plotCompress() */
+static double *slopelo, *slopehi, *valuemax;
+static int compressed;
 
 #ifdef SHARED_MODULE
 static bool savenone = FALSE;
@@ -155,12 +168,6 @@ beginPlot(JOB *analysisPtr, CKTcircuit *circuitPtr, char *cktName, char *analNam
         if (cp_getvar("printinfo", CP_BOOL, NULL, 0))
             fprintf(cp_err, "(debug printing enabled)\n");
 
-        /* Check to see if we want to save only interpolated data. */
-        if (cp_getvar("interp", CP_BOOL, NULL, 0)) {
-            interpolated = TRUE;
-            fprintf(cp_out, "Warning: Interpolated raw file data!\n\n");
-        }
-
         *runp = run = TMALLOC(struct runDesc, 1);
 
         /* First fill in some general information. */
@@ -445,14 +452,23 @@ beginPlot(JOB *analysisPtr, CKTcircuit *circuitPtr, char *cktName, char *analNam
                 EVTsetup_plot(run->circuit, run->runPlot->pl_typename);
 #endif
         }
+
+        /* store interpolated data only */
+        resampleInit(run);
     }
 
-    /* define storage for old and new data, to allow interpolation */
-    if (interpolated && run->circuit->CKTcurJob->JOBtype == 4) {
-        valueold = TMALLOC(double, run->numData);
-        for (i = 0; i < run->numData; i++)
-            valueold[i] = 0.0;
-        valuenew = TMALLOC(double, run->numData);
+    /* drop transient points on a straight line from memory */
+    plottol = 0.0;
+    if (!run->writeOut && !interpolated && run->refIndex != -1 &&
+        run->circuit->CKTcurJob->JOBtype == 4 &&
+        cp_getvar("plottol", CP_REAL, &plottol, 0) && plottol > 0.0) {
+        tfree(slopelo);
+        tfree(slopehi);
+        tfree(valuemax);
+        slopelo = TMALLOC(double, run->numData);
+        slopehi = TMALLOC(double, run->numData);
+        valuemax = TMALLOC(double, run->numData);
+        compressed = 0;
     }
 
     /*Start BLT, initilises the blt vectors saj*/
@@ -640,17 +656,9 @@ OUTpData(runDesc *plotPtr, IFvalue *refValue, IFvalue *valuePtr)
 #ifdef TCL_MODULE
     steps_completed = run->pointCount;
 #endif
-    /* interpolated batch mode output to file/plot in transient analysis */
-    if (interpolated && run->circuit->CKTcurJob->JOBtype == 4) {
-        /* JOBtype == 4 means Transient Analysis.  FIX ME */
-
-        if (run->writeOut) { /* To file */
-            InterpFileAdd(run, refValue, valuePtr);
-        }
-        else { /* To plot */
-            InterpPlotAdd(run, refValue, valuePtr);
-        }
-        return OK;
+    /* interpolated output to file/plot */
+    if (interpolated) {
+        return resampleAdd(run, refValue, valuePtr);
     } else if (run->writeOut) {
         /* standard batch mode output to file */
 
@@ -774,6 +782,8 @@ OUTpData(runDesc *plotPtr, IFvalue *refValue, IFvalue *valuePtr)
     }
     else {
         OUTpD_memory(run, refValue, valuePtr);
+        if (plottol > 0.0)
+            plotCompress(run);
 
         /*  This is interactive mode. Update the screen with the reference
             variable just the same  */
@@ -814,6 +824,9 @@ OUTpData(runDesc *plotPtr, IFvalue *refValue, IFvalue *valuePtr)
 int
 OUTendPlot(runDesc *plotPtr)
 {
+    if (interpolated)
+        resampleEnd(plotPtr);
+
     if (plotPtr->writeOut) {
         fileEnd(plotPtr);
     } else {
@@ -821,8 +834,14 @@ OUTendPlot(runDesc *plotPtr)
         plotEnd(plotPtr);
     }
 
-    tfree(valueold);
-    tfree(valuenew);
+    tfree(slopelo);
+    tfree(slopehi);
+    tfree(valuemax);
+    plottol = 0.0;
+
+#ifdef SHARED_MODULE
+    sh_vecend();
+#endif
 
     freeRun(plotPtr);
 
@@ -838,7 +857,8 @@ OUTattributes(runDesc *plotPtr, IFuid varName, int param, IFvalue *value)
 
     struct dvec *d;
 
-    NG_IGNORE(value);
+    if (param == OUT_SPECIALS_GET || param == OUT_SPECIALS_SET)
+        return specialValues(run, param, value);
 
     if (param == OUT_SCALE_LIN)
         type = GRID_LIN;
@@ -1026,9 +1046,6 @@ fileInit_pass2(runDesc *run)
         fprintf(run->fp, "\n");
     }
 
-    fprintf(run->fp, "%s:\n", run->binary ? "Binary" : "Values");
-    fflush(run->fp);
-
     /*  Allocate Row buffer  */
 
     if (run->binary) {
@@ -1036,32 +1053,56 @@ fileInit_pass2(runDesc *run)
         if (run->isComplex)
             rowbuflen *= 2;
         rowbuf = TMALLOC(double, rowbuflen);
+    } else if (rawasync_wanted()) {
+        /* the writer thread formats the ascii rows */
+        rowbuflen = 2 * (size_t) (run->numData);
+        rowbuf = TMALLOC(double, rowbuflen);
+        rowcplx = TMALLOC(unsigned char, run->numData);
     } else {
         rowbuflen = 0;
         rowbuf = NULL;
     }
+
+    /* the columnar format needs a seekable file, else write binary */
+    colout = NULL;
+    if (run->binary && colraw_filetype() && run->fp != stdout)
+        colout = colraw_begin(run->fp, (int) rowbuflen);
+    if (!colout)
+        fprintf(run->fp, "%s:\n", run->binary ? "Binary" : "Values");
+    fflush(run->fp);
+
+    asyncout = NULL;
+    if (rawasync_wanted())
+        asyncout = rawasync_begin(run->fp, colout, run->binary,
+                                  (int) rowbuflen, run->numData);
 }
 
 
 static void
 fileStartPoint(FILE *fp, bool bin, int num)
 {
-    if (!bin)
+    if (!bin && !asyncout)
         fprintf(fp, "%d\t", num - 1);
 
     /*  reset buffer pointer to zero  */
 
     column = 0;
+    rownum = num;
+    nvalue = 0;
 }
 
 
 static void
 fileAddRealValue(FILE *fp, bool bin, double value)
 {
-    if (bin)
+    if (bin) {
         rowbuf[column++] = value;
-    else
+    } else if (asyncout) {
+        rowcplx[nvalue++] = 0;
+        rowbuf[column++] = value;
+    } else {
         fprintf(fp, "\t%.*e\n", DOUBLE_PRECISION, value);
+    }
 }
 
 
@@ -1071,6 +1112,10 @@ fileAddComplexValue(FILE *fp, bool bin, IFcomplex value)
     if (bin) {
         rowbuf[column++] = value.real;
         rowbuf[column++] = value.imag;
+    } else if (asyncout) {
+        rowcplx[nvalue++] = 1;
+        rowbuf[column++] = value.real;
+        rowbuf[column++] = value.imag;
     } else {
         fprintf(fp, "\t%.*e,%.*e\n", DOUBLE_PRECISION, value.real,
                 DOUBLE_PRECISION, value.imag);
@@ -1084,8 +1129,15 @@ fileEndPoint(FILE *fp, bool bin)
     /*  write row buffer to file  */
     /* otherwise the data has already been written */
 
-    if (bin)
-        fwrite(rowbuf, sizeof(double), rowbuflen, fp);
+    if (asyncout) {
+        rawasync_add_row(asyncout, rownum, rowbuf,
+                         bin ? (int) rowbuflen : (int) column, rowcplx, nvalue);
+    } else if (bin) {
+        if (colout)
+            colraw_add_row(colout, rowbuf);
+        else
+            fwrite(rowbuf, sizeof(double), rowbuflen, fp);
+    }
 }
 
 
@@ -1094,6 +1146,16 @@ fileEndPoint(FILE *fp, bool bin)
 static void
 fileEnd(runDesc *run)
 {
+    if (asyncout) {
+        rawasync_end(asyncout);
+        asyncout = NULL;
+    }
+
+    if (colout) {
+        colraw_end(colout);
+        colout = NULL;
+    }
+
     if (run->fp != stdout) {
         long place = ftell(run->fp);
         fseek(run->fp, run->pointPos, SEEK_SET);
@@ -1108,6 +1170,7 @@ fileEnd(runDesc *run)
     fflush(run->fp);
 
     tfree(rowbuf);
+    tfree(rowcplx);
 }
 
 
@@ -1257,6 +1320,88 @@ plotAddComplexValue(dataDesc *desc, IFcomplex value)
 }
 
 
+/* With variable 'plottol' set, a transient time point is not kept in
+ * memory if every vector of the plot, within plottol times its largest
+ * magnitude so far, lies on the straight line between its neighbours.
+ * Like the swinging door algorithm of process historians, slopelo and
+ * slopehi hold the slopes from the last point kept, the anchor, that
+ * pass within the tolerance of all points dropped since.  The newest
+ * point always is stored, it replaces the previous one as long as the
+ * line from the anchor to it fits all points in between.  So quiescent
+ * stretches shrink to their end points, and 'linearize' or 'interpolate'
+ * recover all dropped points within the tolerance.
+ *
+ * Only the plot as a whole is compressed: the vectors share one scale, so
+ * a point is dropped for all of them or for none.  A quiescent node next
+ * to a switching one keeps every point of the switching one.
+ */
+static void
+plotCompress(runDesc *run)
+{
+    struct dvec *scale = run->data[run->refIndex].vec;
+    int n = scale->v_length;
+    int i;
+    bool drop = (n >= 3 && n == compressed + 1);
+
+    for (i = 0; i < run->numData; i++) {
+        struct dvec *v = run->data[i].vec;
+        if (!isreal(v) || v->v_length != n) {
+            compressed = 0;
+            return;
+        }
+    }
+
+    /* is the slope from the anchor to the new point inside all bounds? */
+    if (drop) {
+        double dt = scale->v_realdata[n - 1] - scale->v_realdata[n - 3];
+        if (dt <= 0.0)
+            drop = FALSE;
+        for (i = 0; drop && i < run->numData; i++) {
+            double *y = run->data[i].vec->v_realdata;
+            double slope = (y[n - 1] - y[n - 3]) / dt;
+            if (slope < slopelo[i] || slope > slopehi[i])
+                drop = FALSE;
+        }
+    }
+
+    for (i = 0; i < run->numData; i++) {
+        struct dvec *v = run->data[i].vec;
+        double *y = v->v_realdata;
+        double band, dt, lo, hi;
+
+        if (n < 2)
+            break;
+
+        valuemax[i] = MAX(valuemax[i], fabs(y[n - 1]));
+        band = plottol * valuemax[i];
+
+        if (drop) {
+            /* the new point replaces the previous one */
+            dt = scale->v_realdata[n - 1] - scale->v_realdata[n - 3];
+            lo = (y[n - 1] - band - y[n - 3]) / dt;
+            hi = (y[n - 1] + band - y[n - 3]) / dt;
+            slopelo[i] = MAX(slopelo[i], lo);
+            slopehi[i] = MIN(slopehi[i], hi);
+            y[n - 2] = y[n - 1];
+            v->v_length = n - 1;
+            v->v_dims[0] = n - 1;
+        } else {
+            /* the previous point is the new anchor */
+            dt = scale->v_realdata[n - 1] - scale->v_realdata[n - 2];
+            if (dt > 0.0) {
+                slopelo[i] = (y[n - 1] - band - y[n - 2]) / dt;
+                slopehi[i] = (y[n - 1] + band - y[n - 2]) / dt;
+            } else {
+                slopelo[i] = 1.0;
+                slopehi[i] = -1.0;
+            }
+        }
+    }
+
+    compressed = drop ? n - 1 : n;
+}
+
+
 static void
 plotEnd(runDesc *run)
 {
@@ -1344,6 +1489,15 @@ getSpecial(dataDesc *desc, runDesc *run, IFvalue *val)
     IFvalue selector;
     struct variable *vv;
 
+    if (run->specValues) {
+        double value = run->specValues[desc - run->data];
+        if (isnan(value))
+            return FALSE;
+        desc->type = IF_REAL;
+        val->rValue = value;
+        return TRUE;
+    }
+
     selector.iValue = desc->specIndex;
     if (INPaName(desc->specParamName, val, run->circuit, &desc->specType,
                  desc->specName, &desc->specFast, ft_sim, &desc->type,
@@ -1371,6 +1525,50 @@ getSpecial(dataDesc *desc, runDesc *run, IFvalue *val)
 }
 
 
+/* The @ vectors are read from the circuit by getSpecial() when a point is
+ * written.  A dc sweep done by worker processes (option dcparallel) reads
+ * them in the worker with OUT_SPECIALS_GET, and hands them to OUTpData()
+ * in the parent with OUT_SPECIALS_SET.  The values are indexed like
+ * run->data, NaN where getSpecial() found nothing.  With rVec NULL,
+ * OUT_SPECIALS_GET returns the size of the array, 0 if there are no @
+ * vectors.  OUT_SPECIALS_SET with value NULL ends the replay.
+ */
+static int
+specialValues(runDesc *run, int param, IFvalue *value)
+{
+    int i;
+
+    if (param == OUT_SPECIALS_SET) {
+        run->specValues = value ? value->v.vec.rVec : NULL;
+        return (OK);
+    }
+
+    if (run->isComplex)
+        return (E_UNSUPP);
+
+    if (!value->v.vec.rVec) {
+        value->v.numValue = 0;
+        for (i = 0; i < run->numData; i++)
+            if (!run->data[i].regular)
+                value->v.numValue = run->numData;
+        return (OK);
+    }
+
+    for (i = 0; i < run->numData; i++) {
+        IFvalue val;
+
+        if (run->data[i].regular)
+            continue;
+        if (getSpecial(&run->data[i], run, &val) && run->data[i].type == IF_REAL)
+            value->v.vec.rVec[i] = val.rValue;
+        else
+            value->v.vec.rVec[i] = NAN;
+    }
+
+    return (OK);
+}
+
+
 static void
 freeRun(runDesc *run)
 {
@@ -1473,296 +1671,469 @@ OUTerrorf(int flags, const char *format, ...)
 }
 
 
-static int
-InterpFileAdd(runDesc *run, IFvalue *refValue, IFvalue *valuePtr)
+/* Resampled output.
+ *
+ * With option 'interp' the transient output is resampled to the TSTEP
+ * grid of the .tran statement.  Variable 'interpgrid' selects a grid for
+ * the output of every analysis with a scale:
+ *
+ *   set interpgrid=10n             steps of 10n from the first point
+ *   set interpgrid=( dec 20 )      20 points per decade from the first point
+ *   set interpgrid=( 1u 2u 5u )    the given scale values
+ *
+ * 'interporder' 2 interpolates quadratically through the last three
+ * simulator points, default is 1, linear interpolation between the last
+ * two.  Only the grid points and the last simulator point are stored to
+ * memory, to the raw file and sent to the shared ngspice callbacks.  A
+ * dec grid needs a first point above 0, else the output is not resampled.
+ * A scale stepping back, like the inner sweep of a nested dc sweep, starts
+ * the grid anew from that point.
+ */
+
+enum { GRID_STEP, GRID_DEC, GRID_LIST };
+
+static struct {
+    int grid;               /* GRID_STEP, GRID_DEC or GRID_LIST */
+    double step;            /* step or points per decade */
+    double base;            /* first grid point, if hasbase */
+    bool hasbase;
+    double *list;           /* GRID_LIST, ascending */
+    int listlen;
+    int order;              /* 1 linear, 2 quadratic */
+    int next;               /* index of the next grid point */
+    int dir;                /* +1 rising, -1 falling scale */
+    int count;              /* simulator points of the segment so far */
+    int segment;            /* scale resets so far */
+    bool atend;             /* the latest point has been stored */
+    bool off;               /* no grid, every point is stored */
+    double x[3];            /* scale of the last three points, x[2] latest */
+    double *row[3];         /* their values, real and imaginary parts */
+    bool *valid;            /* the values of the latest point are known */
+    double *out;            /* interpolated values */
+} resample;
+
+
+static void
+resampleFree(void)
 {
     int i;
-    static double timeold = 0.0, timenew = 0.0, timestep = 0.0;
-    bool nodata = FALSE;
-    bool interpolatenow = FALSE;
 
-    if (run->pointCount == 1) {
-        fileInit_pass2(run);
-        timestep = run->circuit->CKTinitTime + run->circuit->CKTstep;
+    tfree(resample.list);
+    for (i = 0; i < 3; i++)
+        tfree(resample.row[i]);
+    tfree(resample.valid);
+    tfree(resample.out);
+    interpolated = FALSE;
+}
+
+
+static bool
+resampleValue(struct variable *v, double *value)
+{
+    char *s;
+
+    switch (v->va_type) {
+    case CP_NUM:
+        *value = v->va_num;
+        return TRUE;
+    case CP_REAL:
+        *value = v->va_real;
+        return TRUE;
+    case CP_STRING:
+        s = v->va_string;
+        return ft_numparse(&s, TRUE, value) >= 0;
+    default:
+        return FALSE;
     }
+}
 
-    if (run->refIndex != -1) {
-        /*  Save first time step  */
-        if (refValue->rValue == run->circuit->CKTinitTime) {
-            fileStartPoint(run->fp, run->binary, run->pointCount);
-            fileAddRealValue(run->fp, run->binary, run->circuit->CKTinitTime);
-            interpolatenow = nodata = FALSE;
-        }
-        /*  Save last time step  */
-        else if (refValue->rValue == run->circuit->CKTfinalTime) {
-            fileStartPoint(run->fp, run->binary, run->pointCount);
-            fileAddRealValue(run->fp, run->binary, run->circuit->CKTfinalTime);
-            interpolatenow = nodata = FALSE;
-        }
-        /*  Save exact point  */
-        else if (refValue->rValue == timestep) {
-            fileStartPoint(run->fp, run->binary, run->pointCount);
-            fileAddRealValue(run->fp, run->binary, timestep);
-            timestep += run->circuit->CKTstep;
-            interpolatenow = nodata = FALSE;
-        }
-        else if (refValue->rValue > timestep) {
-            /* add the next time step value to the vector */
-            fileStartPoint(run->fp, run->binary, run->pointCount);
-            timenew = refValue->rValue;
-            fileAddRealValue(run->fp, run->binary, timestep);
-            timestep += run->circuit->CKTstep;
-            nodata = FALSE;
-            interpolatenow = TRUE;
-        }
-        else {
-            /* Do not save this step */
-            run->pointCount--;
-            nodata = TRUE;
-            interpolatenow = FALSE;
-        }
-#ifndef HAS_WINGUI
-        if (!orflag && !ft_norefprint && !cp_background) {
-            currclock = clock();
-            if ((currclock-lastclock) > (0.25*CLOCKS_PER_SEC)) {
-                fprintf(stdout, " Reference value : % 12.5e\r",
-                        refValue->rValue);
-                fflush(stdout);
-                lastclock = currclock;
-            }
+
+static int
+resampleCompare(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/* the grid from the words of variable interpgrid */
+static bool
+resampleGrid(struct variable *v)
+{
+    struct variable *w;
+    int n;
+
+    if (v && v->va_type == CP_STRING &&
+        (cieq(v->va_string, "dec") || cieq(v->va_string, "lin"))) {
+        resample.grid = cieq(v->va_string, "dec") ? GRID_DEC : GRID_STEP;
+        return v->va_next && !v->va_next->va_next &&
+            resampleValue(v->va_next, &resample.step) && resample.step > 0.0;
+    }
+
+    if (v && !v->va_next) {
+        resample.grid = GRID_STEP;
+        return resampleValue(v, &resample.step) && resample.step > 0.0;
+    }
+
+    for (n = 0, w = v; w; w = w->va_next)
+        n++;
+    resample.grid = GRID_LIST;
+    resample.list = TMALLOC(double, n);
+    resample.listlen = n;
+    for (n = 0, w = v; w; w = w->va_next)
+        if (!resampleValue(w, &resample.list[n++]))
+            return FALSE;
+    qsort(resample.list, (size_t) n, sizeof(double), resampleCompare);
+
+    return n > 0;
+}
+
+
+/* Set up resampling for a new plot, if wanted */
+static void
+resampleInit(runDesc *run)
+{
+    struct variable *v = NULL;
+    double value;
+    char buf[BSIZE_SP];
+    bool ok = TRUE;
+    int i;
+
+    resampleFree();
+
+    if (run->refIndex == -1)
+        return;
+
+    memset(&resample, 0, sizeof(resample));
+
+    if (cp_getvar("interpgrid", CP_LIST, &v, 0)) {
+        ok = resampleGrid(v);
+    } else if (cp_getvar("interpgrid", CP_REAL, &value, 0)) {
+        resample.grid = GRID_STEP;
+        resample.step = value;
+        ok = value > 0.0;
+    } else if (cp_getvar("interpgrid", CP_STRING, buf, sizeof(buf))) {
+        /* "dec 20" */
+        struct variable *words = NULL, **pw = &words;
+        char *s = buf, *word;
+        while ((word = gettok(&s)) != NULL) {
+            *pw = var_alloc_string(NULL, word, NULL);
+            pw = &(*pw)->va_next;
         }
-#endif
+        ok = resampleGrid(words);
+        free_struct_variable(words);
+    } else if (cp_getvar("interp", CP_BOOL, NULL, 0) &&
+               run->circuit->CKTcurJob->JOBtype == 4) {
+        /* JOBtype == 4 means Transient Analysis.  FIX ME */
+        resample.grid = GRID_STEP;
+        resample.step = run->circuit->CKTstep;
+        resample.base = run->circuit->CKTinitTime;
+        resample.hasbase = TRUE;
+        ok = resample.step > 0.0;
+        fprintf(cp_out, "Warning: Interpolated raw file data!\n\n");
+    } else {
+        return;
+    }
 
+    if (!ok) {
+        fprintf(cp_err, "Warning: bad interpgrid, output not resampled\n");
+        resampleFree();
+        return;
     }
 
-    for (i = 0; i < run->numData; i++) {
-        /* we've already printed reference vec first */
-        if (run->data[i].outIndex == -1)
-            continue;
+    if (!cp_getvar("interporder", CP_NUM, &resample.order, 0) ||
+        resample.order < 1 || resample.order > 2)
+        resample.order = 1;
 
-#ifdef TCL_MODULE
-        blt_add(i, refValue ? refValue->rValue : NAN);
-#endif
+    for (i = 0; i < 3; i++)
+        resample.row[i] = TMALLOC(double, 2 * run->numData);
+    resample.valid = TMALLOC(bool, run->numData);
+    resample.out = TMALLOC(double, 2 * run->numData);
+    interpolated = TRUE;
+}
 
-        if (run->data[i].regular) {
-        /*  Store value or interpolate and store or do not store any value to file */
-            if (!interpolatenow && !nodata) {
-                /* store the first or last value */
-                valueold[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
-                fileAddRealValue(run->fp, run->binary, valueold[i]);
-            }
-            else if (interpolatenow) {
-            /*  Interpolate time if actual time is greater than proposed next time step  */
-                double newval;
-                valuenew[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
-                newval = (timestep -  run->circuit->CKTstep - timeold)/(timenew - timeold) * (valuenew[i] - valueold[i]) + valueold[i];
-                fileAddRealValue(run->fp, run->binary, newval);
-                valueold[i] = valuenew[i];
-            }
-            else if (nodata)
-                /* Just keep the transient output value corresponding to timeold, 
-                    but do not store to file */
-                valueold[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
+
+/* a GRID_LIST for a falling scale is descending */
+static void
+resampleReverse(void)
+{
+    int i;
+
+    for (i = 0; i < resample.listlen / 2; i++) {
+        double t = resample.list[i];
+        resample.list[i] = resample.list[resample.listlen - 1 - i];
+        resample.list[resample.listlen - 1 - i] = t;
+    }
+}
+
+
+/* grid point k, FALSE beyond the end of the grid */
+static bool
+resamplePoint(int k, double *x)
+{
+    switch (resample.grid) {
+    case GRID_STEP:
+        *x = resample.base + resample.dir * k * resample.step;
+        return TRUE;
+    case GRID_DEC:
+        *x = resample.base * pow(10.0, resample.dir * k / resample.step);
+        return *x > 0.0 && *x < HUGE_VAL;
+    default:
+        if (k >= resample.listlen)
+            return FALSE;
+        *x = resample.list[k];
+        return TRUE;
+    }
+}
+
+
+/* Store the grid point x with the values in resample.out */
+static void
+resampleEmit(runDesc *run, double x)
+{
+    double *y = resample.out;
+    int i;
+
+    run->pointCount++;
+
+    if (run->writeOut) {
+        fileStartPoint(run->fp, run->binary, run->pointCount);
+
+        if (run->isComplex) {
+            IFcomplex c;
+            c.real = x;
+            c.imag = 0.0;
+            fileAddComplexValue(run->fp, run->binary, c);
         } else {
-            IFvalue val;
-            /* should pre-check instance */
-            if (!getSpecial(&run->data[i], run, &val)) {
-
-                /*  If this is the first data point, print a warning for any unrecognized
-                    variables, since this has not already been checked  */
-                if (run->pointCount == 1)
-                fprintf(stderr, "Warning: unrecognized variable - %s\n",
-                        run->data[i].name);
-                val.rValue = 0;
-                fileAddRealValue(run->fp, run->binary, val.rValue);
+            fileAddRealValue(run->fp, run->binary, x);
+        }
+
+        for (i = 0; i < run->numData; i++) {
+            double re = resample.valid[i] ? y[2 * i] : 0.0;
+            double im = resample.valid[i] ? y[2 * i + 1] : 0.0;
+
+            /* we've already printed reference vec first */
+            if (run->data[i].outIndex == -1)
                 continue;
+
+#ifdef TCL_MODULE
+            blt_add(i, re);
+#endif
+
+            if (run->data[i].type == IF_COMPLEX) {
+                IFcomplex c;
+                c.real = re;
+                c.imag = im;
+                fileAddComplexValue(run->fp, run->binary, c);
+            } else {
+                fileAddRealValue(run->fp, run->binary, re);
             }
-            if (!interpolatenow && !nodata) {
-                /* store the first or last value */
-                valueold[i] = val.rValue;
-                fileAddRealValue(run->fp, run->binary, valueold[i]);
-            }
-            else if (interpolatenow) {
-            /*  Interpolate time if actual time is greater than proposed next time step  */
-                double newval;
-                valuenew[i] = val.rValue;
-                newval = (timestep -  run->circuit->CKTstep - timeold)/(timenew - timeold) * (valuenew[i] - valueold[i]) + valueold[i];
-                fileAddRealValue(run->fp, run->binary, newval);
-                valueold[i] = valuenew[i];
-            }
-            else if (nodata)
-                /* Just keep the transient output value corresponding to timeold, 
-                    but do not store to file */
-                valueold[i] = val.rValue;
         }
 
+        fileEndPoint(run->fp, run->binary);
+
+        /*  Check that the write to disk completed successfully, otherwise abort  */
+        if (ferror(run->fp)) {
+            fprintf(stderr, "Warning: rawfile write error !!\n");
+            shouldstop = TRUE;
+        }
+    } else {
+        for (i = 0; i < run->numData; i++) {
+            dataDesc *d = &run->data[i];
+            IFcomplex c;
+
+            if (!resample.valid[i])
+                continue;
+
 #ifdef TCL_MODULE
-        blt_add(i, valuePtr->v.vec.rVec [run->data[i].outIndex]);
+            /*Locks the blt vector to stop access*/
+            blt_lockvec(i);
 #endif
 
-    }
-    timeold = refValue->rValue;
-    fileEndPoint(run->fp, run->binary);
+            c.real = (d->outIndex == -1) ? x : y[2 * i];
+            c.imag = (d->outIndex == -1) ? 0.0 : y[2 * i + 1];
+            if (d->type == IF_COMPLEX)
+                plotAddComplexValue(d, c);
+            else
+                plotAddRealValue(d, c.real);
 
-    /*  Check that the write to disk completed successfully, otherwise abort  */
-    if (ferror(run->fp)) {
-        fprintf(stderr, "Warning: rawfile write error !!\n");
-        shouldstop = TRUE;
+#ifdef TCL_MODULE
+            /*relinks and unlocks vector*/
+            blt_relink(i, d->vec);
+#endif
+        }
     }
 
-    if (ft_bpcheck(run->runPlot, run->pointCount) == FALSE)
-        shouldstop = TRUE;
-
-#ifdef TCL_MODULE
-    Tcl_ExecutePerLoop();
-#elif defined SHARED_MODULE
+#ifdef SHARED_MODULE
     sh_ExecutePerLoop();
 #endif
-    return(OK);
 }
 
+
+/* A new simulator point: store the grid points up to it */
 static int
-InterpPlotAdd(runDesc *run, IFvalue *refValue, IFvalue *valuePtr)
+resampleAdd(runDesc *run, IFvalue *refValue, IFvalue *valuePtr)
 {
-    int i, iscale = -1;
-    static double timeold = 0.0, timenew = 0.0, timestep = 0.0;
-    bool nodata = FALSE;
-    bool interpolatenow = FALSE;
+    dataDesc *ref = &run->data[run->refIndex];
+    double x = (ref->type == IF_COMPLEX) ? refValue->cValue.real : refValue->rValue;
+    double *row, g, eps;
+    int i, n = 2 * run->numData;
+    bool emitted = FALSE;
 
-    if (run->pointCount == 1)
-        timestep = run->circuit->CKTinitTime + run->circuit->CKTstep;
+    /* counts the grid points stored */
+    run->pointCount--;
 
-    /* find the scale vector */
-    for (i = 0; i < run->numData; i++)
-        if (run->data[i].outIndex == -1) {
-            iscale = i;
-            break;
-        }
-    if (iscale == -1)
-        fprintf(stderr, "Error: no scale vector found\n");
-
-#ifdef TCL_MODULE
-    /*Locks the blt vector to stop access*/
-    blt_lockvec(iscale);
-#endif
+    if (resample.count == 0 && resample.segment == 0 && run->writeOut)
+        fileInit_pass2(run);
 
-    /*  Save first time step  */
-    if (refValue->rValue == run->circuit->CKTinitTime) {
-        plotAddRealValue(&run->data[iscale], refValue->rValue);
-        interpolatenow = nodata = FALSE;
-    }
-    /*  Save last time step  */
-    else if (refValue->rValue == run->circuit->CKTfinalTime) {
-        plotAddRealValue(&run->data[iscale], run->circuit->CKTfinalTime);
-        interpolatenow = nodata = FALSE;
-    }
-    /*  Save exact point  */
-    else if (refValue->rValue == timestep) {
-        plotAddRealValue(&run->data[iscale], timestep);
-        timestep += run->circuit->CKTstep;
-        interpolatenow = nodata = FALSE;
-    }
-    else if (refValue->rValue > timestep) {
-        /* add the next time step value to the vector */
-        timenew = refValue->rValue;
-        plotAddRealValue(&run->data[iscale], timestep);
-        timestep += run->circuit->CKTstep;
-        nodata = FALSE;
-        interpolatenow = TRUE;
+    /* the scale steps back: the last point of the segment is stored, and
+       the grid starts anew */
+    if (resample.count > 1 && resample.dir * (x - resample.x[2]) < 0.0) {
+        if (!resample.atend) {
+            memcpy(resample.out, resample.row[2], (size_t) n * sizeof(double));
+            resampleEmit(run, resample.x[2]);
+            emitted = TRUE;
+        }
+        if (resample.grid == GRID_LIST && resample.dir < 0)
+            resampleReverse();
+        resample.count = 0;
+        resample.next = 0;
+        resample.dir = 0;
+        resample.segment++;
     }
-    else {
-        /* Do not save this step */
-        run->pointCount--;
-        nodata = TRUE;
-        interpolatenow = FALSE;
+
+    /* a point not beyond the latest one replaces it */
+    if (resample.count == 0 ||
+        (resample.count == 1 ? x != resample.x[2] : resample.dir * (x - resample.x[2]) > 0.0)) {
+        row = resample.row[0];
+        resample.row[0] = resample.row[1];
+        resample.row[1] = resample.row[2];
+        resample.row[2] = row;
+        resample.x[0] = resample.x[1];
+        resample.x[1] = resample.x[2];
+        resample.count++;
     }
+    row = resample.row[2];
+    resample.x[2] = x;
 
-#ifdef TCL_MODULE
-    /*relinks and unlocks vector*/
-    blt_relink(iscale, (run->data[iscale]).vec);
-#endif
+    for (i = 0; i < run->numData; i++) {
+        dataDesc *d = &run->data[i];
+        IFvalue val;
+
+        resample.valid[i] = TRUE;
+        row[2 * i + 1] = 0.0;
+
+        if (d->outIndex == -1) {
+            val = *refValue;
+        } else if (d->regular) {
+            if (d->type == IF_COMPLEX)
+                val.cValue = valuePtr->v.vec.cVec[d->outIndex];
+            else
+                val.rValue = valuePtr->v.vec.rVec[d->outIndex];
+        } else if (!getSpecial(d, run, &val)) {
+            /*  If this is the first data point, print a warning for any unrecognized
+                variables, since this has not already been checked  */
+            if (resample.count == 1 && resample.segment == 0 && run->writeOut)
+                fprintf(stderr, "Warning: unrecognized variable - %s\n", d->name);
+            resample.valid[i] = FALSE;
+            row[2 * i] = 0.0;
+            continue;
+        }
+
+        if (d->type == IF_COMPLEX) {
+            row[2 * i] = val.cValue.real;
+            row[2 * i + 1] = val.cValue.imag;
+        } else {
+            row[2 * i] = val.rValue;
+        }
+    }
 
 #ifndef HAS_WINGUI
     if (!orflag && !ft_norefprint && !cp_background) {
         currclock = clock();
         if ((currclock-lastclock) > (0.25*CLOCKS_PER_SEC)) {
-            fprintf(stdout, " Reference value : % 12.5e\r",
-                    refValue->rValue);
+            fprintf(stdout, " Reference value : % 12.5e\r", x);
             fflush(stdout);
             lastclock = currclock;
         }
     }
 #endif
 
-    for (i = 0; i < run->numData; i++) {
-        if (i == iscale)
-            continue;
+    resample.atend = FALSE;
 
-#ifdef TCL_MODULE
-        /*Locks the blt vector to stop access*/
-        blt_lockvec(i);
-#endif
-
-        if (run->data[i].regular) {
-        /*  Store value or interpolate and store or do not store any value to file */
-            if (!interpolatenow && !nodata) {
-                /* store the first or last value */
-                valueold[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
-                plotAddRealValue(&run->data[i], valueold[i]);
-            }
-            else if (interpolatenow) {
-            /*  Interpolate time if actual time is greater than proposed next time step  */
-                double newval;
-                valuenew[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
-                newval = (timestep -  run->circuit->CKTstep - timeold)/(timenew - timeold) * (valuenew[i] - valueold[i]) + valueold[i];
-                plotAddRealValue(&run->data[i], newval);
-                valueold[i] = valuenew[i];
-            }
-            else if (nodata)
-                /* Just keep the transient output value corresponding to timeold, 
-                    but do not store to file */
-                valueold[i] = valuePtr->v.vec.rVec [run->data[i].outIndex];
-        } else {
-            IFvalue val;
-            /* should pre-check instance */
-            if (!getSpecial(&run->data[i], run, &val))
-                continue;
-            if (!interpolatenow && !nodata) {
-                /* store the first or last value */
-                valueold[i] = val.rValue;
-                plotAddRealValue(&run->data[i], valueold[i]);
-            }
-            else if (interpolatenow) {
-            /*  Interpolate time if actual time is greater than proposed next time step  */
-                double newval;
-                valuenew[i] = val.rValue;
-                newval = (timestep -  run->circuit->CKTstep - timeold)/(timenew - timeold) * (valuenew[i] - valueold[i]) + valueold[i];
-                plotAddRealValue(&run->data[i], newval);
-                valueold[i] = valuenew[i];
-            }
-            else if (nodata)
-                /* Just keep the transient output value corresponding to timeold, 
-                    but do not store to file */
-                valueold[i] = val.rValue;
+    if (resample.count == 1 && !resample.hasbase) {
+        resample.base = x;
+        if (resample.grid == GRID_DEC && x <= 0.0 && !resample.off) {
+            fprintf(cp_err, "Warning: interpgrid dec needs a scale above 0, "
+                    "output not resampled\n");
+            resample.off = TRUE;
         }
+    }
 
-#ifdef TCL_MODULE
-        /*relinks and unlocks vector*/
-        blt_relink(i, (run->data[i]).vec);
-#endif
+    if (resample.off) {
+        memcpy(resample.out, row, (size_t) n * sizeof(double));
+        resampleEmit(run, x);
+        resample.atend = TRUE;
+        emitted = TRUE;
+    } else if (resample.count > 1) {
+        double *y0 = resample.row[0], *y1 = resample.row[1], *y2 = resample.row[2];
+        double x0 = resample.x[0], x1 = resample.x[1], x2 = resample.x[2];
+
+        eps = 1e-9 * fabs(x2 - x1) + 1e-14 * fabs(x2);
+
+        if (resample.count == 2) {
+            /* the direction of the scale is known now */
+            resample.dir = (x2 > x1) ? 1 : -1;
+            if (resample.grid == GRID_LIST && resample.dir < 0)
+                resampleReverse();
+            while (resamplePoint(resample.next, &g) && resample.dir * (g - x1) < -eps)
+                resample.next++;
+        }
 
+        while (resamplePoint(resample.next, &g) && resample.dir * (g - x2) <= eps) {
+            if (resample.order == 2 && resample.count >= 3) {
+                /* Lagrange polynomial through the last three points */
+                double l0 = (g - x1) * (g - x2) / ((x0 - x1) * (x0 - x2));
+                double l1 = (g - x0) * (g - x2) / ((x1 - x0) * (x1 - x2));
+                double l2 = (g - x0) * (g - x1) / ((x2 - x0) * (x2 - x1));
+                for (i = 0; i < n; i++)
+                    resample.out[i] = l0 * y0[i] + l1 * y1[i] + l2 * y2[i];
+            } else {
+                double f = (g - x1) / (x2 - x1);
+                for (i = 0; i < n; i++)
+                    resample.out[i] = y1[i] + f * (y2[i] - y1[i]);
+            }
+            resampleEmit(run, g);
+            resample.next++;
+            emitted = TRUE;
+            if (fabs(g - x2) <= eps)
+                resample.atend = TRUE;
+        }
     }
-    timeold = refValue->rValue;
-    gr_iplot(run->runPlot);
+
+    if (emitted && !run->writeOut)
+        gr_iplot(run->runPlot);
 
     if (ft_bpcheck(run->runPlot, run->pointCount) == FALSE)
         shouldstop = TRUE;
 
 #ifdef TCL_MODULE
     Tcl_ExecutePerLoop();
-#elif defined SHARED_MODULE
-    sh_ExecutePerLoop();
 #endif
 
-    return(OK);
+    return OK;
+}
+
+
+/* End of the plot: the last simulator point is stored as it is, unless
+   it is on the grid */
+static void
+resampleEnd(runDesc *run)
+{
+    if (resample.count > 0 && !resample.atend) {
+        memcpy(resample.out, resample.row[2], 2 * (size_t) run->numData * sizeof(double));
+        resampleEmit(run, resample.x[2]);
+    }
+    resampleFree();
 }
@@ -43,6 +43,7 @@ struct runDesc {
     int isComplex;
     int windowCount;
     int maxData;
+    double *specValues;         /* replayed @ vectors, OUT_SPECIALS_SET */
 };
 
 
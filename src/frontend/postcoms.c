@@ -456,7 +456,7 @@ com_write(wordlist *wl)
     }
 
     if (cp_getvar("filetype", CP_STRING, buf, sizeof(buf))) {
-        if (eq(buf, "binary"))
+        if (eq(buf, "binary") || eq(buf, "columnar"))
             ascii = FALSE;
         else if (eq(buf, "ascii"))
             ascii = TRUE;
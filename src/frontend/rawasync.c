@@ -0,0 +1,278 @@
+/*************
+ * Raw file output in a separate thread
+ ************/
+
+/*
+ * With variable 'rawasync' set, the batch mode raw file is written by a
+ * writer thread.  OUTpData() copies each data point into one of a ring of
+ * RING_BUFFERS buffers, and hands a buffer to the writer when it is full.
+ * The writer formats ascii rows, encodes columnar chunks or writes binary
+ * rows, so the simulation waits for the disk only when all buffers are
+ * still queued.  OUTendPlot() hands over the rest and waits for the writer.
+ */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cpdefs.h"
+#include "ngspice/ftedefs.h"
+
+#include "rawasync.h"
+#include "colraw.h"
+#include "variable.h"
+
+
+#if defined(HAVE_PTHREAD_CREATE) && defined(HAVE_PTHREAD_H)
+
+#include <pthread.h>
+
+#define DOUBLE_PRECISION    15  /* as in outitf.c */
+
+#define RING_BUFFERS 4
+#define RING_DOUBLES 131072     /* 1 MB of data per buffer */
+
+
+struct rawbuf {
+    int rows;
+    int *num;               /* point number, ascii */
+    int *ndoubles;          /* doubles in the row */
+    int *nvalues;           /* values in the row, ascii */
+    double *data;           /* rows of up to ndoubles_max doubles */
+    unsigned char *cplx;    /* value is complex, ascii */
+};
+
+
+struct rawasync {
+    FILE *fp;
+    struct colraw *cr;
+    bool binary;
+    int ndoubles_max, nvalues_max, maxrows;
+
+    struct rawbuf ring[RING_BUFFERS];
+    int head;               /* next buffer to write */
+    int tail;               /* buffer being filled */
+    int queued;             /* buffers handed to the writer */
+    bool done;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t queued_cond, free_cond;
+};
+
+
+static void
+write_buffer(struct rawasync *ra, struct rawbuf *b)
+{
+    int i, k;
+
+    if (ra->binary) {
+        for (i = 0; i < b->rows; i++) {
+            double *row = b->data + (size_t) i * (size_t) ra->ndoubles_max;
+            if (ra->cr)
+                colraw_add_row(ra->cr, row);
+            else
+                fwrite(row, sizeof(double), (size_t) b->ndoubles[i], ra->fp);
+        }
+        return;
+    }
+
+    for (i = 0; i < b->rows; i++) {
+        double *val = b->data + (size_t) i * (size_t) ra->ndoubles_max;
+        unsigned char *cplx = b->cplx + (size_t) i * (size_t) ra->nvalues_max;
+
+        fprintf(ra->fp, "%d\t", b->num[i] - 1);
+        for (k = 0; k < b->nvalues[i]; k++)
+            if (cplx[k]) {
+                fprintf(ra->fp, "\t%.*e,%.*e\n", DOUBLE_PRECISION, val[0],
+                        DOUBLE_PRECISION, val[1]);
+                val += 2;
+            } else {
+                fprintf(ra->fp, "\t%.*e\n", DOUBLE_PRECISION, val[0]);
+                val++;
+            }
+    }
+}
+
+
+static void *
+writer(void *arg)
+{
+    struct rawasync *ra = (struct rawasync *) arg;
+
+    pthread_mutex_lock(&ra->mutex);
+    for (;;) {
+        struct rawbuf *b;
+
+        while (ra->queued == 0 && !ra->done)
+            pthread_cond_wait(&ra->queued_cond, &ra->mutex);
+        if (ra->queued == 0)
+            break;
+
+        b = &ra->ring[ra->head];
+        pthread_mutex_unlock(&ra->mutex);
+
+        write_buffer(ra, b);
+
+        pthread_mutex_lock(&ra->mutex);
+        b->rows = 0;
+        ra->head = (ra->head + 1) % RING_BUFFERS;
+        ra->queued--;
+        pthread_cond_signal(&ra->free_cond);
+    }
+    pthread_mutex_unlock(&ra->mutex);
+
+    return NULL;
+}
+
+
+bool
+rawasync_wanted(void)
+{
+    return cp_getvar("rawasync", CP_BOOL, NULL, 0);
+}
+
+
+/* Start the writer for the data section of a plot.  Rows hold up to
+   ndoubles doubles and, in an ascii file, up to nvalues values.  Binary
+   rows are sent to cr if given.  Returns NULL if no thread is available. */
+struct rawasync *
+rawasync_begin(FILE *fp, struct colraw *cr, bool binary, int ndoubles, int nvalues)
+{
+    struct rawasync *ra = TMALLOC(struct rawasync, 1);
+    int i;
+
+    ra->fp = fp;
+    ra->cr = cr;
+    ra->binary = binary;
+    ra->ndoubles_max = MAX(ndoubles, 1);
+    ra->nvalues_max = MAX(nvalues, 1);
+    ra->maxrows = MAX(RING_DOUBLES / ra->ndoubles_max, 1);
+
+    for (i = 0; i < RING_BUFFERS; i++) {
+        struct rawbuf *b = &ra->ring[i];
+        b->ndoubles = TMALLOC(int, ra->maxrows);
+        b->data = TMALLOC(double, (size_t) ra->maxrows * (size_t) ra->ndoubles_max);
+        if (!binary) {
+            b->num = TMALLOC(int, ra->maxrows);
+            b->nvalues = TMALLOC(int, ra->maxrows);
+            b->cplx = TMALLOC(unsigned char, (size_t) ra->maxrows * (size_t) ra->nvalues_max);
+        }
+    }
+
+    pthread_mutex_init(&ra->mutex, NULL);
+    pthread_cond_init(&ra->queued_cond, NULL);
+    pthread_cond_init(&ra->free_cond, NULL);
+
+    if (pthread_create(&ra->thread, NULL, writer, ra) != 0) {
+        ra->done = TRUE;
+        rawasync_end(ra);
+        return NULL;
+    }
+
+    return ra;
+}
+
+
+/* Queue one row of ndoubles doubles.  Value k of an ascii row is complex
+   if cplx[k] is set. */
+void
+rawasync_add_row(struct rawasync *ra, int num, const double *row, int ndoubles,
+                 const unsigned char *cplx, int nvalues)
+{
+    struct rawbuf *b = &ra->ring[ra->tail];
+    int i = b->rows++;
+
+    b->ndoubles[i] = ndoubles;
+    memcpy(b->data + (size_t) i * (size_t) ra->ndoubles_max, row,
+           (size_t) ndoubles * sizeof(double));
+    if (!ra->binary) {
+        b->num[i] = num;
+        b->nvalues[i] = nvalues;
+        memcpy(b->cplx + (size_t) i * (size_t) ra->nvalues_max, cplx,
+               (size_t) nvalues);
+    }
+
+    if (b->rows < ra->maxrows)
+        return;
+
+    /* hand the buffer over, and wait for a free one */
+    pthread_mutex_lock(&ra->mutex);
+    ra->queued++;
+    ra->tail = (ra->tail + 1) % RING_BUFFERS;
+    pthread_cond_signal(&ra->queued_cond);
+    while (ra->queued == RING_BUFFERS)
+        pthread_cond_wait(&ra->free_cond, &ra->mutex);
+    pthread_mutex_unlock(&ra->mutex);
+}
+
+
+/* Write the remaining rows, stop the writer and free ra */
+void
+rawasync_end(struct rawasync *ra)
+{
+    int i;
+
+    if (!ra->done) {
+        pthread_mutex_lock(&ra->mutex);
+        if (ra->ring[ra->tail].rows > 0)
+            ra->queued++;
+        ra->done = TRUE;
+        pthread_cond_signal(&ra->queued_cond);
+        pthread_mutex_unlock(&ra->mutex);
+        pthread_join(ra->thread, NULL);
+    }
+
+    pthread_mutex_destroy(&ra->mutex);
+    pthread_cond_destroy(&ra->queued_cond);
+    pthread_cond_destroy(&ra->free_cond);
+
+    for (i = 0; i < RING_BUFFERS; i++) {
+        struct rawbuf *b = &ra->ring[i];
+        tfree(b->num);
+        tfree(b->ndoubles);
+        tfree(b->nvalues);
+        tfree(b->data);
+        tfree(b->cplx);
+    }
+    tfree(ra);
+}
+
+#else
+
+bool
+rawasync_wanted(void)
+{
+    return FALSE;
+}
+
+
+struct rawasync *
+rawasync_begin(FILE *fp, struct colraw *cr, bool binary, int ndoubles, int nvalues)
+{
+    NG_IGNORE(fp);
+    NG_IGNORE(cr);
+    NG_IGNORE(binary);
+    NG_IGNORE(ndoubles);
+    NG_IGNORE(nvalues);
+    return NULL;
+}
+
+
+void
+rawasync_add_row(struct rawasync *ra, int num, const double *row, int ndoubles,
+                 const unsigned char *cplx, int nvalues)
+{
+    NG_IGNORE(ra);
+    NG_IGNORE(num);
+    NG_IGNORE(row);
+    NG_IGNORE(ndoubles);
+    NG_IGNORE(cplx);
+    NG_IGNORE(nvalues);
+}
+
+
+void
+rawasync_end(struct rawasync *ra)
+{
+    NG_IGNORE(ra);
+}
+
+#endif
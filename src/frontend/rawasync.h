@@ -0,0 +1,19 @@
+/*************
+ * Header file for rawasync.c
+ ************/
+
+#ifndef ngspice_RAWASYNC_H
+#define ngspice_RAWASYNC_H
+
+
+struct rawasync;
+struct colraw;
+
+bool rawasync_wanted(void);
+struct rawasync *rawasync_begin(FILE *fp, struct colraw *cr, bool binary, int ndoubles, int nvalues);
+void rawasync_add_row(struct rawasync *ra, int num, const double *row, int ndoubles,
+                      const unsigned char *cplx, int nvalues);
+void rawasync_end(struct rawasync *ra);
+
+
+#endif
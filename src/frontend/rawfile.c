@@ -17,7 +17,9 @@ Author: 1986 Wayne A. Christopher, U. C. Berkeley CAD Group
 
 #include "rawfile.h"
 #include "variable.h"
+#include "colraw.h"
 #include "../misc/misc_time.h"
+#include "../misc/util.h" /* ngdirname() */
 
 #include "ngspice/compatmode.h"
 
@@ -53,6 +55,7 @@ void raw_write(char *name, struct plot *pl, bool app, bool binary)
     char buf[BSIZE_SP];
     char *branch;
     bool keepbranch = FALSE;
+    bool columnar = binary && colraw_filetype();
 
     raw_padding = !cp_getvar("nopadding", CP_BOOL, NULL, 0);
     keepbranch = cp_getvar("keep#branch", CP_BOOL, NULL, 0);
@@ -71,7 +74,17 @@ void raw_write(char *name, struct plot *pl, bool app, bool binary)
     }
 
     /* - Binary file binary write -  hvogt 15.03.2000 ---------------------*/
-    if (binary) {
+    if (columnar) {
+        /* the columnar format patches its header, append mode would not allow it */
+        if ((fp = app ? fopen(name, "r+b") : NULL) != NULL)
+            fseek(fp, 0, SEEK_END);
+        else if ((fp = fopen(name, "wb")) == NULL) {
+            perror(name);
+            return;
+        }
+        fprintf(cp_out, "columnar raw file \"%s\"\n", name);
+    }
+    else if (binary) {
         if ((fp = fopen(name, app ? "ab" : "wb")) == NULL) {
             perror(name);
             return;
@@ -220,7 +233,39 @@ void raw_write(char *name, struct plot *pl, bool app, bool binary)
         (void) putc('\n', fp);
     }
 
-    if (binary) {
+    if (columnar) {
+        int ncols = realflag ? nvars : 2 * nvars;
+        double *row = TMALLOC(double, ncols);
+        struct colraw *cr = colraw_begin(fp, ncols);
+
+        if (!cr) {
+            fprintf(cp_err, "Error: %s is not seekable, nothing written.\n", name);
+            length = 0;
+        }
+
+        /* shorter vectors are padded with zeros */
+        for (i = 0; i < length; i++) {
+            for (j = 0, v = pl->pl_dvecs; v; v = v->v_next) {
+                if (i >= v->v_length) {
+                    row[j++] = 0.0;
+                    if (!realflag)
+                        row[j++] = 0.0;
+                }
+                else if (realflag) {
+                    row[j++] = isreal(v) ? v->v_realdata[i] : realpart(v->v_compdata[i]);
+                }
+                else {
+                    row[j++] = isreal(v) ? v->v_realdata[i] : realpart(v->v_compdata[i]);
+                    row[j++] = isreal(v) ? 0.0 : imagpart(v->v_compdata[i]);
+                }
+            }
+            colraw_add_row(cr, row);
+        }
+        if (cr)
+            colraw_end(cr);
+        tfree(row);
+    }
+    else if (binary) {
         fprintf(fp, "Binary:\n");
         for (i = 0; i < length; i++) {
             for (v = pl->pl_dvecs; v; v = v->v_next) {
@@ -295,6 +340,239 @@ void raw_write(char *name, struct plot *pl, bool app, bool binary)
 } /* end of function raw_write */
 
 
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP) && defined(HAVE_MKSTEMP)
+
+/*
+ * With variable 'rawmmap' set, the data of a binary raw file are not read
+ * into the heap.  The raw file is mapped, and its rows are transposed once
+ * into the columns of a deleted scratch file, which is mapped shared.  The
+ * vectors point into these columns, so their data live in the page cache
+ * and are paged in and out by the kernel.  The scratch file is made in the
+ * directory given by variable 'rawmmapdir', else next to the raw file, else
+ * in the temporary directory.
+ *
+ * Vector data are accessed through plain pointers everywhere, so a column
+ * cannot be filled on its first use, the transposition is done during
+ * 'load'.  It reads the raw file once, sequentially.
+ *
+ * Every mapping counts the vectors pointing into it and is removed with
+ * the last of them.  dvec.c asks raw_mapped() before it reallocates or
+ * frees vector data.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct rawmap {
+    char *base;
+    size_t len;
+    int refs;
+    struct rawmap *next;
+};
+
+static struct rawmap *rawmaps = NULL;
+
+/* rows transposed per pass, keeps the source pages of a pass in cache */
+#define MAP_ROWS 4096
+
+
+static struct rawmap *
+raw_findmap(const void *data)
+{
+    struct rawmap *m;
+
+    for (m = rawmaps; m; m = m->next)
+        if ((const char *) data >= m->base && (const char *) data < m->base + m->len)
+            return m;
+
+    return NULL;
+}
+
+
+/* Does data point into the mapping of a raw file? */
+bool
+raw_mapped(const void *data)
+{
+    return rawmaps && data && raw_findmap(data);
+}
+
+
+/* Release data of a vector, if they point into the mapping of a raw file.
+   Returns FALSE for any other data. */
+bool
+raw_unmap(void *data)
+{
+    struct rawmap *m, **prev;
+
+    if (!rawmaps || !data)
+        return FALSE;
+
+    for (prev = &rawmaps; (m = *prev) != NULL; prev = &m->next)
+        if ((char *) data >= m->base && (char *) data < m->base + m->len)
+            break;
+    if (!m)
+        return FALSE;
+
+    if (--m->refs == 0) {
+        munmap(m->base, m->len);
+        *prev = m->next;
+        tfree(m);
+    }
+
+    return TRUE;
+}
+
+
+/* Make a deleted scratch file of len bytes for the columns of raw file
+   name.  Returns its descriptor, or -1. */
+static int
+raw_scratch(const char *name, size_t len)
+{
+    char buf[BSIZE_SP];
+    char *dirs[3], *path;
+    int fd = -1, i, ndirs = 0;
+
+    if (cp_getvar("rawmmapdir", CP_STRING, buf, sizeof(buf)) && *buf) {
+        dirs[ndirs++] = copy(buf);
+    } else {
+        const char *tmpdir = getenv("TMPDIR");
+        dirs[ndirs++] = ngdirname(name);
+        dirs[ndirs++] = copy((tmpdir && *tmpdir) ? tmpdir : "/tmp");
+    }
+
+    for (i = 0; i < ndirs && fd < 0; i++) {
+        path = tprintf("%s/ngrawXXXXXX", dirs[i]);
+        fd = mkstemp(path);
+        if (fd >= 0) {
+            unlink(path);
+            if (ftruncate(fd, (off_t) len) < 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        tfree(path);
+    }
+
+    if (fd < 0)
+        fprintf(cp_err, "Warning: no scratch file for mapping %s in %s, "
+                "the data are read\n", name, dirs[0]);
+
+    for (i = 0; i < ndirs; i++)
+        tfree(dirs[i]);
+
+    return fd;
+}
+
+
+/* Map the values of plot pl of raw file name, stored row by row from the
+   current position of fp, and let its vectors point into the transposed
+   copy.  Every row holds all nvars vectors.  Returns FALSE if the file
+   cannot be mapped, nothing has been changed then. */
+static bool
+raw_map(FILE *fp, const char *name, struct plot *pl, int nvars, int npoints,
+        bool real)
+{
+    size_t esize = real ? sizeof(double) : sizeof(ngcomplex_t);
+    size_t len = (size_t) nvars * (size_t) npoints * esize;
+    size_t srclen;
+    long pagesize = sysconf(_SC_PAGESIZE);
+    struct rawmap *m;
+    struct dvec *v;
+    struct stat st;
+    char *src, *dst;
+    const char *rows;
+    off_t off, aoff;
+    int fd, i, j, k;
+
+    if (len == 0 || pagesize <= 0)
+        return FALSE;
+
+    off = ftello(fp);
+    if (off < 0 || fstat(fileno(fp), &st) < 0 || st.st_size < off + (off_t) len)
+        return FALSE;
+
+    /* the rows are not aligned in the file */
+    aoff = off - off % pagesize;
+    srclen = len + (size_t) (off - aoff);
+    src = mmap(NULL, srclen, PROT_READ, MAP_PRIVATE, fileno(fp), aoff);
+    if (src == MAP_FAILED)
+        return FALSE;
+#ifdef MADV_SEQUENTIAL
+    madvise(src, srclen, MADV_SEQUENTIAL);
+#endif
+    rows = src + (off - aoff);
+
+    fd = raw_scratch(name, len);
+    if (fd < 0) {
+        munmap(src, srclen);
+        return FALSE;
+    }
+    dst = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (dst == MAP_FAILED) {
+        munmap(src, srclen);
+        return FALSE;
+    }
+
+    for (i = 0; i < npoints; i += MAP_ROWS) {
+        int nrows = MIN(MAP_ROWS, npoints - i);
+        for (j = 0; j < nvars; j++) {
+            const char *s = rows + ((size_t) i * (size_t) nvars + (size_t) j) * esize;
+            char *d = dst + ((size_t) j * (size_t) npoints + (size_t) i) * esize;
+            for (k = 0; k < nrows; k++) {
+                memcpy(d, s, esize);
+                s += (size_t) nvars * esize;
+                d += esize;
+            }
+        }
+    }
+    munmap(src, srclen);
+
+    m = TMALLOC(struct rawmap, 1);
+    m->base = dst;
+    m->len = len;
+    m->refs = 0;
+    m->next = rawmaps;
+    rawmaps = m;
+
+    for (v = pl->pl_dvecs, j = 0; v; v = v->v_next, j++) {
+        char *col = dst + (size_t) j * (size_t) npoints * esize;
+        if (real) {
+            tfree(v->v_realdata);
+            v->v_realdata = (double *) col;
+        } else {
+            tfree(v->v_compdata);
+            v->v_compdata = (ngcomplex_t *) col;
+        }
+        m->refs++;
+    }
+
+    fseeko(fp, off + (off_t) len, SEEK_SET);
+
+    return TRUE;
+}
+
+#else
+
+bool
+raw_mapped(const void *data)
+{
+    NG_IGNORE(data);
+    return FALSE;
+}
+
+
+bool
+raw_unmap(void *data)
+{
+    NG_IGNORE(data);
+    return FALSE;
+}
+
+#endif
+
+
 
 /* Read a raw file.  Returns a list of plot structures.  This routine should be
  * very flexible about what it expects to see in the rawfile.  Really all we
@@ -588,7 +866,8 @@ raw_read(char *name) {
                 curpl->pl_dvecs = v;
             }
 
-        } else if (ciprefix("values:", buf) || ciprefix("binary:", buf)) {
+        } else if (ciprefix("values:", buf) || ciprefix("binary:", buf) ||
+                   ciprefix("columnar:", buf)) {
 
             if (!curpl) {
                 fprintf(cp_err, "Error: no plot name given\n");
@@ -634,6 +913,28 @@ raw_read(char *name) {
             else
                 is_ascii = FALSE;
 
+            if (ciprefix("columnar:", buf)) {
+                if (colraw_read(fp, buf, curpl, !(flags & VF_REAL))) {
+                    fprintf(cp_err, "  load aborted\n");
+                    return (NULL);
+                }
+                continue;
+            }
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP) && defined(HAVE_MKSTEMP)
+            if (!is_ascii && cp_getvar("rawmmap", CP_BOOL, NULL, 0)) {
+                /* every row must hold all vectors */
+                bool full = TRUE;
+                int count = 0;
+                for (v = curpl->pl_dvecs; v; v = v->v_next, count++)
+                    if (v->v_length != npoints)
+                        full = FALSE;
+                if ((raw_padded || full) &&
+                    raw_map(fp, name, curpl, count, npoints, (flags & VF_REAL) != 0))
+                    continue;
+            }
+#endif
+
             for (i = 0; i < npoints; i++) {
                 if (is_ascii) {
                     /* It's an ASCII file. */
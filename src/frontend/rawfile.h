@@ -7,6 +7,8 @@
 #define ngspice_RAWFILE_H
 
 
+bool raw_mapped(const void *data);
+bool raw_unmap(void *data);
 
 
 #endif
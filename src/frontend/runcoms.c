@@ -24,6 +24,7 @@ Modified: 2000 AlansFixes
 #include "variable.h"
 #include "spiceif.h"
 #include "runcoms2.h"
+#include "colraw.h"
 
 #ifdef XSPICE
 /* gtri - add - 12/12/90 - wbk - include ipc stuff */
@@ -229,7 +230,7 @@ static int dosim(
     }
     /* reset output file type according to variable given in spinit */
     if (cp_getvar("filetype", CP_STRING, buf, sizeof(buf))) {
-        if (eq(buf, "binary")) {
+        if (eq(buf, "binary") || eq(buf, "columnar")) {
             ascii = FALSE;
         }
         else if (eq(buf, "ascii")) {
@@ -297,7 +298,8 @@ static int dosim(
                 ft_setflag = FALSE;
                 return 1;
             }
-            fprintf(cp_out, "binary raw file \"%s\"\n", wl->wl_word);
+            fprintf(cp_out, "%s raw file \"%s\"\n",
+                    colraw_filetype() ? "columnar" : "binary", wl->wl_word);
         }
         rawfileBinary = !ascii;
     }
@@ -101,7 +101,7 @@ com_resume(wordlist *wl)
         dofile = TRUE;
 
     if (cp_getvar("filetype", CP_STRING, buf, sizeof(buf))) {
-        if (eq(buf, "binary"))
+        if (eq(buf, "binary") || eq(buf, "columnar"))
             ascii = FALSE;
         else if (eq(buf, "ascii"))
             ascii = TRUE;
@@ -564,6 +564,13 @@ doit(struct card *deck, wordlist *modnames) {
     if (!cp_getvar("scale", CP_REAL, &scale, 0))
         scale = 1;
 
+    /* hash the .subckt names, the first entry in subs (the last
+       definition in the deck) wins, as with the linear search */
+    NGHASHPTR subs_hash = nghash_init(NGHASH_MIN_SIZE);
+    nghash_unique(subs_hash, TRUE);
+    for (sss = subs; sss; sss = sss->su_next)
+        nghash_insert(subs_hash, sss->su_name, sss);
+
     error = 0;
     /* Second pass: do the replacements. */
     do {                    /*  while (!error && numpasses-- && gotone)  */
@@ -599,10 +606,8 @@ doit(struct card *deck, wordlist *modnames) {
                     s--;
                 s++;
 
-                /* iterate through .subckt list and look for .subckt name invoked */
-                for (sss = subs; sss; sss = sss->su_next)
-                    if (eq(sss->su_name, s))
-                        break;
+                /* look for .subckt name invoked */
+                sss = nghash_find(subs_hash, s);
 
 
                 /* At this point, sss points to the .subckt invoked,
@@ -783,6 +788,8 @@ doit(struct card *deck, wordlist *modnames) {
     }
 #endif
 
+    nghash_free(subs_hash, NULL, NULL);
+
     wl_delete_slice(modnames, xmodnames);
 
     if (error)
@@ -1114,11 +1121,10 @@ translate_node_name(struct bxx_buffer *buffer, const char *scname, const char *n
 
     t = gettrans(name, name_e, &isglobal);
 
-    if (t) {
+    if (isglobal) {
+        bxx_put_substring(buffer, name, name_e);
+    } else if (t) {
         bxx_put_cstring(buffer, t);
-        /* free only if t is global node, nodes from table[].t_new are freed elsewhere */
-        if(isglobal)
-            tfree(t);
     } else {
         bxx_put_cstring(buffer, scname);
         bxx_putc(buffer, '.');
@@ -1149,7 +1155,7 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
 
     struct card *c;
     struct bxx_buffer buffer;
-    char *next_name, *name, *t, *nametofree, *paren_ptr;
+    char *next_name, *name, *name_e, *t, *nametofree, *paren_ptr;
     int nnodes, i, dim;
     int rtn = 0;
 
@@ -1366,7 +1372,7 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
 
             nnodes = numnodes(c->line, subs);
             while (--nnodes >= 0) {
-                name = gettok_node(&s);
+                findtok_node(&s, &name, &name_e);
                 if (name == NULL) {
                     fprintf(cp_err, "Error: too few nodes: %s\n",
                             c->line);
@@ -1374,8 +1380,7 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
                     goto quit;
                 }
 
-                translate_node_name(&buffer, scname, name, NULL);
-                tfree(name);
+                translate_node_name(&buffer, scname, name, name_e);
                 bxx_putc(&buffer, ' ');
             }
 
@@ -1422,7 +1427,7 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
             /* Now translate the controlling source/nodes */
             nnodes = dim * numdevs(c->line);
             while (--nnodes >= 0) {
-                name = gettok_node(&s);   /* name points to the returned token */
+                findtok_node(&s, &name, &name_e);
                 if (name == NULL) {
                     fprintf(cp_err, "Error: too few devs: %s\n", c->line);
                     fprintf(cp_err, "    line no. %d from file %s\n", c->linenum_orig, c->linesource);
@@ -1430,10 +1435,9 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
                 }
 
                 if ((dev_type == 'f') || (dev_type == 'h'))
-                    translate_inst_name(&buffer, scname, name, NULL);
+                    translate_inst_name(&buffer, scname, name, name_e);
                 else
-                    translate_node_name(&buffer, scname, name, NULL);
-                tfree(name);
+                    translate_node_name(&buffer, scname, name, name_e);
                 bxx_putc(&buffer, ' ');
             }
 
@@ -1442,29 +1446,23 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
             break;
 
         default:            /* this section handles ordinary components */
-            name = gettok_node(&s);  /* changed to gettok_node to handle netlists with ( , ) */
+            findtok_node(&s, &name, &name_e);  /* like gettok_node, to handle netlists with ( , ) */
             if (!name)
                 continue;
-            if (!*name) {
-                tfree(name);
-                continue;
-            }
 
-            translate_inst_name(&buffer, scname, name, NULL);
-            tfree(name);
+            translate_inst_name(&buffer, scname, name, name_e);
             bxx_putc(&buffer, ' ');
 
             nnodes = numnodes(c->line, subs);
             while (--nnodes >= 0) {
-                name = gettok_node(&s);
+                findtok_node(&s, &name, &name_e);
                 if (name == NULL) {
                     fprintf(cp_err, "Error: too few nodes: %s\n", c->line);
                     fprintf(cp_err, "    line no. %d from file %s\n", c->linenum_orig, c->linesource);
                     goto quit;
                 }
 
-                translate_node_name(&buffer, scname, name, NULL);
-                tfree(name);
+                translate_node_name(&buffer, scname, name, name_e);
                 bxx_putc(&buffer, ' ');
             }
 
@@ -1474,15 +1472,14 @@ translate(struct card *deck, char *formal, int flen, char *actual, char *scname,
              */
             nnodes = numdevs(c->line);
             while (--nnodes >= 0) {
-                name = gettok_node(&s);
+                findtok_node(&s, &name, &name_e);
                 if (name == NULL) {
                     fprintf(cp_err, "Error: too few devs: %s\n", c->line);
                     fprintf(cp_err, "    line no. %d from file %s\n", c->linenum_orig, c->linesource);
                     goto quit;
                 }
 
-                translate_inst_name(&buffer, scname, name, NULL);
-                tfree(name);
+                translate_inst_name(&buffer, scname, name, name_e);
                 bxx_putc(&buffer, ' ');
             }
 
@@ -1634,25 +1631,37 @@ eq_substr(const char *str, const char *end, const char *cstring)
 
 /*------------------------------------------------------------------------------*
  * gettrans returns the name of the top level net if it is in the list,
- * otherwise it returns NULL.
+ * otherwise it returns NULL.  A global node sets *isglobal, its name is
+ * kept.
  *------------------------------------------------------------------------------*/
 static char *
 gettrans(const char *name, const char *name_end, bool *isglobal)
 {
+    char buf[BSIZE_SP], *newgl;
+    size_t len;
     int i;
+
     *isglobal = FALSE;
 
     if (!name_end)
         name_end = strchr(name, '\0');
 
     /* Added by H.Tanaka to translate global nodes */
-    char* newgl = copy_substring(name, name_end);
-    if (nghash_find(glonodes, newgl)) {
-        *isglobal = TRUE;
-        return newgl;
+    len = (size_t) (name_end - name);
+    if (len < sizeof(buf)) {
+        /* the usual short name, without a copy on the heap */
+        memcpy(buf, name, len);
+        buf[len] = '\0';
+        newgl = buf;
     }
-    else
+    else {
+        newgl = copy_substring(name, name_end);
+    }
+    *isglobal = nghash_find(glonodes, newgl) != NULL;
+    if (newgl != buf)
         tfree(newgl);
+    if (*isglobal)
+        return (char *) name;   /* kept as is */
 
     for (i = 0; table[i].t_old; i++)
         if (eq_substr(name, name_end, table[i].t_old)) {
@@ -20,8 +20,18 @@
 #endif
 
 
+/* white noise from stream rs, if given */
+static double
+f_alpha_gauss(struct rndstream *rs)
+{
+    if (rs)
+        return rndstream_gauss(rs);
+    return GaussWa;
+}
+
+
 void
-f_alpha(int n_pts, int n_exp, double X[], double Q_d, double alpha)
+f_alpha(int n_pts, int n_exp, double X[], double Q_d, double alpha, struct rndstream *rs)
 {
     int i, length;
     double ha;
@@ -45,13 +55,13 @@ f_alpha(int n_pts, int n_exp, double X[], double Q_d, double alpha)
     wfa = TMALLOC(double, length);
 
     hfa[0] = 1.0;
-    wfa[0] = Q_d * GaussWa;
+    wfa[0] = Q_d * f_alpha_gauss(rs);
     /* generate the coefficients hk */
     for (i = 1; i < n_pts; i++) {
         /* generate the coefficients hk */
         hfa[i] = hfa[i-1] * (ha + (double)(i-1)) / ((double)(i));
         /* fill the sequence wk with white noise */
-        wfa[i] = Q_d * GaussWa;
+        wfa[i] = Q_d * f_alpha_gauss(rs);
     }
 
 #ifdef HAVE_LIBFFTW3
@@ -119,6 +129,9 @@ trnoise_state_gen(struct trnoise_state *this, CKTcircuit *ckt)
 {
     if (this->top == 0) {
 
+        /* a new run repeats the streams */
+        this->white.index = this->pink.index = 0;
+
         if (cp_getvar("notrnoise", CP_BOOL, NULL, 0))
             this -> NA = this -> TS = this -> NALPHA = this -> NAMP =
                 this -> RTSAM = this -> RTSCAPT = this -> RTSEMT = 0.0;
@@ -149,7 +162,8 @@ trnoise_state_gen(struct trnoise_state *this, CKTcircuit *ckt)
             f_alpha((int) newsteps, newexp,
                     this -> oneof,
                     this -> NAMP,
-                    this -> NALPHA);
+                    this -> NALPHA,
+                    this -> stream ? &this -> pink : NULL);
         }
 
         trnoise_state_push(this, 0.0); /* first is deterministic */
@@ -162,7 +176,12 @@ trnoise_state_gen(struct trnoise_state *this, CKTcircuit *ckt)
         double ra1, ra2;
         double NA = this -> NA;
 
-        if (NA != 0.0) {
+        if (NA != 0.0 && this -> stream) {
+
+            ra1 = NA * rndstream_gauss(&this -> white);
+            ra2 = NA * rndstream_gauss(&this -> white);
+
+        } else if (NA != 0.0) {
 
 #ifdef FastRand
             // use FastNorm3
@@ -202,10 +221,18 @@ trnoise_state_gen(struct trnoise_state *this, CKTcircuit *ckt)
 }
 
 
+/* The random streams of instance name are numbered 0 (white noise),
+   1 (1/f noise) and 2 (RTS times), see randnumb.c */
 struct trnoise_state *
-trnoise_state_init(double NA, double TS, double NALPHA, double NAMP, double RTSAM, double RTSCAPT, double RTSEMT)
+trnoise_state_init(const char *name, double NA, double TS, double NALPHA, double NAMP, double RTSAM, double RTSCAPT, double RTSEMT)
 {
     struct trnoise_state *this = TMALLOC(struct trnoise_state, 1);
+    unsigned int hash = rndstream_hash(name);
+
+    this->stream =
+        rndstream_init(&this->white, hash, 0) &&
+        rndstream_init(&this->pink, hash, 1) &&
+        rndstream_init(&this->rts, hash, 2);
 
     this->NA = NA;
     this->TS = TS;
@@ -216,8 +243,8 @@ trnoise_state_init(double NA, double TS, double NALPHA, double NAMP, double RTSA
     this->RTSEMT = RTSEMT;
 
     if (RTSAM > 0) {
-        this->RTScapTime = exprand(RTSCAPT);
-        this->RTSemTime = this->RTScapTime + exprand(RTSEMT);
+        this->RTScapTime = trnoise_state_exprand(this, RTSCAPT);
+        this->RTSemTime = this->RTScapTime + trnoise_state_exprand(this, RTSEMT);
     }
 
     this -> top = 0;
@@ -228,10 +255,12 @@ trnoise_state_init(double NA, double TS, double NALPHA, double NAMP, double RTSA
 
 
 struct trrandom_state *
-trrandom_state_init(int rndtype, double TS, double TD, double PARAM1, double PARAM2)
+trrandom_state_init(const char *name, int rndtype, double TS, double TD, double PARAM1, double PARAM2)
 {
     struct trrandom_state *this = TMALLOC(struct trrandom_state, 1);
 
+    this->stream = rndstream_init(&this->rs, rndstream_hash(name), 0);
+
     this->rndtype = rndtype;
     this->TS = TS;
     this->TD = TD;
@@ -682,9 +682,7 @@ bool
 cp_getvar(char *name, enum cp_types type, void *retval, size_t rsize)
 {
     struct variable *v;
-    struct variable *uv1;
-
-    uv1 = cp_usrvars();
+    struct variable *uv1 = NULL;
 
 #ifdef TRACE
     /* SDB debug statement */
@@ -695,10 +693,13 @@ cp_getvar(char *name, enum cp_types type, void *retval, size_t rsize)
         if (eq(name, v->va_name))
             break;
 
-    if (!v)
+    /* cp_usrvars() builds its list anew on each call, so only if needed */
+    if (!v) {
+        uv1 = cp_usrvars();
         for (v = uv1; v; v = v->va_next)
             if (eq(name, v->va_name))
                 break;
+    }
 
     if (!v && plot_cur)
         for (v = plot_cur->pl_env; v; v = v->va_next)
@@ -1,7 +1,7 @@
 #include "ngspice/randnumb.h"
 
 void f_alpha(int n_pts, int n_exp, double X[], double Q_d,
-double alpha);
+double alpha, struct rndstream *rs);
 
 void rvfft(float X[], unsigned long int n);
 
@@ -21,6 +21,10 @@ struct trnoise_state
 
     double RTScapTime, RTSemTime;
     bool RTS;
+
+    /* counter based streams of the instance, if variable rndstream is set */
+    bool stream;
+    struct rndstream white, pink, rts;
 };
 
 struct trrandom_state
@@ -29,10 +33,13 @@ struct trrandom_state
 
     int rndtype;
     double TS, TD, PARAM1, PARAM2;
+
+    bool stream;
+    struct rndstream rs;
 };
 
-struct trnoise_state *trnoise_state_init(double NA, double TS, double NALPHA, double NAMP, double RTSAM, double RTSCAPT, double RTSEMT);
-struct trrandom_state *trrandom_state_init(int rndtype, double TS, double TD, double PARAM1, double PARAM2);
+struct trnoise_state *trnoise_state_init(const char *name, double NA, double TS, double NALPHA, double NAMP, double RTSAM, double RTSCAPT, double RTSEMT);
+struct trrandom_state *trrandom_state_init(const char *name, int rndtype, double TS, double TD, double PARAM1, double PARAM2);
 
 
 void trnoise_state_gen(struct trnoise_state *this, CKTcircuit *ckt);
@@ -61,11 +68,35 @@ trnoise_state_get(struct trnoise_state *this, CKTcircuit *ckt, size_t index)
     return this->points[index % TRNOISE_STATE_MEM_LEN];
 }
 
+/* exponentially distributed RTS times */
+static inline double
+trnoise_state_exprand(struct trnoise_state *this, double mean)
+{
+    if (this->stream)
+        return rndstream_exp(&this->rts, mean);
+    return exprand(mean);
+}
+
 static inline double
 trrandom_state_get(struct trrandom_state *this)
 {
     double param1 = this->PARAM1;
     double param2 = this->PARAM2;
+
+    if (this->stream)
+        switch (this->rndtype) {
+            case 1:
+                return param1 * (2.0 * rndstream_uniform(&this->rs) - 1.0) + param2;
+            case 2:
+                return param1 * rndstream_gauss(&this->rs) + param2;
+            case 3:
+                return rndstream_exp(&this->rs, param1) + param2;
+            case 4:
+                return (double)rndstream_poisson(&this->rs, param1) + param2;
+            default:
+                return 0.0;
+        }
+
     switch (this->rndtype) {
         case 1:
             /* param1: range -param1[ ... +param1[  (default = 1)
@@ -313,11 +313,17 @@ struct CKTcircuit {
                                    contains only linear elements */
     unsigned int CKTnoopac:1; /* flag to indicate that OP will not be evaluated
                                  during AC simulation */
+    unsigned int CKTdcWarmStart:1; /* flag to start each inner dc sweep from
+                                      the first point of the previous one */
     int CKTsoaCheck;    /* flag to indicate that in certain device models
                            a safe operating area (SOA) check is executed */
     int CKTsoaMaxWarns; /* specifies the maximum number of SOA warnings */
 
     double CKTepsmin; /* minimum argument value for some log functions, e.g. diode saturation current*/
+    double CKTrcondTol; /* reject an LU refactorization if its rcond estimate drops below
+                           CKTrcondTol times the one of the last pivoting factorization */
+    int CKTopCache;     /* number of operating points kept for warm starts */
+    int CKTdcParallel;  /* number of worker processes a dc sweep is split over */
 
     NGHASHPTR DEVnameHash;
     NGHASHPTR MODnameHash;
@@ -327,6 +333,15 @@ struct CKTcircuit {
 #ifdef KLU
     unsigned int CKTkluMODE:1;
     double CKTkluMemGrowFactor ;
+    unsigned int CKTkluParallel:1;
+    unsigned int CKTacParallel:1;
+#endif
+
+#ifdef USE_OMP
+    unsigned int CKTnoiseParallel:1;
+    GENinstance **CKTloadInst;  /* instances of all device types with a
+                                   DEVloadInstance, evaluated by CKTload */
+    int CKTloadInstCount;
 #endif
 };
 
@@ -344,6 +359,13 @@ extern int CKTask(CKTcircuit *, GENinstance *, int , IFvalue *, IFvalue *);
 extern int CKTaskAnalQ(CKTcircuit *, JOB *, int , IFvalue *, IFvalue *);
 extern int CKTaskNodQst(CKTcircuit *, CKTnode *, int , IFvalue *, IFvalue *);
 extern int CKTbindNode(CKTcircuit *, GENinstance *, int , CKTnode *);
+extern int CKTckptBegin(CKTcircuit *, int *);
+extern void CKTckptSave(CKTcircuit *);
+extern void CKTckptEnd(int);
+extern void CKTckptPut(CKTckpt *, const void *, size_t);
+extern int CKTckptGet(CKTckpt *, void *, size_t);
+extern void CKTckptPutName(CKTckpt *, const char *);
+extern int CKTckptGetName(CKTckpt *, const char *);
 extern void CKTbreakDump(CKTcircuit *);
 extern int CKTclrBreak(CKTcircuit *);
 extern int CKTconvTest(CKTcircuit *);
@@ -375,6 +397,9 @@ extern int CKTinit(CKTcircuit **);
 extern int CKTinst2Node(CKTcircuit *, void *, int , CKTnode **, IFuid *);
 extern int CKTlinkEq(CKTcircuit *, CKTnode *);
 extern int CKTload(CKTcircuit *);
+#ifdef USE_OMP
+extern int CKTloadSetup(CKTcircuit *);
+#endif
 extern int CKTmapNode(CKTcircuit *, CKTnode **, IFuid);
 extern int CKTmkCur(CKTcircuit  *, CKTnode **, IFuid , char *);
 extern int CKTmkNode(CKTcircuit *, CKTnode **);
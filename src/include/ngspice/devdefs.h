@@ -24,6 +24,15 @@ void DEVqmeyer(double,double,double,double,double,double*,double*,double*,
 void DevCapVDMOS(double, double, double, double, double,
                  double*, double*);
 double DEVpred(CKTcircuit*,int);
+#ifdef USE_OMP
+int DEVcolorInstances(GENinstance **, int, int, int, int **);
+
+/* Instances of one color may still share the ground node.  Its rhs entry
+ * and matrix elements (the trash slot) are never read, so each thread
+ * stamps them into a scratch variable of its own. */
+#define DEVrhsSlot(rhs, node, scratch) ((node) ? (rhs) + (node) : (scratch))
+#define DEVmatSlot(ptr, trash, scratch) (((ptr) == (trash)) ? (scratch) : (ptr))
+#endif
 
 /* Cider integration */
 double limitResistorVoltage( double, double, int * );
@@ -126,6 +135,19 @@ typedef struct SPICEdev {
         /* routine to convert Complex CSC array to Real CSC array */
 #endif
 
+    int (*DEVcheckpoint)(GENmodel *, CKTcircuit *, CKTckpt *);
+        /* routine to save transient history kept outside of CKTstates */
+    int (*DEVrestore)(GENmodel *, CKTcircuit *, CKTckpt *);
+        /* routine to restore it when resuming from a checkpoint */
+
+#ifdef USE_OMP
+    int (*DEVloadInstance)(GENinstance *, CKTcircuit *);
+        /* routine to evaluate one instance, thread safe, keeping the
+         * matrix and rhs contributions in the instance */
+    void (*DEVloadStamp)(GENmodel *, CKTcircuit *);
+        /* routine to stamp the kept contributions of all instances */
+#endif
+
 } SPICEdev;  /* instance of structure for each possible type of device */
 
 
@@ -480,4 +480,9 @@ struct IFfrontEnd {
 #define OUT_SCALE_LIN   1
 #define OUT_SCALE_LOG   2
 
+    /* the values of the @ vectors of a point, read from the circuit or
+       handed to the next OUTpData, see OUTattributes() */
+#define OUT_SPECIALS_GET 3
+#define OUT_SPECIALS_SET 4
+
 #endif
@@ -12,6 +12,7 @@ Modified: 2000 AlansFixes
 #include "ngspice/gendefs.h"
 #include "ngspice/ifsim.h"
 #include "ngspice/inpptree.h"
+#include "ngspice/hash.h"
 
 typedef struct INPtables INPtables;
 typedef struct INPmodel INPmodel;
@@ -64,6 +65,8 @@ struct nscope {
     struct nscope *next;
     struct card_assoc *subckts;
     struct modellist *models;
+    NGHASHPTR subckt_hash;      /* subckts by name */
+    NGHASHPTR model_hash;       /* models by name without bin number */
 };
 
 /* A linked list of netlist line entries, associated for a specific reason */
@@ -131,6 +134,7 @@ int INPgetTok(char **, char **, int);
 int INPgetNetTok(char **, char **, int);
 void INPgetTree(char **, INPparseTree **, CKTcircuit *, INPtables *);
 void INPfreeTree(IFparseTree *);
+void INPrndstream(const char *, const char *);
 IFvalue *INPgetValue(CKTcircuit *, char **, int, INPtables *);
 int INPgndInsert(CKTcircuit *, char **, INPtables *, CKTnode **);
 int INPinsertNofree(char **token, INPtables *tab);
@@ -138,6 +142,7 @@ int INPinsert(char **, INPtables *);
 int INPretrieve(char **, INPtables *);
 int INPremove(char *, INPtables *);
 INPmodel *INPlookMod(const char *);
+IFparm *INPlookParm(const char *, IFparm *, int);
 int INPmakeMod(char *, int, struct card *);
 char *INPmkTemp(char *);
 void INPpas1(CKTcircuit *, struct card *, INPtables *);
@@ -31,6 +31,7 @@ typedef struct INPparseTree {
     IFparseTree p;
     struct INPparseNode *tree;  /* The real stuff. */
     struct INPparseNode **derivs;   /* The derivative parse trees. */
+    struct PTtape *tape;        /* The trees compiled, NULL if not possible. */
 } INPparseTree;
 
 /* This is what is passed as the actual parameter value.  The fields will all
@@ -175,5 +176,31 @@ typedef struct PTelement {
 
 extern int IFeval(IFparseTree *tree, double gmin, double *result, double *vals, double *derivs);
 
+/* The function and its derivatives compiled into one linear sequence of
+ * instructions, each writing its own register.  Subtrees shared between
+ * the trees, or equal in structure, are computed only once.
+ */
+
+typedef struct PTinstr {
+    int op;                     /* One of PTI_*, in ifeval.c. */
+    int dst;                    /* Register written. */
+    int a, b;                   /* Operand registers, var index or jump target. */
+    void (*function)(void);
+    void *data;
+    const char *funcname;
+} PTinstr;
+
+typedef struct PTtape {
+    int ncode;
+    PTinstr *code;
+    int nregs;
+    double *regs;               /* Constants are preloaded. */
+    int result;                 /* Register of the function value, */
+    int *derivs;                /* ... and of the derivatives. */
+} PTtape;
+
+extern PTtape *PTcompile(INPparseNode *tree, INPparseNode **derivs, int numVars);
+extern void PTfreeTape(PTtape *tape);
+
 #endif
 
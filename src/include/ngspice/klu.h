@@ -177,6 +177,10 @@ typedef struct klu_common_struct
         *   Numeric object.  klu_refactor will not free it, but will leave the
         *   numerical values only partially defined.  This is the default. */
 
+    int parallel ;      /* ngspice: klu_refactor factors the diagonal blocks of
+        * the BTF form concurrently (OpenMP only).  Results are identical to
+        * the serial refactorization.  Default: FALSE. */
+
     /* ---------------------------------------------------------------------- */
     /* statistics */
     /* ---------------------------------------------------------------------- */
@@ -226,6 +230,7 @@ typedef struct klu_l_common_struct /* 64-bit version (otherwise same as above)*/
         struct klu_l_common_struct *) ;
     void *user_data ;
     UF_long halt_if_singular ;
+    UF_long parallel ;
     UF_long status, nrealloc, structural_rank, numerical_rank, singular_col,
         noffdiag ;
     double flops, rcond, condest, rgrowth, work ;
@@ -30,6 +30,12 @@ typedef struct {
 
     int STATtotalDev;   /* PN: number of total devices in the netlist */
 
+    int STATrefactor;   /* number of LU factorizations re-using the pivots */
+    int STATrefactorRej; /* number of those rejected (zero pivot or rcondtol) */
+
+    int STATopCacheHit;  /* operating points converged from a cached one */
+    int STATopCacheMiss; /* operating points not found in the cache or failed */
+
     double STATtotAnalTime;     /* total time for all analysis */
     double STATloadTime;        /* total time spent in device loading */
     double STATdecompTime;      /* total time spent in LU decomposition */
@@ -125,11 +131,25 @@ enum {
     OPT_INDVERBOSITY,
     OPT_EPSMIN,
     OPT_CSHUNT,
+    OPT_DCWARMSTART,
+    OPT_RCONDTOL,
+    OPT_REFACTOR,
+    OPT_REFACTORREJ,
+    OPT_OPCACHE,
+    OPT_OPCACHEHIT,
+    OPT_OPCACHEMISS,
+    OPT_DCPARALLEL,
 
 #ifdef KLU
     OPT_SPARSE,
     OPT_KLU,
     OPT_KLU_MEMGROW_FACTOR,
+    OPT_KLU_PARALLEL,
+    OPT_ACPARALLEL,
+#endif
+
+#ifdef USE_OMP
+    OPT_NOISEPARALLEL,
 #endif
 
     OPT_LTERELTOL,
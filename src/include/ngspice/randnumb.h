@@ -19,4 +19,20 @@ extern void TausSeed(void);
 extern unsigned int CombLCGTausInt(void);
 extern unsigned int CombLCGTausInt2(void);
 
+/* counter based random stream, see randnumb.c */
+struct rndstream {
+    unsigned int key[2];    /* rndseed, rndrun */
+    unsigned int name;      /* hash of the stream name */
+    unsigned int param;     /* parameter number */
+    size_t index;           /* next value */
+};
+
+extern bool rndstream_wanted(void);
+extern unsigned int rndstream_hash(const char *name);
+extern bool rndstream_init(struct rndstream *rs, unsigned int name, unsigned int param);
+extern double rndstream_uniform(struct rndstream *rs);
+extern double rndstream_gauss(struct rndstream *rs);
+extern double rndstream_exp(struct rndstream *rs, double mean);
+extern int rndstream_poisson(struct rndstream *rs, double lambda);
+
 #endif
@@ -98,6 +98,19 @@ char** ngSpice_AllVecs(char*);
 returns to the caller a pointer to an array of vector names in the plot
 named by the string in the argument.
 
+**
+int ngSpice_Stream(char**, int, SendVecBlock*, void*)
+Subscribe to a fixed list of vectors (NULL terminated array of names as
+returned by ngSpice_AllVecs). For every new data point of a simulation
+the values of these vectors are copied into one row of a contiguous
+buffer of doubles. The buffer is sent to the caller by callback
+SendVecBlock every time it holds the requested number of rows, and once
+more with the remaining rows when the plot is finished. The column order
+is the order of the names, a complex vector takes two adjacent columns
+(real and imaginary part), a vector not found in the plot gives a column
+of NaN. Sending NULL removes the subscription.
+This is much cheaper than SendData for long simulations with many vectors.
+
 **
 int ngSpice_LockRealloc(void)
 int ngSpice_UnlockRealloc(void)
@@ -109,6 +122,22 @@ background thread is moving on.
 int ngSpice_Reset(void)
 Reset ngspice as far as possible
 
+**
+ngSpice_Handle* ngSpice_Create(SendChar*, SendStat*, ControlledExit*,
+             SendData*, SendInitData*, BGThreadRunning*, void*)
+Load a private copy of ngspice.dll (libngspice.so) and initialize it like
+ngSpice_Init(). The handle returned is sent to the *_H functions, which
+are the ones above, operating on that simulator. Simulators behind
+different handles are independent and may run concurrently in one
+process, each one from its own thread. The callbacks receive the
+identification number ngSpice_Ident() of their handle.
+A handle may be used for many circuits (see ngSpice_Reset_H and the
+'remcirc' command).
+
+**
+void ngSpice_Destroy(ngSpice_Handle*)
+Stop the simulator behind the handle and unload its copy of ngspice.dll.
+
 **
 Additional basics:
 No memory mallocing and freeing across the interface:
@@ -291,6 +320,17 @@ typedef int (BGThreadRunning)(NG_BOOL, int, void*);
    void*       return pointer received from caller
 */
 
+/* send back a block of data of the vectors subscribed by ngSpice_Stream() */
+typedef int (SendVecBlock)(double*, int, int, int, void*);
+/*
+   double*     rows of values, one row per data point, row after row
+   int         number of rows
+   int         number of values per row
+   int         identification number of calling ngspice shared lib
+   void*       return pointer received from caller
+   The buffer is owned by ngspice and valid during the call only.
+*/
+
 /* callback functions
    addresses received from caller with ngSpice_Init_Sync() function
 */
@@ -481,6 +521,12 @@ named by plotname */
 IMPEXP
 char** ngSpice_AllVecs(char* plotname);
 
+/* subscribe to the vectors named in the NULL terminated array vecnames,
+   their data are sent by sblock in blocks of up to 'rows' data points.
+   To be called before the simulation is started. */
+IMPEXP
+int ngSpice_Stream(char** vecnames, int rows, SendVecBlock* sblock, void* userData);
+
 /* returns TRUE if ngspice is running in a second (background) thread */
 IMPEXP
 NG_BOOL ngSpice_running(void);
@@ -510,6 +556,63 @@ int ngSpice_UnlockRealloc(void);
 IMPEXP
 int ngSpice_Reset(void);
 
+
+/* Handle based interface, one simulator per handle */
+typedef struct ngspice_handle ngSpice_Handle;
+
+/* load and initialize a new simulator, arguments as for ngSpice_Init() */
+IMPEXP
+ngSpice_Handle* ngSpice_Create(SendChar* printfcn, SendStat* statfcn, ControlledExit* ngexit,
+                               SendData* sdata, SendInitData* sinitdata, BGThreadRunning* bgtrun, void* userData);
+
+/* stop the simulator and release the handle */
+IMPEXP
+void ngSpice_Destroy(ngSpice_Handle* h);
+
+/* identification number sent to the callbacks of this handle */
+IMPEXP
+int ngSpice_Ident(ngSpice_Handle* h);
+
+IMPEXP
+int ngSpice_Init_Sync_H(ngSpice_Handle* h, GetVSRCData *vsrcdat, GetISRCData *isrcdat,
+                        GetSyncData *syncdat, void *userData);
+
+IMPEXP
+int ngSpice_Command_H(ngSpice_Handle* h, char* command);
+
+IMPEXP
+pvector_info ngGet_Vec_Info_H(ngSpice_Handle* h, char* vecname);
+
+IMPEXP
+int ngSpice_Circ_H(ngSpice_Handle* h, char** circarray);
+
+IMPEXP
+char* ngSpice_CurPlot_H(ngSpice_Handle* h);
+
+IMPEXP
+char** ngSpice_AllPlots_H(ngSpice_Handle* h);
+
+IMPEXP
+char** ngSpice_AllVecs_H(ngSpice_Handle* h, char* plotname);
+
+IMPEXP
+int ngSpice_Stream_H(ngSpice_Handle* h, char** vecnames, int rows, SendVecBlock* sblock, void* userData);
+
+IMPEXP
+NG_BOOL ngSpice_running_H(ngSpice_Handle* h);
+
+IMPEXP
+NG_BOOL ngSpice_SetBkpt_H(ngSpice_Handle* h, double time);
+
+IMPEXP
+int ngSpice_LockRealloc_H(ngSpice_Handle* h);
+
+IMPEXP
+int ngSpice_UnlockRealloc_H(ngSpice_Handle* h);
+
+IMPEXP
+int ngSpice_Reset_H(ngSpice_Handle* h);
+
 #ifdef __cplusplus
 }
 #endif
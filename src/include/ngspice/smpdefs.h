@@ -26,6 +26,8 @@ Modified: 2000  AlansFixes
 /* SMPmatrix structure - Francesco Lannutti (2012-02) */
 typedef struct sSMPmatrix {
     MatrixFrame *SPmatrix ;                /* pointer to sparse matrix */
+    double SMPrcondTol ;                   /* accepted rcond drop of a refactorization, 0 = no check */
+    double SMPrcondRef ;                   /* rcond of the last pivoting factorization */
 
 #ifdef KLU
     KLUmatrix *SMPkluMatrix ;              /* KLU Pointer to the KLU Matrix Data Structure (only for CIDER, for the moment) */
@@ -33,6 +35,7 @@ typedef struct sSMPmatrix {
     #define CKTkluON 1                     /* KLU MODE ON definition */
     #define CKTkluOFF 0                    /* KLU MODE OFF definition */
     double CKTkluMemGrowFactor ;           /* KLU Memory Grow Factor - default = 1.2 */
+    unsigned int CKTkluParallel:1 ;        /* KLU refactor of the BTF blocks in parallel (OpenMP) */
 #endif
 
 } SMPmatrix ;
@@ -42,6 +45,15 @@ typedef struct sSMPmatrix {
 void spDeterminant_KLU (SMPmatrix *, int *, double *, double *) ;
 void SMPconvertCOOtoCSC (SMPmatrix *) ;
 
+/* Batch of complex systems sharing the pattern of a matrix, factored and
+ * solved concurrently (frequency points of an AC analysis) */
+typedef struct sSMPcBatch SMPcBatch ;
+SMPcBatch *SMPcBatchNew (SMPmatrix *, int) ;
+void SMPcBatchStore (SMPcBatch *, int, double [], double []) ;
+void SMPcBatchSolve (SMPcBatch *, int, int []) ;
+void SMPcBatchGet (SMPcBatch *, int, double [], double []) ;
+void SMPcBatchDestroy (SMPcBatch *) ;
+
 #ifdef CIDER
 void SMPsolveKLUforCIDER (SMPmatrix *, double [], double [], double [], double []) ;
 int SMPreorderKLUforCIDER (SMPmatrix *) ;
@@ -65,6 +77,7 @@ int SMPcLUfac( SMPmatrix *, double );
 int SMPluFac( SMPmatrix *, double , double );
 int SMPcReorder( SMPmatrix * , double , double , int *);
 int SMPreorder( SMPmatrix * , double , double , double );
+double SMPrcond( SMPmatrix *);
 void SMPcaSolve(SMPmatrix *Matrix, double RHS[], double iRHS[],
 		double Spare[], double iSpare[]);
 void SMPcSolve( SMPmatrix *, double [], double [], double [], double []);
@@ -30,6 +30,7 @@ Author: 1985 Thomas L. Quarles
 #define E_NOF2SRC (E_PRIVATE+15) /* no source at F2 for IM disto analysis */
 #define E_NODISTO (E_PRIVATE+16) /* no distortion analysis - NODISTO defined */
 #define E_NONOISE (E_PRIVATE+17) /* no noise analysis - NONOISE defined */
+#define E_CHECKPOINT (E_PRIVATE+18) /* checkpoint file does not fit the circuit */
 
 const char *SPerror(int type);
 
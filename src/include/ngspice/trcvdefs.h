@@ -41,6 +41,8 @@ typedef struct {
     int TRCVset[TRCVNESTLEVEL];     /* flag to indicate this nest level used */
     int TRCVnestLevel;      /* number of levels of nesting called for */
     int TRCVnestState;      /* iteration state during pause */
+    double *TRCVwarmRhs;    /* solution and states at the first point of */
+    double *TRCVwarmState;  /* the last inner sweep (option dcwarmstart) */
 } TRCV;
 
 enum {
@@ -70,13 +70,23 @@ struct TSKtask {
     unsigned int TSKcopyNodesets:1; /* flag for nodeset copy */
     unsigned int TSKnodeDamping:1;  /* flag for node damping */
     unsigned int TSKnoopac:1; /* flag for no OP calculation before AC */
+    unsigned int TSKdcWarmStart:1; /* flag for warm started nested dc sweeps */
     double TSKabsDv;                 /* abs limit for iter-iter voltage change */
     double TSKrelDv;                 /* rel limit for iter-iter voltage change */
     double TSKepsmin;         /* minimum value for log */
+    double TSKrcondTol;       /* accepted rcond drop of an LU refactorization */
+    int TSKopCache;           /* operating points kept for warm starts */
+    int TSKdcParallel;        /* worker processes for dc sweeps */
 
 #ifdef KLU
     unsigned int TSKkluMODE:1;
     double TSKkluMemGrowFactor ;
+    unsigned int TSKkluParallel:1;
+    unsigned int TSKacParallel:1;
+#endif
+
+#ifdef USE_OMP
+    unsigned int TSKnoiseParallel:1;
 #endif
 
 };
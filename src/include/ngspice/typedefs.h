@@ -9,6 +9,7 @@
 
 typedef struct CKTcircuit CKTcircuit;
 typedef struct CKTnode CKTnode;
+typedef struct CKTckpt CKTckpt;
 
 
 typedef struct GENinstance GENinstance;
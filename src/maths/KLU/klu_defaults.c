@@ -30,6 +30,7 @@ Int KLU_defaults
                                  * 0: none, but check for errors,
                                  * 1: sum, 2: max */
     Common->halt_if_singular = TRUE ;   /* quick halt if matrix is singular */
+    Common->parallel = FALSE ;  /* serial refactorization */
 
     /* memory management routines */
     Common->malloc_memory  = malloc ;
@@ -8,8 +8,265 @@
  * the pattern given to KLU_factor.
  */
 
+#include "ngspice/config.h"
 #include "klu_internal.h"
 
+#ifdef USE_OMP
+
+/* ========================================================================== */
+/* === refactor_block ======================================================= */
+/* ========================================================================== */
+
+/* Refactor a single diagonal block of the BTF form.  A block only touches its
+ * own columns of L, U, Udiag and the off-diagonal part, so distinct blocks may
+ * be refactored concurrently.  X is a workspace of size nk, all zero on input
+ * and on output.  Rs is NULL if the matrix is not scaled.  Returns the first
+ * column (relative to the block) with a zero pivot, or EMPTY.
+ */
+
+static Int refactor_block
+(
+    Int block,
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry *Az,
+    double *Rs,
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    Entry *X,
+    Int halt_if_singular
+)
+{
+    Entry ukk, ujk, s ;
+    Entry *Offx, *Lx, *Ux, *Udiag ;
+    Int *Q, *R, *Offp, *Ui, *Li, *Pinv, *Lip, *Uip, *Llen, *Ulen ;
+    Unit *LU ;
+    Int k1, k2, nk, k, oldcol, pend, oldrow, newrow, p, poff, nzoff, i, j, up,
+        ulen, llen, singular ;
+
+    Q = Symbolic->Q ;
+    R = Symbolic->R ;
+    nzoff = Symbolic->nzoff ;
+    Offp = Numeric->Offp ;
+    Offx = (Entry *) Numeric->Offx ;
+    Pinv = Numeric->Pinv ;
+    Udiag = Numeric->Udiag ;
+
+    k1 = R [block] ;
+    k2 = R [block+1] ;
+    nk = k2 - k1 ;
+
+    /* the off-diagonal entries of this block start at column k1 */
+    poff = Offp [k1] ;
+    singular = EMPTY ;
+
+    if (nk == 1)
+    {
+        oldcol = Q [k1] ;
+        pend = Ap [oldcol+1] ;
+        CLEAR (s) ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            oldrow = Ai [p] ;
+            newrow = Pinv [oldrow] - k1 ;
+            if (newrow < 0 && poff < nzoff)
+            {
+                if (Rs)
+                {
+                    SCALE_DIV_ASSIGN (Offx [poff], Az [p], Rs [oldrow]) ;
+                }
+                else
+                {
+                    Offx [poff] = Az [p] ;
+                }
+                poff++ ;
+            }
+            else
+            {
+                if (Rs)
+                {
+                    SCALE_DIV_ASSIGN (s, Az [p], Rs [oldrow]) ;
+                }
+                else
+                {
+                    s = Az [p] ;
+                }
+            }
+        }
+        Udiag [k1] = s ;
+        return (EMPTY) ;
+    }
+
+    Lip  = Numeric->Lip  + k1 ;
+    Llen = Numeric->Llen + k1 ;
+    Uip  = Numeric->Uip  + k1 ;
+    Ulen = Numeric->Ulen + k1 ;
+    LU = ((Unit **) Numeric->LUbx) [block] ;
+
+    for (k = 0 ; k < nk ; k++)
+    {
+        /* scatter kth column of the block into workspace X */
+        oldcol = Q [k+k1] ;
+        pend = Ap [oldcol+1] ;
+        for (p = Ap [oldcol] ; p < pend ; p++)
+        {
+            oldrow = Ai [p] ;
+            newrow = Pinv [oldrow] - k1 ;
+            if (newrow < 0 && poff < nzoff)
+            {
+                if (Rs)
+                {
+                    SCALE_DIV_ASSIGN (Offx [poff], Az [p], Rs [oldrow]) ;
+                }
+                else
+                {
+                    Offx [poff] = Az [p] ;
+                }
+                poff++ ;
+            }
+            else
+            {
+                if (Rs)
+                {
+                    SCALE_DIV_ASSIGN (X [newrow], Az [p], Rs [oldrow]) ;
+                }
+                else
+                {
+                    X [newrow] = Az [p] ;
+                }
+            }
+        }
+
+        /* compute kth column of U, and update kth column of A */
+        GET_POINTER (LU, Uip, Ulen, Ui, Ux, k, ulen) ;
+        for (up = 0 ; up < ulen ; up++)
+        {
+            j = Ui [up] ;
+            ujk = X [j] ;
+            CLEAR (X [j]) ;
+            Ux [up] = ujk ;
+            GET_POINTER (LU, Lip, Llen, Li, Lx, j, llen) ;
+            for (p = 0 ; p < llen ; p++)
+            {
+                MULT_SUB (X [Li [p]], Lx [p], ujk) ;
+            }
+        }
+        /* get the diagonal entry of U */
+        ukk = X [k] ;
+        CLEAR (X [k]) ;
+        if (IS_ZERO (ukk))
+        {
+            if (singular == EMPTY)
+            {
+                singular = k ;
+            }
+            if (halt_if_singular)
+            {
+                /* leave the workspace clean for the next block */
+                for (i = 0 ; i < nk ; i++)
+                {
+                    CLEAR (X [i]) ;
+                }
+                return (singular) ;
+            }
+        }
+        Udiag [k+k1] = ukk ;
+        /* gather and divide by pivot to get kth column of L */
+        GET_POINTER (LU, Lip, Llen, Li, Lx, k, llen) ;
+        for (p = 0 ; p < llen ; p++)
+        {
+            i = Li [p] ;
+            DIV (Lx [p], X [i], ukk) ;
+            CLEAR (X [i]) ;
+        }
+    }
+
+    return (singular) ;
+}
+
+
+/* ========================================================================== */
+/* === refactor_parallel ==================================================== */
+/* ========================================================================== */
+
+/* Refactor all blocks, distributed over the OpenMP threads.  Each thread owns
+ * a workspace of size maxblock.  Singularity is reported for the lowest
+ * singular column, as the serial loop does.
+ */
+
+static Int refactor_parallel
+(
+    Int Ap [ ],
+    Int Ai [ ],
+    Entry *Az,
+    double *Rs,
+    KLU_symbolic *Symbolic,
+    KLU_numeric *Numeric,
+    KLU_common *Common
+)
+{
+    Int *R = Symbolic->R ;
+    Int *Q = Symbolic->Q ;
+    Int nblocks = Symbolic->nblocks ;
+    Int maxblock = Symbolic->maxblock ;
+    Int halt_if_singular = Common->halt_if_singular ;
+    Int rank = EMPTY ;
+    Int nomem = FALSE ;
+
+    #pragma omp parallel
+    {
+        Entry *X = (Entry *) calloc ((size_t) maxblock, sizeof (Entry)) ;
+        Int block, singular ;
+
+        if (X == NULL)
+        {
+            #pragma omp atomic write
+            nomem = TRUE ;
+        }
+
+        #pragma omp for schedule(dynamic, 8)
+        for (block = 0 ; block < nblocks ; block++)
+        {
+            if (X == NULL)
+            {
+                continue ;
+            }
+            singular = refactor_block (block, Ap, Ai, Az, Rs, Symbolic,
+                Numeric, X, halt_if_singular) ;
+            if (singular != EMPTY)
+            {
+                #pragma omp critical (klu_refactor_rank)
+                if (rank == EMPTY || R [block] + singular < rank)
+                {
+                    rank = R [block] + singular ;
+                }
+            }
+        }
+
+        free (X) ;
+    }
+
+    if (nomem)
+    {
+        Common->status = KLU_OUT_OF_MEMORY ;
+        return (FALSE) ;
+    }
+    if (rank != EMPTY)
+    {
+        /* matrix is numerically singular */
+        Common->status = KLU_SINGULAR ;
+        Common->numerical_rank = rank ;
+        Common->singular_col = Q [rank] ;
+        if (halt_if_singular)
+        {
+            return (FALSE) ;
+        }
+    }
+    return (TRUE) ;
+}
+
+#endif
+
 
 /* ========================================================================== */
 /* === KLU_refactor ========================================================= */
@@ -128,6 +385,19 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
         }
     }
 
+#ifdef USE_OMP
+    if (Common->parallel && nblocks > 1)
+    {
+        if (!refactor_parallel (Ap, Ai, Az, (scale > 0) ? Rs : NULL, Symbolic,
+            Numeric, Common))
+        {
+            return (FALSE) ;
+        }
+        poff = nzoff ;
+        goto blocks_done ;
+    }
+#endif
+
     /* ---------------------------------------------------------------------- */
     /* clear workspace X */
     /* ---------------------------------------------------------------------- */
@@ -425,6 +695,10 @@ Int KLU_refactor        /* returns TRUE if successful, FALSE otherwise */
         }
     }
 
+#ifdef USE_OMP
+blocks_done:
+#endif
+
     /* ---------------------------------------------------------------------- */
     /* permute scale factors Rs according to pivotal row order */
     /* ---------------------------------------------------------------------- */
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 #include "ngspice/spmatrix.h"
 #include "../sparse/spdefs.h"
 #include "ngspice/smpdefs.h"
@@ -805,6 +806,26 @@ SMPreorder (SMPmatrix *Matrix, double PivTol, double PivRel, double Gmin)
     }
 }
 
+/*
+ * SMPrcond()
+ * crude reciprocal condition estimate of the last real factorization,
+ * min(abs(diag(U))) / max(abs(diag(U))) with KLU
+ */
+double
+SMPrcond (SMPmatrix *Matrix)
+{
+    if (Matrix->CKTkluMODE)
+    {
+        if (!klu_rcond (Matrix->SMPkluMatrix->KLUmatrixSymbolic, Matrix->SMPkluMatrix->KLUmatrixNumeric,
+                        Matrix->SMPkluMatrix->KLUmatrixCommon))
+            return 0.0 ;
+        return Matrix->SMPkluMatrix->KLUmatrixCommon->rcond ;
+    } else {
+        double PseudoCondition = spPseudoCondition (Matrix->SPmatrix) ;
+        return (PseudoCondition > 0.0) ? 1.0 / PseudoCondition : 0.0 ;
+    }
+}
+
 #ifdef CIDER
 int
 SMPreorderKLUforCIDER (SMPmatrix *Matrix)
@@ -943,6 +964,147 @@ SMPcSolve (SMPmatrix *Matrix, double RHS[], double iRHS[], double Spare[], doubl
     }
 }
 
+/*
+ * SMPcBatch
+ *
+ * Each slot of a batch holds a snapshot of the complex matrix values and the
+ * rhs of one system, plus its own numeric factors and common object.  The
+ * slots share the symbolic analysis of Matrix, so they are factored and
+ * solved in parallel.  As in SMPcLUfac, a slot refactors with the pivot
+ * order of its previous system and factors anew only if that fails.
+ */
+
+struct sSMPcBatch {
+    SMPmatrix *Matrix ;
+    int size ;
+    double **Ax ;               /* complex matrix values per slot, 2 * nz */
+    double **B ;                /* interleaved rhs and solution per slot, 2 * n */
+    klu_numeric **Numeric ;
+    klu_common *Common ;
+} ;
+
+SMPcBatch *
+SMPcBatchNew (SMPmatrix *Matrix, int size)
+{
+    SMPcBatch *Batch ;
+    size_t nz, n ;
+    int slot ;
+
+    if (!Matrix->CKTkluMODE || !Matrix->SMPkluMatrix->KLUmatrixSymbolic || size < 1)
+        return NULL ;
+
+    nz = Matrix->SMPkluMatrix->KLUmatrixNZ ;
+    n = Matrix->SMPkluMatrix->KLUmatrixN ;
+
+    Batch = (SMPcBatch *) malloc (sizeof (SMPcBatch)) ;
+    if (!Batch)
+        return NULL ;
+    Batch->Matrix = Matrix ;
+    Batch->size = size ;
+    Batch->Ax = (double **) calloc ((size_t)size, sizeof (double *)) ;
+    Batch->B = (double **) calloc ((size_t)size, sizeof (double *)) ;
+    Batch->Numeric = (klu_numeric **) calloc ((size_t)size, sizeof (klu_numeric *)) ;
+    Batch->Common = (klu_common *) calloc ((size_t)size, sizeof (klu_common)) ;
+    if (!Batch->Ax || !Batch->B || !Batch->Numeric || !Batch->Common) {
+        SMPcBatchDestroy (Batch) ;
+        return NULL ;
+    }
+
+    for (slot = 0 ; slot < size ; slot++) {
+        Batch->Ax [slot] = (double *) malloc (2 * nz * sizeof (double)) ;
+        Batch->B [slot] = (double *) malloc (2 * n * sizeof (double)) ;
+        if (!Batch->Ax [slot] || !Batch->B [slot]) {
+            SMPcBatchDestroy (Batch) ;
+            return NULL ;
+        }
+        Batch->Common [slot] = *(Matrix->SMPkluMatrix->KLUmatrixCommon) ;
+        Batch->Common [slot].parallel = FALSE ;
+    }
+
+    return Batch ;
+}
+
+void
+SMPcBatchStore (SMPcBatch *Batch, int slot, double RHS[], double iRHS[])
+{
+    KLUmatrix *klu = Batch->Matrix->SMPkluMatrix ;
+    double *B = Batch->B [slot] ;
+    unsigned int i ;
+
+    memcpy (Batch->Ax [slot], klu->KLUmatrixAxComplex, 2 * klu->KLUmatrixNZ * sizeof (double)) ;
+
+    for (i = 0 ; i < klu->KLUmatrixN ; i++) {
+        B [2 * i] = RHS [i + 1] ;
+        B [2 * i + 1] = iRHS [i + 1] ;
+    }
+}
+
+void
+SMPcBatchSolve (SMPcBatch *Batch, int count, int errors[])
+{
+    KLUmatrix *klu = Batch->Matrix->SMPkluMatrix ;
+    int slot ;
+
+#ifdef USE_OMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (slot = 0 ; slot < count ; slot++) {
+        klu_common *Common = &Batch->Common [slot] ;
+
+        if (!Batch->Numeric [slot] ||
+            !klu_z_refactor (klu->KLUmatrixAp, klu->KLUmatrixAi, Batch->Ax [slot],
+                             klu->KLUmatrixSymbolic, Batch->Numeric [slot], Common))
+        {
+            klu_z_free_numeric (&Batch->Numeric [slot], Common) ;
+            Batch->Numeric [slot] = klu_z_factor (klu->KLUmatrixAp, klu->KLUmatrixAi, Batch->Ax [slot],
+                                                  klu->KLUmatrixSymbolic, Common) ;
+        }
+
+        if (!Batch->Numeric [slot]) {
+            errors [slot] = (Common->status == KLU_SINGULAR) ? E_SINGULAR : E_NOMEM ;
+            continue ;
+        }
+
+        klu_z_solve (klu->KLUmatrixSymbolic, Batch->Numeric [slot], (int)klu->KLUmatrixN, 1, Batch->B [slot], Common) ;
+        errors [slot] = 0 ;
+    }
+}
+
+void
+SMPcBatchGet (SMPcBatch *Batch, int slot, double RHS[], double iRHS[])
+{
+    double *B = Batch->B [slot] ;
+    unsigned int i ;
+
+    for (i = 0 ; i < Batch->Matrix->SMPkluMatrix->KLUmatrixN ; i++) {
+        RHS [i + 1] = B [2 * i] ;
+        iRHS [i + 1] = B [2 * i + 1] ;
+    }
+}
+
+void
+SMPcBatchDestroy (SMPcBatch *Batch)
+{
+    int slot ;
+
+    if (!Batch)
+        return ;
+
+    for (slot = 0 ; slot < Batch->size ; slot++) {
+        if (Batch->Numeric && Batch->Common)
+            klu_z_free_numeric (&Batch->Numeric [slot], &Batch->Common [slot]) ;
+        if (Batch->Ax)
+            free (Batch->Ax [slot]) ;
+        if (Batch->B)
+            free (Batch->B [slot]) ;
+    }
+    free (Batch->Ax) ;
+    free (Batch->B) ;
+    free (Batch->Numeric) ;
+    free (Batch->Common) ;
+    free (Batch) ;
+}
+
 /*
  * SMPsolve()
  */
@@ -1108,6 +1270,7 @@ SMPnewMatrix (SMPmatrix *Matrix, int size)
         /* Initialize the KLU Common Data Structure */
         klu_defaults (Matrix->SMPkluMatrix->KLUmatrixCommon) ;
         Matrix->SMPkluMatrix->KLUmatrixCommon->memgrow = Matrix->CKTkluMemGrowFactor ;
+        Matrix->SMPkluMatrix->KLUmatrixCommon->parallel = Matrix->CKTkluParallel ;
 
         /* Allocate KLU data structures */
         Matrix->SMPkluMatrix->KLUmatrixN = (unsigned int)size ;
@@ -1248,6 +1411,138 @@ SMPdestroyKLUforCIDER (SMPmatrix *Matrix)
 }
 #endif
 
+/*
+ * KLU symbolic analysis cache
+ *
+ * The symbolic analysis (BTF and AMD/COLAMD ordering) depends on the sparsity
+ * pattern of the matrix only.  It is repeated for an unchanged topology on
+ * every 'reset', 'alter' and 'run', and in every pass of a Monte Carlo loop.
+ * A copy of the symbolic object is kept for the last few patterns and handed
+ * out again if n, Ap and Ai match exactly.  The cache lives as long as the
+ * session, including the shared library.
+ */
+
+#define KLU_SYMBOLIC_CACHE_SIZE 4
+
+typedef struct sKLUsymbolicCache {
+    unsigned long hash ;
+    int n ;
+    int nz ;
+    int btf ;
+    int ordering ;
+    int *Ap ;
+    int *Ai ;
+    klu_symbolic *Symbolic ;
+} KLUsymbolicCache ;
+
+static KLUsymbolicCache SymbolicCache [KLU_SYMBOLIC_CACHE_SIZE] ;
+static int SymbolicCacheNext = 0 ;
+static klu_common SymbolicCacheCommon ;
+static int SymbolicCacheCommonInit = 0 ;
+
+static unsigned long
+SymbolicPatternHash (int n, int *Ap, int *Ai)
+{
+    unsigned long hash = 2166136261UL ;
+    int i ;
+
+    /* FNV-1a over the column pointers and the row indices */
+    hash = (hash ^ (unsigned long)n) * 16777619UL ;
+    for (i = 0 ; i <= n ; i++)
+        hash = (hash ^ (unsigned long)Ap [i]) * 16777619UL ;
+    for (i = 0 ; i < Ap [n] ; i++)
+        hash = (hash ^ (unsigned long)Ai [i]) * 16777619UL ;
+
+    return hash ;
+}
+
+static klu_symbolic *
+SymbolicCopy (klu_symbolic *Old, klu_common *Common)
+{
+    klu_symbolic *New ;
+    size_t n = (size_t)Old->n ;
+
+    New = klu_malloc (1, sizeof (klu_symbolic), Common) ;
+    if (New == NULL)
+        return NULL ;
+
+    *New = *Old ;
+    New->P = klu_malloc (n, sizeof (int), Common) ;
+    New->Q = klu_malloc (n, sizeof (int), Common) ;
+    New->R = klu_malloc (n + 1, sizeof (int), Common) ;
+    New->Lnz = Old->Lnz ? klu_malloc (n, sizeof (double), Common) : NULL ;
+    if (!New->P || !New->Q || !New->R || (Old->Lnz && !New->Lnz)) {
+        klu_free_symbolic (&New, Common) ;
+        return NULL ;
+    }
+
+    memcpy (New->P, Old->P, n * sizeof (int)) ;
+    memcpy (New->Q, Old->Q, n * sizeof (int)) ;
+    memcpy (New->R, Old->R, (n + 1) * sizeof (int)) ;
+    if (Old->Lnz)
+        memcpy (New->Lnz, Old->Lnz, n * sizeof (double)) ;
+
+    return New ;
+}
+
+static KLUsymbolicCache *
+SymbolicCacheLookup (unsigned long hash, int n, int *Ap, int *Ai, klu_common *Common)
+{
+    KLUsymbolicCache *entry ;
+    int i ;
+
+    for (i = 0 ; i < KLU_SYMBOLIC_CACHE_SIZE ; i++) {
+        entry = &SymbolicCache [i] ;
+        if (entry->Symbolic && entry->hash == hash && entry->n == n && entry->nz == Ap [n] &&
+            entry->btf == Common->btf && entry->ordering == Common->ordering &&
+            memcmp (entry->Ap, Ap, (size_t)(n + 1) * sizeof (int)) == 0 &&
+            memcmp (entry->Ai, Ai, (size_t)Ap [n] * sizeof (int)) == 0)
+            return entry ;
+    }
+
+    return NULL ;
+}
+
+static void
+SymbolicCacheInsert (unsigned long hash, int n, int *Ap, int *Ai, klu_symbolic *Symbolic, klu_common *Common)
+{
+    KLUsymbolicCache *entry ;
+    int nz = Ap [n] ;
+
+    if (!SymbolicCacheCommonInit) {
+        klu_defaults (&SymbolicCacheCommon) ;
+        SymbolicCacheCommonInit = 1 ;
+    }
+
+    /* round robin replacement */
+    entry = &SymbolicCache [SymbolicCacheNext] ;
+    SymbolicCacheNext = (SymbolicCacheNext + 1) % KLU_SYMBOLIC_CACHE_SIZE ;
+
+    klu_free_symbolic (&entry->Symbolic, &SymbolicCacheCommon) ;
+    free (entry->Ap) ;
+    free (entry->Ai) ;
+
+    entry->Ap = (int *) malloc ((size_t)(n + 1) * sizeof (int)) ;
+    entry->Ai = (int *) malloc ((size_t)(nz > 0 ? nz : 1) * sizeof (int)) ;
+    entry->Symbolic = SymbolicCopy (Symbolic, &SymbolicCacheCommon) ;
+    if (!entry->Ap || !entry->Ai || !entry->Symbolic) {
+        klu_free_symbolic (&entry->Symbolic, &SymbolicCacheCommon) ;
+        free (entry->Ap) ;
+        free (entry->Ai) ;
+        entry->Ap = NULL ;
+        entry->Ai = NULL ;
+        return ;
+    }
+
+    memcpy (entry->Ap, Ap, (size_t)(n + 1) * sizeof (int)) ;
+    memcpy (entry->Ai, Ai, (size_t)nz * sizeof (int)) ;
+    entry->hash = hash ;
+    entry->n = n ;
+    entry->nz = nz ;
+    entry->btf = Common->btf ;
+    entry->ordering = Common->ordering ;
+}
+
 /*
  * SMPpreOrder()
  */
@@ -1257,14 +1552,37 @@ SMPpreOrder (SMPmatrix *Matrix)
 {
     if (Matrix->CKTkluMODE)
     {
+        KLUsymbolicCache *entry ;
+        unsigned long hash ;
+        int n ;
+
         if (CircuitIsDigital() && Matrix->SMPkluMatrix->KLUmatrixN == 0) {
           // XSPICE pure digital circuits produce empty KLU matrix
           return 0 ;
         }
 
+        n = (int)Matrix->SMPkluMatrix->KLUmatrixN ;
+        hash = 0 ;
+        if (n > 0 && Matrix->SMPkluMatrix->KLUmatrixAp) {
+            hash = SymbolicPatternHash (n, Matrix->SMPkluMatrix->KLUmatrixAp, Matrix->SMPkluMatrix->KLUmatrixAi) ;
+            entry = SymbolicCacheLookup (hash, n, Matrix->SMPkluMatrix->KLUmatrixAp, Matrix->SMPkluMatrix->KLUmatrixAi,
+                                         Matrix->SMPkluMatrix->KLUmatrixCommon) ;
+            if (entry) {
+                Matrix->SMPkluMatrix->KLUmatrixSymbolic = SymbolicCopy (entry->Symbolic, Matrix->SMPkluMatrix->KLUmatrixCommon) ;
+                if (Matrix->SMPkluMatrix->KLUmatrixSymbolic) {
+                    Matrix->SMPkluMatrix->KLUmatrixCommon->status = KLU_OK ;
+                    return 0 ;
+                }
+            }
+        }
+
         Matrix->SMPkluMatrix->KLUmatrixSymbolic = klu_analyze ((int)Matrix->SMPkluMatrix->KLUmatrixN, Matrix->SMPkluMatrix->KLUmatrixAp,
                                                                Matrix->SMPkluMatrix->KLUmatrixAi, Matrix->SMPkluMatrix->KLUmatrixCommon) ;
 
+        if (n > 0 && Matrix->SMPkluMatrix->KLUmatrixSymbolic)
+            SymbolicCacheInsert (hash, n, Matrix->SMPkluMatrix->KLUmatrixAp, Matrix->SMPkluMatrix->KLUmatrixAi,
+                                 Matrix->SMPkluMatrix->KLUmatrixSymbolic, Matrix->SMPkluMatrix->KLUmatrixCommon) ;
+
         if (Matrix->SMPkluMatrix->KLUmatrixSymbolic == NULL)
         {
             if (Matrix->SMPkluMatrix->KLUmatrixCommon->status == KLU_EMPTY_MATRIX)
@@ -43,6 +43,7 @@ Copyright 2008 Holger Vogt
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #ifdef _MSC_VER
 #include <process.h>
 #else
@@ -327,3 +328,166 @@ setseedinfo(void)
 {
     seedinfo = TRUE;
 }
+
+
+/* Counter based random streams, variable 'rndstream'
+
+   The generators above deliver one sequence of random numbers for the
+   whole session, so the value a random function gets depends on the order
+   of evaluation.  With 'set rndstream' the random functions of numparam,
+   of gauss() in .model lines, and the TRNOISE and TRRANDOM sources draw
+   from the Philox4x32-10 generator instead (J. K. Salmon et al.: "Parallel
+   random numbers: as easy as 1, 2, 3", SC11, 2011).  This is a keyed
+   bijection of a 128 bit counter.  The key is made of rndseed and of
+   rndrun, the run index set by 'mcrun'.  The counter is made of a hash of
+   the stream name (the instance or parameter name), a parameter number
+   and the index of the value in the stream.  Every value is thus
+   reproducible on its own, whatever is evaluated before it, in whatever
+   thread or process.
+*/
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+
+static void
+philox4x32(uint32_t ctr[4], const uint32_t key[2])
+{
+    uint32_t k0 = key[0], k1 = key[1];
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * ctr[0];
+        uint64_t p1 = (uint64_t) PHILOX_M1 * ctr[2];
+        uint32_t c1 = ctr[1], c3 = ctr[3];
+        ctr[0] = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        ctr[1] = (uint32_t) p1;
+        ctr[2] = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        ctr[3] = (uint32_t) p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+
+bool
+rndstream_wanted(void)
+{
+    return cp_getvar("rndstream", CP_BOOL, NULL, 0);
+}
+
+
+/* hash of a stream name, FNV-1a, case insensitive as spice names are */
+unsigned int
+rndstream_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+
+    if (name)
+        for (; *name; name++)
+            hash = (hash ^ (unsigned char) tolower_c(*name)) * 16777619U;
+    return hash;
+}
+
+
+/* Set up stream number param of the name with hash value name, keyed by
+   rndseed and rndrun.  Returns FALSE if variable rndstream is not set. */
+bool
+rndstream_init(struct rndstream *rs, unsigned int name, unsigned int param)
+{
+    int seed = 1, run = 0;
+
+    if (!rndstream_wanted())
+        return FALSE;
+
+    cp_getvar("rndseed", CP_NUM, &seed, 0);
+    cp_getvar("rndrun", CP_NUM, &run, 0);
+
+    rs->key[0] = (unsigned int) seed;
+    rs->key[1] = (unsigned int) run;
+    rs->name = name;
+    rs->param = param;
+    rs->index = 0;
+
+    return TRUE;
+}
+
+
+/* four random words for value number index of the stream */
+static void
+rndstream_block(const struct rndstream *rs, size_t index, uint32_t w[4])
+{
+    uint32_t key[2];
+
+    key[0] = rs->key[0];
+    key[1] = rs->key[1];
+    w[0] = (uint32_t) index;
+    w[1] = (uint32_t) ((uint64_t) index >> 32);
+    w[2] = rs->name;
+    w[3] = rs->param;
+    philox4x32(w, key);
+}
+
+
+/* 53 bit uniform variate in [0.0 .. 1.0[ */
+static double
+rndstream_double(uint32_t hi, uint32_t lo)
+{
+    return ((double) (hi >> 5) * 67108864.0 + (double) (lo >> 6)) *
+        (1.0 / 9007199254740992.0);
+}
+
+
+/* next uniform variate in [0.0 .. 1.0[ */
+double
+rndstream_uniform(struct rndstream *rs)
+{
+    uint32_t w[4];
+
+    rndstream_block(rs, rs->index++, w);
+    return rndstream_double(w[0], w[1]);
+}
+
+
+/* next normal variate, Box-Muller without rejection, so that one value
+   needs exactly one counter */
+double
+rndstream_gauss(struct rndstream *rs)
+{
+    uint32_t w[4];
+    double u1, u2;
+
+    rndstream_block(rs, rs->index++, w);
+    u1 = 1.0 - rndstream_double(w[0], w[1]); /* ]0.0 .. 1.0] */
+    u2 = rndstream_double(w[2], w[3]);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+double
+rndstream_exp(struct rndstream *rs, double mean)
+{
+    return -log(1.0 - rndstream_uniform(rs)) * mean;
+}
+
+
+int
+rndstream_poisson(struct rndstream *rs, double lambda)
+{
+    const int max_k = 1000;
+    double p = rndstream_uniform(rs);
+    double P = exp(-lambda);
+    double sum = P;
+    int k;
+
+    if (sum >= p)
+        return 0;
+    for (k = 1; k < max_k; ++k) {
+        P *= lambda / (double) k;
+        sum += P;
+        if (sum >= p)
+            break;
+    }
+    return k;
+}
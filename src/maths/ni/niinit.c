@@ -30,10 +30,12 @@ NIinit(CKTcircuit *ckt)
 
 /* Allocation of the new SMPmatrix structure - Francesco Lannutti (2012-02) */
     ckt->CKTmatrix = TMALLOC (SMPmatrix, 1) ;
+    ckt->CKTmatrix->SMPrcondTol = ckt->CKTrcondTol ;
 
 #ifdef KLU
     ckt->CKTmatrix->CKTkluMODE = ckt->CKTkluMODE ; /* TO BE SUBSTITUTED WITH THE HEURISTICS */
     ckt->CKTmatrix->CKTkluMemGrowFactor = ckt->CKTkluMemGrowFactor ;
+    ckt->CKTmatrix->CKTkluParallel = ckt->CKTkluParallel ;
 #endif
 
     ckt->CKTniState = NIUNINITIALIZED;
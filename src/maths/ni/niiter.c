@@ -23,6 +23,38 @@ Modified: 2001 AlansFixes
 /* Limit the number of 'singular matrix' warnings */
 static int msgcount = 0;
 
+
+/* Option rcondtol: the rcond estimate of a pivoting factorization is the
+ * reference for the refactorizations that keep its pivots. */
+static void
+NIrcondRef(SMPmatrix *Matrix)
+{
+    if (Matrix->SMPrcondTol > 0.0)
+        Matrix->SMPrcondRef = SMPrcond(Matrix);
+}
+
+
+/* The pivots kept by a refactorization may have become poor ones.  Reject
+ * it like a singular one, if its rcond estimate dropped below SMPrcondTol
+ * times the reference. */
+static int
+NIrcondCheck(SMPmatrix *Matrix)
+{
+    double rcond;
+
+    if (Matrix->SMPrcondTol <= 0.0 || Matrix->SMPrcondRef <= 0.0)
+        return OK;
+
+    rcond = SMPrcond(Matrix);
+    if (rcond < Matrix->SMPrcondTol * Matrix->SMPrcondRef) {
+        if (ft_ngdebug)
+            fprintf(stderr, "Warning (ReFactor): rcond dropped from %g to %g\n",
+                    Matrix->SMPrcondRef, rcond);
+        return E_SINGULAR;
+    }
+    return OK;
+}
+
 /* NIiter() - return value is non-zero for convergence failure */
 
 int
@@ -143,6 +175,7 @@ NIiter(CKTcircuit *ckt, int maxIter)
                     FREE(OldCKTstate0);
                     return(error); /* can't handle these errors - pass up! */
                 }
+                NIrcondRef(ckt->CKTmatrix);
                 ckt->CKTniState &= ~NISHOULDREORDER;
             } else {
                 startTime = SPfrontEnd->IFseconds();
@@ -157,6 +190,12 @@ NIiter(CKTcircuit *ckt, int maxIter)
                                  ckt->CKTdiagGmin);
                 ckt->CKTstat->STATdecompTime +=
                     SPfrontEnd->IFseconds() - startTime;
+                if (!error)
+                    error = NIrcondCheck(ckt->CKTmatrix);
+                if (!error)
+                    ckt->CKTstat->STATrefactor++;
+                else if (error == E_SINGULAR)
+                    ckt->CKTstat->STATrefactorRej++;
 
 #ifdef KLU
                 if ((ckt->CKTkluMODE) && (error == E_SINGULAR)) {
@@ -193,6 +232,7 @@ NIiter(CKTcircuit *ckt, int maxIter)
                         FREE(OldCKTstate0);
                         return(error);
                     }
+                    NIrcondRef(ckt->CKTmatrix);
                 } else if (error) {
                     if (!(ckt->CKTkluMODE) && (error == E_SINGULAR)) {
 
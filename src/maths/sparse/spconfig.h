@@ -221,7 +221,7 @@
 #define  DETERMINANT2                   YES
 #define  STABILITY                      NO
 #define  CONDITION                      NO
-#define  PSEUDOCONDITION                NO
+#define  PSEUDOCONDITION                YES
 #ifdef HAS_MINDATA
 #  define  DEBUG                          NO
 #else
@@ -61,7 +61,7 @@
  *      DETERMINANT                     YES
  *      STABILITY                       NO
  *      CONDITION                       NO
- *      PSEUDOCONDITION                 NO
+ *      PSEUDOCONDITION                 YES
  *      DEBUG                           YES
  *
  *      spREAL  double
@@ -207,6 +207,17 @@ SMPreorder(SMPmatrix *Matrix, double PivTol, double PivRel, double Gmin)
                              PivRel, PivTol, YES );
 }
 
+/*
+ * SMPrcond()
+ * crude reciprocal condition estimate of the last real factorization
+ */
+double
+SMPrcond(SMPmatrix *Matrix)
+{
+    double PseudoCondition = spPseudoCondition(Matrix->SPmatrix);
+    return (PseudoCondition > 0.0) ? 1.0 / PseudoCondition : 0.0;
+}
+
 /*
  * SMPcaSolve()
  */
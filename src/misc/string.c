@@ -813,6 +813,51 @@ gettok_char(char **s, char p, bool inc_p, bool nested)
 }
 
 
+/* findtok_node() does the string scanning for gettok_node() but does not
+ * allocate a token. It skips over white space, '(', ')' and ',' before and
+ * after the token, and returns NULL in *p_token at the end of the line */
+void findtok_node(char **p_str, char **p_token, char **p_token_end)
+{
+    char *str = *p_str;
+
+    while (isspace_c(*str) ||
+           (*str == '(') ||
+           (*str == ')') ||
+           (*str == ',')
+        )
+        str++;   /* iterate over whitespace and ( , ) */
+
+    if (!*str) {
+        *p_str = str;
+        *p_token = (char *) NULL;
+        return;
+    }
+
+    *p_token = str;
+    {
+        char c;
+        while ((c = *str) != '\0' &&
+               !isspace_c(c) &&
+               (c != '(') &&
+               (c != ')') &&
+               (c != ',')
+            )            /* collect chars until whitespace or ( , ) */
+            str++;
+    }
+    *p_token_end = str;
+
+    /* Now iterate up to next non-whitespace char */
+    while (isspace_c(*str) ||
+           (*str == '(') ||
+           (*str == ')') ||
+           (*str == ',')
+        )
+        str++;   /* iterate over whitespace and ( , ) */
+
+    *p_str = str;
+} /* end of function findtok_node */
+
+
 /*-------------------------------------------------------------------------*
  * gettok_node was added by SDB on 12.3.2003
  * It acts like gettok, except that it treats parens and commas like
@@ -823,41 +868,15 @@ gettok_char(char **s, char p, bool inc_p, bool nested)
 char *
 gettok_node(char **s)
 {
-    char c;
-    const char *token, *token_e;
+    char *token, *token_e;
 
     if (*s == NULL)
         return NULL;
 
-    while (isspace_c(**s) ||
-           (**s == '(') ||
-           (**s == ')') ||
-           (**s == ',')
-        )
-        (*s)++;   /* iterate over whitespace and ( , ) */
-
-    if (!**s)
+    findtok_node(s, &token, &token_e);
+    if (token == (char *) NULL)
         return NULL;  /* return NULL if we come to end of line */
 
-    token = *s;
-    while ((c = **s) != '\0' &&
-           !isspace_c(c) &&
-           (**s != '(') &&
-           (**s != ')') &&
-           (**s != ',')
-        )            /* collect chars until whitespace or ( , ) */
-        (*s)++;
-
-    token_e = *s;
-
-    /* Now iterate up to next non-whitespace char */
-    while (isspace_c(**s) ||
-           (**s == '(') ||
-           (**s == ')') ||
-           (**s == ',')
-        )
-        (*s)++;   /* iterate over whitespace and ( , ) */
-
     return copy_substring(token, token_e);
 }
 
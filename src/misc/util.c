@@ -289,3 +289,58 @@ newfopen(const char *fn, const char* md)
 #endif
 #endif
 
+
+#if defined(SHARED_MODULE) && !defined(HAS_WINGUI) && !defined(__MINGW32__) && !defined(_MSC_VER)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* The runtime linker returns the library already loaded for the same file
+   name.  dlopen_copy() loads a private instance of library 'path' from a
+   copy in the temporary directory, named after 'prefix'.  The copy is
+   removed right away, the mapping stays valid.  Returns NULL on failure,
+   dlerror() tells if dlopen() failed. */
+void *
+dlopen_copy(const char *path, const char *prefix, int flags)
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char *libcopy, buf[BSIZE_SP];
+    int in, out;
+    ssize_t n;
+    bool ok = TRUE;
+    void *lib;
+
+    if (!tmpdir || !*tmpdir)
+        tmpdir = "/tmp";
+    libcopy = tprintf("%s/%sXXXXXX", tmpdir, prefix);
+
+    in = open(path, O_RDONLY);
+    if (in < 0) {
+        tfree(libcopy);
+        return NULL;
+    }
+    out = mkstemp(libcopy);
+    if (out < 0) {
+        close(in);
+        tfree(libcopy);
+        return NULL;
+    }
+
+    while ((n = read(in, buf, sizeof(buf))) > 0)
+        if (write(out, buf, (size_t) n) != n) {
+            ok = FALSE;
+            break;
+        }
+    if (n < 0)
+        ok = FALSE;
+    close(in);
+    if (close(out) < 0)
+        ok = FALSE;
+
+    lib = ok ? dlopen(libcopy, flags) : NULL;
+    unlink(libcopy);
+    tfree(libcopy);
+
+    return lib;
+}
+#endif
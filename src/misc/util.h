@@ -10,4 +10,8 @@ char *canonicalize_pathname(char *path);
 char *absolute_pathname(char *string, char *dot_path);
 char *ngdirname(const char *name);
 
+#if defined(SHARED_MODULE) && !defined(HAS_WINGUI) && !defined(__MINGW32__) && !defined(_MSC_VER)
+void *dlopen_copy(const char *path, const char *prefix, int flags);
+#endif
+
 #endif
@@ -34,10 +34,6 @@ extern CMat *iNoise;
 #include "../maths/dense/denseinlines.h"
 #endif
 
-static double *noise_dens = NULL;
-static double *noise_dens_ln = NULL;
-static uint32_t noise_dense_len = 0;
-
 #define nVar(i, j) noise_vals[i * descr->num_noise_src + j]
 /*
  * HICUMnoise (mode, operation, firstModel, ckt, data, OnDens)
@@ -59,6 +55,7 @@ int OSDInoise(int mode, int operation, GENmodel *inModel, CKTcircuit *ckt,
   OsdiNoiseSource src;
   uint32_t *node_mapping;
   double *noise_vals;
+  double *noise_dens = NULL, *noise_dens_ln = NULL;
   NOISEAN *job = (NOISEAN *)ckt->CKTcurJob;
 
   OsdiRegistryEntry *entry = osdi_reg_entry_model(inModel);
@@ -68,10 +65,11 @@ int OSDInoise(int mode, int operation, GENmodel *inModel, CKTcircuit *ckt,
     return OK;
   }
 
-  if (noise_dense_len < descr->num_noise_src) {
-    noise_dens = realloc(noise_dens, descr->num_noise_src * sizeof(double));
-    noise_dens_ln =
-        realloc(noise_dens_ln, descr->num_noise_src * sizeof(double));
+  /* local to the call, CKTnoise may run the noise routines of several
+     device types concurrently */
+  if (operation == N_CALC && mode == N_DENS) {
+    noise_dens = TMALLOC(double, descr->num_noise_src);
+    noise_dens_ln = TMALLOC(double, descr->num_noise_src);
   }
 
   for (gen_model = inModel; gen_model; gen_model = gen_model->GENnextModel) {
@@ -249,5 +247,7 @@ int OSDInoise(int mode, int operation, GENmodel *inModel, CKTcircuit *ckt,
       }
     }
   }
+  tfree(noise_dens);
+  tfree(noise_dens_ln);
   return (OK);
 }
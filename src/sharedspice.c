@@ -322,6 +322,7 @@ int sh_fputsll(const char *input, FILE* outf);
 int sh_ExecutePerLoop(void);
 double getvsrcval(double, char*);
 int sh_vecinit(runDesc *run);
+int sh_vecend(void);
 
 ATTRIBUTE_NORETURN void shared_exit(int status);
 
@@ -399,6 +400,8 @@ static SendRawEvtData *sendrawevt;
 #endif
 static void* euserptr;
 static wordlist *shcontrols;
+static SendVecBlock* sendblock = NULL;
+static void* buserptr;
 
 // thread IDs
 unsigned int main_id, ng_id, command_id;
@@ -1332,6 +1335,62 @@ char** ngSpice_AllVecs(char* plotname)
 }
 
 
+/* Subscribed vectors, their order is the column order of the data sent
+   by sendblock().  Resolved to the vectors of each new plot by
+   sh_vecinit(), so that no name lookup is needed per data point. */
+static char **blocknames = NULL;
+static int blockcount = 0;
+static int blockrows = 1;
+static struct dvec **blockvecs = NULL;
+static double *blockbuf = NULL;
+static int blockcols = 0;
+static int blockfill = 0;
+
+static void
+sh_delete_block(void)
+{
+    int i;
+
+    for (i = 0; i < blockcount; i++)
+        tfree(blocknames[i]);
+    tfree(blocknames);
+    tfree(blockvecs);
+    tfree(blockbuf);
+    blockcount = blockcols = blockfill = 0;
+    sendblock = NULL;
+}
+
+/* subscribe to the vectors named in the NULL terminated array vecnames,
+   data are sent by sblock() in blocks of up to 'rows' data points */
+IMPEXP
+int ngSpice_Stream(char** vecnames, int rows, SendVecBlock* sblock, void* userData)
+{
+    int i;
+
+    sh_delete_block();
+
+    if (!vecnames || !sblock)
+        return 0;
+
+    for (blockcount = 0; vecnames[blockcount]; blockcount++)
+        ;
+    if (blockcount == 0) {
+        fprintf(cp_err, "Error: ngSpice_Stream: no vectors given.\n");
+        return 1;
+    }
+
+    blocknames = TMALLOC(char*, blockcount);
+    for (i = 0; i < blockcount; i++)
+        blocknames[i] = copy(vecnames[i]);
+    blockvecs = TMALLOC(struct dvec*, blockcount);
+    blockrows = (rows > 0) ? rows : 1;
+    sendblock = sblock;
+    buserptr = userData;
+
+    return 0;
+}
+
+
 static double *bkpttmp = NULL;
 static int bkpttmpsize = 0;
 
@@ -2245,6 +2304,47 @@ int sh_ExecutePerLoop_old(void)
 }
 #endif
 
+/* send the data points collected for the subscribed vectors */
+static void
+sh_sendblock(void)
+{
+    if (blockfill > 0)
+        sendblock(blockbuf, blockfill, blockcols, ng_ident, buserptr);
+    blockfill = 0;
+}
+
+
+/* copy the last data point of the subscribed vectors into the next row */
+static void
+sh_blockadd(void)
+{
+    double *row = blockbuf + (size_t) blockfill * (size_t) blockcols;
+    int i;
+
+    for (i = 0; i < blockcount; i++) {
+        struct dvec *d = blockvecs[i];
+        if (!d) {
+            *row++ = NAN;
+        }
+        else if (d->v_length < 1) {
+            *row++ = NAN;
+            if (!isreal(d))
+                *row++ = NAN;
+        }
+        else if (isreal(d)) {
+            *row++ = d->v_realdata[d->v_length - 1];
+        }
+        else {
+            *row++ = d->v_compdata[d->v_length - 1].cx_real;
+            *row++ = d->v_compdata[d->v_length - 1].cx_imag;
+        }
+    }
+
+    if (++blockfill == blockrows)
+        sh_sendblock();
+}
+
+
 /* called each time a new data set is written to the output vectors */
 int sh_ExecutePerLoop(void)
 {
@@ -2252,6 +2352,10 @@ int sh_ExecutePerLoop(void)
     int i, veclen;
 //  double testval;
     struct plot *pl = plot_cur;
+
+    if (sendblock && blockbuf)
+        sh_blockadd();
+
     /* return immediately if callback not wanted */
     if (nodatawanted)
         return 2;
@@ -2294,6 +2398,25 @@ int sh_vecinit(runDesc *run)
     static pvecinfoall pvca = NULL;
     pvecinfo *pvc;
 
+    /* find the subscribed vectors in the new plot,
+       a complex vector takes two columns */
+    if (sendblock) {
+        blockcols = 0;
+        blockfill = 0;
+        for (i = 0; i < blockcount; i++) {
+            for (d = run->runPlot->pl_dvecs; d; d = d->v_next)
+                if (cieq(d->v_name, blocknames[i]))
+                    break;
+            if (!d)
+                fprintf(cp_err, "Warning: vector %s not found in plot %s\n",
+                        blocknames[i], run->runPlot->pl_typename);
+            blockvecs[i] = d;
+            blockcols += (d && !isreal(d)) ? 2 : 1;
+        }
+        tfree(blockbuf);
+        blockbuf = TMALLOC(double, (size_t) blockrows * (size_t) blockcols);
+    }
+
     /* return immediately if callback not wanted */
     if (nodatainitwanted)
         return 2;
@@ -2364,6 +2487,21 @@ int sh_vecinit(runDesc *run)
 }
 
 
+/* called from OUTendPlot() in outitf.c,
+   sends the rest of the data points and releases the plot's vectors */
+int sh_vecend(void)
+{
+    if (!sendblock || !blockbuf)
+        return 2;
+
+    sh_sendblock();
+    tfree(blockbuf);
+    memset(blockvecs, 0, (size_t) blockcount * sizeof(struct dvec*));
+
+    return 0;
+}
+
+
 /* issue callback to request external voltage data for source vname */
 double
 getvsrcval(double time, char *vname)
@@ -2512,6 +2650,8 @@ static int totalreset(void)
 
     is_initialized = FALSE;
 
+    sh_delete_block();
+
     // if we are in a worker thread, we exit it here
     // detaching then has to be done explicitely by the caller
     if (fl_running && !fl_exited) {
@@ -0,0 +1,356 @@
+/*************
+ * Handle based interface to shared ngspice
+ ************/
+
+/*
+ * All state of ngspice lives in global variables, so one library instance
+ * runs one simulation at a time.  ngSpice_Create() loads a private copy
+ * of this very library, with its own set of globals, initializes it with
+ * ngSpice_Init() and returns a handle to it.  All *_H functions are
+ * forwarded to the copy behind the handle.  Simulations behind different
+ * handles run concurrently in one process, on separate threads.
+ *
+ * The runtime linker returns the instance already loaded, if a library is
+ * opened a second time under the same name.  So every handle gets a copy
+ * of the library file in the temporary directory.  On Linux and macOS the
+ * copy is removed right after loading, on Windows when the handle is
+ * destroyed.
+ *
+ * Code model libraries keep a pointer to the core functions of the
+ * instance which loaded them.  So load_opus() gives an instance a private
+ * copy of a code model library another instance has loaded already (on
+ * Windows it refuses to load it).
+ *
+ * A handle may be used for any number of circuits, the price of loading
+ * the library, reading spinit and loading code models is paid only once
+ * by ngSpice_Create().
+ */
+
+#if !defined(__MINGW32__) && !defined(_MSC_VER) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* dladdr() */
+#endif
+
+#include "ngspice/ngspice.h"
+
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#undef BOOLEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+#include "ngspice/sharedspice.h"
+#include "misc/util.h" /* dlopen_copy() */
+
+
+struct ngspice_handle {
+#if defined(__MINGW32__) || defined(_MSC_VER)
+    HMODULE lib;
+    char libcopy[MAX_PATH];
+#else
+    void *lib;
+#endif
+    int ident;
+
+    int (*Init)(SendChar*, SendStat*, ControlledExit*, SendData*, SendInitData*, BGThreadRunning*, void*);
+    int (*Init_Sync)(GetVSRCData*, GetISRCData*, GetSyncData*, int*, void*);
+    int (*Command)(char*);
+    pvector_info (*Get_Vec_Info)(char*);
+    int (*Circ)(char**);
+    char* (*CurPlot)(void);
+    char** (*AllPlots)(void);
+    char** (*AllVecs)(char*);
+    int (*Stream)(char**, int, SendVecBlock*, void*);
+    NG_BOOL (*running)(void);
+    NG_BOOL (*SetBkpt)(double);
+    int (*LockRealloc)(void);
+    int (*UnlockRealloc)(void);
+    int (*Reset)(void);
+};
+
+
+#if defined(__MINGW32__) || defined(_MSC_VER)
+
+static LONG last_ident = 0;
+
+static int
+new_ident(void)
+{
+    return (int) InterlockedIncrement(&last_ident);
+}
+
+
+/* load a private copy of this library */
+static bool
+load_copy(ngSpice_Handle *h)
+{
+    HMODULE self;
+    char selfpath[MAX_PATH], tmpdir[MAX_PATH];
+
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            (LPCSTR) ngSpice_Create, &self) ||
+        !GetModuleFileNameA(self, selfpath, MAX_PATH) ||
+        !GetTempPathA(MAX_PATH, tmpdir) ||
+        !GetTempFileNameA(tmpdir, "ngs", 0, h->libcopy))
+        return FALSE;
+
+    if (!CopyFileA(selfpath, h->libcopy, FALSE)) {
+        DeleteFileA(h->libcopy);
+        return FALSE;
+    }
+
+    h->lib = LoadLibraryA(h->libcopy);
+    if (!h->lib) {
+        DeleteFileA(h->libcopy);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+static void
+unload_copy(ngSpice_Handle *h)
+{
+    FreeLibrary(h->lib);
+    DeleteFileA(h->libcopy);
+}
+
+
+#define GET_SYM(lib, sym) ((void *) GetProcAddress(lib, sym))
+
+#else
+
+static pthread_mutex_t ident_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int last_ident = 0;
+
+static int
+new_ident(void)
+{
+    int ident;
+
+    pthread_mutex_lock(&ident_mutex);
+    ident = ++last_ident;
+    pthread_mutex_unlock(&ident_mutex);
+
+    return ident;
+}
+
+
+/* load a private copy of this library */
+static bool
+load_copy(ngSpice_Handle *h)
+{
+    Dl_info info;
+    const char *err;
+
+    if (!dladdr((void *) ngSpice_Create, &info) || !info.dli_fname)
+        return FALSE;
+
+    dlerror();
+    h->lib = dlopen_copy(info.dli_fname, "ngspice", RTLD_NOW | RTLD_LOCAL);
+    if (!h->lib && (err = dlerror()) != NULL)
+        fprintf(stderr, "Error: ngSpice_Create: %s\n", err);
+
+    return h->lib != NULL;
+}
+
+static void
+unload_copy(ngSpice_Handle *h)
+{
+    dlclose(h->lib);
+}
+
+
+#define GET_SYM(lib, sym) dlsym(lib, sym)
+
+#endif
+
+
+/* Load and initialize a new simulator instance.
+   The arguments are the ones of ngSpice_Init(), the callbacks receive
+   the ident number of the handle, see ngSpice_Ident(). */
+IMPEXP
+ngSpice_Handle*
+ngSpice_Create(SendChar* printfcn, SendStat* statfcn, ControlledExit* ngexit,
+               SendData* sdata, SendInitData* sinitdata, BGThreadRunning* bgtrun, void* userData)
+{
+    ngSpice_Handle *h = TMALLOC(ngSpice_Handle, 1);
+
+    if (!load_copy(h)) {
+        fprintf(stderr, "Error: ngSpice_Create: cannot load a copy of the ngspice library\n");
+        tfree(h);
+        return NULL;
+    }
+
+    h->Init = GET_SYM(h->lib, "ngSpice_Init");
+    h->Init_Sync = GET_SYM(h->lib, "ngSpice_Init_Sync");
+    h->Command = GET_SYM(h->lib, "ngSpice_Command");
+    h->Get_Vec_Info = GET_SYM(h->lib, "ngGet_Vec_Info");
+    h->Circ = GET_SYM(h->lib, "ngSpice_Circ");
+    h->CurPlot = GET_SYM(h->lib, "ngSpice_CurPlot");
+    h->AllPlots = GET_SYM(h->lib, "ngSpice_AllPlots");
+    h->AllVecs = GET_SYM(h->lib, "ngSpice_AllVecs");
+    h->Stream = GET_SYM(h->lib, "ngSpice_Stream");
+    h->running = GET_SYM(h->lib, "ngSpice_running");
+    h->SetBkpt = GET_SYM(h->lib, "ngSpice_SetBkpt");
+    h->LockRealloc = GET_SYM(h->lib, "ngSpice_LockRealloc");
+    h->UnlockRealloc = GET_SYM(h->lib, "ngSpice_UnlockRealloc");
+    h->Reset = GET_SYM(h->lib, "ngSpice_Reset");
+
+    if (!h->Init || !h->Init_Sync || !h->Command || !h->Get_Vec_Info ||
+        !h->Circ || !h->CurPlot || !h->AllPlots || !h->AllVecs || !h->Stream ||
+        !h->running || !h->SetBkpt || !h->LockRealloc ||
+        !h->UnlockRealloc || !h->Reset) {
+        fprintf(stderr, "Error: ngSpice_Create: missing interface functions\n");
+        unload_copy(h);
+        tfree(h);
+        return NULL;
+    }
+
+    h->ident = new_ident();
+    h->Init(printfcn, statfcn, ngexit, sdata, sinitdata, bgtrun, userData);
+    h->Init_Sync(NULL, NULL, NULL, &h->ident, NULL);
+
+    return h;
+}
+
+
+/* Stop a background simulation, release the simulator and unload its
+   copy of the library. */
+IMPEXP
+void
+ngSpice_Destroy(ngSpice_Handle* h)
+{
+    if (!h)
+        return;
+
+    if (h->running()) {
+        h->Command("bg_halt");
+        while (h->running())
+#if defined(__MINGW32__) || defined(_MSC_VER)
+            Sleep(10);
+#else
+            usleep(10000);
+#endif
+    }
+    h->Reset();
+
+    unload_copy(h);
+    tfree(h);
+}
+
+
+IMPEXP
+int
+ngSpice_Ident(ngSpice_Handle* h)
+{
+    return h->ident;
+}
+
+
+IMPEXP
+int
+ngSpice_Init_Sync_H(ngSpice_Handle* h, GetVSRCData* vsrcdat, GetISRCData* isrcdat,
+                    GetSyncData* syncdat, void* userData)
+{
+    return h->Init_Sync(vsrcdat, isrcdat, syncdat, &h->ident, userData);
+}
+
+
+IMPEXP
+int
+ngSpice_Command_H(ngSpice_Handle* h, char* command)
+{
+    return h->Command(command);
+}
+
+
+IMPEXP
+pvector_info
+ngGet_Vec_Info_H(ngSpice_Handle* h, char* vecname)
+{
+    return h->Get_Vec_Info(vecname);
+}
+
+
+IMPEXP
+int
+ngSpice_Circ_H(ngSpice_Handle* h, char** circarray)
+{
+    return h->Circ(circarray);
+}
+
+
+IMPEXP
+char*
+ngSpice_CurPlot_H(ngSpice_Handle* h)
+{
+    return h->CurPlot();
+}
+
+
+IMPEXP
+char**
+ngSpice_AllPlots_H(ngSpice_Handle* h)
+{
+    return h->AllPlots();
+}
+
+
+IMPEXP
+char**
+ngSpice_AllVecs_H(ngSpice_Handle* h, char* plotname)
+{
+    return h->AllVecs(plotname);
+}
+
+
+IMPEXP
+int
+ngSpice_Stream_H(ngSpice_Handle* h, char** vecnames, int rows, SendVecBlock* sblock, void* userData)
+{
+    return h->Stream(vecnames, rows, sblock, userData);
+}
+
+
+IMPEXP
+NG_BOOL
+ngSpice_running_H(ngSpice_Handle* h)
+{
+    return h->running();
+}
+
+
+IMPEXP
+NG_BOOL
+ngSpice_SetBkpt_H(ngSpice_Handle* h, double time)
+{
+    return h->SetBkpt(time);
+}
+
+
+IMPEXP
+int
+ngSpice_LockRealloc_H(ngSpice_Handle* h)
+{
+    return h->LockRealloc();
+}
+
+
+IMPEXP
+int
+ngSpice_UnlockRealloc_H(ngSpice_Handle* h)
+{
+    return h->UnlockRealloc();
+}
+
+
+IMPEXP
+int
+ngSpice_Reset_H(ngSpice_Handle* h)
+{
+    return h->Reset();
+}
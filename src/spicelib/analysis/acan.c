@@ -10,6 +10,10 @@ Modified 2001: AlansFixes
 #include "ngspice/devdefs.h"
 #include "ngspice/sperror.h"
 
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
 #ifdef XSPICE
 #include "ngspice/evt.h"
 #include "ngspice/enh.h"
@@ -41,6 +45,127 @@ do { \
 } while(0)
 
 
+/* ACstep(job, &freq)
+ * advance freq to the next point of the sweep.  Returns 1 if the sweep
+ * consists of this single point, -1 for an unknown step type.
+ */
+
+static int
+ACstep(ACAN* job, double* freq)
+{
+    switch (job->ACstepType) {
+    case DECADE:
+    case OCTAVE:
+
+        /* inserted again 14.12.2001  */
+#ifdef HAS_PROGREP
+    {
+        double endfreq = job->ACstopFreq;
+        double startfreq = job->ACstartFreq;
+        endfreq = log(endfreq);
+        if (startfreq == 0.0)
+            startfreq = 1e-12;
+        startfreq = log(startfreq);
+
+        if (*freq > 0.0)
+            SetAnalyse("ac", (int)((log(*freq) - startfreq) * 1000.0 / (endfreq - startfreq)));
+    }
+#endif
+
+    *freq *= job->ACfreqDelta;
+    if (job->ACfreqDelta == 1) return 1;
+    break;
+    case LINEAR:
+
+#ifdef HAS_PROGREP
+    {
+        double endfreq = job->ACstopFreq;
+        double startfreq = job->ACstartFreq;
+        SetAnalyse("ac", (int)((*freq - startfreq) * 1000.0 / (endfreq - startfreq)));
+    }
+#endif
+
+    *freq += job->ACfreqDelta;
+    if (job->ACfreqDelta == 0) return 1;
+    break;
+    default:
+        return -1;
+
+    }
+
+    return 0;
+}
+
+
+#if defined(KLU) && defined(USE_OMP)
+
+/* ACanBatch(ckt, job, batch, freq, freqTol, acPlot)
+ * frequency loop of ACan for option 'acparallel': the matrices of as many
+ * frequency points as the batch has slots are loaded serially, factored
+ * and solved in parallel, and dumped in order of frequency.
+ */
+
+static int
+ACanBatch(CKTcircuit* ckt, ACAN* job, SMPcBatch* batch, int size,
+          double freq, double freqTol, runDesc* acPlot)
+{
+    double* freqs = TMALLOC(double, size);
+    int* errors = TMALLOC(int, size);
+    double startTime;
+    int count, slot, last = 0;
+    int error = OK;
+
+    while (!last && freq <= job->ACstopFreq + freqTol) {
+        if (SPfrontEnd->IFpauseTest()) {
+            /* user asked us to pause via an interrupt */
+            job->ACsaveFreq = freq;
+            error = E_PAUSE;
+            break;
+        }
+
+        for (count = 0; count < size && !last && freq <= job->ACstopFreq + freqTol; count++) {
+            ckt->CKTomega = 2.0 * M_PI * freq;
+            ckt->CKTmode = (ckt->CKTmode & MODEUIC) | MODEAC;
+            ckt->CKTnoncon = 0;
+            error = CKTacLoad(ckt);
+            if (error)
+                goto done;
+            SMPcBatchStore(batch, count, ckt->CKTrhs, ckt->CKTirhs);
+            freqs[count] = freq;
+
+            last = ACstep(job, &freq);
+            if (last < 0) {
+                error = E_INTERN;
+                goto done;
+            }
+        }
+
+        startTime = SPfrontEnd->IFseconds();
+        SMPcBatchSolve(batch, count, errors);
+        ckt->CKTstat->STATdecompTime += SPfrontEnd->IFseconds() - startTime;
+
+        for (slot = 0; slot < count; slot++) {
+            if (errors[slot]) {
+                error = errors[slot];
+                goto done;
+            }
+            SMPcBatchGet(batch, slot, ckt->CKTrhsOld, ckt->CKTirhsOld);
+            ckt->CKTrhsOld[0] = 0;
+            ckt->CKTirhsOld[0] = 0;
+            error = CKTacDump(ckt, freqs[slot], acPlot);
+            if (error)
+                goto done;
+        }
+    }
+
+done:
+    tfree(freqs);
+    tfree(errors);
+    return(error);
+}
+
+#endif
+
 int
 ACan(CKTcircuit* ckt, int restart)
 {
@@ -238,6 +363,30 @@ ACan(CKTcircuit* ckt, int restart)
     }
 #endif
 
+#if defined(KLU) && defined(USE_OMP)
+    /* frequency points are independent if the operating point is fixed */
+    if (ckt->CKTmatrix->CKTkluMODE && ckt->CKTacParallel && !ckt->CKTvarHertz
+#ifdef WANT_SENSE2
+        && !(ckt->CKTsenInfo && (ckt->CKTsenInfo->SENmode & ACSEN))
+#endif
+        ) {
+        int size = omp_get_max_threads();
+        SMPcBatch* batch = SMPcBatchNew(ckt->CKTmatrix, size);
+
+        if (batch) {
+            error = ACanBatch(ckt, job, batch, size, freq, freqTol, acPlot);
+            SMPcBatchDestroy(batch);
+            if (error == E_PAUSE)
+                return(error);
+            if (error) {
+                UPDATE_STATS(DOING_AC);
+                return(error);
+            }
+            goto endsweep;
+        }
+    }
+#endif
+
     /* main loop through all scheduled frequencies */
     while (freq <= job->ACstopFreq + freqTol) {
         if (SPfrontEnd->IFpauseTest()) {
@@ -343,47 +492,11 @@ ACan(CKTcircuit* ckt, int restart)
         }
 
         /*  increment frequency */
-
-        switch (job->ACstepType) {
-        case DECADE:
-        case OCTAVE:
-
-            /* inserted again 14.12.2001  */
-#ifdef HAS_PROGREP
-        {
-            double endfreq = job->ACstopFreq;
-            double startfreq = job->ACstartFreq;
-            endfreq = log(endfreq);
-            if (startfreq == 0.0)
-                startfreq = 1e-12;
-            startfreq = log(startfreq);
-
-            if (freq > 0.0)
-                SetAnalyse("ac", (int)((log(freq) - startfreq) * 1000.0 / (endfreq - startfreq)));
-        }
-#endif
-
-        freq *= job->ACfreqDelta;
-        if (job->ACfreqDelta == 1) goto endsweep;
-        break;
-        case LINEAR:
-
-#ifdef HAS_PROGREP
-        {
-            double endfreq = job->ACstopFreq;
-            double startfreq = job->ACstartFreq;
-            SetAnalyse("ac", (int)((freq - startfreq) * 1000.0 / (endfreq - startfreq)));
-        }
-#endif
-
-        freq += job->ACfreqDelta;
-        if (job->ACfreqDelta == 0) goto endsweep;
-        break;
-        default:
+        error = ACstep(job, &freq);
+        if (error < 0)
             return(E_INTERN);
-
-        }
-
+        if (error)
+            goto endsweep;
     }
 endsweep:
     SPfrontEnd->OUTendPlot(acPlot);
@@ -112,6 +112,18 @@ CKTacct(CKTcircuit *ckt, JOB *anal, int which, IFvalue *val)
     case OPT_TRANRJCT:
         val->iValue = ckt->CKTstat->STATrejected;
         break;
+    case OPT_REFACTOR:
+        val->iValue = ckt->CKTstat->STATrefactor;
+        break;
+    case OPT_REFACTORREJ:
+        val->iValue = ckt->CKTstat->STATrefactorRej;
+        break;
+    case OPT_OPCACHEHIT:
+        val->iValue = ckt->CKTstat->STATopCacheHit;
+        break;
+    case OPT_OPCACHEMISS:
+        val->iValue = ckt->CKTstat->STATopCacheMiss;
+        break;
     case OPT_TOTANALTIME:
         val->rValue = ckt->CKTstat->STATtotAnalTime;
         break;
@@ -0,0 +1,730 @@
+/**********
+Checkpoints of a transient analysis
+**********/
+
+/*
+ * With variable 'checkpoint' set to a file name, DCtran() saves the state
+ * of the transient analysis to this file every 'checkpointinterval' seconds
+ * of wall clock time (default 600).  A later run of the same circuit with
+ * the same variable set finds the file after the operating point, and
+ * continues from the time point saved instead of from time 0.  The file is
+ * removed when the analysis reaches its final time.
+ *
+ * The file holds a header and a list of tagged sections, each with its
+ * length, so that a reader skips sections it does not know:
+ *   CIRCUIT  size and names of the circuit, to refuse a foreign file
+ *   TIME     time, time steps, integration order
+ *   STATES   CKTstates[0 .. CKTmaxOrder+1]
+ *   RHS      the solution at the last time point
+ *   BREAKS   the breakpoint table
+ *   TIMEPTS  the accepted time points, if a LTRA line wants them
+ *   STATS    time point counts
+ *   XSPICE   temporary breakpoints of code models
+ *   DEVICE   history of one device type kept outside of CKTstates, written
+ *            and read by its DEVcheckpoint() and DEVrestore() functions
+ *
+ * The data are collected into memory at an accepted time point, and written
+ * to '<file>.tmp' by a writer thread, which then renames it to '<file>'.
+ * An interrupted run thus always leaves a complete checkpoint behind.
+ *
+ * The output of a resumed run starts at the checkpoint time.  Event-driven
+ * XSPICE code models are not covered: their queues hold values of
+ * user-defined node types, which have no binary representation.  Neither
+ * are devices that keep history outside of CKTstates without saving it:
+ * the TXL and CPL lines, the CIDER devices, sources with TRNOISE or
+ * TRRANDOM and code models with instance variables.  With any of these
+ * in the circuit no checkpoint is written.
+ */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cktdefs.h"
+#include "ngspice/devdefs.h"
+#include "ngspice/smpdefs.h"
+#include "ngspice/sperror.h"
+#include "ngspice/cpextern.h"
+#include "vsrc/vsrcdefs.h"
+#include "isrc/isrcdefs.h"
+
+#ifdef XSPICE
+#include "ngspice/evt.h"
+#include "ngspice/mif.h"
+#include "ngspice/mifdefs.h"
+
+extern int *DEVicesfl;
+#endif
+
+#include <stdint.h>
+#include <time.h>
+
+
+#define CKPT_MAGIC      "NGCKPT\r\n"
+#define CKPT_VERSION    1
+#define CKPT_TAGSIZE    8
+
+struct CKTckpt {
+    char *data;
+    size_t len;             /* bytes written, or bytes of the file read */
+    size_t size;            /* bytes allocated */
+    size_t pos;             /* read position */
+    size_t end;             /* end of the section being read */
+};
+
+
+static char *ckpt_file = NULL;
+static double ckpt_interval;
+static time_t ckpt_last;
+static uint64_t ckpt_signature;
+
+
+void
+CKTckptPut(CKTckpt *ck, const void *data, size_t n)
+{
+    if (ck->len + n > ck->size) {
+        ck->size = MAX(2 * ck->size, ck->len + n + 4096);
+        ck->data = TREALLOC(char, ck->data, ck->size);
+    }
+    memcpy(ck->data + ck->len, data, n);
+    ck->len += n;
+}
+
+
+/* Returns E_CHECKPOINT if the section holds less than n more bytes */
+int
+CKTckptGet(CKTckpt *ck, void *data, size_t n)
+{
+    if (ck->pos + n > ck->end)
+        return E_CHECKPOINT;
+    memcpy(data, ck->data + ck->pos, n);
+    ck->pos += n;
+    return OK;
+}
+
+
+void
+CKTckptPutName(CKTckpt *ck, const char *name)
+{
+    int n = (int) strlen(name);
+
+    CKTckptPut(ck, &n, sizeof(int));
+    CKTckptPut(ck, name, (size_t) n);
+}
+
+
+/* Read a name, it must be the given one */
+int
+CKTckptGetName(CKTckpt *ck, const char *name)
+{
+    int n;
+
+    if (CKTckptGet(ck, &n, sizeof(int)) || n != (int) strlen(name) ||
+        ck->pos + (size_t) n > ck->end ||
+        strncmp(ck->data + ck->pos, name, (size_t) n) != 0)
+        return E_CHECKPOINT;
+    ck->pos += (size_t) n;
+    return OK;
+}
+
+
+/* FNV-1a, over the names of all nodes and instances and the sizes of the
+   circuit */
+static uint64_t
+hash_bytes(uint64_t h, const void *data, size_t n)
+{
+    const unsigned char *p = (const unsigned char *) data;
+
+    while (n--) {
+        h ^= *p++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+
+static uint64_t
+signature(CKTcircuit *ckt)
+{
+    uint64_t h = 14695981039346656037ULL;
+    CKTnode *node;
+    int i, size = SMPmatSize(ckt->CKTmatrix);
+
+    h = hash_bytes(h, &ckt->CKTnumStates, sizeof(int));
+    h = hash_bytes(h, &ckt->CKTmaxOrder, sizeof(int));
+    h = hash_bytes(h, &size, sizeof(int));
+    h = hash_bytes(h, &ckt->CKTfinalTime, sizeof(double));
+    h = hash_bytes(h, &ckt->CKTstep, sizeof(double));
+
+    for (node = ckt->CKTnodes; node; node = node->next)
+        if (node->name)
+            h = hash_bytes(h, node->name, strlen(node->name) + 1);
+
+    for (i = 0; i < DEVmaxnum; i++) {
+        GENmodel *model;
+        GENinstance *here;
+        if (!ckt->CKThead[i])
+            continue;
+        h = hash_bytes(h, DEVices[i]->DEVpublic.name,
+                       strlen(DEVices[i]->DEVpublic.name) + 1);
+        for (model = ckt->CKThead[i]; model; model = model->GENnextModel)
+            for (here = model->GENinstances; here; here = here->GENnextInstance)
+                h = hash_bytes(h, here->GENname, strlen(here->GENname) + 1);
+    }
+
+    return h;
+}
+
+
+/* Sections are a tag of CKPT_TAGSIZE bytes and the length of the data */
+static size_t
+begin_section(CKTckpt *ck, const char *tag)
+{
+    char name[CKPT_TAGSIZE];
+    uint64_t len = 0;
+
+    memset(name, 0, CKPT_TAGSIZE);
+    strncpy(name, tag, CKPT_TAGSIZE);
+    CKTckptPut(ck, name, CKPT_TAGSIZE);
+    CKTckptPut(ck, &len, sizeof(uint64_t));
+    return ck->len;
+}
+
+
+static void
+end_section(CKTckpt *ck, size_t start)
+{
+    uint64_t len = ck->len - start;
+
+    memcpy(ck->data + start - sizeof(uint64_t), &len, sizeof(uint64_t));
+}
+
+
+/* Does instance here of device type i keep state the checkpoint misses? */
+static bool
+unsaved_instance(int i, GENinstance *here)
+{
+    /* devices with history of their own, and no DEVcheckpoint() */
+    static const char *const types[] = {
+        "TransLine", "CplLines", "NUMD", "NUMD2", "NBJT", "NBJT2", "NUMOS", "NDEV"
+    };
+    const char *name = DEVices[i]->DEVpublic.name;
+    size_t k;
+
+    for (k = 0; k < sizeof(types) / sizeof(types[0]); k++)
+        if (eq(name, types[k]))
+            return TRUE;
+
+    if (eq(name, "Vsource")) {
+        int type = ((VSRCinstance *) here)->VSRCfunctionType;
+        return type == TRNOISE || type == TRRANDOM;
+    }
+    if (eq(name, "Isource")) {
+        int type = ((ISRCinstance *) here)->ISRCfunctionType;
+        return type == TRNOISE || type == TRRANDOM;
+    }
+
+#ifdef XSPICE
+    if (DEVicesfl[i])
+        return ((MIFinstance *) here)->num_inst_var > 0;
+#endif
+
+    return FALSE;
+}
+
+
+/* The first instance whose state cannot be saved, or NULL */
+static GENinstance *
+unsaved(CKTcircuit *ckt, int *type)
+{
+    int i;
+
+    for (i = 0; i < DEVmaxnum; i++) {
+        GENmodel *model;
+        GENinstance *here;
+        if (!ckt->CKThead[i] || DEVices[i]->DEVcheckpoint)
+            continue;
+        for (model = ckt->CKThead[i]; model; model = model->GENnextModel)
+            for (here = model->GENinstances; here; here = here->GENnextInstance)
+                if (unsaved_instance(i, here)) {
+                    *type = i;
+                    return here;
+                }
+    }
+
+    return NULL;
+}
+
+
+static int
+collect(CKTcircuit *ckt, CKTckpt *ck)
+{
+    size_t sec;
+    int i, size = SMPmatSize(ckt->CKTmatrix) + 1;
+    int version = CKPT_VERSION, n, error;
+
+    CKTckptPut(ck, CKPT_MAGIC, CKPT_TAGSIZE);
+    CKTckptPut(ck, &version, sizeof(int));
+
+    sec = begin_section(ck, "CIRCUIT");
+    CKTckptPut(ck, &ckpt_signature, sizeof(uint64_t));
+    CKTckptPut(ck, &ckt->CKTnumStates, sizeof(int));
+    CKTckptPut(ck, &size, sizeof(int));
+    end_section(ck, sec);
+
+    sec = begin_section(ck, "TIME");
+    CKTckptPut(ck, &ckt->CKTtime, sizeof(double));
+    CKTckptPut(ck, &ckt->CKTdelta, sizeof(double));
+    CKTckptPut(ck, &ckt->CKTsaveDelta, sizeof(double));
+    CKTckptPut(ck, ckt->CKTdeltaOld, 7 * sizeof(double));
+    CKTckptPut(ck, &ckt->CKTorder, sizeof(int));
+    CKTckptPut(ck, &ckt->CKTbreak, sizeof(int));
+    end_section(ck, sec);
+
+    sec = begin_section(ck, "STATES");
+    for (i = 0; i <= ckt->CKTmaxOrder + 1; i++)
+        CKTckptPut(ck, ckt->CKTstates[i],
+                   (size_t) ckt->CKTnumStates * sizeof(double));
+    end_section(ck, sec);
+
+    sec = begin_section(ck, "RHS");
+    CKTckptPut(ck, ckt->CKTrhsOld, (size_t) size * sizeof(double));
+    CKTckptPut(ck, ckt->CKTrhs, (size_t) size * sizeof(double));
+    end_section(ck, sec);
+
+    sec = begin_section(ck, "BREAKS");
+    CKTckptPut(ck, &ckt->CKTbreakSize, sizeof(int));
+    CKTckptPut(ck, ckt->CKTbreaks, (size_t) ckt->CKTbreakSize * sizeof(double));
+    end_section(ck, sec);
+
+    if (ckt->CKTtimePoints) {
+        sec = begin_section(ck, "TIMEPTS");
+        n = ckt->CKTtimeIndex + 1;
+        CKTckptPut(ck, &n, sizeof(int));
+        CKTckptPut(ck, &ckt->CKTsizeIncr, sizeof(int));
+        CKTckptPut(ck, ckt->CKTtimePoints, (size_t) n * sizeof(double));
+        end_section(ck, sec);
+    }
+
+    sec = begin_section(ck, "STATS");
+    CKTckptPut(ck, &ckt->CKTstat->STATtimePts, sizeof(int));
+    CKTckptPut(ck, &ckt->CKTstat->STATaccepted, sizeof(int));
+    CKTckptPut(ck, &ckt->CKTstat->STATrejected, sizeof(int));
+    end_section(ck, sec);
+
+#ifdef XSPICE
+    sec = begin_section(ck, "XSPICE");
+    CKTckptPut(ck, &g_mif_info.breakpoint.current, sizeof(double));
+    CKTckptPut(ck, &g_mif_info.breakpoint.last, sizeof(double));
+    end_section(ck, sec);
+#endif
+
+    for (i = 0; i < DEVmaxnum; i++)
+        if (ckt->CKThead[i] && DEVices[i]->DEVcheckpoint) {
+            sec = begin_section(ck, "DEVICE");
+            CKTckptPutName(ck, DEVices[i]->DEVpublic.name);
+            error = DEVices[i]->DEVcheckpoint(ckt->CKThead[i], ckt, ck);
+            if (error) {
+                fprintf(stderr, "Error: checkpoint of device type %s failed\n",
+                        DEVices[i]->DEVpublic.name);
+                return error;
+            }
+            end_section(ck, sec);
+        }
+
+    begin_section(ck, "END");
+
+    return OK;
+}
+
+
+/* Write ck to the checkpoint file, and free it */
+static void
+write_file(CKTckpt *ck, char *file)
+{
+    char *tmpfile = tprintf("%s.tmp", file);
+    FILE *fp = fopen(tmpfile, "wb");
+    bool ok = fp != NULL;
+
+    if (fp) {
+        if (fwrite(ck->data, 1, ck->len, fp) != ck->len)
+            ok = FALSE;
+        if (fclose(fp) != 0)
+            ok = FALSE;
+    }
+#if defined(__MINGW32__) || defined(_MSC_VER)
+    /* rename() does not replace an existing file */
+    if (ok)
+        remove(file);
+#endif
+    if (ok && rename(tmpfile, file) != 0)
+        ok = FALSE;
+    if (!ok) {
+        fprintf(stderr, "Warning: cannot write checkpoint %s\n", file);
+        remove(tmpfile);
+    }
+
+    tfree(tmpfile);
+    tfree(ck->data);
+    tfree(ck);
+}
+
+
+#if defined(HAVE_PTHREAD_CREATE) && defined(HAVE_PTHREAD_H)
+
+#include <pthread.h>
+
+static pthread_t writer;
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool writer_started = FALSE, writer_busy = FALSE;
+static CKTckpt *writer_data;
+static char *writer_file;
+
+
+static void *
+writer_main(void *arg)
+{
+    NG_IGNORE(arg);
+
+    write_file(writer_data, writer_file);
+    tfree(writer_file);
+
+    pthread_mutex_lock(&writer_mutex);
+    writer_busy = FALSE;
+    pthread_mutex_unlock(&writer_mutex);
+
+    return NULL;
+}
+
+
+/* Hand ck over to the writer thread, returns FALSE while it is busy */
+static bool
+write_async(CKTckpt *ck)
+{
+    bool busy;
+
+    pthread_mutex_lock(&writer_mutex);
+    busy = writer_busy;
+    pthread_mutex_unlock(&writer_mutex);
+    if (busy)
+        return FALSE;
+
+    if (writer_started)
+        pthread_join(writer, NULL);
+    writer_started = FALSE;
+
+    writer_data = ck;
+    writer_file = copy(ckpt_file);
+    writer_busy = TRUE;
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        writer_busy = FALSE;
+        tfree(writer_file);
+        write_file(ck, ckpt_file);
+    } else {
+        writer_started = TRUE;
+    }
+
+    return TRUE;
+}
+
+
+static void
+write_wait(void)
+{
+    if (writer_started)
+        pthread_join(writer, NULL);
+    writer_started = FALSE;
+}
+
+#else
+
+static bool
+write_async(CKTckpt *ck)
+{
+    write_file(ck, ckpt_file);
+    return TRUE;
+}
+
+
+static void
+write_wait(void)
+{
+}
+
+#endif
+
+
+/* Save a checkpoint, if it is due.  Called after a time point has been
+   accepted and sent to the output. */
+void
+CKTckptSave(CKTcircuit *ckt)
+{
+    CKTckpt *ck;
+    time_t now;
+
+    if (!ckpt_file)
+        return;
+
+    now = time(NULL);
+    if (difftime(now, ckpt_last) < ckpt_interval)
+        return;
+
+    ck = TMALLOC(CKTckpt, 1);
+    if (collect(ckt, ck) != OK) {
+        /* no checkpoint is better than a wrong one */
+        tfree(ck->data);
+        tfree(ck);
+        ckpt_last = now;
+    } else if (write_async(ck)) {
+        ckpt_last = now;
+    } else {
+        /* the last one is still being written, try again later */
+        tfree(ck->data);
+        tfree(ck);
+    }
+}
+
+
+/* Find the next section, returns its tag or NULL at the end of the file */
+static const char *
+next_section(CKTckpt *ck)
+{
+    uint64_t len;
+    const char *tag;
+
+    ck->pos = ck->end;
+    if (ck->pos + CKPT_TAGSIZE + sizeof(uint64_t) > ck->len)
+        return NULL;
+    tag = ck->data + ck->pos;
+    memcpy(&len, ck->data + ck->pos + CKPT_TAGSIZE, sizeof(uint64_t));
+    ck->pos += CKPT_TAGSIZE + sizeof(uint64_t);
+    if (len > ck->len - ck->pos || tag[CKPT_TAGSIZE - 1] != '\0')
+        return NULL;
+    ck->end = ck->pos + (size_t) len;
+    return tag;
+}
+
+
+static int
+get_array(CKTckpt *ck, double **data, int n, int *alloc)
+{
+    if (n > *alloc) {
+        *data = TREALLOC(double, *data, n);
+        *alloc = n;
+    }
+    return CKTckptGet(ck, *data, (size_t) n * sizeof(double));
+}
+
+
+/* Restore the state of the analysis from ck.  The CIRCUIT section has been
+   checked before. */
+static int
+restore(CKTcircuit *ckt, CKTckpt *ck)
+{
+    const char *tag;
+    int i, n, error = OK;
+    int size = SMPmatSize(ckt->CKTmatrix) + 1;
+    int devices = 0, wanted = 0;
+
+    for (i = 0; i < DEVmaxnum; i++)
+        if (ckt->CKThead[i] && DEVices[i]->DEVcheckpoint)
+            wanted++;
+
+    while (!error && (tag = next_section(ck)) != NULL) {
+        if (eq(tag, "END")) {
+            break;
+        } else if (eq(tag, "TIME")) {
+            if (CKTckptGet(ck, &ckt->CKTtime, sizeof(double)) ||
+                CKTckptGet(ck, &ckt->CKTdelta, sizeof(double)) ||
+                CKTckptGet(ck, &ckt->CKTsaveDelta, sizeof(double)) ||
+                CKTckptGet(ck, ckt->CKTdeltaOld, 7 * sizeof(double)) ||
+                CKTckptGet(ck, &ckt->CKTorder, sizeof(int)) ||
+                CKTckptGet(ck, &ckt->CKTbreak, sizeof(int)))
+                error = E_CHECKPOINT;
+        } else if (eq(tag, "STATES")) {
+            for (i = 0; !error && i <= ckt->CKTmaxOrder + 1; i++)
+                error = CKTckptGet(ck, ckt->CKTstates[i],
+                                   (size_t) ckt->CKTnumStates * sizeof(double));
+        } else if (eq(tag, "RHS")) {
+            if (CKTckptGet(ck, ckt->CKTrhsOld, (size_t) size * sizeof(double)) ||
+                CKTckptGet(ck, ckt->CKTrhs, (size_t) size * sizeof(double)))
+                error = E_CHECKPOINT;
+        } else if (eq(tag, "BREAKS")) {
+            if (CKTckptGet(ck, &n, sizeof(int)) || n < 2)
+                error = E_CHECKPOINT;
+            else {
+                ckt->CKTbreakSize = 0;
+                error = get_array(ck, &ckt->CKTbreaks, n, &ckt->CKTbreakSize);
+                ckt->CKTbreakSize = n;
+            }
+        } else if (eq(tag, "TIMEPTS")) {
+            if (CKTckptGet(ck, &n, sizeof(int)) || n < 1 ||
+                CKTckptGet(ck, &ckt->CKTsizeIncr, sizeof(int)))
+                error = E_CHECKPOINT;
+            else {
+                if (!ckt->CKTtimePoints)
+                    ckt->CKTtimeListSize = 0;
+                error = get_array(ck, &ckt->CKTtimePoints, n, &ckt->CKTtimeListSize);
+                ckt->CKTtimeIndex = n - 1;
+            }
+        } else if (eq(tag, "STATS")) {
+            if (CKTckptGet(ck, &ckt->CKTstat->STATtimePts, sizeof(int)) ||
+                CKTckptGet(ck, &ckt->CKTstat->STATaccepted, sizeof(int)) ||
+                CKTckptGet(ck, &ckt->CKTstat->STATrejected, sizeof(int)))
+                error = E_CHECKPOINT;
+#ifdef XSPICE
+        } else if (eq(tag, "XSPICE")) {
+            if (CKTckptGet(ck, &g_mif_info.breakpoint.current, sizeof(double)) ||
+                CKTckptGet(ck, &g_mif_info.breakpoint.last, sizeof(double)))
+                error = E_CHECKPOINT;
+#endif
+        } else if (eq(tag, "DEVICE")) {
+            int type;
+            char name[BSIZE_SP];
+            if (CKTckptGet(ck, &n, sizeof(int)) || n < 0 || n >= BSIZE_SP ||
+                CKTckptGet(ck, name, (size_t) n)) {
+                error = E_CHECKPOINT;
+                break;
+            }
+            name[n] = '\0';
+            type = CKTtypelook(name);
+            if (type < 0 || !ckt->CKThead[type] || !DEVices[type]->DEVrestore)
+                error = E_CHECKPOINT;
+            else
+                error = DEVices[type]->DEVrestore(ckt->CKThead[type], ckt, ck);
+            /* the device must have read its section completely */
+            if (!error && ck->pos != ck->end)
+                error = E_CHECKPOINT;
+            if (error)
+                fprintf(stderr, "Error: device type %s not restored\n", name);
+            devices++;
+        }
+        /* skip sections of a later version */
+    }
+
+    if (!error && devices != wanted)
+        error = E_CHECKPOINT;
+
+    return error;
+}
+
+
+/* Read the checkpoint file, and restore the analysis if the file belongs
+   to this circuit. */
+static int
+resume(CKTcircuit *ckt, FILE *fp, int *resumed)
+{
+    CKTckpt ck;
+    const char *tag;
+    char magic[CKPT_TAGSIZE];
+    uint64_t sig;
+    int version, numStates, size, error = OK;
+    size_t n;
+
+    memset(&ck, 0, sizeof(ck));
+    ck.size = 65536;
+    ck.data = TMALLOC(char, ck.size);
+    while ((n = fread(ck.data + ck.len, 1, ck.size - ck.len, fp)) > 0) {
+        ck.len += n;
+        if (ck.len == ck.size) {
+            ck.size *= 2;
+            ck.data = TREALLOC(char, ck.data, ck.size);
+        }
+    }
+
+    ck.end = ck.len;
+    if (CKTckptGet(&ck, magic, CKPT_TAGSIZE) ||
+        memcmp(magic, CKPT_MAGIC, CKPT_TAGSIZE) != 0 ||
+        CKTckptGet(&ck, &version, sizeof(int)) || version != CKPT_VERSION) {
+        fprintf(stderr, "Warning: %s is not a checkpoint of this version of ngspice\n",
+                ckpt_file);
+        tfree(ck.data);
+        return OK;
+    }
+
+    /* the circuit must be the same */
+    ck.end = ck.pos;
+    tag = next_section(&ck);
+    if (!tag || !eq(tag, "CIRCUIT") ||
+        CKTckptGet(&ck, &sig, sizeof(uint64_t)) || sig != ckpt_signature ||
+        CKTckptGet(&ck, &numStates, sizeof(int)) || numStates != ckt->CKTnumStates ||
+        CKTckptGet(&ck, &size, sizeof(int)) || size != SMPmatSize(ckt->CKTmatrix) + 1) {
+        fprintf(stderr, "Warning: checkpoint %s belongs to another circuit, not resumed\n",
+                ckpt_file);
+        tfree(ck.data);
+        return OK;
+    }
+
+    error = restore(ckt, &ck);
+    tfree(ck.data);
+    if (error) {
+        fprintf(stderr, "Error: checkpoint %s is damaged\n", ckpt_file);
+        return error;
+    }
+
+    *resumed = 1;
+    printf("Resuming transient analysis at time %g from checkpoint %s\n",
+           ckt->CKTtime, ckpt_file);
+    return OK;
+}
+
+
+/* Set up checkpoints for the transient analysis about to start, after its
+   operating point.  If a checkpoint of this circuit exists, the analysis is
+   restored to it, and *resumed is set. */
+int
+CKTckptBegin(CKTcircuit *ckt, int *resumed)
+{
+    char buf[BSIZE_SP];
+    GENinstance *here;
+    FILE *fp;
+    int error = OK, type;
+
+    *resumed = 0;
+    CKTckptEnd(FALSE);
+
+    if (!cp_getvar("checkpoint", CP_STRING, buf, sizeof(buf)) || !*buf)
+        return OK;
+
+#ifdef XSPICE
+    if (ckt->evt->counts.num_insts > 0) {
+        fprintf(stderr, "Warning: no checkpoints with event-driven code models\n");
+        return OK;
+    }
+#endif
+
+    here = unsaved(ckt, &type);
+    if (here) {
+        fprintf(stderr, "Error: no checkpoints, the state of %s (%s) cannot be saved\n",
+                here->GENname, DEVices[type]->DEVpublic.name);
+        return OK;
+    }
+
+    ckpt_file = copy(buf);
+    if (!cp_getvar("checkpointinterval", CP_REAL, &ckpt_interval, 0) ||
+        ckpt_interval < 0)
+        ckpt_interval = 600;
+    ckpt_last = time(NULL);
+    ckpt_signature = signature(ckt);
+
+    fp = fopen(ckpt_file, "rb");
+    if (fp) {
+        error = resume(ckt, fp, resumed);
+        fclose(fp);
+    }
+
+    return error;
+}
+
+
+/* Wait for the writer.  If the analysis is finished, the checkpoint is no
+   longer needed. */
+void
+CKTckptEnd(int finished)
+{
+    write_wait();
+
+    if (!ckpt_file)
+        return;
+
+    if (finished)
+        remove(ckpt_file);
+    tfree(ckpt_file);
+}
@@ -63,6 +63,10 @@ CKTdestroy(CKTcircuit *ckt)
                 DEVices[i]->DEVdestroy();
         }
 
+#ifdef USE_OMP
+    FREE(ckt->CKTloadInst);
+#endif
+
     for(i=0;i<=ckt->CKTmaxOrder+1;i++){
         FREE(ckt->CKTstates[i]);
     }
@@ -107,11 +107,21 @@ CKTdoJob(CKTcircuit* ckt, int reset, TSKtask* task)
     ckt->CKTtroubleNode = 0;
     ckt->CKTtroubleElt = NULL;
     ckt->CKTnoopac = task->TSKnoopac && ckt->CKTisLinear;
+    ckt->CKTdcWarmStart = task->TSKdcWarmStart;
     ckt->CKTepsmin = task->TSKepsmin;
+    ckt->CKTrcondTol = task->TSKrcondTol;
+    ckt->CKTopCache = task->TSKopCache;
+    ckt->CKTdcParallel = task->TSKdcParallel;
 
 #ifdef KLU
     ckt->CKTkluMODE = task->TSKkluMODE;
     ckt->CKTkluMemGrowFactor = task->TSKkluMemGrowFactor ;
+    ckt->CKTkluParallel = task->TSKkluParallel;
+    ckt->CKTacParallel = task->TSKacParallel;
+#endif
+
+#ifdef USE_OMP
+    ckt->CKTnoiseParallel = task->TSKnoiseParallel;
 #endif
 
     ckt->CKTlteReltol = task->TSKlteReltol;
@@ -27,6 +27,71 @@ Modified: 2000 AlansFixes
 
 static int ZeroNoncurRow(SMPmatrix *matrix, CKTnode *nodes, int rownum);
 
+
+#ifdef USE_OMP
+/*
+ * Device types with a DEVloadInstance routine split their load into an
+ * evaluation per instance, which only writes the instance and its own
+ * states, and a DEVloadStamp pass which adds the kept values to the
+ * matrix and rhs.  CKTload evaluates the instances of all these types in
+ * one parallel loop, the dynamic schedule hands out small chunks to the
+ * threads as they become free, so a type with few expensive instances
+ * does not leave the other threads idle.  The stamping is done in the
+ * device order of the serial loop, the results do not change.
+ *
+ * CKTloadSetup collects the instances, it is called by CKTsetup after the
+ * DEVsetup routines, the array is freed by CKTunsetup.
+ */
+int
+CKTloadSetup(CKTcircuit *ckt)
+{
+    GENmodel *model;
+    GENinstance *here;
+    int i, count;
+
+    tfree(ckt->CKTloadInst);
+    ckt->CKTloadInstCount = 0;
+
+    count = 0;
+    for (i = 0; i < DEVmaxnum; i++)
+        if (DEVices[i] && DEVices[i]->DEVloadInstance && ckt->CKThead[i])
+            for (model = ckt->CKThead[i]; model; model = model->GENnextModel)
+                for (here = model->GENinstances; here; here = here->GENnextInstance)
+                    count++;
+
+    if (count == 0)
+        return OK;
+
+    ckt->CKTloadInst = TMALLOC(GENinstance *, count);
+
+    for (i = 0; i < DEVmaxnum; i++)
+        if (DEVices[i] && DEVices[i]->DEVloadInstance && ckt->CKThead[i])
+            for (model = ckt->CKThead[i]; model; model = model->GENnextModel)
+                for (here = model->GENinstances; here; here = here->GENnextInstance)
+                    ckt->CKTloadInst[ckt->CKTloadInstCount++] = here;
+
+    return OK;
+}
+
+
+static int
+CKTloadInstances(CKTcircuit *ckt)
+{
+    GENinstance **inst = ckt->CKTloadInst;
+    int k, error = OK;
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (k = 0; k < ckt->CKTloadInstCount; k++) {
+        int local_error = DEVices[inst[k]->GENmodPtr->GENmodType]->
+            DEVloadInstance(inst[k], ckt);
+        if (local_error)
+            error = local_error;
+    }
+
+    return error;
+}
+#endif
+
 // #define PER_DEVICE_STATS
 int
 CKTload(CKTcircuit *ckt)
@@ -67,10 +132,24 @@ CKTload(CKTcircuit *ckt)
     noncon = ckt->CKTnoncon;
 #endif /* STEPDEBUG */
 
+#ifdef USE_OMP
+    if (ckt->CKTloadInstCount > 0) {
+        error = CKTloadInstances(ckt);
+        if (error) return(error);
+    }
+#endif
+
     for (i = 0; i < DEVmaxnum; i++) {
         if (DEVices[i] && DEVices[i]->DEVload && ckt->CKThead[i]) {
 #ifdef PER_DEVICE_STATS
             td0 = SPfrontEnd->IFseconds();
+#endif
+#ifdef USE_OMP
+            /* evaluated above, only the stamps are left */
+            if (ckt->CKTloadInstCount > 0 && DEVices[i]->DEVloadStamp) {
+                DEVices[i]->DEVloadStamp (ckt->CKThead[i], ckt);
+                error = OK;
+            } else
 #endif
             error = DEVices[i]->DEVload (ckt->CKThead[i], ckt);
 #ifdef PER_DEVICE_STATS
@@ -20,6 +20,82 @@ Author: 1987 Gary W. Ng
 #include "ngspice/sperror.h"
 
 
+#ifdef USE_OMP
+/*
+ * Evaluate the noise densities of the device types concurrently
+ * (option noiseparallel).  Each device type works on a private copy of
+ * the Ndata block, so the integrated noise, the output noise density and
+ * the summary outputs are accumulated per device type and merged
+ * afterwards in device order, the same order the serial loop uses.
+ * The DEVnoise functions only write their own instances, and they read
+ * the adjoint solution, which stays unchanged during the evaluation.
+ *
+ * The frequency points are not split between threads: NOISEan solves
+ * the adjoint system in the one (sparse, not KLU) circuit matrix, the
+ * DEVnoise functions read that solution from ckt, and each instance
+ * keeps the density of the previous point in its own state for the
+ * integration.  A thread per point would need private copies of all of
+ * these, so the parallelism is limited to the device types.
+ */
+static int
+CKTnoiseParallel(CKTcircuit* ckt, int mode, int operation, Ndata* data,
+                 double* OnDens)
+{
+    int *dev, *errs;
+    Ndata *part;
+    double *dens, *summary;
+    int i, k, count, error;
+
+    dev = TMALLOC(int, DEVmaxnum);
+
+    count = 0;
+    for (i = 0; i < DEVmaxnum; i++)
+        if (DEVices[i] && DEVices[i]->DEVnoise && ckt->CKThead[i])
+            dev[count++] = i;
+
+    part = TMALLOC(Ndata, count);
+    dens = TMALLOC(double, count);
+    errs = TMALLOC(int, count);
+    summary = TMALLOC(double, count * data->numPlots);
+
+    for (k = 0; k < count; k++) {
+        part[k] = *data;
+        part[k].outNoiz = 0.0;
+        part[k].inNoise = 0.0;
+        part[k].outNumber = 0;
+        part[k].outpVector = summary + k * data->numPlots;
+        dens[k] = 0.0;
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < count; k++)
+        errs[k] = DEVices[dev[k]]->DEVnoise(mode, operation,
+            ckt->CKThead[dev[k]], ckt, &part[k], &dens[k]);
+
+    error = OK;
+    for (k = 0; k < count; k++) {
+        if (errs[k]) {
+            error = errs[k];
+            break;
+        }
+        *OnDens += dens[k];
+        data->outNoiz += part[k].outNoiz;
+        data->inNoise += part[k].inNoise;
+        for (i = 0; i < part[k].outNumber; i++)
+            data->outpVector[data->outNumber++] = part[k].outpVector[i];
+    }
+
+    tfree(dev);
+    tfree(part);
+    tfree(dens);
+    tfree(errs);
+    tfree(summary);
+
+    return (error);
+}
+#endif
+
+
 int
 CKTnoise(CKTcircuit* ckt, int mode, int operation, Ndata* data)
 {
@@ -35,6 +111,18 @@ CKTnoise(CKTcircuit* ckt, int mode, int operation, Ndata* data)
 
     /* let each device decide how many and what type of noise sources it has */
 
+#ifdef USE_OMP
+    /* the densities are evaluated concurrently, naming the sources (N_OPEN)
+       and the INT_NOIZ summary stay serial */
+    if (ckt->CKTnoiseParallel && operation == N_CALC && mode == N_DENS
+#ifdef RFSPICE
+        && !(ckt->CKTcurrentAnalysis & DOING_SP)
+#endif
+        ) {
+        error = CKTnoiseParallel(ckt, mode, operation, data, &outNdens);
+        if (error) return (error);
+    } else
+#endif
     for (i = 0; i < DEVmaxnum; i++) {
         if (DEVices[i] && DEVices[i]->DEVnoise && ckt->CKThead[i]) {
             error = DEVices[i]->DEVnoise(mode, operation, ckt->CKThead[i],
@@ -75,11 +75,21 @@ CKTnewTask(CKTcircuit *ckt, TSKtask **taskPtr, IFuid taskName, TSKtask **defPtr)
         tsk->TSKabsDv           = def->TSKabsDv;
         tsk->TSKrelDv           = def->TSKrelDv;
         tsk->TSKnoopac          = def->TSKnoopac;
+        tsk->TSKdcWarmStart     = def->TSKdcWarmStart;
         tsk->TSKepsmin          = def->TSKepsmin;
+        tsk->TSKrcondTol        = def->TSKrcondTol;
+        tsk->TSKopCache         = def->TSKopCache;
+        tsk->TSKdcParallel      = def->TSKdcParallel;
 
 #ifdef KLU
         tsk->TSKkluMODE         = def->TSKkluMODE;
         tsk->TSKkluMemGrowFactor = def->TSKkluMemGrowFactor ;
+        tsk->TSKkluParallel     = def->TSKkluParallel;
+        tsk->TSKacParallel      = def->TSKacParallel;
+#endif
+
+#ifdef USE_OMP
+        tsk->TSKnoiseParallel   = def->TSKnoiseParallel;
 #endif
 
         tsk->TSKlteReltol       = def->TSKlteReltol;
@@ -135,13 +145,23 @@ CKTnewTask(CKTcircuit *ckt, TSKtask **taskPtr, IFuid taskName, TSKtask **defPtr)
         tsk->TSKkeepOpInfo      = 0;
         tsk->TSKcopyNodesets    = 0;
         tsk->TSKnodeDamping     = 0;
+        tsk->TSKdcWarmStart     = 0;
         tsk->TSKabsDv           = 0.5;
         tsk->TSKrelDv           = 2.0;
         tsk->TSKepsmin          = 1e-28;
+        tsk->TSKrcondTol        = 0.0;
+        tsk->TSKopCache         = 0;
+        tsk->TSKdcParallel      = 0;
 
 #ifdef KLU
         tsk->TSKkluMODE         = CKTkluOFF;
         tsk->TSKkluMemGrowFactor = 1.2 ;
+        tsk->TSKkluParallel     = 0;
+        tsk->TSKacParallel      = 0;
+#endif
+
+#ifdef USE_OMP
+        tsk->TSKnoiseParallel   = 0;
 #endif
 
 #if (1) /*CDHW*/
@@ -21,6 +21,9 @@ static int spice3_gmin(CKTcircuit *, long int, long int, int);
 static int new_gmin(CKTcircuit*, long int, long int, int);
 static int gillespie_src(CKTcircuit *, long int, long int, int);
 static int spice3_src(CKTcircuit *, long int, long int, int);
+static int op_solve(CKTcircuit *, long int, long int, int);
+static int opcache_start(CKTcircuit *, long int, int);
+static void opcache_store(CKTcircuit *);
 
 
 int
@@ -29,6 +32,26 @@ CKTop (CKTcircuit *ckt, long int firstmode, long int continuemode,
 {
     int converged;
 
+    if (ckt->CKTopCache <= 0 || (firstmode & MODEUIC))
+        return op_solve(ckt, firstmode, continuemode, iterlim);
+
+    /* start from the solution of a similar circuit, if there is one */
+    converged = opcache_start(ckt, continuemode, iterlim);
+    if (converged != 0)
+        converged = op_solve(ckt, firstmode, continuemode, iterlim);
+    if (converged == 0)
+        opcache_store(ckt);
+
+    return converged;
+}
+
+
+static int
+op_solve(CKTcircuit *ckt, long int firstmode, long int continuemode,
+         int iterlim)
+{
+    int converged;
+
 #ifdef HAS_PROGREP
     /* If this is called from dc simulation, don't set "op" */
     if (ckt->CKTcurJob->JOBtype != 2 && (!ckt->CKTnoOpIter || ckt->CKTnumGminSteps >= 1 || ckt->CKTnumSrcSteps >= 1))
@@ -713,3 +736,217 @@ spice3_src (CKTcircuit *ckt, long int firstmode,
 
     return 0;
 }
+
+
+/* Operating point cache, option opcache=<n>
+ *
+ * Monte Carlo, corner and 'alter' loops solve the operating point of one
+ * circuit again and again, with slightly different parameters.  The last
+ * n converged solutions are kept, with a hash of the topology and the
+ * values of all real instance and model parameters.  A new operating point
+ * of the same topology starts from the solution with the nearest parameter
+ * values, and iterates in continuemode, the way a dc sweep continues from
+ * its last point.  Only if this fails the usual gmin and source stepping
+ * follow.  The cache lives as long as the session.
+ */
+
+#define OPCACHE_MAX 64
+
+typedef struct {
+    unsigned long key;          /* hash of nodes, devices and instances */
+    int nparams;
+    double *params;
+    int size;                   /* rhs has size + 1 entries */
+    double *rhs;
+    int numStates;
+    double *state0;
+} OPcacheEntry;
+
+static OPcacheEntry OPcache[OPCACHE_MAX];
+static int OPcacheNext = 0;
+
+/* key and parameters of the circuit being solved */
+static unsigned long OPkey;
+static int OPnparams, OPparamsSize;
+static double *OPparams = NULL;
+
+
+static unsigned long
+opcache_hash(unsigned long hash, const char *s)
+{
+    /* FNV-1a */
+    for (; *s; s++)
+        hash = (hash ^ (unsigned char) *s) * 16777619UL;
+    return (hash ^ 0xff) * 16777619UL;
+}
+
+
+static void
+opcache_param(double value)
+{
+    if (OPnparams == OPparamsSize) {
+        OPparamsSize = MAX(2 * OPparamsSize, 256);
+        OPparams = TREALLOC(double, OPparams, OPparamsSize);
+    }
+    OPparams[OPnparams++] = value;
+}
+
+
+/* input parameters with a real value, which can be asked for */
+static bool
+opcache_wanted(IFparm *p)
+{
+    return (p->dataType & IF_SET) && (p->dataType & IF_ASK) &&
+        (p->dataType & IF_VARTYPES) == IF_REAL &&
+        !(p->dataType & IF_REDUNDANT);
+}
+
+
+/* Collect the key of the topology and the parameter values */
+static void
+opcache_key(CKTcircuit *ckt)
+{
+    CKTnode *node;
+    GENmodel *model;
+    GENinstance *inst;
+    IFvalue val;
+    int i, k;
+
+    OPkey = 2166136261UL;
+    OPnparams = 0;
+
+    for (node = ckt->CKTnodes; node; node = node->next)
+        if (node->name)
+            OPkey = opcache_hash(OPkey, node->name);
+
+    for (i = 0; i < DEVmaxnum; i++) {
+        IFdevice *dev;
+        if (!DEVices[i] || !ckt->CKThead[i])
+            continue;
+        dev = &DEVices[i]->DEVpublic;
+        OPkey = opcache_hash(OPkey, dev->name);
+        for (model = ckt->CKThead[i]; model; model = model->GENnextModel) {
+            if (DEVices[i]->DEVmodAsk && dev->numModelParms)
+                for (k = 0; k < *dev->numModelParms; k++)
+                    if (opcache_wanted(&dev->modelParms[k]) &&
+                        DEVices[i]->DEVmodAsk(ckt, model, dev->modelParms[k].id, &val) == OK)
+                        opcache_param(val.rValue);
+            for (inst = model->GENinstances; inst; inst = inst->GENnextInstance) {
+                OPkey = opcache_hash(OPkey, inst->GENname);
+                if (DEVices[i]->DEVask && dev->numInstanceParms)
+                    for (k = 0; k < *dev->numInstanceParms; k++)
+                        if (opcache_wanted(&dev->instanceParms[k]) &&
+                            DEVices[i]->DEVask(ckt, inst, dev->instanceParms[k].id, &val, NULL) == OK)
+                            opcache_param(val.rValue);
+            }
+        }
+    }
+}
+
+
+/* relative distance of the parameters of entry e to the current ones */
+static double
+opcache_distance(OPcacheEntry *e)
+{
+    double dist = 0.0;
+    int i;
+
+    for (i = 0; i < OPnparams; i++) {
+        double a = e->params[i], b = OPparams[i];
+        if (a != b) {
+            double d = (a - b) / (fabs(a) + fabs(b));
+            dist += d * d;
+        }
+    }
+    return dist;
+}
+
+
+static OPcacheEntry *
+opcache_nearest(CKTcircuit *ckt, double *distp)
+{
+    OPcacheEntry *best = NULL;
+    double dist, bestdist = 0.0;
+    int i, size = SMPmatSize(ckt->CKTmatrix);
+
+    for (i = 0; i < OPCACHE_MAX; i++) {
+        OPcacheEntry *e = &OPcache[i];
+        if (!e->rhs || e->key != OPkey || e->nparams != OPnparams ||
+            e->size != size)
+            continue;
+        dist = opcache_distance(e);
+        if (!best || dist < bestdist) {
+            best = e;
+            bestdist = dist;
+        }
+    }
+
+    *distp = bestdist;
+    return best;
+}
+
+
+/* Iterate from the nearest cached solution, returns 0 on success */
+static int
+opcache_start(CKTcircuit *ckt, long int continuemode, int iterlim)
+{
+    OPcacheEntry *e;
+    double dist;
+    int converged;
+
+    opcache_key(ckt);
+
+    e = opcache_nearest(ckt, &dist);
+    if (!e) {
+        ckt->CKTstat->STATopCacheMiss++;
+        return 1;
+    }
+
+    memcpy(ckt->CKTrhsOld, e->rhs, (size_t) (e->size + 1) * sizeof(double));
+    if (e->numStates == ckt->CKTnumStates)
+        memcpy(ckt->CKTstate0, e->state0, (size_t) e->numStates * sizeof(double));
+
+    ckt->CKTmode = continuemode;
+    converged = NIiter(ckt, iterlim);
+
+    if (converged == 0)
+        ckt->CKTstat->STATopCacheHit++;
+    else
+        ckt->CKTstat->STATopCacheMiss++;
+
+    if (ft_ngdebug)
+        fprintf(stderr, "op cache: distance %g, %s\n", dist,
+                converged ? "failed" : "converged");
+
+    return converged;
+}
+
+
+/* Keep the solution, replacing one with the same parameters */
+static void
+opcache_store(CKTcircuit *ckt)
+{
+    OPcacheEntry *e;
+    double dist;
+    int size = SMPmatSize(ckt->CKTmatrix);
+    int nentries = MIN(ckt->CKTopCache, OPCACHE_MAX);
+
+    e = opcache_nearest(ckt, &dist);
+    if (!e || dist > 0.0) {
+        /* round robin replacement */
+        if (OPcacheNext >= nentries)
+            OPcacheNext = 0;
+        e = &OPcache[OPcacheNext++];
+    }
+
+    e->key = OPkey;
+    e->nparams = OPnparams;
+    e->params = TREALLOC(double, e->params, MAX(OPnparams, 1));
+    memcpy(e->params, OPparams, (size_t) OPnparams * sizeof(double));
+    e->size = size;
+    e->rhs = TREALLOC(double, e->rhs, size + 1);
+    memcpy(e->rhs, ckt->CKTrhsOld, (size_t) (size + 1) * sizeof(double));
+    e->numStates = ckt->CKTnumStates;
+    e->state0 = TREALLOC(double, e->state0, MAX(ckt->CKTnumStates, 1));
+    memcpy(e->state0, ckt->CKTstate0, (size_t) ckt->CKTnumStates * sizeof(double));
+}
@@ -116,6 +116,11 @@ CKTsetup(CKTcircuit *ckt)
         }
     }
 
+#ifdef USE_OMP
+    error = CKTloadSetup(ckt);
+    if(error) return(error);
+#endif
+
 #ifdef XSPICE
   /* gtri - begin - Setup for adding rshunt option resistors */
 
@@ -238,6 +243,11 @@ CKTunsetup(CKTcircuit *ckt)
         }
     }
 
+#ifdef USE_OMP
+    tfree(ckt->CKTloadInst);
+    ckt->CKTloadInstCount = 0;
+#endif
+
     if (ckt->prev_CKTlastNode != ckt->CKTlastNode) {
         fprintf(stderr, "Internal Error: incomplete CKTunsetup(), this will cause serious problems, please report this issue !\n");
         controlled_exit(EXIT_FAILURE);
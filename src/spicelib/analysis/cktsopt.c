@@ -169,9 +169,21 @@ CKTsetOpt(CKTcircuit *ckt, JOB *anal, int opt, IFvalue *val)
     case OPT_NOOPAC:
         task->TSKnoopac = (val->iValue != 0);
         break;
+    case OPT_DCWARMSTART:
+        task->TSKdcWarmStart = (val->iValue != 0);
+        break;
     case OPT_EPSMIN:
         task->TSKepsmin = val->rValue;
         break;
+    case OPT_RCONDTOL:
+        task->TSKrcondTol = val->rValue;
+        break;
+    case OPT_OPCACHE:
+        task->TSKopCache = val->iValue;
+        break;
+    case OPT_DCPARALLEL:
+        task->TSKdcParallel = val->iValue;
+        break;
     case OPT_CSHUNT:
         task->TSKcshunt = val->rValue;
         break;
@@ -186,6 +198,17 @@ CKTsetOpt(CKTcircuit *ckt, JOB *anal, int opt, IFvalue *val)
     case OPT_KLU_MEMGROW_FACTOR:
         task->TSKkluMemGrowFactor = (val->rValue == 1.2);
         break;
+    case OPT_KLU_PARALLEL:
+        task->TSKkluParallel = (val->iValue != 0);
+        break;
+    case OPT_ACPARALLEL:
+        task->TSKacParallel = (val->iValue != 0);
+        break;
+#endif
+#ifdef USE_OMP
+    case OPT_NOISEPARALLEL:
+        task->TSKnoiseParallel = (val->iValue != 0);
+        break;
 #endif
     case OPT_LTERELTOL:
         task->TSKlteReltol = val->rValue;
@@ -326,6 +349,13 @@ static IFparm OPTtbl[] = {
  { "tranpoints", OPT_TRANPTS, IF_ASK|IF_INTEGER,"Transient timepoints" },
  { "accept", OPT_TRANACCPT, IF_ASK|IF_INTEGER,"Accepted timepoints" },
  { "rejected", OPT_TRANRJCT, IF_ASK|IF_INTEGER,"Rejected timepoints" },
+ { "refactors", OPT_REFACTOR, IF_ASK|IF_INTEGER,"LU refactorizations" },
+ { "refactorsrejected", OPT_REFACTORREJ, IF_ASK|IF_INTEGER,
+        "Rejected LU refactorizations" },
+ { "opcachehits", OPT_OPCACHEHIT, IF_ASK|IF_INTEGER,
+        "Operating points started from the cache" },
+ { "opcachemisses", OPT_OPCACHEMISS, IF_ASK|IF_INTEGER,
+        "Operating points not started from the cache" },
  { "time", OPT_TOTANALTIME, IF_ASK|IF_REAL,"Total analysis time (seconds)" },
  { "loadtime", OPT_LOADTIME, IF_ASK|IF_REAL,"Matrix load time" },
  { "synctime", OPT_SYNCTIME, IF_ASK|IF_REAL,"Matrix synchronize time" },
@@ -361,8 +391,16 @@ static IFparm OPTtbl[] = {
         "Maximum relative iter-iter node voltage change" },
  { "noopac", OPT_NOOPAC, IF_SET|IF_FLAG,
         "No op calculation in ac if circuit is linear" },
+ { "dcwarmstart", OPT_DCWARMSTART, IF_SET|IF_FLAG,
+        "Start nested dc sweeps from the previous inner sweep" },
  { "epsmin", OPT_EPSMIN, IF_SET|IF_REAL,
         "Minimum value for log" },
+ { "rcondtol", OPT_RCONDTOL, IF_SET|IF_REAL,
+        "Accepted rcond drop of an LU refactorization" },
+ { "opcache", OPT_OPCACHE, IF_SET|IF_INTEGER,
+        "Operating points kept for warm starts" },
+ { "dcparallel", OPT_DCPARALLEL, IF_SET|IF_INTEGER,
+        "Worker processes a dc sweep is split over" },
 
 #ifdef KLU
  { "sparse", OPT_SPARSE, IF_SET|IF_FLAG,
@@ -371,6 +409,15 @@ static IFparm OPTtbl[] = {
         "Set KLU as Direct Linear Solver" },
  { "klu_memgrow_factor", OPT_KLU_MEMGROW_FACTOR, IF_SET|IF_REAL,
         "KLU Memory Grow Factor (default is 1.2)" },
+ { "klu_parallel", OPT_KLU_PARALLEL, IF_SET|IF_FLAG,
+        "Refactor the KLU diagonal blocks in parallel" },
+ { "acparallel", OPT_ACPARALLEL, IF_SET|IF_FLAG,
+        "Solve AC frequency points in parallel (KLU)" },
+#endif
+
+#ifdef USE_OMP
+ { "noiseparallel", OPT_NOISEPARALLEL, IF_SET|IF_FLAG,
+        "Evaluate the noise sources of the device types in parallel" },
 #endif
 
  { "ltereltol", OPT_LTERELTOL,IF_SET | IF_REAL ,"Relative error tolerence" },
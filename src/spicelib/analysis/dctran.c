@@ -63,9 +63,10 @@ do { \
 } while(0)
 
 
-int
-DCtran(CKTcircuit *ckt,
-       int restart)   /* forced restart flag */
+/* the transient analysis proper, DCtran() ends its checkpoints */
+static int
+DCtranRun(CKTcircuit *ckt,
+          int restart)   /* forced restart flag */
 {
     TRANan *job = (TRANan *) ckt->CKTcurJob;
 
@@ -82,6 +83,7 @@ DCtran(CKTcircuit *ckt,
     int startIters;
     int converged;
     int firsttime;
+    int resumed;
     int error;
 #ifdef WANT_SENSE2
     int save, save2, size;
@@ -330,6 +332,24 @@ DCtran(CKTcircuit *ckt,
 
         INIT_STATS();
 
+        /* Continue from the checkpoint of an earlier run, if there is one */
+        error = CKTckptBegin(ckt, &resumed);
+        if (error) {
+            SPfrontEnd->OUTendPlot(job->TRANplot);
+            job->TRANplot = NULL;
+            return(error);
+        }
+        if (resumed) {
+            ckt->CKTmode = (ckt->CKTmode&MODEUIC) | MODETRAN | MODEINITPRED;
+            firsttime = 0;
+#ifdef XSPICE
+            g_mif_info.circuit.anal_init = MIF_FALSE;
+#endif
+            if (ckt->CKTtime >= ckt->CKTinitTime)
+                CKTdump(ckt, ckt->CKTtime, job->TRANplot);
+            goto resume;
+        }
+
     /* End of (restart || ckt->CKTtime == 0) */
     } else {
         /* traninit resets CKTmode */
@@ -451,6 +471,7 @@ DCtran(CKTcircuit *ckt,
         /* Final return from tran upon success */
         return(OK);
     }
+    CKTckptSave(ckt);
     if(SPfrontEnd->IFpauseTest()) {
         /* user requested pause... */
         UPDATE_STATS(DOING_TRAN);
@@ -971,6 +992,22 @@ chkStep:
 }
 
 
+int
+DCtran(CKTcircuit *ckt,
+       int restart)   /* forced restart flag */
+{
+    int error = DCtranRun(ckt, restart);
+
+    /* A paused run goes on saving checkpoints when it is resumed.  Any
+       other exit, finished or failed, ends them, and a finished run
+       removes its checkpoint file. */
+    if (error != E_PAUSE)
+        CKTckptEnd(error == OK);
+
+    return error;
+}
+
+
 /* If we have a 'step' command, and then 'quit' before reaching the final time,
    remove the run plot memory. */
 int
@@ -25,19 +25,64 @@ Modified: 1999 Paolo Nenzi
 
 #include "ngspice/devdefs.h"
 
+#if defined(HAVE_SYS_WAIT_H) && !defined(SHARED_MODULE)
+#define DCTR_FORK
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#ifdef USE_OMP
+#include <omp.h>
+#include <pthread.h>
+#endif
+#endif
+
 #ifdef HAS_PROGREP
 static double actval, actdiff;
 #endif
 
+/* set in a dcparallel worker process, the points go to the pipe 'out',
+   one record of 'width' doubles each */
+static struct {
+    FILE *out;
+    double *rec;
+    int width;
+    int nspec;
+} worker;
+
+static int DCtrSweep(CKTcircuit *ckt, int restart);
+static int DCtrSteps(CKTcircuit *ckt, runDesc *plot, int i);
+static void DCtrDump(CKTcircuit *ckt, runDesc *plot);
+#ifdef DCTR_FORK
+static int DCtrParallel(CKTcircuit *ckt, runDesc *plot, int *done);
+#endif
+
 
 int
 DCtrCurv(CKTcircuit *ckt, int restart)
+{
+    TRCV *job = (TRCV *) ckt->CKTcurJob;
+    int error = DCtrSweep(ckt, restart);
+
+    /* the warm start buffers are kept for a paused sweep only,
+       on completion and on any error they go */
+    if (error != E_PAUSE) {
+        tfree(job->TRCVwarmRhs);
+        tfree(job->TRCVwarmState);
+    }
+
+    return(error);
+}
+
+
+static int
+DCtrSweep(CKTcircuit *ckt, int restart)
 {
     TRCV *job = (TRCV *) ckt->CKTcurJob;
 
     int i;
-    double *temp;
-    int converged;
     int rcode;
     int vcode;
     int icode;
@@ -46,11 +91,9 @@ DCtrCurv(CKTcircuit *ckt, int restart)
     IFuid varUid;
     IFuid *nameList;
     int numNames;
-    int firstTime = 1;
     static runDesc *plot = NULL;
 
 #ifdef WANT_SENSE2
-    long save;
 #ifdef SENSDEBUG
     if (ckt->CKTsenInfo && (ckt->CKTsenInfo->SENmode & DCSEN)) {
         printf("\nDC Sensitivity Results\n\n");
@@ -75,6 +118,10 @@ DCtrCurv(CKTcircuit *ckt, int restart)
         goto resume;
     }
 
+    /* no warm start for the first inner sweep */
+    tfree(job->TRCVwarmRhs);
+    tfree(job->TRCVwarmState);
+
     ckt->CKTtime = 0;
     ckt->CKTdelta = job->TRCVvStep[0];
     ckt->CKTmode = (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE | MODEINITJCT;
@@ -206,7 +253,73 @@ DCtrCurv(CKTcircuit *ckt, int restart)
 
     i = 0;
 
+#ifdef DCTR_FORK
+    if (ckt->CKTdcParallel > 1) {
+        int done;
+        error = DCtrParallel(ckt, plot, &done);
+        if (error)
+            return(error);
+        if (done)
+            goto restore;
+    }
+#endif
+
  resume:
+    error = DCtrSteps(ckt, plot, i);
+    if (error)
+        return(error);
+
+#ifdef DCTR_FORK
+ restore:
+#endif
+    /* all done, lets put everything back */
+
+    for (i = 0; i <= job->TRCVnestLevel; i++)
+        if (job->TRCVvType[i] == vcode) {   /* voltage source */
+            ((VSRCinstance*)(job->TRCVvElt[i]))->VSRCdcValue = job->TRCVvSave[i];
+            ((VSRCinstance*)(job->TRCVvElt[i]))->VSRCdcGiven = (job->TRCVgSave[i] != 0);
+        } else  if (job->TRCVvType[i] == icode) { /*current source */
+            ((ISRCinstance*)(job->TRCVvElt[i]))->ISRCdcValue = job->TRCVvSave[i];
+            ((ISRCinstance*)(job->TRCVvElt[i]))->ISRCdcGiven = (job->TRCVgSave[i] != 0);
+        } else  if (job->TRCVvType[i] == rcode) { /* Resistance */
+            ((RESinstance*)(job->TRCVvElt[i]))->RESresist = job->TRCVvSave[i];
+            ((RESinstance*)(job->TRCVvElt[i]))->RESresGiven = (job->TRCVgSave[i] != 0);
+            RESupdate_conduct((RESinstance *)(job->TRCVvElt[i]), TRUE);
+            DEVices[rcode]->DEVload(job->TRCVvElt[i]->GENmodPtr, ckt);
+        } else if (job->TRCVvType[i] == TEMP_CODE) {
+            ckt->CKTtemp = job->TRCVvSave[i];
+            inp_evaluate_temper(ft_curckt);
+            CKTtemp(ckt);
+        }
+
+    SPfrontEnd->OUTendPlot (plot);
+
+    return(OK);
+}
+
+
+/* DCtrSteps(ckt, plot, i)
+ * the sweep loop, from the values the sources are set to, stepping nest
+ * level i first.  The points go to the plot, or in a dcparallel worker
+ * to its pipe.
+ */
+
+static int
+DCtrSteps(CKTcircuit *ckt, runDesc *plot, int i)
+{
+    TRCV *job = (TRCV *) ckt->CKTcurJob;
+
+    double *temp;
+    int converged;
+    int rcode = CKTtypelook("Resistor");
+    int vcode = CKTtypelook("Vsource");
+    int icode = CKTtypelook("Isource");
+    int j;
+    int error;
+    int firstTime = 1;
+#ifdef WANT_SENSE2
+    long save;
+#endif
 
     for (;;) {
 
@@ -287,6 +400,19 @@ DCtrCurv(CKTcircuit *ckt, int restart)
             ckt->CKTstates[j + 1] = ckt->CKTstates[j];
         ckt->CKTstate0 = temp;
 
+        /* An inner sweep starts again at its first value after each step of
+           the outer source.  Instead of initializing the junctions anew, start
+           from the solution at the first point of the previous inner sweep.
+           If NIiter does not converge from there, CKTop takes over below. */
+        if (firstTime && job->TRCVwarmRhs) {
+            memcpy(ckt->CKTrhsOld, job->TRCVwarmRhs,
+                   (size_t) (SMPmatSize(ckt->CKTmatrix) + 1) * sizeof(double));
+            if (job->TRCVwarmState)
+                memcpy(ckt->CKTstate0, job->TRCVwarmState,
+                       (size_t) ckt->CKTnumStates * sizeof(double));
+            ckt->CKTmode = (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE | MODEINITFLOAT;
+        }
+
         /* do operation */
 #ifdef XSPICE
 /* gtri - begin - wbk - Do EVTop if event instances exist */
@@ -422,7 +548,7 @@ DCtrCurv(CKTcircuit *ckt, int restart)
         }
 #endif
 
-        CKTdump(ckt,ckt->CKTtime,plot);
+        DCtrDump(ckt, plot);
 
         if (ckt->CKTsoaCheck)
             error = CKTsoaCheck(ckt);
@@ -433,6 +559,19 @@ DCtrCurv(CKTcircuit *ckt, int restart)
                 memcpy(ckt->CKTstate1, ckt->CKTstate0,
                        (size_t) ckt->CKTnumStates * sizeof(double));
             }
+            if (ckt->CKTdcWarmStart && job->TRCVnestLevel > 0) {
+                int size = SMPmatSize(ckt->CKTmatrix) + 1;
+                if (!job->TRCVwarmRhs)
+                    job->TRCVwarmRhs = TMALLOC(double, size);
+                memcpy(job->TRCVwarmRhs, ckt->CKTrhsOld,
+                       (size_t) size * sizeof(double));
+                if (ckt->CKTstate0) {
+                    if (!job->TRCVwarmState)
+                        job->TRCVwarmState = TMALLOC(double, ckt->CKTnumStates);
+                    memcpy(job->TRCVwarmState, ckt->CKTstate0,
+                           (size_t) ckt->CKTnumStates * sizeof(double));
+                }
+            }
         }
 
         i = 0;
@@ -467,14 +606,14 @@ DCtrCurv(CKTcircuit *ckt, int restart)
             CKTtemp(ckt);
         }
 
-        if (SPfrontEnd->IFpauseTest()) {
+        if (!worker.out && SPfrontEnd->IFpauseTest()) {
             /* user asked us to pause, so save state */
             job->TRCVnestState = i;
             return(E_PAUSE);
         }
 
 #ifdef HAS_PROGREP
-        if (i == job->TRCVnestLevel) {
+        if (i == job->TRCVnestLevel && !worker.out) {
             actval += job->TRCVvStep[job->TRCVnestLevel];
             SetAnalyse("dc", abs((int)((actval - job->TRCVvStart[job->TRCVnestLevel]) * 1000. / actdiff)));
         }
@@ -482,27 +621,416 @@ DCtrCurv(CKTcircuit *ckt, int restart)
 
     }
 
-    /* all done, lets put everything back */
+    return(OK);
+}
 
-    for (i = 0; i <= job->TRCVnestLevel; i++)
-        if (job->TRCVvType[i] == vcode) {   /* voltage source */
-            ((VSRCinstance*)(job->TRCVvElt[i]))->VSRCdcValue = job->TRCVvSave[i];
-            ((VSRCinstance*)(job->TRCVvElt[i]))->VSRCdcGiven = (job->TRCVgSave[i] != 0);
-        } else  if (job->TRCVvType[i] == icode) { /*current source */
-            ((ISRCinstance*)(job->TRCVvElt[i]))->ISRCdcValue = job->TRCVvSave[i];
-            ((ISRCinstance*)(job->TRCVvElt[i]))->ISRCdcGiven = (job->TRCVgSave[i] != 0);
-        } else  if (job->TRCVvType[i] == rcode) { /* Resistance */
-            ((RESinstance*)(job->TRCVvElt[i]))->RESresist = job->TRCVvSave[i];
-            ((RESinstance*)(job->TRCVvElt[i]))->RESresGiven = (job->TRCVgSave[i] != 0);
-            RESupdate_conduct((RESinstance *)(job->TRCVvElt[i]), TRUE);
-            DEVices[rcode]->DEVload(job->TRCVvElt[i]->GENmodPtr, ckt);
-        } else if (job->TRCVvType[i] == TEMP_CODE) {
-            ckt->CKTtemp = job->TRCVvSave[i];
-            inp_evaluate_temper(ft_curckt);
-            CKTtemp(ckt);
+
+static void
+DCtrDump(CKTcircuit *ckt, runDesc *plot)
+{
+    if (worker.out) {
+        int size = ckt->CKTmaxEqNum - 1;
+
+        worker.rec[0] = ckt->CKTtime;
+        memcpy(worker.rec + 1, ckt->CKTrhsOld + 1, (size_t) size * sizeof(double));
+        if (worker.nspec > 0) {
+            IFvalue spec;
+            spec.v.numValue = worker.nspec;
+            spec.v.vec.rVec = worker.rec + 1 + size;
+            SPfrontEnd->OUTattributes(plot, NULL, OUT_SPECIALS_GET, &spec);
         }
+        fwrite(worker.rec, sizeof(double), (size_t) worker.width, worker.out);
+        return;
+    }
 
-    SPfrontEnd->OUTendPlot (plot);
+    CKTdump(ckt, ckt->CKTtime, plot);
+}
 
-    return(OK);
+
+#ifdef DCTR_FORK
+
+/*
+ * Option dcparallel: the values of the outermost sweep variable are split
+ * into contiguous chunks, and each chunk is swept by a forked worker
+ * process, which has a copy of the whole circuit.  The workers send their
+ * points through pipes, the parent collects them and writes them to the
+ * plot in the order of the serial sweep.  The @ device parameters of the
+ * plot are read in the worker (OUT_SPECIALS_GET) and replayed in the
+ * parent (OUT_SPECIALS_SET).
+ *
+ * A single sweep continues from one point to the next.  Its chunks are
+ * started from a coarse serial pass: before forking the worker of a chunk
+ * the parent solves the chunk's first point, starting from the first
+ * point of the previous chunk, and the worker begins with that solution as
+ * a warm start.  In a nested sweep each step of the outer variable starts
+ * the inner sweep anew, the chunks need no coarse pass.
+ *
+ * The sweep runs serially if the circuit has event-driven instances or
+ * numerical devices (they dump their internals per point), with dc
+ * sensitivity, and when resuming a paused sweep.  A parallel sweep does
+ * not pause.
+ */
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    char *buf;
+    size_t len, size;
+} DCworker;
+
+
+/* value of sweep variable i, in the unit the sweep loop steps */
+static double
+DCtrGet(CKTcircuit *ckt, TRCV *job, int i)
+{
+    if (job->TRCVvType[i] == CKTtypelook("Vsource"))
+        return ((VSRCinstance *)(job->TRCVvElt[i]))->VSRCdcValue;
+    else if (job->TRCVvType[i] == CKTtypelook("Isource"))
+        return ((ISRCinstance *)(job->TRCVvElt[i]))->ISRCdcValue;
+    else if (job->TRCVvType[i] == CKTtypelook("Resistor"))
+        return ((RESinstance *)(job->TRCVvElt[i]))->RESresist;
+    else
+        return ckt->CKTtemp;
 }
+
+
+static void
+DCtrSet(CKTcircuit *ckt, TRCV *job, int i, double value)
+{
+    int rcode = CKTtypelook("Resistor");
+
+    if (job->TRCVvType[i] == CKTtypelook("Vsource")) {
+        ((VSRCinstance *)(job->TRCVvElt[i]))->VSRCdcValue = value;
+    } else if (job->TRCVvType[i] == CKTtypelook("Isource")) {
+        ((ISRCinstance *)(job->TRCVvElt[i]))->ISRCdcValue = value;
+    } else if (job->TRCVvType[i] == rcode) {
+        ((RESinstance *)(job->TRCVvElt[i]))->RESresist = value;
+        RESupdate_conduct((RESinstance *)(job->TRCVvElt[i]), FALSE);
+        DEVices[rcode]->DEVload(job->TRCVvElt[i]->GENmodPtr, ckt);
+    } else {
+        ckt->CKTtemp = value;
+        inp_evaluate_temper(ft_curckt);
+        CKTtemp(ckt);
+    }
+}
+
+
+/* the stop criterion of the sweep loop */
+static int
+DCtrPast(TRCV *job, int i, double value)
+{
+    if (job->TRCVvType[i] == TEMP_CODE)
+        value -= CONSTCtoK;
+
+    return SGN(job->TRCVvStep[i]) * (value - job->TRCVvStop[i]) >
+        DBL_EPSILON * 1e+03;
+}
+
+
+static int
+DCtrSerialOnly(CKTcircuit *ckt)
+{
+#ifdef CIDER
+    int i;
+
+    for (i = 0; i < DEVmaxnum; i++)
+        if (DEVices[i] && DEVices[i]->DEVdump && ckt->CKThead[i])
+            return 1;
+#endif
+#ifdef XSPICE
+    if (ckt->evt->counts.num_insts > 0)
+        return 1;
+#endif
+#ifdef WANT_SENSE2
+    if (ckt->CKTsenInfo && (ckt->CKTsenInfo->SENmode & DCSEN))
+        return 1;
+#endif
+    NG_IGNORE(ckt);
+    return 0;
+}
+
+
+#ifdef USE_OMP
+/* The OpenMP thread pool of the parent does not survive fork(), the
+   worker sweeps on a new thread, which starts without one. */
+struct DCtrArgs {
+    CKTcircuit *ckt;
+    runDesc *plot;
+    int error;
+};
+
+static void *
+DCtrThread(void *arg)
+{
+    struct DCtrArgs *args = (struct DCtrArgs *) arg;
+
+    /* the workers are the parallelism */
+    omp_set_num_threads(1);
+    args->error = DCtrSteps(args->ckt, args->plot, 0);
+    return NULL;
+}
+#endif
+
+
+/* worker process: sweep the chunk first ... last of the outer variable */
+static void
+DCtrWorker(CKTcircuit *ckt, runDesc *plot, int fd, double first, double last)
+{
+    TRCV *job = (TRCV *) ckt->CKTcurJob;
+    int n = job->TRCVnestLevel;
+    int error;
+
+    signal(SIGINT, SIG_IGN);
+
+    worker.out = fdopen(fd, "w");
+    if (!worker.out)
+        _exit(E_PANIC);
+
+    DCtrSet(ckt, job, n, first);
+    job->TRCVvStop[n] = (job->TRCVvType[n] == TEMP_CODE) ? last - CONSTCtoK : last;
+
+#ifdef USE_OMP
+    {
+        pthread_t tid;
+        struct DCtrArgs args = { ckt, plot, OK };
+        if (pthread_create(&tid, NULL, DCtrThread, &args) != 0)
+            _exit(E_PANIC);
+        pthread_join(tid, NULL);
+        error = args.error;
+    }
+#else
+    error = DCtrSteps(ckt, plot, 0);
+#endif
+
+    if (fclose(worker.out) != 0 && !error)
+        error = E_PANIC;
+    fflush(NULL);
+    _exit(error);
+}
+
+
+/* drain the pipes of all workers into their buffers */
+static void
+DCtrCollect(DCworker *wk, int workers)
+{
+    struct pollfd *pfd = TMALLOC(struct pollfd, workers);
+    int w, open = workers;
+
+    for (w = 0; w < workers; w++) {
+        pfd[w].fd = wk[w].fd;
+        pfd[w].events = POLLIN;
+    }
+
+    while (open > 0) {
+        if (poll(pfd, (nfds_t) workers, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (w = 0; w < workers; w++) {
+            ssize_t got;
+
+            if (pfd[w].fd < 0 || !pfd[w].revents)
+                continue;
+            if (wk[w].size - wk[w].len < 65536) {
+                wk[w].size = 2 * wk[w].size + 65536;
+                wk[w].buf = TREALLOC(char, wk[w].buf, wk[w].size);
+            }
+            got = read(pfd[w].fd, wk[w].buf + wk[w].len, wk[w].size - wk[w].len);
+            if (got > 0) {
+                wk[w].len += (size_t) got;
+            } else if (got == 0 || errno != EINTR) {
+                pfd[w].fd = -1;
+                open--;
+            }
+        }
+    }
+
+    for (w = 0; w < workers; w++) {
+        close(wk[w].fd);
+        wk[w].fd = -1;
+    }
+
+    tfree(pfd);
+}
+
+
+/* stop and reap the workers started so far */
+static void
+DCtrKill(DCworker *wk, int workers)
+{
+    int w;
+
+    for (w = 0; w < workers; w++) {
+        kill(wk[w].pid, SIGKILL);
+        close(wk[w].fd);
+        waitpid(wk[w].pid, NULL, 0);
+    }
+}
+
+
+static int
+DCtrParallel(CKTcircuit *ckt, runDesc *plot, int *done)
+{
+    TRCV *job = (TRCV *) ckt->CKTcurJob;
+    int n = job->TRCVnestLevel;
+    int size = ckt->CKTmaxEqNum - 1;
+    double *values = NULL;
+    double value;
+    int count = 0, alloc = 0;
+    int workers, w, k, first, last, nspec, width;
+    int error = OK;
+    DCworker *wk;
+    IFvalue spec;
+
+    *done = 0;
+
+    if (job->TRCVvStep[n] == 0.0 || DCtrSerialOnly(ckt))
+        return(OK);
+
+    spec.v.numValue = 0;
+    spec.v.vec.rVec = NULL;
+    if (SPfrontEnd->OUTattributes(plot, NULL, OUT_SPECIALS_GET, &spec) != OK)
+        return(OK);
+    nspec = spec.v.numValue;
+
+    /* the values of the outer variable, stepped like the sweep loop does */
+    for (value = DCtrGet(ckt, job, n); !DCtrPast(job, n, value);
+         value += job->TRCVvStep[n]) {
+        if (count == alloc) {
+            alloc = 2 * alloc + 64;
+            values = TREALLOC(double, values, alloc);
+        }
+        values[count++] = value;
+    }
+
+    workers = MIN(ckt->CKTdcParallel, count);
+    if (workers < 2) {
+        tfree(values);
+        return(OK);
+    }
+
+    width = 1 + size + nspec;
+    wk = TMALLOC(DCworker, workers);
+
+    for (w = 0; w < workers; w++) {
+        int fd[2];
+
+        first = (int) ((long) w * count / workers);
+        last = (int) ((long) (w + 1) * count / workers) - 1;
+
+        /* coarse pass, the first point of the chunk from the first point
+           of the previous one, the worker starts from its solution */
+        if (n == 0 && w > 0) {
+            int converged;
+
+            DCtrSet(ckt, job, n, values[first]);
+            ckt->CKTmode = (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE |
+                (w > 1 && job->TRCVwarmRhs ? MODEINITFLOAT : MODEINITJCT);
+            converged = NIiter(ckt, ckt->CKTdcTrcvMaxIter);
+            if (converged != 0)
+                converged = CKTop(ckt,
+                    (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE | MODEINITJCT,
+                    (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE | MODEINITFLOAT,
+                    ckt->CKTdcMaxIter);
+            if (converged != 0) {
+                /* the worker initializes the junctions itself */
+                tfree(job->TRCVwarmRhs);
+                tfree(job->TRCVwarmState);
+            } else {
+                if (!job->TRCVwarmRhs)
+                    job->TRCVwarmRhs = TMALLOC(double, SMPmatSize(ckt->CKTmatrix) + 1);
+                memcpy(job->TRCVwarmRhs, ckt->CKTrhsOld,
+                       (size_t) (SMPmatSize(ckt->CKTmatrix) + 1) * sizeof(double));
+                if (ckt->CKTstate0) {
+                    if (!job->TRCVwarmState)
+                        job->TRCVwarmState = TMALLOC(double, ckt->CKTnumStates);
+                    memcpy(job->TRCVwarmState, ckt->CKTstate0,
+                           (size_t) ckt->CKTnumStates * sizeof(double));
+                }
+            }
+        }
+
+        if (pipe(fd) < 0)
+            break;
+
+        /* do not let the worker inherit pending output */
+        fflush(NULL);
+
+        wk[w].pid = fork();
+        if (wk[w].pid < 0) {
+            close(fd[0]);
+            close(fd[1]);
+            break;
+        }
+        if (wk[w].pid == 0) {
+            close(fd[0]);
+            for (k = 0; k < w; k++)
+                close(wk[k].fd);
+            worker.width = width;
+            worker.nspec = nspec;
+            worker.rec = TMALLOC(double, width);
+            DCtrWorker(ckt, plot, fd[1], values[first], values[last]);
+        }
+        close(fd[1]);
+        wk[w].fd = fd[0];
+        wk[w].buf = NULL;
+        wk[w].len = wk[w].size = 0;
+    }
+
+    if (w < workers) {
+        /* sweep serially from the start */
+        perror("dcparallel");
+        fprintf(stderr, "Warning: could not start the dcparallel workers, "
+                "the dc sweep runs serially\n");
+        DCtrKill(wk, w);
+        tfree(wk);
+        DCtrSet(ckt, job, n, values[0]);
+        tfree(values);
+        tfree(job->TRCVwarmRhs);
+        tfree(job->TRCVwarmState);
+        ckt->CKTmode = (ckt->CKTmode & MODEUIC) | MODEDCTRANCURVE | MODEINITJCT;
+        return(OK);
+    }
+
+    tfree(values);
+
+    DCtrCollect(wk, workers);
+
+    /* the points in the order of the serial sweep, up to the first worker
+       that failed */
+    for (w = 0; w < workers; w++) {
+        int status;
+        size_t points = wk[w].len / (sizeof(double) * (size_t) width);
+        double *rec = (double *) wk[w].buf;
+
+        for (; points > 0 && !error; points--, rec += width) {
+            memcpy(ckt->CKTrhsOld + 1, rec + 1, (size_t) size * sizeof(double));
+            if (nspec > 0) {
+                spec.v.numValue = nspec;
+                spec.v.vec.rVec = rec + 1 + size;
+                SPfrontEnd->OUTattributes(plot, NULL, OUT_SPECIALS_SET, &spec);
+            }
+            CKTdump(ckt, rec[0], plot);
+        }
+
+        if (waitpid(wk[w].pid, &status, 0) < 0 || !WIFEXITED(status))
+            status = E_PANIC;
+        else
+            status = WEXITSTATUS(status);
+        if (!error)
+            error = status;
+
+        tfree(wk[w].buf);
+    }
+
+    if (nspec > 0)
+        SPfrontEnd->OUTattributes(plot, NULL, OUT_SPECIALS_SET, NULL);
+
+    tfree(wk);
+
+    *done = 1;
+    return(error);
+}
+
+#endif
@@ -32,11 +32,6 @@
 #define DELTA_3 0.02
 #define DELTA_4 0.02
 
-#ifdef USE_OMP
-int BSIM3LoadOMP(BSIM3instance *here, CKTcircuit *ckt);
-void BSIM3LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 
 int
 BSIM3load(
@@ -53,7 +48,7 @@ CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM3InstCount; idx++) {
         BSIM3instance *here = InstArray[idx];
-        int local_error = BSIM3LoadOMP(here, ckt);
+        int local_error = BSIM3LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -64,7 +59,8 @@ CKTcircuit *ckt)
 }
 
 
-int BSIM3LoadOMP(BSIM3instance *here, CKTcircuit *ckt) {
+int BSIM3LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+BSIM3instance *here = (BSIM3instance *) inInst;
 BSIM3model *model = BSIM3modPtr(here);
 #else
 BSIM3model *model = (BSIM3model*)inModel;
@@ -3128,64 +3124,79 @@ return(OK);
 }
 
 #ifdef USE_OMP
-void BSIM3LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM3LoadRhsMatRange(BSIM3instance **InstArray, int first, int last, int parallel,
+                     CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    BSIM3instance **InstArray;
+    int idx;
     BSIM3instance *here;
-    BSIM3model *model = (BSIM3model*)inModel;
 
-    InstArray = model->BSIM3InstanceArray;
-    InstCount = model->BSIM3InstCount;
+#pragma omp parallel for private(here) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
-       model = BSIM3modPtr(here);
         /* Update b for Ax = b */
-       (*(ckt->CKTrhs + here->BSIM3gNode) -= here->BSIM3rhsG);
-       (*(ckt->CKTrhs + here->BSIM3bNode) -= here->BSIM3rhsB);
-       (*(ckt->CKTrhs + here->BSIM3dNodePrime) += here->BSIM3rhsD);
-       (*(ckt->CKTrhs + here->BSIM3sNodePrime) += here->BSIM3rhsS);
+       (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3gNode, &scratch) -= here->BSIM3rhsG);
+       (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3bNode, &scratch) -= here->BSIM3rhsB);
+       (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3dNodePrime, &scratch) += here->BSIM3rhsD);
+       (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3sNodePrime, &scratch) += here->BSIM3rhsS);
        if (here->BSIM3nqsMod)
-           (*(ckt->CKTrhs + here->BSIM3qNode) += here->BSIM3rhsQ);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3qNode, &scratch) += here->BSIM3rhsQ);
 
         /* Update A for Ax = b */
-       (*(here->BSIM3DdPtr) += here->BSIM3DdPt);
-       (*(here->BSIM3GgPtr) += here->BSIM3GgPt);
-       (*(here->BSIM3SsPtr) += here->BSIM3SsPt);
-       (*(here->BSIM3BbPtr) += here->BSIM3BbPt);
-       (*(here->BSIM3DPdpPtr) += here->BSIM3DPdpPt);
-       (*(here->BSIM3SPspPtr) += here->BSIM3SPspPt);
-       (*(here->BSIM3DdpPtr) -= here->BSIM3DdpPt);
-       (*(here->BSIM3GbPtr) -= here->BSIM3GbPt);
-       (*(here->BSIM3GdpPtr) += here->BSIM3GdpPt);
-       (*(here->BSIM3GspPtr) += here->BSIM3GspPt);
-       (*(here->BSIM3SspPtr) -= here->BSIM3SspPt);
-       (*(here->BSIM3BgPtr) += here->BSIM3BgPt);
-       (*(here->BSIM3BdpPtr) += here->BSIM3BdpPt);
-       (*(here->BSIM3BspPtr) += here->BSIM3BspPt);
-       (*(here->BSIM3DPdPtr) -= here->BSIM3DPdPt);
-       (*(here->BSIM3DPgPtr) += here->BSIM3DPgPt);
-       (*(here->BSIM3DPbPtr) -= here->BSIM3DPbPt);
-       (*(here->BSIM3DPspPtr) -= here->BSIM3DPspPt);
-       (*(here->BSIM3SPgPtr) += here->BSIM3SPgPt);
-       (*(here->BSIM3SPsPtr) -= here->BSIM3SPsPt);
-       (*(here->BSIM3SPbPtr) -= here->BSIM3SPbPt);
-       (*(here->BSIM3SPdpPtr) -= here->BSIM3SPdpPt);
+       (*DEVmatSlot(here->BSIM3DdPtr, trash, &scratch) += here->BSIM3DdPt);
+       (*DEVmatSlot(here->BSIM3GgPtr, trash, &scratch) += here->BSIM3GgPt);
+       (*DEVmatSlot(here->BSIM3SsPtr, trash, &scratch) += here->BSIM3SsPt);
+       (*DEVmatSlot(here->BSIM3BbPtr, trash, &scratch) += here->BSIM3BbPt);
+       (*DEVmatSlot(here->BSIM3DPdpPtr, trash, &scratch) += here->BSIM3DPdpPt);
+       (*DEVmatSlot(here->BSIM3SPspPtr, trash, &scratch) += here->BSIM3SPspPt);
+       (*DEVmatSlot(here->BSIM3DdpPtr, trash, &scratch) -= here->BSIM3DdpPt);
+       (*DEVmatSlot(here->BSIM3GbPtr, trash, &scratch) -= here->BSIM3GbPt);
+       (*DEVmatSlot(here->BSIM3GdpPtr, trash, &scratch) += here->BSIM3GdpPt);
+       (*DEVmatSlot(here->BSIM3GspPtr, trash, &scratch) += here->BSIM3GspPt);
+       (*DEVmatSlot(here->BSIM3SspPtr, trash, &scratch) -= here->BSIM3SspPt);
+       (*DEVmatSlot(here->BSIM3BgPtr, trash, &scratch) += here->BSIM3BgPt);
+       (*DEVmatSlot(here->BSIM3BdpPtr, trash, &scratch) += here->BSIM3BdpPt);
+       (*DEVmatSlot(here->BSIM3BspPtr, trash, &scratch) += here->BSIM3BspPt);
+       (*DEVmatSlot(here->BSIM3DPdPtr, trash, &scratch) -= here->BSIM3DPdPt);
+       (*DEVmatSlot(here->BSIM3DPgPtr, trash, &scratch) += here->BSIM3DPgPt);
+       (*DEVmatSlot(here->BSIM3DPbPtr, trash, &scratch) -= here->BSIM3DPbPt);
+       (*DEVmatSlot(here->BSIM3DPspPtr, trash, &scratch) -= here->BSIM3DPspPt);
+       (*DEVmatSlot(here->BSIM3SPgPtr, trash, &scratch) += here->BSIM3SPgPt);
+       (*DEVmatSlot(here->BSIM3SPsPtr, trash, &scratch) -= here->BSIM3SPsPt);
+       (*DEVmatSlot(here->BSIM3SPbPtr, trash, &scratch) -= here->BSIM3SPbPt);
+       (*DEVmatSlot(here->BSIM3SPdpPtr, trash, &scratch) -= here->BSIM3SPdpPt);
 
        if (here->BSIM3nqsMod)
-       {   *(here->BSIM3QqPtr) += here->BSIM3QqPt;
+       {   *DEVmatSlot(here->BSIM3QqPtr, trash, &scratch) += here->BSIM3QqPt;
 
-           *(here->BSIM3DPqPtr) += here->BSIM3DPqPt;
-           *(here->BSIM3SPqPtr) += here->BSIM3SPqPt;
-           *(here->BSIM3GqPtr) -= here->BSIM3GqPt;
+           *DEVmatSlot(here->BSIM3DPqPtr, trash, &scratch) += here->BSIM3DPqPt;
+           *DEVmatSlot(here->BSIM3SPqPtr, trash, &scratch) += here->BSIM3SPqPt;
+           *DEVmatSlot(here->BSIM3GqPtr, trash, &scratch) -= here->BSIM3GqPt;
 
-           *(here->BSIM3QgPtr) += here->BSIM3QgPt;
-           *(here->BSIM3QdpPtr) += here->BSIM3QdpPt;
-           *(here->BSIM3QspPtr) += here->BSIM3QspPt;
-           *(here->BSIM3QbPtr) += here->BSIM3QbPt;
+           *DEVmatSlot(here->BSIM3QgPtr, trash, &scratch) += here->BSIM3QgPt;
+           *DEVmatSlot(here->BSIM3QdpPtr, trash, &scratch) += here->BSIM3QdpPt;
+           *DEVmatSlot(here->BSIM3QspPtr, trash, &scratch) += here->BSIM3QspPt;
+           *DEVmatSlot(here->BSIM3QbPtr, trash, &scratch) += here->BSIM3QbPt;
        }
 
     }
 }
+
+void BSIM3LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM3model *model = (BSIM3model*)inModel;
+    int *ColorStart = model->BSIM3ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM3ColorCount; color++)
+        BSIM3LoadRhsMatRange(model->BSIM3InstanceArray, ColorStart[color],
+                             ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM3LoadRhsMatRange(model->BSIM3InstanceArray, ColorStart[model->BSIM3ColorCount],
+                         model->BSIM3InstCount, 0, ckt, trash);
+}
 #endif
@@ -1139,6 +1139,8 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
         model->BSIM3InstCount = 0;
         model->BSIM3InstanceArray = NULL;
+        model->BSIM3ColorCount = 0;
+        model->BSIM3ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM3instance*, InstCount);
     model = (BSIM3model*)inModel;
@@ -1157,6 +1159,11 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
     }
 
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM3model*)inModel;
+    model->BSIM3ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM3ColorStart);
 #endif
     return(OK);
 }
@@ -1172,6 +1179,7 @@ BSIM3unsetup(
 #ifdef USE_OMP
     model = (BSIM3model*)inModel;
     tfree(model->BSIM3InstanceArray);
+    tfree(model->BSIM3ColorStart);
 #endif
 
     for (model = (BSIM3model *)inModel; model != NULL;
@@ -921,6 +921,8 @@ typedef struct sBSIM3model
 #ifdef USE_OMP
     int BSIM3InstCount;
     struct sBSIM3instance **BSIM3InstanceArray;
+    int BSIM3ColorCount;
+    int *BSIM3ColorStart;
 #endif
 
     /* Flags */
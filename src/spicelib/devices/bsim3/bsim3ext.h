@@ -28,6 +28,11 @@ extern int BSIM3noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM3unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM3soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM3LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM3LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM3bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM3bindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -67,6 +67,11 @@ SPICEdev BSIM3info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM3LoadOMP,
+    .DEVloadStamp = BSIM3LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM3bindCSC,
     .DEVbindCSCComplex = BSIM3bindCSCComplex,
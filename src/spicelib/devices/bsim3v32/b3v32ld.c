@@ -31,11 +31,6 @@
 #define DELTA_3 0.02
 #define DELTA_4 0.02
 
-#ifdef USE_OMP
-int BSIM3v32LoadOMP(BSIM3v32instance *here, CKTcircuit *ckt);
-void BSIM3v32LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 int
 BSIM3v32load (GENmodel *inModel, CKTcircuit *ckt)
 {
@@ -49,7 +44,7 @@ BSIM3v32load (GENmodel *inModel, CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM3v32InstCount; idx++) {
         BSIM3v32instance *here = InstArray[idx];
-        int local_error = BSIM3v32LoadOMP(here, ckt);
+        int local_error = BSIM3v32LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -60,7 +55,8 @@ BSIM3v32load (GENmodel *inModel, CKTcircuit *ckt)
 }
 
 
-int BSIM3v32LoadOMP(BSIM3v32instance *here, CKTcircuit *ckt) {
+int BSIM3v32LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+    BSIM3v32instance *here = (BSIM3v32instance *) inInst;
     BSIM3v32model *model = BSIM3v32modPtr(here);
 #else
 BSIM3v32model *model = (BSIM3v32model*)inModel;
@@ -3448,65 +3444,80 @@ return(OK);
 }
 
 #ifdef USE_OMP
-void BSIM3v32LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM3v32LoadRhsMatRange(BSIM3v32instance **InstArray, int first, int last, int parallel,
+                        CKTcircuit *ckt, double *trash)
 {
-   int InstCount, idx;
-   BSIM3v32instance **InstArray;
-   BSIM3v32instance *here;
-   BSIM3v32model *model = (BSIM3v32model*)inModel;
+    int idx;
+    BSIM3v32instance *here;
 
-    InstArray = model->BSIM3v32InstanceArray;
-    InstCount = model->BSIM3v32InstCount;
+#pragma omp parallel for private(here) if (parallel)
+    for (idx = first; idx < last; idx++) {
+        double scratch;
 
-    for (idx = 0; idx < InstCount; idx++) {
         here = InstArray[idx];
-        model = BSIM3v32modPtr(here);
         /* Update b for Ax = b */
-        (*(ckt->CKTrhs + here->BSIM3v32gNode) -= here->BSIM3v32rhsG);
-        (*(ckt->CKTrhs + here->BSIM3v32bNode) -= here->BSIM3v32rhsB);
-        (*(ckt->CKTrhs + here->BSIM3v32dNodePrime) += here->BSIM3v32rhsD);
-        (*(ckt->CKTrhs + here->BSIM3v32sNodePrime) += here->BSIM3v32rhsS);
+        (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3v32gNode, &scratch) -= here->BSIM3v32rhsG);
+        (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3v32bNode, &scratch) -= here->BSIM3v32rhsB);
+        (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3v32dNodePrime, &scratch) += here->BSIM3v32rhsD);
+        (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3v32sNodePrime, &scratch) += here->BSIM3v32rhsS);
         if (here->BSIM3v32nqsMod)
-            (*(ckt->CKTrhs + here->BSIM3v32qNode) += here->BSIM3v32rhsQ);
+            (*DEVrhsSlot(ckt->CKTrhs, here->BSIM3v32qNode, &scratch) += here->BSIM3v32rhsQ);
 
         /* Update A for Ax = b */
-        (*(here->BSIM3v32DdPtr) += here->BSIM3v32DdPt);
-        (*(here->BSIM3v32GgPtr) += here->BSIM3v32GgPt);
-        (*(here->BSIM3v32SsPtr) += here->BSIM3v32SsPt);
-        (*(here->BSIM3v32BbPtr) += here->BSIM3v32BbPt);
-        (*(here->BSIM3v32DPdpPtr) += here->BSIM3v32DPdpPt);
-        (*(here->BSIM3v32SPspPtr) += here->BSIM3v32SPspPt);
-        (*(here->BSIM3v32DdpPtr) -= here->BSIM3v32DdpPt);
-        (*(here->BSIM3v32GbPtr) -= here->BSIM3v32GbPt);
-        (*(here->BSIM3v32GdpPtr) += here->BSIM3v32GdpPt);
-        (*(here->BSIM3v32GspPtr) += here->BSIM3v32GspPt);
-        (*(here->BSIM3v32SspPtr) -= here->BSIM3v32SspPt);
-        (*(here->BSIM3v32BgPtr) += here->BSIM3v32BgPt);
-        (*(here->BSIM3v32BdpPtr) += here->BSIM3v32BdpPt);
-        (*(here->BSIM3v32BspPtr) += here->BSIM3v32BspPt);
-        (*(here->BSIM3v32DPdPtr) -= here->BSIM3v32DPdPt);
-        (*(here->BSIM3v32DPgPtr) += here->BSIM3v32DPgPt);
-        (*(here->BSIM3v32DPbPtr) -= here->BSIM3v32DPbPt);
-        (*(here->BSIM3v32DPspPtr) -= here->BSIM3v32DPspPt);
-        (*(here->BSIM3v32SPgPtr) += here->BSIM3v32SPgPt);
-        (*(here->BSIM3v32SPsPtr) -= here->BSIM3v32SPsPt);
-        (*(here->BSIM3v32SPbPtr) -= here->BSIM3v32SPbPt);
-        (*(here->BSIM3v32SPdpPtr) -= here->BSIM3v32SPdpPt);
+        (*DEVmatSlot(here->BSIM3v32DdPtr, trash, &scratch) += here->BSIM3v32DdPt);
+        (*DEVmatSlot(here->BSIM3v32GgPtr, trash, &scratch) += here->BSIM3v32GgPt);
+        (*DEVmatSlot(here->BSIM3v32SsPtr, trash, &scratch) += here->BSIM3v32SsPt);
+        (*DEVmatSlot(here->BSIM3v32BbPtr, trash, &scratch) += here->BSIM3v32BbPt);
+        (*DEVmatSlot(here->BSIM3v32DPdpPtr, trash, &scratch) += here->BSIM3v32DPdpPt);
+        (*DEVmatSlot(here->BSIM3v32SPspPtr, trash, &scratch) += here->BSIM3v32SPspPt);
+        (*DEVmatSlot(here->BSIM3v32DdpPtr, trash, &scratch) -= here->BSIM3v32DdpPt);
+        (*DEVmatSlot(here->BSIM3v32GbPtr, trash, &scratch) -= here->BSIM3v32GbPt);
+        (*DEVmatSlot(here->BSIM3v32GdpPtr, trash, &scratch) += here->BSIM3v32GdpPt);
+        (*DEVmatSlot(here->BSIM3v32GspPtr, trash, &scratch) += here->BSIM3v32GspPt);
+        (*DEVmatSlot(here->BSIM3v32SspPtr, trash, &scratch) -= here->BSIM3v32SspPt);
+        (*DEVmatSlot(here->BSIM3v32BgPtr, trash, &scratch) += here->BSIM3v32BgPt);
+        (*DEVmatSlot(here->BSIM3v32BdpPtr, trash, &scratch) += here->BSIM3v32BdpPt);
+        (*DEVmatSlot(here->BSIM3v32BspPtr, trash, &scratch) += here->BSIM3v32BspPt);
+        (*DEVmatSlot(here->BSIM3v32DPdPtr, trash, &scratch) -= here->BSIM3v32DPdPt);
+        (*DEVmatSlot(here->BSIM3v32DPgPtr, trash, &scratch) += here->BSIM3v32DPgPt);
+        (*DEVmatSlot(here->BSIM3v32DPbPtr, trash, &scratch) -= here->BSIM3v32DPbPt);
+        (*DEVmatSlot(here->BSIM3v32DPspPtr, trash, &scratch) -= here->BSIM3v32DPspPt);
+        (*DEVmatSlot(here->BSIM3v32SPgPtr, trash, &scratch) += here->BSIM3v32SPgPt);
+        (*DEVmatSlot(here->BSIM3v32SPsPtr, trash, &scratch) -= here->BSIM3v32SPsPt);
+        (*DEVmatSlot(here->BSIM3v32SPbPtr, trash, &scratch) -= here->BSIM3v32SPbPt);
+        (*DEVmatSlot(here->BSIM3v32SPdpPtr, trash, &scratch) -= here->BSIM3v32SPdpPt);
 
         if (here->BSIM3v32nqsMod)
         {
-            *(here->BSIM3v32QqPtr) += here->BSIM3v32QqPt;
+            *DEVmatSlot(here->BSIM3v32QqPtr, trash, &scratch) += here->BSIM3v32QqPt;
 
-            *(here->BSIM3v32DPqPtr) += here->BSIM3v32DPqPt;
-            *(here->BSIM3v32SPqPtr) += here->BSIM3v32SPqPt;
-            *(here->BSIM3v32GqPtr) -= here->BSIM3v32GqPt;
+            *DEVmatSlot(here->BSIM3v32DPqPtr, trash, &scratch) += here->BSIM3v32DPqPt;
+            *DEVmatSlot(here->BSIM3v32SPqPtr, trash, &scratch) += here->BSIM3v32SPqPt;
+            *DEVmatSlot(here->BSIM3v32GqPtr, trash, &scratch) -= here->BSIM3v32GqPt;
 
-            *(here->BSIM3v32QgPtr) += here->BSIM3v32QgPt;
-            *(here->BSIM3v32QdpPtr) += here->BSIM3v32QdpPt;
-            *(here->BSIM3v32QspPtr) += here->BSIM3v32QspPt;
-            *(here->BSIM3v32QbPtr) += here->BSIM3v32QbPt;
+            *DEVmatSlot(here->BSIM3v32QgPtr, trash, &scratch) += here->BSIM3v32QgPt;
+            *DEVmatSlot(here->BSIM3v32QdpPtr, trash, &scratch) += here->BSIM3v32QdpPt;
+            *DEVmatSlot(here->BSIM3v32QspPtr, trash, &scratch) += here->BSIM3v32QspPt;
+            *DEVmatSlot(here->BSIM3v32QbPtr, trash, &scratch) += here->BSIM3v32QbPt;
         }
 
     }
 }
+
+void BSIM3v32LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM3v32model *model = (BSIM3v32model*)inModel;
+    int *ColorStart = model->BSIM3v32ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM3v32ColorCount; color++)
+        BSIM3v32LoadRhsMatRange(model->BSIM3v32InstanceArray, ColorStart[color],
+                                ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM3v32LoadRhsMatRange(model->BSIM3v32InstanceArray, ColorStart[model->BSIM3v32ColorCount],
+                            model->BSIM3v32InstCount, 0, ckt, trash);
+}
 #endif
@@ -22,6 +22,7 @@ BSIM3v32mDelete(GENmodel *gen_model)
 
 #ifdef USE_OMP
     FREE(model->BSIM3v32InstanceArray);
+    FREE(model->BSIM3v32ColorStart);
 #endif
 
     struct bsim3v32SizeDependParam *p =  model->pSizeDependParamKnot;
@@ -1151,6 +1151,8 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
         model->BSIM3v32InstCount = 0;
         model->BSIM3v32InstanceArray = NULL;
+        model->BSIM3v32ColorCount = 0;
+        model->BSIM3v32ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM3v32instance*, InstCount);
     model = (BSIM3v32model*)inModel;
@@ -1169,6 +1171,11 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
     }
 
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM3v32model*)inModel;
+    model->BSIM3v32ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM3v32ColorStart);
 #endif
     return(OK);
 }
@@ -1184,6 +1191,7 @@ BSIM3v32unsetup(
 #ifdef USE_OMP
     model = (BSIM3v32model*)inModel;
     tfree(model->BSIM3v32InstanceArray);
+    tfree(model->BSIM3v32ColorStart);
 #endif
 
     for (model = (BSIM3v32model *)inModel; model != NULL;
@@ -925,6 +925,8 @@ typedef struct sBSIM3v32model
 #ifdef USE_OMP
     int BSIM3v32InstCount;
     struct sBSIM3v32instance **BSIM3v32InstanceArray;
+    int BSIM3v32ColorCount;
+    int *BSIM3v32ColorStart;
 #endif
 
     /* Flags */
@@ -29,6 +29,11 @@ extern int BSIM3v32noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM3v32unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM3v32soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM3v32LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM3v32LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM3v32bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM3v32bindCSCComplex (GENmodel*, CKTcircuit*) ;
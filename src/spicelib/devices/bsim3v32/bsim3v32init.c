@@ -67,6 +67,11 @@ SPICEdev BSIM3v32info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM3v32LoadOMP,
+    .DEVloadStamp = BSIM3v32LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM3v32bindCSC,
     .DEVbindCSCComplex = BSIM3v32bindCSCComplex,
@@ -59,11 +59,6 @@ standard can be found at: http://www.si2.org/cmc
         }                                                                     \
     }
 
-#ifdef USE_OMP
-int BSIM4LoadOMP(BSIM4instance *here, CKTcircuit *ckt);
-void BSIM4LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 int BSIM4polyDepletion(double phi, double ngate,double epsgate, double coxe, double Vgs, double *Vgs_eff, double *dVgs_eff_dVg);
 
 int
@@ -81,7 +76,7 @@ CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM4InstCount; idx++) {
         BSIM4instance *here = InstArray[idx];
-        int local_error = BSIM4LoadOMP(here, ckt);
+        int local_error = BSIM4LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -91,7 +86,8 @@ CKTcircuit *ckt)
     return error;
 }
 
-int BSIM4LoadOMP(BSIM4instance *here, CKTcircuit *ckt) {
+int BSIM4LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+BSIM4instance *here = (BSIM4instance *) inInst;
 BSIM4model *model = BSIM4modPtr(here);
 #else
 BSIM4model *model = (BSIM4model*)inModel;
@@ -5433,191 +5429,208 @@ int BSIM4polyDepletion(
 }
 
 #ifdef USE_OMP
-void BSIM4LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM4LoadRhsMatRange(BSIM4instance **InstArray, int first, int last, int parallel,
+                     CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    BSIM4instance **InstArray;
+    int idx;
     BSIM4instance *here;
-    BSIM4model *model = (BSIM4model*)inModel;
+    BSIM4model *model;
 
-    InstArray = model->BSIM4InstanceArray;
-    InstCount = model->BSIM4InstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = BSIM4modPtr(here);
         /* Update b for Ax = b */
-           (*(ckt->CKTrhs + here->BSIM4dNodePrime) += here->BSIM4rhsdPrime);
-           (*(ckt->CKTrhs + here->BSIM4gNodePrime) -= here->BSIM4rhsgPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4dNodePrime, &scratch) += here->BSIM4rhsdPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4gNodePrime, &scratch) -= here->BSIM4rhsgPrime);
 
            if (here->BSIM4rgateMod == 2)
-               (*(ckt->CKTrhs + here->BSIM4gNodeExt) -= here->BSIM4rhsgExt);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4gNodeExt, &scratch) -= here->BSIM4rhsgExt);
            else if (here->BSIM4rgateMod == 3)
-               (*(ckt->CKTrhs + here->BSIM4gNodeMid) -= here->BSIM4grhsMid);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4gNodeMid, &scratch) -= here->BSIM4grhsMid);
 
            if (!here->BSIM4rbodyMod)
-           {   (*(ckt->CKTrhs + here->BSIM4bNodePrime) += here->BSIM4rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4sNodePrime) += here->BSIM4rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4bNodePrime, &scratch) += here->BSIM4rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4sNodePrime, &scratch) += here->BSIM4rhssPrime);
            }
            else
-           {   (*(ckt->CKTrhs + here->BSIM4dbNode) -= here->BSIM4rhsdb);
-               (*(ckt->CKTrhs + here->BSIM4bNodePrime) += here->BSIM4rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4sbNode) -= here->BSIM4rhssb);
-               (*(ckt->CKTrhs + here->BSIM4sNodePrime) += here->BSIM4rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4dbNode, &scratch) -= here->BSIM4rhsdb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4bNodePrime, &scratch) += here->BSIM4rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4sbNode, &scratch) -= here->BSIM4rhssb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4sNodePrime, &scratch) += here->BSIM4rhssPrime);
            }
 
            if (model->BSIM4rdsMod)
-           {   (*(ckt->CKTrhs + here->BSIM4dNode) -= here->BSIM4rhsd);
-               (*(ckt->CKTrhs + here->BSIM4sNode) += here->BSIM4rhss);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4dNode, &scratch) -= here->BSIM4rhsd);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4sNode, &scratch) += here->BSIM4rhss);
            }
 
            if (here->BSIM4trnqsMod)
-               *(ckt->CKTrhs + here->BSIM4qNode) += here->BSIM4rhsq;
+               *DEVrhsSlot(ckt->CKTrhs, here->BSIM4qNode, &scratch) += here->BSIM4rhsq;
 
 
         /* Update A for Ax = b */
            if (here->BSIM4rgateMod == 1)
-           {   (*(here->BSIM4GEgePtr) += here->BSIM4_1);
-               (*(here->BSIM4GPgePtr) -= here->BSIM4_2);
-               (*(here->BSIM4GEgpPtr) -= here->BSIM4_3);
-               (*(here->BSIM4GPgpPtr) += here->BSIM4_4);
-               (*(here->BSIM4GPdpPtr) += here->BSIM4_5);
-               (*(here->BSIM4GPspPtr) += here->BSIM4_6);
-               (*(here->BSIM4GPbpPtr) += here->BSIM4_7);
+           {   (*DEVmatSlot(here->BSIM4GEgePtr, trash, &scratch) += here->BSIM4_1);
+               (*DEVmatSlot(here->BSIM4GPgePtr, trash, &scratch) -= here->BSIM4_2);
+               (*DEVmatSlot(here->BSIM4GEgpPtr, trash, &scratch) -= here->BSIM4_3);
+               (*DEVmatSlot(here->BSIM4GPgpPtr, trash, &scratch) += here->BSIM4_4);
+               (*DEVmatSlot(here->BSIM4GPdpPtr, trash, &scratch) += here->BSIM4_5);
+               (*DEVmatSlot(here->BSIM4GPspPtr, trash, &scratch) += here->BSIM4_6);
+               (*DEVmatSlot(here->BSIM4GPbpPtr, trash, &scratch) += here->BSIM4_7);
            }
            else if (here->BSIM4rgateMod == 2)
-           {   (*(here->BSIM4GEgePtr) += here->BSIM4_8);
-               (*(here->BSIM4GEgpPtr) += here->BSIM4_9);
-               (*(here->BSIM4GEdpPtr) += here->BSIM4_10);
-               (*(here->BSIM4GEspPtr) += here->BSIM4_11);
-               (*(here->BSIM4GEbpPtr) += here->BSIM4_12);
-
-               (*(here->BSIM4GPgePtr) -= here->BSIM4_13);
-               (*(here->BSIM4GPgpPtr) += here->BSIM4_14);
-               (*(here->BSIM4GPdpPtr) += here->BSIM4_15);
-               (*(here->BSIM4GPspPtr) += here->BSIM4_16);
-               (*(here->BSIM4GPbpPtr) += here->BSIM4_17);
+           {   (*DEVmatSlot(here->BSIM4GEgePtr, trash, &scratch) += here->BSIM4_8);
+               (*DEVmatSlot(here->BSIM4GEgpPtr, trash, &scratch) += here->BSIM4_9);
+               (*DEVmatSlot(here->BSIM4GEdpPtr, trash, &scratch) += here->BSIM4_10);
+               (*DEVmatSlot(here->BSIM4GEspPtr, trash, &scratch) += here->BSIM4_11);
+               (*DEVmatSlot(here->BSIM4GEbpPtr, trash, &scratch) += here->BSIM4_12);
+
+               (*DEVmatSlot(here->BSIM4GPgePtr, trash, &scratch) -= here->BSIM4_13);
+               (*DEVmatSlot(here->BSIM4GPgpPtr, trash, &scratch) += here->BSIM4_14);
+               (*DEVmatSlot(here->BSIM4GPdpPtr, trash, &scratch) += here->BSIM4_15);
+               (*DEVmatSlot(here->BSIM4GPspPtr, trash, &scratch) += here->BSIM4_16);
+               (*DEVmatSlot(here->BSIM4GPbpPtr, trash, &scratch) += here->BSIM4_17);
            }
            else if (here->BSIM4rgateMod == 3)
-           {   (*(here->BSIM4GEgePtr) += here->BSIM4_18);
-               (*(here->BSIM4GEgmPtr) -= here->BSIM4_19);
-               (*(here->BSIM4GMgePtr) -= here->BSIM4_20);
-               (*(here->BSIM4GMgmPtr) += here->BSIM4_21);
-
-               (*(here->BSIM4GMdpPtr) += here->BSIM4_22);
-               (*(here->BSIM4GMgpPtr) += here->BSIM4_23);
-               (*(here->BSIM4GMspPtr) += here->BSIM4_24);
-               (*(here->BSIM4GMbpPtr) += here->BSIM4_25);
-
-               (*(here->BSIM4DPgmPtr) += here->BSIM4_26);
-               (*(here->BSIM4GPgmPtr) -= here->BSIM4_27);
-               (*(here->BSIM4SPgmPtr) += here->BSIM4_28);
-               (*(here->BSIM4BPgmPtr) += here->BSIM4_29);
-
-               (*(here->BSIM4GPgpPtr) += here->BSIM4_30);
-               (*(here->BSIM4GPdpPtr) += here->BSIM4_31);
-               (*(here->BSIM4GPspPtr) += here->BSIM4_32);
-               (*(here->BSIM4GPbpPtr) += here->BSIM4_33);
+           {   (*DEVmatSlot(here->BSIM4GEgePtr, trash, &scratch) += here->BSIM4_18);
+               (*DEVmatSlot(here->BSIM4GEgmPtr, trash, &scratch) -= here->BSIM4_19);
+               (*DEVmatSlot(here->BSIM4GMgePtr, trash, &scratch) -= here->BSIM4_20);
+               (*DEVmatSlot(here->BSIM4GMgmPtr, trash, &scratch) += here->BSIM4_21);
+
+               (*DEVmatSlot(here->BSIM4GMdpPtr, trash, &scratch) += here->BSIM4_22);
+               (*DEVmatSlot(here->BSIM4GMgpPtr, trash, &scratch) += here->BSIM4_23);
+               (*DEVmatSlot(here->BSIM4GMspPtr, trash, &scratch) += here->BSIM4_24);
+               (*DEVmatSlot(here->BSIM4GMbpPtr, trash, &scratch) += here->BSIM4_25);
+
+               (*DEVmatSlot(here->BSIM4DPgmPtr, trash, &scratch) += here->BSIM4_26);
+               (*DEVmatSlot(here->BSIM4GPgmPtr, trash, &scratch) -= here->BSIM4_27);
+               (*DEVmatSlot(here->BSIM4SPgmPtr, trash, &scratch) += here->BSIM4_28);
+               (*DEVmatSlot(here->BSIM4BPgmPtr, trash, &scratch) += here->BSIM4_29);
+
+               (*DEVmatSlot(here->BSIM4GPgpPtr, trash, &scratch) += here->BSIM4_30);
+               (*DEVmatSlot(here->BSIM4GPdpPtr, trash, &scratch) += here->BSIM4_31);
+               (*DEVmatSlot(here->BSIM4GPspPtr, trash, &scratch) += here->BSIM4_32);
+               (*DEVmatSlot(here->BSIM4GPbpPtr, trash, &scratch) += here->BSIM4_33);
            }
 
 
             else
-           {   (*(here->BSIM4GPgpPtr) += here->BSIM4_34);
-               (*(here->BSIM4GPdpPtr) += here->BSIM4_35);
-               (*(here->BSIM4GPspPtr) += here->BSIM4_36);
-               (*(here->BSIM4GPbpPtr) += here->BSIM4_37);
+           {   (*DEVmatSlot(here->BSIM4GPgpPtr, trash, &scratch) += here->BSIM4_34);
+               (*DEVmatSlot(here->BSIM4GPdpPtr, trash, &scratch) += here->BSIM4_35);
+               (*DEVmatSlot(here->BSIM4GPspPtr, trash, &scratch) += here->BSIM4_36);
+               (*DEVmatSlot(here->BSIM4GPbpPtr, trash, &scratch) += here->BSIM4_37);
            }
 
 
            if (model->BSIM4rdsMod)
-           {   (*(here->BSIM4DgpPtr) += here->BSIM4_38);
-               (*(here->BSIM4DspPtr) += here->BSIM4_39);
-               (*(here->BSIM4DbpPtr) += here->BSIM4_40);
-               (*(here->BSIM4SdpPtr) += here->BSIM4_41);
-               (*(here->BSIM4SgpPtr) += here->BSIM4_42);
-               (*(here->BSIM4SbpPtr) += here->BSIM4_43);
+           {   (*DEVmatSlot(here->BSIM4DgpPtr, trash, &scratch) += here->BSIM4_38);
+               (*DEVmatSlot(here->BSIM4DspPtr, trash, &scratch) += here->BSIM4_39);
+               (*DEVmatSlot(here->BSIM4DbpPtr, trash, &scratch) += here->BSIM4_40);
+               (*DEVmatSlot(here->BSIM4SdpPtr, trash, &scratch) += here->BSIM4_41);
+               (*DEVmatSlot(here->BSIM4SgpPtr, trash, &scratch) += here->BSIM4_42);
+               (*DEVmatSlot(here->BSIM4SbpPtr, trash, &scratch) += here->BSIM4_43);
            }
 
-           (*(here->BSIM4DPdpPtr) += here->BSIM4_44);
-           (*(here->BSIM4DPdPtr) -= here->BSIM4_45);
-           (*(here->BSIM4DPgpPtr) += here->BSIM4_46);
-           (*(here->BSIM4DPspPtr) -= here->BSIM4_47);
-           (*(here->BSIM4DPbpPtr) -= here->BSIM4_48);
+           (*DEVmatSlot(here->BSIM4DPdpPtr, trash, &scratch) += here->BSIM4_44);
+           (*DEVmatSlot(here->BSIM4DPdPtr, trash, &scratch) -= here->BSIM4_45);
+           (*DEVmatSlot(here->BSIM4DPgpPtr, trash, &scratch) += here->BSIM4_46);
+           (*DEVmatSlot(here->BSIM4DPspPtr, trash, &scratch) -= here->BSIM4_47);
+           (*DEVmatSlot(here->BSIM4DPbpPtr, trash, &scratch) -= here->BSIM4_48);
 
-           (*(here->BSIM4DdpPtr) -= here->BSIM4_49);
-           (*(here->BSIM4DdPtr) += here->BSIM4_50);
+           (*DEVmatSlot(here->BSIM4DdpPtr, trash, &scratch) -= here->BSIM4_49);
+           (*DEVmatSlot(here->BSIM4DdPtr, trash, &scratch) += here->BSIM4_50);
 
-           (*(here->BSIM4SPdpPtr) -= here->BSIM4_51);
-           (*(here->BSIM4SPgpPtr) += here->BSIM4_52);
-           (*(here->BSIM4SPspPtr) += here->BSIM4_53);
-           (*(here->BSIM4SPsPtr) -= here->BSIM4_54);
-           (*(here->BSIM4SPbpPtr) -= here->BSIM4_55);
+           (*DEVmatSlot(here->BSIM4SPdpPtr, trash, &scratch) -= here->BSIM4_51);
+           (*DEVmatSlot(here->BSIM4SPgpPtr, trash, &scratch) += here->BSIM4_52);
+           (*DEVmatSlot(here->BSIM4SPspPtr, trash, &scratch) += here->BSIM4_53);
+           (*DEVmatSlot(here->BSIM4SPsPtr, trash, &scratch) -= here->BSIM4_54);
+           (*DEVmatSlot(here->BSIM4SPbpPtr, trash, &scratch) -= here->BSIM4_55);
 
-           (*(here->BSIM4SspPtr) -= here->BSIM4_56);
-           (*(here->BSIM4SsPtr) += here->BSIM4_57);
+           (*DEVmatSlot(here->BSIM4SspPtr, trash, &scratch) -= here->BSIM4_56);
+           (*DEVmatSlot(here->BSIM4SsPtr, trash, &scratch) += here->BSIM4_57);
 
-           (*(here->BSIM4BPdpPtr) += here->BSIM4_58);
-           (*(here->BSIM4BPgpPtr) += here->BSIM4_59);
-           (*(here->BSIM4BPspPtr) += here->BSIM4_60);
-           (*(here->BSIM4BPbpPtr) += here->BSIM4_61);
+           (*DEVmatSlot(here->BSIM4BPdpPtr, trash, &scratch) += here->BSIM4_58);
+           (*DEVmatSlot(here->BSIM4BPgpPtr, trash, &scratch) += here->BSIM4_59);
+           (*DEVmatSlot(here->BSIM4BPspPtr, trash, &scratch) += here->BSIM4_60);
+           (*DEVmatSlot(here->BSIM4BPbpPtr, trash, &scratch) += here->BSIM4_61);
 
            /* stamp gidl */
-           (*(here->BSIM4DPdpPtr) += here->BSIM4_62);
-           (*(here->BSIM4DPgpPtr) += here->BSIM4_63);
-           (*(here->BSIM4DPspPtr) -= here->BSIM4_64);
-           (*(here->BSIM4DPbpPtr) += here->BSIM4_65);
-           (*(here->BSIM4BPdpPtr) -= here->BSIM4_66);
-           (*(here->BSIM4BPgpPtr) -= here->BSIM4_67);
-           (*(here->BSIM4BPspPtr) += here->BSIM4_68);
-           (*(here->BSIM4BPbpPtr) -= here->BSIM4_69);
+           (*DEVmatSlot(here->BSIM4DPdpPtr, trash, &scratch) += here->BSIM4_62);
+           (*DEVmatSlot(here->BSIM4DPgpPtr, trash, &scratch) += here->BSIM4_63);
+           (*DEVmatSlot(here->BSIM4DPspPtr, trash, &scratch) -= here->BSIM4_64);
+           (*DEVmatSlot(here->BSIM4DPbpPtr, trash, &scratch) += here->BSIM4_65);
+           (*DEVmatSlot(here->BSIM4BPdpPtr, trash, &scratch) -= here->BSIM4_66);
+           (*DEVmatSlot(here->BSIM4BPgpPtr, trash, &scratch) -= here->BSIM4_67);
+           (*DEVmatSlot(here->BSIM4BPspPtr, trash, &scratch) += here->BSIM4_68);
+           (*DEVmatSlot(here->BSIM4BPbpPtr, trash, &scratch) -= here->BSIM4_69);
             /* stamp gisl */
-           (*(here->BSIM4SPdpPtr) -= here->BSIM4_70);
-           (*(here->BSIM4SPgpPtr) += here->BSIM4_71);
-           (*(here->BSIM4SPspPtr) += here->BSIM4_72);
-           (*(here->BSIM4SPbpPtr) += here->BSIM4_73);
-           (*(here->BSIM4BPdpPtr) += here->BSIM4_74);
-           (*(here->BSIM4BPgpPtr) -= here->BSIM4_75);
-           (*(here->BSIM4BPspPtr) -= here->BSIM4_76);
-           (*(here->BSIM4BPbpPtr) -= here->BSIM4_77);
+           (*DEVmatSlot(here->BSIM4SPdpPtr, trash, &scratch) -= here->BSIM4_70);
+           (*DEVmatSlot(here->BSIM4SPgpPtr, trash, &scratch) += here->BSIM4_71);
+           (*DEVmatSlot(here->BSIM4SPspPtr, trash, &scratch) += here->BSIM4_72);
+           (*DEVmatSlot(here->BSIM4SPbpPtr, trash, &scratch) += here->BSIM4_73);
+           (*DEVmatSlot(here->BSIM4BPdpPtr, trash, &scratch) += here->BSIM4_74);
+           (*DEVmatSlot(here->BSIM4BPgpPtr, trash, &scratch) -= here->BSIM4_75);
+           (*DEVmatSlot(here->BSIM4BPspPtr, trash, &scratch) -= here->BSIM4_76);
+           (*DEVmatSlot(here->BSIM4BPbpPtr, trash, &scratch) -= here->BSIM4_77);
 
 
            if (here->BSIM4rbodyMod)
-           {   (*(here->BSIM4DPdbPtr) += here->BSIM4_78);
-               (*(here->BSIM4SPsbPtr) -= here->BSIM4_79);
-
-               (*(here->BSIM4DBdpPtr) += here->BSIM4_80);
-               (*(here->BSIM4DBdbPtr) += here->BSIM4_81);
-               (*(here->BSIM4DBbpPtr) -= here->BSIM4_82);
-               (*(here->BSIM4DBbPtr) -= here->BSIM4_83);
-
-               (*(here->BSIM4BPdbPtr) -= here->BSIM4_84);
-               (*(here->BSIM4BPbPtr) -= here->BSIM4_85);
-               (*(here->BSIM4BPsbPtr) -= here->BSIM4_86);
-               (*(here->BSIM4BPbpPtr) += here->BSIM4_87);
-
-               (*(here->BSIM4SBspPtr) += here->BSIM4_88);
-               (*(here->BSIM4SBbpPtr) -= here->BSIM4_89);
-               (*(here->BSIM4SBbPtr) -= here->BSIM4_90);
-               (*(here->BSIM4SBsbPtr) += here->BSIM4_91);
-
-               (*(here->BSIM4BdbPtr) -= here->BSIM4_92);
-               (*(here->BSIM4BbpPtr) -= here->BSIM4_93);
-               (*(here->BSIM4BsbPtr) -= here->BSIM4_94);
-               (*(here->BSIM4BbPtr) += here->BSIM4_95);
+           {   (*DEVmatSlot(here->BSIM4DPdbPtr, trash, &scratch) += here->BSIM4_78);
+               (*DEVmatSlot(here->BSIM4SPsbPtr, trash, &scratch) -= here->BSIM4_79);
+
+               (*DEVmatSlot(here->BSIM4DBdpPtr, trash, &scratch) += here->BSIM4_80);
+               (*DEVmatSlot(here->BSIM4DBdbPtr, trash, &scratch) += here->BSIM4_81);
+               (*DEVmatSlot(here->BSIM4DBbpPtr, trash, &scratch) -= here->BSIM4_82);
+               (*DEVmatSlot(here->BSIM4DBbPtr, trash, &scratch) -= here->BSIM4_83);
+
+               (*DEVmatSlot(here->BSIM4BPdbPtr, trash, &scratch) -= here->BSIM4_84);
+               (*DEVmatSlot(here->BSIM4BPbPtr, trash, &scratch) -= here->BSIM4_85);
+               (*DEVmatSlot(here->BSIM4BPsbPtr, trash, &scratch) -= here->BSIM4_86);
+               (*DEVmatSlot(here->BSIM4BPbpPtr, trash, &scratch) += here->BSIM4_87);
+
+               (*DEVmatSlot(here->BSIM4SBspPtr, trash, &scratch) += here->BSIM4_88);
+               (*DEVmatSlot(here->BSIM4SBbpPtr, trash, &scratch) -= here->BSIM4_89);
+               (*DEVmatSlot(here->BSIM4SBbPtr, trash, &scratch) -= here->BSIM4_90);
+               (*DEVmatSlot(here->BSIM4SBsbPtr, trash, &scratch) += here->BSIM4_91);
+
+               (*DEVmatSlot(here->BSIM4BdbPtr, trash, &scratch) -= here->BSIM4_92);
+               (*DEVmatSlot(here->BSIM4BbpPtr, trash, &scratch) -= here->BSIM4_93);
+               (*DEVmatSlot(here->BSIM4BsbPtr, trash, &scratch) -= here->BSIM4_94);
+               (*DEVmatSlot(here->BSIM4BbPtr, trash, &scratch) += here->BSIM4_95);
            }
 
            if (here->BSIM4trnqsMod)
-           {   (*(here->BSIM4QqPtr) += here->BSIM4_96);
-               (*(here->BSIM4QgpPtr) += here->BSIM4_97);
-               (*(here->BSIM4QdpPtr) += here->BSIM4_98);
-               (*(here->BSIM4QspPtr) += here->BSIM4_99);
-               (*(here->BSIM4QbpPtr) += here->BSIM4_100);
-
-               (*(here->BSIM4DPqPtr) += here->BSIM4_101);
-               (*(here->BSIM4SPqPtr) += here->BSIM4_102);
-               (*(here->BSIM4GPqPtr) -= here->BSIM4_103);
+           {   (*DEVmatSlot(here->BSIM4QqPtr, trash, &scratch) += here->BSIM4_96);
+               (*DEVmatSlot(here->BSIM4QgpPtr, trash, &scratch) += here->BSIM4_97);
+               (*DEVmatSlot(here->BSIM4QdpPtr, trash, &scratch) += here->BSIM4_98);
+               (*DEVmatSlot(here->BSIM4QspPtr, trash, &scratch) += here->BSIM4_99);
+               (*DEVmatSlot(here->BSIM4QbpPtr, trash, &scratch) += here->BSIM4_100);
+
+               (*DEVmatSlot(here->BSIM4DPqPtr, trash, &scratch) += here->BSIM4_101);
+               (*DEVmatSlot(here->BSIM4SPqPtr, trash, &scratch) += here->BSIM4_102);
+               (*DEVmatSlot(here->BSIM4GPqPtr, trash, &scratch) -= here->BSIM4_103);
            }
     }
 }
 
+void BSIM4LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM4model *model = (BSIM4model*)inModel;
+    int *ColorStart = model->BSIM4ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM4ColorCount; color++)
+        BSIM4LoadRhsMatRange(model->BSIM4InstanceArray, ColorStart[color],
+                             ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM4LoadRhsMatRange(model->BSIM4InstanceArray, ColorStart[model->BSIM4ColorCount],
+                         model->BSIM4InstCount, 0, ckt, trash);
+}
+
 #endif
@@ -35,6 +35,7 @@ BSIM4mDelete(GENmodel *gen_model)
 
 #ifdef USE_OMP
     FREE(model->BSIM4InstanceArray);
+    FREE(model->BSIM4ColorStart);
 #endif
 
     struct bsim4SizeDependParam *p = model->pSizeDependParamKnot;
@@ -28,6 +28,7 @@ standard can be found at: http://www.si2.org/cmc
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "bsim4def.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
@@ -2694,6 +2695,8 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
         }
         model->BSIM4InstCount = 0;
         model->BSIM4InstanceArray = NULL;
+        model->BSIM4ColorCount = 0;
+        model->BSIM4ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM4instance*, InstCount);
     model = (BSIM4model*)inModel;
@@ -2711,6 +2714,11 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM4model*)inModel;
+    model->BSIM4ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM4ColorStart);
 #endif
 
     return(OK);
@@ -2727,6 +2735,7 @@ BSIM4unsetup(
 #ifdef USE_OMP
     model = (BSIM4model*)inModel;
     tfree(model->BSIM4InstanceArray);
+    tfree(model->BSIM4ColorStart);
 #endif
 
     for (model = (BSIM4model *)inModel; model != NULL;
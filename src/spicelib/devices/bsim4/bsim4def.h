@@ -1897,6 +1897,8 @@ typedef struct sBSIM4model
 #ifdef USE_OMP
     int BSIM4InstCount;
     struct sBSIM4instance **BSIM4InstanceArray;
+    int BSIM4ColorCount;
+    int *BSIM4ColorStart;
 #endif
 
     /* Flags */
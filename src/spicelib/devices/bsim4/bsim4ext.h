@@ -45,6 +45,11 @@ extern int BSIM4noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM4unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM4soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM4LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM4LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM4bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM4bindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -67,6 +67,11 @@ SPICEdev BSIM4info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM4LoadOMP,
+    .DEVloadStamp = BSIM4LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM4bindCSC,
     .DEVbindCSCComplex = BSIM4bindCSCComplex,
@@ -50,11 +50,6 @@
         }                                                                     \
     }
 
-#ifdef USE_OMP
-int BSIM4v5LoadOMP(BSIM4v5instance *here, CKTcircuit *ckt);
-void BSIM4v5LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 int BSIM4v5polyDepletion(double phi, double ngate,double coxe, double Vgs, double *Vgs_eff, double *dVgs_eff_dVg);
 
 int
@@ -72,7 +67,7 @@ CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM4v5InstCount; idx++) {
         BSIM4v5instance *here = InstArray[idx];
-        int local_error = BSIM4v5LoadOMP(here, ckt);
+        int local_error = BSIM4v5LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -83,7 +78,8 @@ CKTcircuit *ckt)
 }
 
 
-int BSIM4v5LoadOMP(BSIM4v5instance *here, CKTcircuit *ckt) {
+int BSIM4v5LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+BSIM4v5instance *here = (BSIM4v5instance *) inInst;
 BSIM4v5model *model = BSIM4v5modPtr(here);
 #else
 BSIM4v5model *model = (BSIM4v5model*)inModel;
@@ -4989,193 +4985,210 @@ return(OK);
 
 
 #ifdef USE_OMP
-void BSIM4v5LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM4v5LoadRhsMatRange(BSIM4v5instance **InstArray, int first, int last, int parallel,
+                       CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    BSIM4v5instance **InstArray;
+    int idx;
     BSIM4v5instance *here;
-    BSIM4v5model *model = (BSIM4v5model*)inModel;
+    BSIM4v5model *model;
 
-    InstArray = model->BSIM4v5InstanceArray;
-    InstCount = model->BSIM4v5InstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = BSIM4v5modPtr(here);
         /* Update b for Ax = b */
-           (*(ckt->CKTrhs + here->BSIM4v5dNodePrime) += here->BSIM4v5rhsdPrime);
-           (*(ckt->CKTrhs + here->BSIM4v5gNodePrime) -= here->BSIM4v5rhsgPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5dNodePrime, &scratch) += here->BSIM4v5rhsdPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5gNodePrime, &scratch) -= here->BSIM4v5rhsgPrime);
 
            if (here->BSIM4v5rgateMod == 2)
-               (*(ckt->CKTrhs + here->BSIM4v5gNodeExt) -= here->BSIM4v5rhsgExt);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5gNodeExt, &scratch) -= here->BSIM4v5rhsgExt);
            else if (here->BSIM4v5rgateMod == 3)
-               (*(ckt->CKTrhs + here->BSIM4v5gNodeMid) -= here->BSIM4v5grhsMid);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5gNodeMid, &scratch) -= here->BSIM4v5grhsMid);
 
            if (!here->BSIM4v5rbodyMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v5bNodePrime) += here->BSIM4v5rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v5sNodePrime) += here->BSIM4v5rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5bNodePrime, &scratch) += here->BSIM4v5rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5sNodePrime, &scratch) += here->BSIM4v5rhssPrime);
            }
            else
-           {   (*(ckt->CKTrhs + here->BSIM4v5dbNode) -= here->BSIM4v5rhsdb);
-               (*(ckt->CKTrhs + here->BSIM4v5bNodePrime) += here->BSIM4v5rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v5sbNode) -= here->BSIM4v5rhssb);
-               (*(ckt->CKTrhs + here->BSIM4v5sNodePrime) += here->BSIM4v5rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5dbNode, &scratch) -= here->BSIM4v5rhsdb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5bNodePrime, &scratch) += here->BSIM4v5rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5sbNode, &scratch) -= here->BSIM4v5rhssb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5sNodePrime, &scratch) += here->BSIM4v5rhssPrime);
            }
 
            if (model->BSIM4v5rdsMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v5dNode) -= here->BSIM4v5rhsd);
-               (*(ckt->CKTrhs + here->BSIM4v5sNode) += here->BSIM4v5rhss);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5dNode, &scratch) -= here->BSIM4v5rhsd);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5sNode, &scratch) += here->BSIM4v5rhss);
            }
 
            if (here->BSIM4v5trnqsMod)
-               *(ckt->CKTrhs + here->BSIM4v5qNode) += here->BSIM4v5rhsq;
+               *DEVrhsSlot(ckt->CKTrhs, here->BSIM4v5qNode, &scratch) += here->BSIM4v5rhsq;
 
 
         /* Update A for Ax = b */
            if (here->BSIM4v5rgateMod == 1)
-           {   (*(here->BSIM4v5GEgePtr) += here->BSIM4v5_1);
-               (*(here->BSIM4v5GPgePtr) -= here->BSIM4v5_2);
-               (*(here->BSIM4v5GEgpPtr) -= here->BSIM4v5_3);
-               (*(here->BSIM4v5GPgpPtr) += here->BSIM4v5_4);
-               (*(here->BSIM4v5GPdpPtr) += here->BSIM4v5_5);
-               (*(here->BSIM4v5GPspPtr) += here->BSIM4v5_6);
-               (*(here->BSIM4v5GPbpPtr) += here->BSIM4v5_7);
+           {   (*DEVmatSlot(here->BSIM4v5GEgePtr, trash, &scratch) += here->BSIM4v5_1);
+               (*DEVmatSlot(here->BSIM4v5GPgePtr, trash, &scratch) -= here->BSIM4v5_2);
+               (*DEVmatSlot(here->BSIM4v5GEgpPtr, trash, &scratch) -= here->BSIM4v5_3);
+               (*DEVmatSlot(here->BSIM4v5GPgpPtr, trash, &scratch) += here->BSIM4v5_4);
+               (*DEVmatSlot(here->BSIM4v5GPdpPtr, trash, &scratch) += here->BSIM4v5_5);
+               (*DEVmatSlot(here->BSIM4v5GPspPtr, trash, &scratch) += here->BSIM4v5_6);
+               (*DEVmatSlot(here->BSIM4v5GPbpPtr, trash, &scratch) += here->BSIM4v5_7);
            }
            else if (here->BSIM4v5rgateMod == 2)
-           {   (*(here->BSIM4v5GEgePtr) += here->BSIM4v5_8);
-               (*(here->BSIM4v5GEgpPtr) += here->BSIM4v5_9);
-               (*(here->BSIM4v5GEdpPtr) += here->BSIM4v5_10);
-               (*(here->BSIM4v5GEspPtr) += here->BSIM4v5_11);
-               (*(here->BSIM4v5GEbpPtr) += here->BSIM4v5_12);
-
-               (*(here->BSIM4v5GPgePtr) -= here->BSIM4v5_13);
-               (*(here->BSIM4v5GPgpPtr) += here->BSIM4v5_14);
-               (*(here->BSIM4v5GPdpPtr) += here->BSIM4v5_15);
-               (*(here->BSIM4v5GPspPtr) += here->BSIM4v5_16);
-               (*(here->BSIM4v5GPbpPtr) += here->BSIM4v5_17);
+           {   (*DEVmatSlot(here->BSIM4v5GEgePtr, trash, &scratch) += here->BSIM4v5_8);
+               (*DEVmatSlot(here->BSIM4v5GEgpPtr, trash, &scratch) += here->BSIM4v5_9);
+               (*DEVmatSlot(here->BSIM4v5GEdpPtr, trash, &scratch) += here->BSIM4v5_10);
+               (*DEVmatSlot(here->BSIM4v5GEspPtr, trash, &scratch) += here->BSIM4v5_11);
+               (*DEVmatSlot(here->BSIM4v5GEbpPtr, trash, &scratch) += here->BSIM4v5_12);
+
+               (*DEVmatSlot(here->BSIM4v5GPgePtr, trash, &scratch) -= here->BSIM4v5_13);
+               (*DEVmatSlot(here->BSIM4v5GPgpPtr, trash, &scratch) += here->BSIM4v5_14);
+               (*DEVmatSlot(here->BSIM4v5GPdpPtr, trash, &scratch) += here->BSIM4v5_15);
+               (*DEVmatSlot(here->BSIM4v5GPspPtr, trash, &scratch) += here->BSIM4v5_16);
+               (*DEVmatSlot(here->BSIM4v5GPbpPtr, trash, &scratch) += here->BSIM4v5_17);
            }
            else if (here->BSIM4v5rgateMod == 3)
-           {   (*(here->BSIM4v5GEgePtr) += here->BSIM4v5_18);
-               (*(here->BSIM4v5GEgmPtr) -= here->BSIM4v5_19);
-               (*(here->BSIM4v5GMgePtr) -= here->BSIM4v5_20);
-               (*(here->BSIM4v5GMgmPtr) += here->BSIM4v5_21);
-
-               (*(here->BSIM4v5GMdpPtr) += here->BSIM4v5_22);
-               (*(here->BSIM4v5GMgpPtr) += here->BSIM4v5_23);
-               (*(here->BSIM4v5GMspPtr) += here->BSIM4v5_24);
-               (*(here->BSIM4v5GMbpPtr) += here->BSIM4v5_25);
-
-               (*(here->BSIM4v5DPgmPtr) += here->BSIM4v5_26);
-               (*(here->BSIM4v5GPgmPtr) -= here->BSIM4v5_27);
-               (*(here->BSIM4v5SPgmPtr) += here->BSIM4v5_28);
-               (*(here->BSIM4v5BPgmPtr) += here->BSIM4v5_29);
-
-               (*(here->BSIM4v5GPgpPtr) += here->BSIM4v5_30);
-               (*(here->BSIM4v5GPdpPtr) += here->BSIM4v5_31);
-               (*(here->BSIM4v5GPspPtr) += here->BSIM4v5_32);
-               (*(here->BSIM4v5GPbpPtr) += here->BSIM4v5_33);
+           {   (*DEVmatSlot(here->BSIM4v5GEgePtr, trash, &scratch) += here->BSIM4v5_18);
+               (*DEVmatSlot(here->BSIM4v5GEgmPtr, trash, &scratch) -= here->BSIM4v5_19);
+               (*DEVmatSlot(here->BSIM4v5GMgePtr, trash, &scratch) -= here->BSIM4v5_20);
+               (*DEVmatSlot(here->BSIM4v5GMgmPtr, trash, &scratch) += here->BSIM4v5_21);
+
+               (*DEVmatSlot(here->BSIM4v5GMdpPtr, trash, &scratch) += here->BSIM4v5_22);
+               (*DEVmatSlot(here->BSIM4v5GMgpPtr, trash, &scratch) += here->BSIM4v5_23);
+               (*DEVmatSlot(here->BSIM4v5GMspPtr, trash, &scratch) += here->BSIM4v5_24);
+               (*DEVmatSlot(here->BSIM4v5GMbpPtr, trash, &scratch) += here->BSIM4v5_25);
+
+               (*DEVmatSlot(here->BSIM4v5DPgmPtr, trash, &scratch) += here->BSIM4v5_26);
+               (*DEVmatSlot(here->BSIM4v5GPgmPtr, trash, &scratch) -= here->BSIM4v5_27);
+               (*DEVmatSlot(here->BSIM4v5SPgmPtr, trash, &scratch) += here->BSIM4v5_28);
+               (*DEVmatSlot(here->BSIM4v5BPgmPtr, trash, &scratch) += here->BSIM4v5_29);
+
+               (*DEVmatSlot(here->BSIM4v5GPgpPtr, trash, &scratch) += here->BSIM4v5_30);
+               (*DEVmatSlot(here->BSIM4v5GPdpPtr, trash, &scratch) += here->BSIM4v5_31);
+               (*DEVmatSlot(here->BSIM4v5GPspPtr, trash, &scratch) += here->BSIM4v5_32);
+               (*DEVmatSlot(here->BSIM4v5GPbpPtr, trash, &scratch) += here->BSIM4v5_33);
            }
 
 
             else
-           {   (*(here->BSIM4v5GPgpPtr) += here->BSIM4v5_34);
-               (*(here->BSIM4v5GPdpPtr) += here->BSIM4v5_35);
-               (*(here->BSIM4v5GPspPtr) += here->BSIM4v5_36);
-               (*(here->BSIM4v5GPbpPtr) += here->BSIM4v5_37);
+           {   (*DEVmatSlot(here->BSIM4v5GPgpPtr, trash, &scratch) += here->BSIM4v5_34);
+               (*DEVmatSlot(here->BSIM4v5GPdpPtr, trash, &scratch) += here->BSIM4v5_35);
+               (*DEVmatSlot(here->BSIM4v5GPspPtr, trash, &scratch) += here->BSIM4v5_36);
+               (*DEVmatSlot(here->BSIM4v5GPbpPtr, trash, &scratch) += here->BSIM4v5_37);
            }
 
 
            if (model->BSIM4v5rdsMod)
-           {   (*(here->BSIM4v5DgpPtr) += here->BSIM4v5_38);
-               (*(here->BSIM4v5DspPtr) += here->BSIM4v5_39);
-               (*(here->BSIM4v5DbpPtr) += here->BSIM4v5_40);
-               (*(here->BSIM4v5SdpPtr) += here->BSIM4v5_41);
-               (*(here->BSIM4v5SgpPtr) += here->BSIM4v5_42);
-               (*(here->BSIM4v5SbpPtr) += here->BSIM4v5_43);
+           {   (*DEVmatSlot(here->BSIM4v5DgpPtr, trash, &scratch) += here->BSIM4v5_38);
+               (*DEVmatSlot(here->BSIM4v5DspPtr, trash, &scratch) += here->BSIM4v5_39);
+               (*DEVmatSlot(here->BSIM4v5DbpPtr, trash, &scratch) += here->BSIM4v5_40);
+               (*DEVmatSlot(here->BSIM4v5SdpPtr, trash, &scratch) += here->BSIM4v5_41);
+               (*DEVmatSlot(here->BSIM4v5SgpPtr, trash, &scratch) += here->BSIM4v5_42);
+               (*DEVmatSlot(here->BSIM4v5SbpPtr, trash, &scratch) += here->BSIM4v5_43);
            }
 
-           (*(here->BSIM4v5DPdpPtr) += here->BSIM4v5_44);
-           (*(here->BSIM4v5DPdPtr) -= here->BSIM4v5_45);
-           (*(here->BSIM4v5DPgpPtr) += here->BSIM4v5_46);
-           (*(here->BSIM4v5DPspPtr) -= here->BSIM4v5_47);
-           (*(here->BSIM4v5DPbpPtr) -= here->BSIM4v5_48);
+           (*DEVmatSlot(here->BSIM4v5DPdpPtr, trash, &scratch) += here->BSIM4v5_44);
+           (*DEVmatSlot(here->BSIM4v5DPdPtr, trash, &scratch) -= here->BSIM4v5_45);
+           (*DEVmatSlot(here->BSIM4v5DPgpPtr, trash, &scratch) += here->BSIM4v5_46);
+           (*DEVmatSlot(here->BSIM4v5DPspPtr, trash, &scratch) -= here->BSIM4v5_47);
+           (*DEVmatSlot(here->BSIM4v5DPbpPtr, trash, &scratch) -= here->BSIM4v5_48);
 
-           (*(here->BSIM4v5DdpPtr) -= here->BSIM4v5_49);
-           (*(here->BSIM4v5DdPtr) += here->BSIM4v5_50);
+           (*DEVmatSlot(here->BSIM4v5DdpPtr, trash, &scratch) -= here->BSIM4v5_49);
+           (*DEVmatSlot(here->BSIM4v5DdPtr, trash, &scratch) += here->BSIM4v5_50);
 
-           (*(here->BSIM4v5SPdpPtr) -= here->BSIM4v5_51);
-           (*(here->BSIM4v5SPgpPtr) += here->BSIM4v5_52);
-           (*(here->BSIM4v5SPspPtr) += here->BSIM4v5_53);
-           (*(here->BSIM4v5SPsPtr) -= here->BSIM4v5_54);
-           (*(here->BSIM4v5SPbpPtr) -= here->BSIM4v5_55);
+           (*DEVmatSlot(here->BSIM4v5SPdpPtr, trash, &scratch) -= here->BSIM4v5_51);
+           (*DEVmatSlot(here->BSIM4v5SPgpPtr, trash, &scratch) += here->BSIM4v5_52);
+           (*DEVmatSlot(here->BSIM4v5SPspPtr, trash, &scratch) += here->BSIM4v5_53);
+           (*DEVmatSlot(here->BSIM4v5SPsPtr, trash, &scratch) -= here->BSIM4v5_54);
+           (*DEVmatSlot(here->BSIM4v5SPbpPtr, trash, &scratch) -= here->BSIM4v5_55);
 
-           (*(here->BSIM4v5SspPtr) -= here->BSIM4v5_56);
-           (*(here->BSIM4v5SsPtr) += here->BSIM4v5_57);
+           (*DEVmatSlot(here->BSIM4v5SspPtr, trash, &scratch) -= here->BSIM4v5_56);
+           (*DEVmatSlot(here->BSIM4v5SsPtr, trash, &scratch) += here->BSIM4v5_57);
 
-           (*(here->BSIM4v5BPdpPtr) += here->BSIM4v5_58);
-           (*(here->BSIM4v5BPgpPtr) += here->BSIM4v5_59);
-           (*(here->BSIM4v5BPspPtr) += here->BSIM4v5_60);
-           (*(here->BSIM4v5BPbpPtr) += here->BSIM4v5_61);
+           (*DEVmatSlot(here->BSIM4v5BPdpPtr, trash, &scratch) += here->BSIM4v5_58);
+           (*DEVmatSlot(here->BSIM4v5BPgpPtr, trash, &scratch) += here->BSIM4v5_59);
+           (*DEVmatSlot(here->BSIM4v5BPspPtr, trash, &scratch) += here->BSIM4v5_60);
+           (*DEVmatSlot(here->BSIM4v5BPbpPtr, trash, &scratch) += here->BSIM4v5_61);
 
            /* stamp gidl */
-           (*(here->BSIM4v5DPdpPtr) += here->BSIM4v5_62);
-           (*(here->BSIM4v5DPgpPtr) += here->BSIM4v5_63);
-           (*(here->BSIM4v5DPspPtr) -= here->BSIM4v5_64);
-           (*(here->BSIM4v5DPbpPtr) += here->BSIM4v5_65);
-           (*(here->BSIM4v5BPdpPtr) -= here->BSIM4v5_66);
-           (*(here->BSIM4v5BPgpPtr) -= here->BSIM4v5_67);
-           (*(here->BSIM4v5BPspPtr) += here->BSIM4v5_68);
-           (*(here->BSIM4v5BPbpPtr) -= here->BSIM4v5_69);
+           (*DEVmatSlot(here->BSIM4v5DPdpPtr, trash, &scratch) += here->BSIM4v5_62);
+           (*DEVmatSlot(here->BSIM4v5DPgpPtr, trash, &scratch) += here->BSIM4v5_63);
+           (*DEVmatSlot(here->BSIM4v5DPspPtr, trash, &scratch) -= here->BSIM4v5_64);
+           (*DEVmatSlot(here->BSIM4v5DPbpPtr, trash, &scratch) += here->BSIM4v5_65);
+           (*DEVmatSlot(here->BSIM4v5BPdpPtr, trash, &scratch) -= here->BSIM4v5_66);
+           (*DEVmatSlot(here->BSIM4v5BPgpPtr, trash, &scratch) -= here->BSIM4v5_67);
+           (*DEVmatSlot(here->BSIM4v5BPspPtr, trash, &scratch) += here->BSIM4v5_68);
+           (*DEVmatSlot(here->BSIM4v5BPbpPtr, trash, &scratch) -= here->BSIM4v5_69);
             /* stamp gisl */
-           (*(here->BSIM4v5SPdpPtr) -= here->BSIM4v5_70);
-           (*(here->BSIM4v5SPgpPtr) += here->BSIM4v5_71);
-           (*(here->BSIM4v5SPspPtr) += here->BSIM4v5_72);
-           (*(here->BSIM4v5SPbpPtr) += here->BSIM4v5_73);
-           (*(here->BSIM4v5BPdpPtr) += here->BSIM4v5_74);
-           (*(here->BSIM4v5BPgpPtr) -= here->BSIM4v5_75);
-           (*(here->BSIM4v5BPspPtr) -= here->BSIM4v5_76);
-           (*(here->BSIM4v5BPbpPtr) -= here->BSIM4v5_77);
+           (*DEVmatSlot(here->BSIM4v5SPdpPtr, trash, &scratch) -= here->BSIM4v5_70);
+           (*DEVmatSlot(here->BSIM4v5SPgpPtr, trash, &scratch) += here->BSIM4v5_71);
+           (*DEVmatSlot(here->BSIM4v5SPspPtr, trash, &scratch) += here->BSIM4v5_72);
+           (*DEVmatSlot(here->BSIM4v5SPbpPtr, trash, &scratch) += here->BSIM4v5_73);
+           (*DEVmatSlot(here->BSIM4v5BPdpPtr, trash, &scratch) += here->BSIM4v5_74);
+           (*DEVmatSlot(here->BSIM4v5BPgpPtr, trash, &scratch) -= here->BSIM4v5_75);
+           (*DEVmatSlot(here->BSIM4v5BPspPtr, trash, &scratch) -= here->BSIM4v5_76);
+           (*DEVmatSlot(here->BSIM4v5BPbpPtr, trash, &scratch) -= here->BSIM4v5_77);
 
 
            if (here->BSIM4v5rbodyMod)
-           {   (*(here->BSIM4v5DPdbPtr) += here->BSIM4v5_78);
-               (*(here->BSIM4v5SPsbPtr) -= here->BSIM4v5_79);
-
-               (*(here->BSIM4v5DBdpPtr) += here->BSIM4v5_80);
-               (*(here->BSIM4v5DBdbPtr) += here->BSIM4v5_81);
-               (*(here->BSIM4v5DBbpPtr) -= here->BSIM4v5_82);
-               (*(here->BSIM4v5DBbPtr) -= here->BSIM4v5_83);
-
-               (*(here->BSIM4v5BPdbPtr) -= here->BSIM4v5_84);
-               (*(here->BSIM4v5BPbPtr) -= here->BSIM4v5_85);
-               (*(here->BSIM4v5BPsbPtr) -= here->BSIM4v5_86);
-               (*(here->BSIM4v5BPbpPtr) += here->BSIM4v5_87);
-
-               (*(here->BSIM4v5SBspPtr) += here->BSIM4v5_88);
-               (*(here->BSIM4v5SBbpPtr) -= here->BSIM4v5_89);
-               (*(here->BSIM4v5SBbPtr) -= here->BSIM4v5_90);
-               (*(here->BSIM4v5SBsbPtr) += here->BSIM4v5_91);
-
-               (*(here->BSIM4v5BdbPtr) -= here->BSIM4v5_92);
-               (*(here->BSIM4v5BbpPtr) -= here->BSIM4v5_93);
-               (*(here->BSIM4v5BsbPtr) -= here->BSIM4v5_94);
-               (*(here->BSIM4v5BbPtr) += here->BSIM4v5_95);
+           {   (*DEVmatSlot(here->BSIM4v5DPdbPtr, trash, &scratch) += here->BSIM4v5_78);
+               (*DEVmatSlot(here->BSIM4v5SPsbPtr, trash, &scratch) -= here->BSIM4v5_79);
+
+               (*DEVmatSlot(here->BSIM4v5DBdpPtr, trash, &scratch) += here->BSIM4v5_80);
+               (*DEVmatSlot(here->BSIM4v5DBdbPtr, trash, &scratch) += here->BSIM4v5_81);
+               (*DEVmatSlot(here->BSIM4v5DBbpPtr, trash, &scratch) -= here->BSIM4v5_82);
+               (*DEVmatSlot(here->BSIM4v5DBbPtr, trash, &scratch) -= here->BSIM4v5_83);
+
+               (*DEVmatSlot(here->BSIM4v5BPdbPtr, trash, &scratch) -= here->BSIM4v5_84);
+               (*DEVmatSlot(here->BSIM4v5BPbPtr, trash, &scratch) -= here->BSIM4v5_85);
+               (*DEVmatSlot(here->BSIM4v5BPsbPtr, trash, &scratch) -= here->BSIM4v5_86);
+               (*DEVmatSlot(here->BSIM4v5BPbpPtr, trash, &scratch) += here->BSIM4v5_87);
+
+               (*DEVmatSlot(here->BSIM4v5SBspPtr, trash, &scratch) += here->BSIM4v5_88);
+               (*DEVmatSlot(here->BSIM4v5SBbpPtr, trash, &scratch) -= here->BSIM4v5_89);
+               (*DEVmatSlot(here->BSIM4v5SBbPtr, trash, &scratch) -= here->BSIM4v5_90);
+               (*DEVmatSlot(here->BSIM4v5SBsbPtr, trash, &scratch) += here->BSIM4v5_91);
+
+               (*DEVmatSlot(here->BSIM4v5BdbPtr, trash, &scratch) -= here->BSIM4v5_92);
+               (*DEVmatSlot(here->BSIM4v5BbpPtr, trash, &scratch) -= here->BSIM4v5_93);
+               (*DEVmatSlot(here->BSIM4v5BsbPtr, trash, &scratch) -= here->BSIM4v5_94);
+               (*DEVmatSlot(here->BSIM4v5BbPtr, trash, &scratch) += here->BSIM4v5_95);
            }
 
            if (here->BSIM4v5trnqsMod)
-           {   (*(here->BSIM4v5QqPtr) += here->BSIM4v5_96);
-               (*(here->BSIM4v5QgpPtr) += here->BSIM4v5_97);
-               (*(here->BSIM4v5QdpPtr) += here->BSIM4v5_98);
-               (*(here->BSIM4v5QspPtr) += here->BSIM4v5_99);
-               (*(here->BSIM4v5QbpPtr) += here->BSIM4v5_100);
-
-               (*(here->BSIM4v5DPqPtr) += here->BSIM4v5_101);
-               (*(here->BSIM4v5SPqPtr) += here->BSIM4v5_102);
-               (*(here->BSIM4v5GPqPtr) -= here->BSIM4v5_103);
+           {   (*DEVmatSlot(here->BSIM4v5QqPtr, trash, &scratch) += here->BSIM4v5_96);
+               (*DEVmatSlot(here->BSIM4v5QgpPtr, trash, &scratch) += here->BSIM4v5_97);
+               (*DEVmatSlot(here->BSIM4v5QdpPtr, trash, &scratch) += here->BSIM4v5_98);
+               (*DEVmatSlot(here->BSIM4v5QspPtr, trash, &scratch) += here->BSIM4v5_99);
+               (*DEVmatSlot(here->BSIM4v5QbpPtr, trash, &scratch) += here->BSIM4v5_100);
+
+               (*DEVmatSlot(here->BSIM4v5DPqPtr, trash, &scratch) += here->BSIM4v5_101);
+               (*DEVmatSlot(here->BSIM4v5SPqPtr, trash, &scratch) += here->BSIM4v5_102);
+               (*DEVmatSlot(here->BSIM4v5GPqPtr, trash, &scratch) -= here->BSIM4v5_103);
            }
     }
 }
 
+void BSIM4v5LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM4v5model *model = (BSIM4v5model*)inModel;
+    int *ColorStart = model->BSIM4v5ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM4v5ColorCount; color++)
+        BSIM4v5LoadRhsMatRange(model->BSIM4v5InstanceArray, ColorStart[color],
+                               ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM4v5LoadRhsMatRange(model->BSIM4v5InstanceArray, ColorStart[model->BSIM4v5ColorCount],
+                           model->BSIM4v5InstCount, 0, ckt, trash);
+}
+
 #endif
 
 
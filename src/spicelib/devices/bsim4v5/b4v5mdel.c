@@ -21,6 +21,7 @@ BSIM4v5mDelete(GENmodel *gen_model)
 
 #ifdef USE_OMP
     FREE(model->BSIM4v5InstanceArray);
+    FREE(model->BSIM4v5ColorStart);
 #endif
 
     struct bsim4v5SizeDependParam *p = model->pSizeDependParamKnot;
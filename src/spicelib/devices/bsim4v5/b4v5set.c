@@ -20,6 +20,7 @@
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "bsim4v5def.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
@@ -2110,6 +2111,8 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
         model->BSIM4v5InstCount = 0;
         model->BSIM4v5InstanceArray = NULL;
+        model->BSIM4v5ColorCount = 0;
+        model->BSIM4v5ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM4v5instance*, InstCount);
     model = (BSIM4v5model*)inModel;
@@ -2127,6 +2130,11 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM4v5model*)inModel;
+    model->BSIM4v5ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM4v5ColorStart);
 #endif
 
     return(OK);
@@ -2144,6 +2152,7 @@ BSIM4v5unsetup(
 #ifdef USE_OMP
     model = (BSIM4v5model*)inModel;
     tfree(model->BSIM4v5InstanceArray);
+    tfree(model->BSIM4v5ColorStart);
 #endif
 
     for (model = (BSIM4v5model *)inModel; model != NULL;
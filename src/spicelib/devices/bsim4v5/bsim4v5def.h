@@ -1691,6 +1691,8 @@ typedef struct sBSIM4v5model
 #ifdef USE_OMP
     int BSIM4v5InstCount;
     struct sBSIM4v5instance **BSIM4v5InstanceArray;
+    int BSIM4v5ColorCount;
+    int *BSIM4v5ColorStart;
 #endif
 
     /* Flags */
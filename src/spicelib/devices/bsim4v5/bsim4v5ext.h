@@ -28,6 +28,11 @@ extern int BSIM4v5noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM4v5unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM4v5soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM4v5LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM4v5LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM4v5bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM4v5bindCSCComplex (GENmodel*, CKTcircuit*) ;
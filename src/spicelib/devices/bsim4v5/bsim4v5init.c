@@ -67,6 +67,11 @@ SPICEdev BSIM4v5info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM4v5LoadOMP,
+    .DEVloadStamp = BSIM4v5LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM4v5bindCSC,
     .DEVbindCSCComplex = BSIM4v5bindCSCComplex,
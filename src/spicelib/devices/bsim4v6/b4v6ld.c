@@ -61,11 +61,6 @@
     }
 
 
-#ifdef USE_OMP
-int BSIM4v6LoadOMP(BSIM4v6instance *here, CKTcircuit *ckt);
-void BSIM4v6LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 int BSIM4v6polyDepletion(double phi, double ngate,double epsgate, double coxe, double Vgs, double *Vgs_eff, double *dVgs_eff_dVg);
 
 int
@@ -83,7 +78,7 @@ CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM4v6InstCount; idx++) {
         BSIM4v6instance *here = InstArray[idx];
-        int local_error = BSIM4v6LoadOMP(here, ckt);
+        int local_error = BSIM4v6LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -94,7 +89,8 @@ CKTcircuit *ckt)
 }
 
 
-int BSIM4v6LoadOMP(BSIM4v6instance *here, CKTcircuit *ckt) {
+int BSIM4v6LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+BSIM4v6instance *here = (BSIM4v6instance *) inInst;
 BSIM4v6model *model = BSIM4v6modPtr(here);
 #else
 BSIM4v6model *model = (BSIM4v6model*)inModel;
@@ -5198,191 +5194,208 @@ int BSIM4v6polyDepletion(
 }
 
 #ifdef USE_OMP
-void BSIM4v6LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM4v6LoadRhsMatRange(BSIM4v6instance **InstArray, int first, int last, int parallel,
+                       CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    BSIM4v6instance **InstArray;
+    int idx;
     BSIM4v6instance *here;
-    BSIM4v6model *model = (BSIM4v6model*)inModel;
+    BSIM4v6model *model;
 
-    InstArray = model->BSIM4v6InstanceArray;
-    InstCount = model->BSIM4v6InstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = BSIM4v6modPtr(here);
         /* Update b for Ax = b */
-           (*(ckt->CKTrhs + here->BSIM4v6dNodePrime) += here->BSIM4v6rhsdPrime);
-           (*(ckt->CKTrhs + here->BSIM4v6gNodePrime) -= here->BSIM4v6rhsgPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6dNodePrime, &scratch) += here->BSIM4v6rhsdPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6gNodePrime, &scratch) -= here->BSIM4v6rhsgPrime);
 
            if (here->BSIM4v6rgateMod == 2)
-               (*(ckt->CKTrhs + here->BSIM4v6gNodeExt) -= here->BSIM4v6rhsgExt);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6gNodeExt, &scratch) -= here->BSIM4v6rhsgExt);
            else if (here->BSIM4v6rgateMod == 3)
-               (*(ckt->CKTrhs + here->BSIM4v6gNodeMid) -= here->BSIM4v6grhsMid);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6gNodeMid, &scratch) -= here->BSIM4v6grhsMid);
 
            if (!here->BSIM4v6rbodyMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v6bNodePrime) += here->BSIM4v6rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v6sNodePrime) += here->BSIM4v6rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6bNodePrime, &scratch) += here->BSIM4v6rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6sNodePrime, &scratch) += here->BSIM4v6rhssPrime);
            }
            else
-           {   (*(ckt->CKTrhs + here->BSIM4v6dbNode) -= here->BSIM4v6rhsdb);
-               (*(ckt->CKTrhs + here->BSIM4v6bNodePrime) += here->BSIM4v6rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v6sbNode) -= here->BSIM4v6rhssb);
-               (*(ckt->CKTrhs + here->BSIM4v6sNodePrime) += here->BSIM4v6rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6dbNode, &scratch) -= here->BSIM4v6rhsdb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6bNodePrime, &scratch) += here->BSIM4v6rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6sbNode, &scratch) -= here->BSIM4v6rhssb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6sNodePrime, &scratch) += here->BSIM4v6rhssPrime);
            }
 
            if (model->BSIM4v6rdsMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v6dNode) -= here->BSIM4v6rhsd); 
-               (*(ckt->CKTrhs + here->BSIM4v6sNode) += here->BSIM4v6rhss);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6dNode, &scratch) -= here->BSIM4v6rhsd); 
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6sNode, &scratch) += here->BSIM4v6rhss);
            }
 
            if (here->BSIM4v6trnqsMod)
-               *(ckt->CKTrhs + here->BSIM4v6qNode) += here->BSIM4v6rhsq;
+               *DEVrhsSlot(ckt->CKTrhs, here->BSIM4v6qNode, &scratch) += here->BSIM4v6rhsq;
 
 
         /* Update A for Ax = b */
            if (here->BSIM4v6rgateMod == 1)
-           {   (*(here->BSIM4v6GEgePtr) += here->BSIM4v6_1);
-               (*(here->BSIM4v6GPgePtr) -= here->BSIM4v6_2);
-               (*(here->BSIM4v6GEgpPtr) -= here->BSIM4v6_3);
-               (*(here->BSIM4v6GPgpPtr) += here->BSIM4v6_4);
-               (*(here->BSIM4v6GPdpPtr) += here->BSIM4v6_5);
-               (*(here->BSIM4v6GPspPtr) += here->BSIM4v6_6);
-               (*(here->BSIM4v6GPbpPtr) += here->BSIM4v6_7);
+           {   (*DEVmatSlot(here->BSIM4v6GEgePtr, trash, &scratch) += here->BSIM4v6_1);
+               (*DEVmatSlot(here->BSIM4v6GPgePtr, trash, &scratch) -= here->BSIM4v6_2);
+               (*DEVmatSlot(here->BSIM4v6GEgpPtr, trash, &scratch) -= here->BSIM4v6_3);
+               (*DEVmatSlot(here->BSIM4v6GPgpPtr, trash, &scratch) += here->BSIM4v6_4);
+               (*DEVmatSlot(here->BSIM4v6GPdpPtr, trash, &scratch) += here->BSIM4v6_5);
+               (*DEVmatSlot(here->BSIM4v6GPspPtr, trash, &scratch) += here->BSIM4v6_6);
+               (*DEVmatSlot(here->BSIM4v6GPbpPtr, trash, &scratch) += here->BSIM4v6_7);
            }
            else if (here->BSIM4v6rgateMod == 2)        
-           {   (*(here->BSIM4v6GEgePtr) += here->BSIM4v6_8);
-               (*(here->BSIM4v6GEgpPtr) += here->BSIM4v6_9);
-               (*(here->BSIM4v6GEdpPtr) += here->BSIM4v6_10);
-               (*(here->BSIM4v6GEspPtr) += here->BSIM4v6_11);
-               (*(here->BSIM4v6GEbpPtr) += here->BSIM4v6_12);        
-
-               (*(here->BSIM4v6GPgePtr) -= here->BSIM4v6_13);
-               (*(here->BSIM4v6GPgpPtr) += here->BSIM4v6_14);
-               (*(here->BSIM4v6GPdpPtr) += here->BSIM4v6_15);
-               (*(here->BSIM4v6GPspPtr) += here->BSIM4v6_16);
-               (*(here->BSIM4v6GPbpPtr) += here->BSIM4v6_17);
+           {   (*DEVmatSlot(here->BSIM4v6GEgePtr, trash, &scratch) += here->BSIM4v6_8);
+               (*DEVmatSlot(here->BSIM4v6GEgpPtr, trash, &scratch) += here->BSIM4v6_9);
+               (*DEVmatSlot(here->BSIM4v6GEdpPtr, trash, &scratch) += here->BSIM4v6_10);
+               (*DEVmatSlot(here->BSIM4v6GEspPtr, trash, &scratch) += here->BSIM4v6_11);
+               (*DEVmatSlot(here->BSIM4v6GEbpPtr, trash, &scratch) += here->BSIM4v6_12);        
+
+               (*DEVmatSlot(here->BSIM4v6GPgePtr, trash, &scratch) -= here->BSIM4v6_13);
+               (*DEVmatSlot(here->BSIM4v6GPgpPtr, trash, &scratch) += here->BSIM4v6_14);
+               (*DEVmatSlot(here->BSIM4v6GPdpPtr, trash, &scratch) += here->BSIM4v6_15);
+               (*DEVmatSlot(here->BSIM4v6GPspPtr, trash, &scratch) += here->BSIM4v6_16);
+               (*DEVmatSlot(here->BSIM4v6GPbpPtr, trash, &scratch) += here->BSIM4v6_17);
            }
            else if (here->BSIM4v6rgateMod == 3)
-           {   (*(here->BSIM4v6GEgePtr) += here->BSIM4v6_18);
-               (*(here->BSIM4v6GEgmPtr) -= here->BSIM4v6_19);
-               (*(here->BSIM4v6GMgePtr) -= here->BSIM4v6_20);
-               (*(here->BSIM4v6GMgmPtr) += here->BSIM4v6_21);
-
-               (*(here->BSIM4v6GMdpPtr) += here->BSIM4v6_22);
-               (*(here->BSIM4v6GMgpPtr) += here->BSIM4v6_23);
-               (*(here->BSIM4v6GMspPtr) += here->BSIM4v6_24);
-               (*(here->BSIM4v6GMbpPtr) += here->BSIM4v6_25);
-
-               (*(here->BSIM4v6DPgmPtr) += here->BSIM4v6_26);
-               (*(here->BSIM4v6GPgmPtr) -= here->BSIM4v6_27);
-               (*(here->BSIM4v6SPgmPtr) += here->BSIM4v6_28);
-               (*(here->BSIM4v6BPgmPtr) += here->BSIM4v6_29);
-
-               (*(here->BSIM4v6GPgpPtr) += here->BSIM4v6_30);
-               (*(here->BSIM4v6GPdpPtr) += here->BSIM4v6_31);
-               (*(here->BSIM4v6GPspPtr) += here->BSIM4v6_32);
-               (*(here->BSIM4v6GPbpPtr) += here->BSIM4v6_33);
+           {   (*DEVmatSlot(here->BSIM4v6GEgePtr, trash, &scratch) += here->BSIM4v6_18);
+               (*DEVmatSlot(here->BSIM4v6GEgmPtr, trash, &scratch) -= here->BSIM4v6_19);
+               (*DEVmatSlot(here->BSIM4v6GMgePtr, trash, &scratch) -= here->BSIM4v6_20);
+               (*DEVmatSlot(here->BSIM4v6GMgmPtr, trash, &scratch) += here->BSIM4v6_21);
+
+               (*DEVmatSlot(here->BSIM4v6GMdpPtr, trash, &scratch) += here->BSIM4v6_22);
+               (*DEVmatSlot(here->BSIM4v6GMgpPtr, trash, &scratch) += here->BSIM4v6_23);
+               (*DEVmatSlot(here->BSIM4v6GMspPtr, trash, &scratch) += here->BSIM4v6_24);
+               (*DEVmatSlot(here->BSIM4v6GMbpPtr, trash, &scratch) += here->BSIM4v6_25);
+
+               (*DEVmatSlot(here->BSIM4v6DPgmPtr, trash, &scratch) += here->BSIM4v6_26);
+               (*DEVmatSlot(here->BSIM4v6GPgmPtr, trash, &scratch) -= here->BSIM4v6_27);
+               (*DEVmatSlot(here->BSIM4v6SPgmPtr, trash, &scratch) += here->BSIM4v6_28);
+               (*DEVmatSlot(here->BSIM4v6BPgmPtr, trash, &scratch) += here->BSIM4v6_29);
+
+               (*DEVmatSlot(here->BSIM4v6GPgpPtr, trash, &scratch) += here->BSIM4v6_30);
+               (*DEVmatSlot(here->BSIM4v6GPdpPtr, trash, &scratch) += here->BSIM4v6_31);
+               (*DEVmatSlot(here->BSIM4v6GPspPtr, trash, &scratch) += here->BSIM4v6_32);
+               (*DEVmatSlot(here->BSIM4v6GPbpPtr, trash, &scratch) += here->BSIM4v6_33);
            }
 
 
             else
-           {   (*(here->BSIM4v6GPgpPtr) += here->BSIM4v6_34);
-               (*(here->BSIM4v6GPdpPtr) += here->BSIM4v6_35);
-               (*(here->BSIM4v6GPspPtr) += here->BSIM4v6_36);
-               (*(here->BSIM4v6GPbpPtr) += here->BSIM4v6_37);
+           {   (*DEVmatSlot(here->BSIM4v6GPgpPtr, trash, &scratch) += here->BSIM4v6_34);
+               (*DEVmatSlot(here->BSIM4v6GPdpPtr, trash, &scratch) += here->BSIM4v6_35);
+               (*DEVmatSlot(here->BSIM4v6GPspPtr, trash, &scratch) += here->BSIM4v6_36);
+               (*DEVmatSlot(here->BSIM4v6GPbpPtr, trash, &scratch) += here->BSIM4v6_37);
            }
 
 
            if (model->BSIM4v6rdsMod)
-           {   (*(here->BSIM4v6DgpPtr) += here->BSIM4v6_38);
-               (*(here->BSIM4v6DspPtr) += here->BSIM4v6_39);
-               (*(here->BSIM4v6DbpPtr) += here->BSIM4v6_40);
-               (*(here->BSIM4v6SdpPtr) += here->BSIM4v6_41);
-               (*(here->BSIM4v6SgpPtr) += here->BSIM4v6_42);
-               (*(here->BSIM4v6SbpPtr) += here->BSIM4v6_43);
+           {   (*DEVmatSlot(here->BSIM4v6DgpPtr, trash, &scratch) += here->BSIM4v6_38);
+               (*DEVmatSlot(here->BSIM4v6DspPtr, trash, &scratch) += here->BSIM4v6_39);
+               (*DEVmatSlot(here->BSIM4v6DbpPtr, trash, &scratch) += here->BSIM4v6_40);
+               (*DEVmatSlot(here->BSIM4v6SdpPtr, trash, &scratch) += here->BSIM4v6_41);
+               (*DEVmatSlot(here->BSIM4v6SgpPtr, trash, &scratch) += here->BSIM4v6_42);
+               (*DEVmatSlot(here->BSIM4v6SbpPtr, trash, &scratch) += here->BSIM4v6_43);
            }
 
-           (*(here->BSIM4v6DPdpPtr) += here->BSIM4v6_44);
-           (*(here->BSIM4v6DPdPtr) -= here->BSIM4v6_45);
-           (*(here->BSIM4v6DPgpPtr) += here->BSIM4v6_46);
-           (*(here->BSIM4v6DPspPtr) -= here->BSIM4v6_47);
-           (*(here->BSIM4v6DPbpPtr) -= here->BSIM4v6_48);
+           (*DEVmatSlot(here->BSIM4v6DPdpPtr, trash, &scratch) += here->BSIM4v6_44);
+           (*DEVmatSlot(here->BSIM4v6DPdPtr, trash, &scratch) -= here->BSIM4v6_45);
+           (*DEVmatSlot(here->BSIM4v6DPgpPtr, trash, &scratch) += here->BSIM4v6_46);
+           (*DEVmatSlot(here->BSIM4v6DPspPtr, trash, &scratch) -= here->BSIM4v6_47);
+           (*DEVmatSlot(here->BSIM4v6DPbpPtr, trash, &scratch) -= here->BSIM4v6_48);
 
-           (*(here->BSIM4v6DdpPtr) -= here->BSIM4v6_49);
-           (*(here->BSIM4v6DdPtr) += here->BSIM4v6_50);
+           (*DEVmatSlot(here->BSIM4v6DdpPtr, trash, &scratch) -= here->BSIM4v6_49);
+           (*DEVmatSlot(here->BSIM4v6DdPtr, trash, &scratch) += here->BSIM4v6_50);
 
-           (*(here->BSIM4v6SPdpPtr) -= here->BSIM4v6_51);
-           (*(here->BSIM4v6SPgpPtr) += here->BSIM4v6_52);
-           (*(here->BSIM4v6SPspPtr) += here->BSIM4v6_53);
-           (*(here->BSIM4v6SPsPtr) -= here->BSIM4v6_54);
-           (*(here->BSIM4v6SPbpPtr) -= here->BSIM4v6_55);
+           (*DEVmatSlot(here->BSIM4v6SPdpPtr, trash, &scratch) -= here->BSIM4v6_51);
+           (*DEVmatSlot(here->BSIM4v6SPgpPtr, trash, &scratch) += here->BSIM4v6_52);
+           (*DEVmatSlot(here->BSIM4v6SPspPtr, trash, &scratch) += here->BSIM4v6_53);
+           (*DEVmatSlot(here->BSIM4v6SPsPtr, trash, &scratch) -= here->BSIM4v6_54);
+           (*DEVmatSlot(here->BSIM4v6SPbpPtr, trash, &scratch) -= here->BSIM4v6_55);
 
-           (*(here->BSIM4v6SspPtr) -= here->BSIM4v6_56);
-           (*(here->BSIM4v6SsPtr) += here->BSIM4v6_57);
+           (*DEVmatSlot(here->BSIM4v6SspPtr, trash, &scratch) -= here->BSIM4v6_56);
+           (*DEVmatSlot(here->BSIM4v6SsPtr, trash, &scratch) += here->BSIM4v6_57);
 
-           (*(here->BSIM4v6BPdpPtr) += here->BSIM4v6_58);
-           (*(here->BSIM4v6BPgpPtr) += here->BSIM4v6_59);
-           (*(here->BSIM4v6BPspPtr) += here->BSIM4v6_60);
-           (*(here->BSIM4v6BPbpPtr) += here->BSIM4v6_61);
+           (*DEVmatSlot(here->BSIM4v6BPdpPtr, trash, &scratch) += here->BSIM4v6_58);
+           (*DEVmatSlot(here->BSIM4v6BPgpPtr, trash, &scratch) += here->BSIM4v6_59);
+           (*DEVmatSlot(here->BSIM4v6BPspPtr, trash, &scratch) += here->BSIM4v6_60);
+           (*DEVmatSlot(here->BSIM4v6BPbpPtr, trash, &scratch) += here->BSIM4v6_61);
 
            /* stamp gidl */
-           (*(here->BSIM4v6DPdpPtr) += here->BSIM4v6_62);
-           (*(here->BSIM4v6DPgpPtr) += here->BSIM4v6_63);
-           (*(here->BSIM4v6DPspPtr) -= here->BSIM4v6_64);
-           (*(here->BSIM4v6DPbpPtr) += here->BSIM4v6_65);
-           (*(here->BSIM4v6BPdpPtr) -= here->BSIM4v6_66);
-           (*(here->BSIM4v6BPgpPtr) -= here->BSIM4v6_67);
-           (*(here->BSIM4v6BPspPtr) += here->BSIM4v6_68);
-           (*(here->BSIM4v6BPbpPtr) -= here->BSIM4v6_69);
+           (*DEVmatSlot(here->BSIM4v6DPdpPtr, trash, &scratch) += here->BSIM4v6_62);
+           (*DEVmatSlot(here->BSIM4v6DPgpPtr, trash, &scratch) += here->BSIM4v6_63);
+           (*DEVmatSlot(here->BSIM4v6DPspPtr, trash, &scratch) -= here->BSIM4v6_64);
+           (*DEVmatSlot(here->BSIM4v6DPbpPtr, trash, &scratch) += here->BSIM4v6_65);
+           (*DEVmatSlot(here->BSIM4v6BPdpPtr, trash, &scratch) -= here->BSIM4v6_66);
+           (*DEVmatSlot(here->BSIM4v6BPgpPtr, trash, &scratch) -= here->BSIM4v6_67);
+           (*DEVmatSlot(here->BSIM4v6BPspPtr, trash, &scratch) += here->BSIM4v6_68);
+           (*DEVmatSlot(here->BSIM4v6BPbpPtr, trash, &scratch) -= here->BSIM4v6_69);
             /* stamp gisl */
-           (*(here->BSIM4v6SPdpPtr) -= here->BSIM4v6_70);
-           (*(here->BSIM4v6SPgpPtr) += here->BSIM4v6_71);
-           (*(here->BSIM4v6SPspPtr) += here->BSIM4v6_72);
-           (*(here->BSIM4v6SPbpPtr) += here->BSIM4v6_73);
-           (*(here->BSIM4v6BPdpPtr) += here->BSIM4v6_74);
-           (*(here->BSIM4v6BPgpPtr) -= here->BSIM4v6_75);
-           (*(here->BSIM4v6BPspPtr) -= here->BSIM4v6_76);
-           (*(here->BSIM4v6BPbpPtr) -= here->BSIM4v6_77);
+           (*DEVmatSlot(here->BSIM4v6SPdpPtr, trash, &scratch) -= here->BSIM4v6_70);
+           (*DEVmatSlot(here->BSIM4v6SPgpPtr, trash, &scratch) += here->BSIM4v6_71);
+           (*DEVmatSlot(here->BSIM4v6SPspPtr, trash, &scratch) += here->BSIM4v6_72);
+           (*DEVmatSlot(here->BSIM4v6SPbpPtr, trash, &scratch) += here->BSIM4v6_73);
+           (*DEVmatSlot(here->BSIM4v6BPdpPtr, trash, &scratch) += here->BSIM4v6_74);
+           (*DEVmatSlot(here->BSIM4v6BPgpPtr, trash, &scratch) -= here->BSIM4v6_75);
+           (*DEVmatSlot(here->BSIM4v6BPspPtr, trash, &scratch) -= here->BSIM4v6_76);
+           (*DEVmatSlot(here->BSIM4v6BPbpPtr, trash, &scratch) -= here->BSIM4v6_77);
 
 
            if (here->BSIM4v6rbodyMod)
-           {   (*(here->BSIM4v6DPdbPtr) += here->BSIM4v6_78);
-               (*(here->BSIM4v6SPsbPtr) -= here->BSIM4v6_79);
-
-               (*(here->BSIM4v6DBdpPtr) += here->BSIM4v6_80);
-               (*(here->BSIM4v6DBdbPtr) += here->BSIM4v6_81);
-               (*(here->BSIM4v6DBbpPtr) -= here->BSIM4v6_82);
-               (*(here->BSIM4v6DBbPtr) -= here->BSIM4v6_83);
-
-               (*(here->BSIM4v6BPdbPtr) -= here->BSIM4v6_84);
-               (*(here->BSIM4v6BPbPtr) -= here->BSIM4v6_85);
-               (*(here->BSIM4v6BPsbPtr) -= here->BSIM4v6_86);
-               (*(here->BSIM4v6BPbpPtr) += here->BSIM4v6_87);
-
-               (*(here->BSIM4v6SBspPtr) += here->BSIM4v6_88);
-               (*(here->BSIM4v6SBbpPtr) -= here->BSIM4v6_89);
-               (*(here->BSIM4v6SBbPtr) -= here->BSIM4v6_90);
-               (*(here->BSIM4v6SBsbPtr) += here->BSIM4v6_91);
-
-               (*(here->BSIM4v6BdbPtr) -= here->BSIM4v6_92);
-               (*(here->BSIM4v6BbpPtr) -= here->BSIM4v6_93);
-               (*(here->BSIM4v6BsbPtr) -= here->BSIM4v6_94);
-               (*(here->BSIM4v6BbPtr) += here->BSIM4v6_95);
+           {   (*DEVmatSlot(here->BSIM4v6DPdbPtr, trash, &scratch) += here->BSIM4v6_78);
+               (*DEVmatSlot(here->BSIM4v6SPsbPtr, trash, &scratch) -= here->BSIM4v6_79);
+
+               (*DEVmatSlot(here->BSIM4v6DBdpPtr, trash, &scratch) += here->BSIM4v6_80);
+               (*DEVmatSlot(here->BSIM4v6DBdbPtr, trash, &scratch) += here->BSIM4v6_81);
+               (*DEVmatSlot(here->BSIM4v6DBbpPtr, trash, &scratch) -= here->BSIM4v6_82);
+               (*DEVmatSlot(here->BSIM4v6DBbPtr, trash, &scratch) -= here->BSIM4v6_83);
+
+               (*DEVmatSlot(here->BSIM4v6BPdbPtr, trash, &scratch) -= here->BSIM4v6_84);
+               (*DEVmatSlot(here->BSIM4v6BPbPtr, trash, &scratch) -= here->BSIM4v6_85);
+               (*DEVmatSlot(here->BSIM4v6BPsbPtr, trash, &scratch) -= here->BSIM4v6_86);
+               (*DEVmatSlot(here->BSIM4v6BPbpPtr, trash, &scratch) += here->BSIM4v6_87);
+
+               (*DEVmatSlot(here->BSIM4v6SBspPtr, trash, &scratch) += here->BSIM4v6_88);
+               (*DEVmatSlot(here->BSIM4v6SBbpPtr, trash, &scratch) -= here->BSIM4v6_89);
+               (*DEVmatSlot(here->BSIM4v6SBbPtr, trash, &scratch) -= here->BSIM4v6_90);
+               (*DEVmatSlot(here->BSIM4v6SBsbPtr, trash, &scratch) += here->BSIM4v6_91);
+
+               (*DEVmatSlot(here->BSIM4v6BdbPtr, trash, &scratch) -= here->BSIM4v6_92);
+               (*DEVmatSlot(here->BSIM4v6BbpPtr, trash, &scratch) -= here->BSIM4v6_93);
+               (*DEVmatSlot(here->BSIM4v6BsbPtr, trash, &scratch) -= here->BSIM4v6_94);
+               (*DEVmatSlot(here->BSIM4v6BbPtr, trash, &scratch) += here->BSIM4v6_95);
            }
 
            if (here->BSIM4v6trnqsMod)
-           {   (*(here->BSIM4v6QqPtr) += here->BSIM4v6_96);
-               (*(here->BSIM4v6QgpPtr) += here->BSIM4v6_97);
-               (*(here->BSIM4v6QdpPtr) += here->BSIM4v6_98);
-               (*(here->BSIM4v6QspPtr) += here->BSIM4v6_99);
-               (*(here->BSIM4v6QbpPtr) += here->BSIM4v6_100);
-
-               (*(here->BSIM4v6DPqPtr) += here->BSIM4v6_101);
-               (*(here->BSIM4v6SPqPtr) += here->BSIM4v6_102);
-               (*(here->BSIM4v6GPqPtr) -= here->BSIM4v6_103);
+           {   (*DEVmatSlot(here->BSIM4v6QqPtr, trash, &scratch) += here->BSIM4v6_96);
+               (*DEVmatSlot(here->BSIM4v6QgpPtr, trash, &scratch) += here->BSIM4v6_97);
+               (*DEVmatSlot(here->BSIM4v6QdpPtr, trash, &scratch) += here->BSIM4v6_98);
+               (*DEVmatSlot(here->BSIM4v6QspPtr, trash, &scratch) += here->BSIM4v6_99);
+               (*DEVmatSlot(here->BSIM4v6QbpPtr, trash, &scratch) += here->BSIM4v6_100);
+
+               (*DEVmatSlot(here->BSIM4v6DPqPtr, trash, &scratch) += here->BSIM4v6_101);
+               (*DEVmatSlot(here->BSIM4v6SPqPtr, trash, &scratch) += here->BSIM4v6_102);
+               (*DEVmatSlot(here->BSIM4v6GPqPtr, trash, &scratch) -= here->BSIM4v6_103);
            }
     }
 }
 
+void BSIM4v6LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM4v6model *model = (BSIM4v6model*)inModel;
+    int *ColorStart = model->BSIM4v6ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM4v6ColorCount; color++)
+        BSIM4v6LoadRhsMatRange(model->BSIM4v6InstanceArray, ColorStart[color],
+                               ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM4v6LoadRhsMatRange(model->BSIM4v6InstanceArray, ColorStart[model->BSIM4v6ColorCount],
+                           model->BSIM4v6InstCount, 0, ckt, trash);
+}
+
 #endif
@@ -23,6 +23,7 @@ BSIM4v6mDelete(GENmodel *gen_model)
 
 #ifdef USE_OMP
     FREE(model->BSIM4v6InstanceArray);
+    FREE(model->BSIM4v6ColorStart);
 #endif
 
     struct bsim4v6SizeDependParam *p = model->pSizeDependParamKnot;
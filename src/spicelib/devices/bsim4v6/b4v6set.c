@@ -27,6 +27,7 @@
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "bsim4v6def.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
@@ -2445,6 +2446,8 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
         }
         model->BSIM4v6InstCount = 0;
         model->BSIM4v6InstanceArray = NULL;
+        model->BSIM4v6ColorCount = 0;
+        model->BSIM4v6ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM4v6instance*, InstCount);
     model = (BSIM4v6model*)inModel;
@@ -2462,6 +2465,11 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM4v6model*)inModel;
+    model->BSIM4v6ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM4v6ColorStart);
 #endif
 
     return(OK);
@@ -2477,6 +2485,7 @@ BSIM4v6unsetup(GENmodel *inModel, CKTcircuit *ckt)
 #ifdef USE_OMP
     model = (BSIM4v6model*)inModel;
     tfree(model->BSIM4v6InstanceArray);
+    tfree(model->BSIM4v6ColorStart);
 #endif
 
     for (model = (BSIM4v6model *)inModel; model != NULL;
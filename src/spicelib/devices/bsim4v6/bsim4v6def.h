@@ -1795,6 +1795,8 @@ typedef struct sBSIM4v6model
 #ifdef USE_OMP
     int BSIM4v6InstCount;
     struct sBSIM4v6instance **BSIM4v6InstanceArray;
+    int BSIM4v6ColorCount;
+    int *BSIM4v6ColorStart;
 #endif
 
     /* Flags */
@@ -28,6 +28,11 @@ extern int BSIM4v6noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM4v6unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM4v6soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM4v6LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM4v6LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM4v6bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM4v6bindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -67,6 +67,11 @@ SPICEdev BSIM4v6info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM4v6LoadOMP,
+    .DEVloadStamp = BSIM4v6LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM4v6bindCSC,
     .DEVbindCSCComplex = BSIM4v6bindCSCComplex,
@@ -59,11 +59,6 @@
         }                                                                     \
     }
 
-#ifdef USE_OMP
-int BSIM4v7LoadOMP(BSIM4v7instance *here, CKTcircuit *ckt);
-void BSIM4v7LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 int BSIM4v7polyDepletion(double phi, double ngate,double epsgate, double coxe, double Vgs, double *Vgs_eff, double *dVgs_eff_dVg);
 
 int
@@ -81,7 +76,7 @@ CKTcircuit *ckt)
 #pragma omp parallel for
     for (idx = 0; idx < model->BSIM4v7InstCount; idx++) {
         BSIM4v7instance *here = InstArray[idx];
-        int local_error = BSIM4v7LoadOMP(here, ckt);
+        int local_error = BSIM4v7LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -92,7 +87,8 @@ CKTcircuit *ckt)
 }
 
 
-int BSIM4v7LoadOMP(BSIM4v7instance *here, CKTcircuit *ckt) {
+int BSIM4v7LoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+BSIM4v7instance *here = (BSIM4v7instance *) inInst;
 BSIM4v7model *model = BSIM4v7modPtr(here);
 #else
 BSIM4v7model *model = (BSIM4v7model*)inModel;
@@ -5357,191 +5353,208 @@ int BSIM4v7polyDepletion(
 }
 
 #ifdef USE_OMP
-void BSIM4v7LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+BSIM4v7LoadRhsMatRange(BSIM4v7instance **InstArray, int first, int last, int parallel,
+                       CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    BSIM4v7instance **InstArray;
+    int idx;
     BSIM4v7instance *here;
-    BSIM4v7model *model = (BSIM4v7model*)inModel;
+    BSIM4v7model *model;
 
-    InstArray = model->BSIM4v7InstanceArray;
-    InstCount = model->BSIM4v7InstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = BSIM4v7modPtr(here);
         /* Update b for Ax = b */
-           (*(ckt->CKTrhs + here->BSIM4v7dNodePrime) += here->BSIM4v7rhsdPrime);
-           (*(ckt->CKTrhs + here->BSIM4v7gNodePrime) -= here->BSIM4v7rhsgPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7dNodePrime, &scratch) += here->BSIM4v7rhsdPrime);
+           (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7gNodePrime, &scratch) -= here->BSIM4v7rhsgPrime);
 
            if (here->BSIM4v7rgateMod == 2)
-               (*(ckt->CKTrhs + here->BSIM4v7gNodeExt) -= here->BSIM4v7rhsgExt);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7gNodeExt, &scratch) -= here->BSIM4v7rhsgExt);
            else if (here->BSIM4v7rgateMod == 3)
-               (*(ckt->CKTrhs + here->BSIM4v7gNodeMid) -= here->BSIM4v7grhsMid);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7gNodeMid, &scratch) -= here->BSIM4v7grhsMid);
 
            if (!here->BSIM4v7rbodyMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v7bNodePrime) += here->BSIM4v7rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v7sNodePrime) += here->BSIM4v7rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7bNodePrime, &scratch) += here->BSIM4v7rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7sNodePrime, &scratch) += here->BSIM4v7rhssPrime);
            }
            else
-           {   (*(ckt->CKTrhs + here->BSIM4v7dbNode) -= here->BSIM4v7rhsdb);
-               (*(ckt->CKTrhs + here->BSIM4v7bNodePrime) += here->BSIM4v7rhsbPrime);
-               (*(ckt->CKTrhs + here->BSIM4v7sbNode) -= here->BSIM4v7rhssb);
-               (*(ckt->CKTrhs + here->BSIM4v7sNodePrime) += here->BSIM4v7rhssPrime);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7dbNode, &scratch) -= here->BSIM4v7rhsdb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7bNodePrime, &scratch) += here->BSIM4v7rhsbPrime);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7sbNode, &scratch) -= here->BSIM4v7rhssb);
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7sNodePrime, &scratch) += here->BSIM4v7rhssPrime);
            }
 
            if (model->BSIM4v7rdsMod)
-           {   (*(ckt->CKTrhs + here->BSIM4v7dNode) -= here->BSIM4v7rhsd); 
-               (*(ckt->CKTrhs + here->BSIM4v7sNode) += here->BSIM4v7rhss);
+           {   (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7dNode, &scratch) -= here->BSIM4v7rhsd); 
+               (*DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7sNode, &scratch) += here->BSIM4v7rhss);
            }
 
            if (here->BSIM4v7trnqsMod)
-               *(ckt->CKTrhs + here->BSIM4v7qNode) += here->BSIM4v7rhsq;
+               *DEVrhsSlot(ckt->CKTrhs, here->BSIM4v7qNode, &scratch) += here->BSIM4v7rhsq;
 
 
         /* Update A for Ax = b */
            if (here->BSIM4v7rgateMod == 1)
-           {   (*(here->BSIM4v7GEgePtr) += here->BSIM4v7_1);
-               (*(here->BSIM4v7GPgePtr) -= here->BSIM4v7_2);
-               (*(here->BSIM4v7GEgpPtr) -= here->BSIM4v7_3);
-               (*(here->BSIM4v7GPgpPtr) += here->BSIM4v7_4);
-               (*(here->BSIM4v7GPdpPtr) += here->BSIM4v7_5);
-               (*(here->BSIM4v7GPspPtr) += here->BSIM4v7_6);
-               (*(here->BSIM4v7GPbpPtr) += here->BSIM4v7_7);
+           {   (*DEVmatSlot(here->BSIM4v7GEgePtr, trash, &scratch) += here->BSIM4v7_1);
+               (*DEVmatSlot(here->BSIM4v7GPgePtr, trash, &scratch) -= here->BSIM4v7_2);
+               (*DEVmatSlot(here->BSIM4v7GEgpPtr, trash, &scratch) -= here->BSIM4v7_3);
+               (*DEVmatSlot(here->BSIM4v7GPgpPtr, trash, &scratch) += here->BSIM4v7_4);
+               (*DEVmatSlot(here->BSIM4v7GPdpPtr, trash, &scratch) += here->BSIM4v7_5);
+               (*DEVmatSlot(here->BSIM4v7GPspPtr, trash, &scratch) += here->BSIM4v7_6);
+               (*DEVmatSlot(here->BSIM4v7GPbpPtr, trash, &scratch) += here->BSIM4v7_7);
            }
            else if (here->BSIM4v7rgateMod == 2)        
-           {   (*(here->BSIM4v7GEgePtr) += here->BSIM4v7_8);
-               (*(here->BSIM4v7GEgpPtr) += here->BSIM4v7_9);
-               (*(here->BSIM4v7GEdpPtr) += here->BSIM4v7_10);
-               (*(here->BSIM4v7GEspPtr) += here->BSIM4v7_11);
-               (*(here->BSIM4v7GEbpPtr) += here->BSIM4v7_12);        
-
-               (*(here->BSIM4v7GPgePtr) -= here->BSIM4v7_13);
-               (*(here->BSIM4v7GPgpPtr) += here->BSIM4v7_14);
-               (*(here->BSIM4v7GPdpPtr) += here->BSIM4v7_15);
-               (*(here->BSIM4v7GPspPtr) += here->BSIM4v7_16);
-               (*(here->BSIM4v7GPbpPtr) += here->BSIM4v7_17);
+           {   (*DEVmatSlot(here->BSIM4v7GEgePtr, trash, &scratch) += here->BSIM4v7_8);
+               (*DEVmatSlot(here->BSIM4v7GEgpPtr, trash, &scratch) += here->BSIM4v7_9);
+               (*DEVmatSlot(here->BSIM4v7GEdpPtr, trash, &scratch) += here->BSIM4v7_10);
+               (*DEVmatSlot(here->BSIM4v7GEspPtr, trash, &scratch) += here->BSIM4v7_11);
+               (*DEVmatSlot(here->BSIM4v7GEbpPtr, trash, &scratch) += here->BSIM4v7_12);        
+
+               (*DEVmatSlot(here->BSIM4v7GPgePtr, trash, &scratch) -= here->BSIM4v7_13);
+               (*DEVmatSlot(here->BSIM4v7GPgpPtr, trash, &scratch) += here->BSIM4v7_14);
+               (*DEVmatSlot(here->BSIM4v7GPdpPtr, trash, &scratch) += here->BSIM4v7_15);
+               (*DEVmatSlot(here->BSIM4v7GPspPtr, trash, &scratch) += here->BSIM4v7_16);
+               (*DEVmatSlot(here->BSIM4v7GPbpPtr, trash, &scratch) += here->BSIM4v7_17);
            }
            else if (here->BSIM4v7rgateMod == 3)
-           {   (*(here->BSIM4v7GEgePtr) += here->BSIM4v7_18);
-               (*(here->BSIM4v7GEgmPtr) -= here->BSIM4v7_19);
-               (*(here->BSIM4v7GMgePtr) -= here->BSIM4v7_20);
-               (*(here->BSIM4v7GMgmPtr) += here->BSIM4v7_21);
-
-               (*(here->BSIM4v7GMdpPtr) += here->BSIM4v7_22);
-               (*(here->BSIM4v7GMgpPtr) += here->BSIM4v7_23);
-               (*(here->BSIM4v7GMspPtr) += here->BSIM4v7_24);
-               (*(here->BSIM4v7GMbpPtr) += here->BSIM4v7_25);
-
-               (*(here->BSIM4v7DPgmPtr) += here->BSIM4v7_26);
-               (*(here->BSIM4v7GPgmPtr) -= here->BSIM4v7_27);
-               (*(here->BSIM4v7SPgmPtr) += here->BSIM4v7_28);
-               (*(here->BSIM4v7BPgmPtr) += here->BSIM4v7_29);
-
-               (*(here->BSIM4v7GPgpPtr) += here->BSIM4v7_30);
-               (*(here->BSIM4v7GPdpPtr) += here->BSIM4v7_31);
-               (*(here->BSIM4v7GPspPtr) += here->BSIM4v7_32);
-               (*(here->BSIM4v7GPbpPtr) += here->BSIM4v7_33);
+           {   (*DEVmatSlot(here->BSIM4v7GEgePtr, trash, &scratch) += here->BSIM4v7_18);
+               (*DEVmatSlot(here->BSIM4v7GEgmPtr, trash, &scratch) -= here->BSIM4v7_19);
+               (*DEVmatSlot(here->BSIM4v7GMgePtr, trash, &scratch) -= here->BSIM4v7_20);
+               (*DEVmatSlot(here->BSIM4v7GMgmPtr, trash, &scratch) += here->BSIM4v7_21);
+
+               (*DEVmatSlot(here->BSIM4v7GMdpPtr, trash, &scratch) += here->BSIM4v7_22);
+               (*DEVmatSlot(here->BSIM4v7GMgpPtr, trash, &scratch) += here->BSIM4v7_23);
+               (*DEVmatSlot(here->BSIM4v7GMspPtr, trash, &scratch) += here->BSIM4v7_24);
+               (*DEVmatSlot(here->BSIM4v7GMbpPtr, trash, &scratch) += here->BSIM4v7_25);
+
+               (*DEVmatSlot(here->BSIM4v7DPgmPtr, trash, &scratch) += here->BSIM4v7_26);
+               (*DEVmatSlot(here->BSIM4v7GPgmPtr, trash, &scratch) -= here->BSIM4v7_27);
+               (*DEVmatSlot(here->BSIM4v7SPgmPtr, trash, &scratch) += here->BSIM4v7_28);
+               (*DEVmatSlot(here->BSIM4v7BPgmPtr, trash, &scratch) += here->BSIM4v7_29);
+
+               (*DEVmatSlot(here->BSIM4v7GPgpPtr, trash, &scratch) += here->BSIM4v7_30);
+               (*DEVmatSlot(here->BSIM4v7GPdpPtr, trash, &scratch) += here->BSIM4v7_31);
+               (*DEVmatSlot(here->BSIM4v7GPspPtr, trash, &scratch) += here->BSIM4v7_32);
+               (*DEVmatSlot(here->BSIM4v7GPbpPtr, trash, &scratch) += here->BSIM4v7_33);
            }
 
 
             else
-           {   (*(here->BSIM4v7GPgpPtr) += here->BSIM4v7_34);
-               (*(here->BSIM4v7GPdpPtr) += here->BSIM4v7_35);
-               (*(here->BSIM4v7GPspPtr) += here->BSIM4v7_36);
-               (*(here->BSIM4v7GPbpPtr) += here->BSIM4v7_37);
+           {   (*DEVmatSlot(here->BSIM4v7GPgpPtr, trash, &scratch) += here->BSIM4v7_34);
+               (*DEVmatSlot(here->BSIM4v7GPdpPtr, trash, &scratch) += here->BSIM4v7_35);
+               (*DEVmatSlot(here->BSIM4v7GPspPtr, trash, &scratch) += here->BSIM4v7_36);
+               (*DEVmatSlot(here->BSIM4v7GPbpPtr, trash, &scratch) += here->BSIM4v7_37);
            }
 
 
            if (model->BSIM4v7rdsMod)
-           {   (*(here->BSIM4v7DgpPtr) += here->BSIM4v7_38);
-               (*(here->BSIM4v7DspPtr) += here->BSIM4v7_39);
-               (*(here->BSIM4v7DbpPtr) += here->BSIM4v7_40);
-               (*(here->BSIM4v7SdpPtr) += here->BSIM4v7_41);
-               (*(here->BSIM4v7SgpPtr) += here->BSIM4v7_42);
-               (*(here->BSIM4v7SbpPtr) += here->BSIM4v7_43);
+           {   (*DEVmatSlot(here->BSIM4v7DgpPtr, trash, &scratch) += here->BSIM4v7_38);
+               (*DEVmatSlot(here->BSIM4v7DspPtr, trash, &scratch) += here->BSIM4v7_39);
+               (*DEVmatSlot(here->BSIM4v7DbpPtr, trash, &scratch) += here->BSIM4v7_40);
+               (*DEVmatSlot(here->BSIM4v7SdpPtr, trash, &scratch) += here->BSIM4v7_41);
+               (*DEVmatSlot(here->BSIM4v7SgpPtr, trash, &scratch) += here->BSIM4v7_42);
+               (*DEVmatSlot(here->BSIM4v7SbpPtr, trash, &scratch) += here->BSIM4v7_43);
            }
 
-           (*(here->BSIM4v7DPdpPtr) += here->BSIM4v7_44);
-           (*(here->BSIM4v7DPdPtr) -= here->BSIM4v7_45);
-           (*(here->BSIM4v7DPgpPtr) += here->BSIM4v7_46);
-           (*(here->BSIM4v7DPspPtr) -= here->BSIM4v7_47);
-           (*(here->BSIM4v7DPbpPtr) -= here->BSIM4v7_48);
+           (*DEVmatSlot(here->BSIM4v7DPdpPtr, trash, &scratch) += here->BSIM4v7_44);
+           (*DEVmatSlot(here->BSIM4v7DPdPtr, trash, &scratch) -= here->BSIM4v7_45);
+           (*DEVmatSlot(here->BSIM4v7DPgpPtr, trash, &scratch) += here->BSIM4v7_46);
+           (*DEVmatSlot(here->BSIM4v7DPspPtr, trash, &scratch) -= here->BSIM4v7_47);
+           (*DEVmatSlot(here->BSIM4v7DPbpPtr, trash, &scratch) -= here->BSIM4v7_48);
 
-           (*(here->BSIM4v7DdpPtr) -= here->BSIM4v7_49);
-           (*(here->BSIM4v7DdPtr) += here->BSIM4v7_50);
+           (*DEVmatSlot(here->BSIM4v7DdpPtr, trash, &scratch) -= here->BSIM4v7_49);
+           (*DEVmatSlot(here->BSIM4v7DdPtr, trash, &scratch) += here->BSIM4v7_50);
 
-           (*(here->BSIM4v7SPdpPtr) -= here->BSIM4v7_51);
-           (*(here->BSIM4v7SPgpPtr) += here->BSIM4v7_52);
-           (*(here->BSIM4v7SPspPtr) += here->BSIM4v7_53);
-           (*(here->BSIM4v7SPsPtr) -= here->BSIM4v7_54);
-           (*(here->BSIM4v7SPbpPtr) -= here->BSIM4v7_55);
+           (*DEVmatSlot(here->BSIM4v7SPdpPtr, trash, &scratch) -= here->BSIM4v7_51);
+           (*DEVmatSlot(here->BSIM4v7SPgpPtr, trash, &scratch) += here->BSIM4v7_52);
+           (*DEVmatSlot(here->BSIM4v7SPspPtr, trash, &scratch) += here->BSIM4v7_53);
+           (*DEVmatSlot(here->BSIM4v7SPsPtr, trash, &scratch) -= here->BSIM4v7_54);
+           (*DEVmatSlot(here->BSIM4v7SPbpPtr, trash, &scratch) -= here->BSIM4v7_55);
 
-           (*(here->BSIM4v7SspPtr) -= here->BSIM4v7_56);
-           (*(here->BSIM4v7SsPtr) += here->BSIM4v7_57);
+           (*DEVmatSlot(here->BSIM4v7SspPtr, trash, &scratch) -= here->BSIM4v7_56);
+           (*DEVmatSlot(here->BSIM4v7SsPtr, trash, &scratch) += here->BSIM4v7_57);
 
-           (*(here->BSIM4v7BPdpPtr) += here->BSIM4v7_58);
-           (*(here->BSIM4v7BPgpPtr) += here->BSIM4v7_59);
-           (*(here->BSIM4v7BPspPtr) += here->BSIM4v7_60);
-           (*(here->BSIM4v7BPbpPtr) += here->BSIM4v7_61);
+           (*DEVmatSlot(here->BSIM4v7BPdpPtr, trash, &scratch) += here->BSIM4v7_58);
+           (*DEVmatSlot(here->BSIM4v7BPgpPtr, trash, &scratch) += here->BSIM4v7_59);
+           (*DEVmatSlot(here->BSIM4v7BPspPtr, trash, &scratch) += here->BSIM4v7_60);
+           (*DEVmatSlot(here->BSIM4v7BPbpPtr, trash, &scratch) += here->BSIM4v7_61);
 
            /* stamp gidl */
-           (*(here->BSIM4v7DPdpPtr) += here->BSIM4v7_62);
-           (*(here->BSIM4v7DPgpPtr) += here->BSIM4v7_63);
-           (*(here->BSIM4v7DPspPtr) -= here->BSIM4v7_64);
-           (*(here->BSIM4v7DPbpPtr) += here->BSIM4v7_65);
-           (*(here->BSIM4v7BPdpPtr) -= here->BSIM4v7_66);
-           (*(here->BSIM4v7BPgpPtr) -= here->BSIM4v7_67);
-           (*(here->BSIM4v7BPspPtr) += here->BSIM4v7_68);
-           (*(here->BSIM4v7BPbpPtr) -= here->BSIM4v7_69);
+           (*DEVmatSlot(here->BSIM4v7DPdpPtr, trash, &scratch) += here->BSIM4v7_62);
+           (*DEVmatSlot(here->BSIM4v7DPgpPtr, trash, &scratch) += here->BSIM4v7_63);
+           (*DEVmatSlot(here->BSIM4v7DPspPtr, trash, &scratch) -= here->BSIM4v7_64);
+           (*DEVmatSlot(here->BSIM4v7DPbpPtr, trash, &scratch) += here->BSIM4v7_65);
+           (*DEVmatSlot(here->BSIM4v7BPdpPtr, trash, &scratch) -= here->BSIM4v7_66);
+           (*DEVmatSlot(here->BSIM4v7BPgpPtr, trash, &scratch) -= here->BSIM4v7_67);
+           (*DEVmatSlot(here->BSIM4v7BPspPtr, trash, &scratch) += here->BSIM4v7_68);
+           (*DEVmatSlot(here->BSIM4v7BPbpPtr, trash, &scratch) -= here->BSIM4v7_69);
             /* stamp gisl */
-           (*(here->BSIM4v7SPdpPtr) -= here->BSIM4v7_70);
-           (*(here->BSIM4v7SPgpPtr) += here->BSIM4v7_71);
-           (*(here->BSIM4v7SPspPtr) += here->BSIM4v7_72);
-           (*(here->BSIM4v7SPbpPtr) += here->BSIM4v7_73);
-           (*(here->BSIM4v7BPdpPtr) += here->BSIM4v7_74);
-           (*(here->BSIM4v7BPgpPtr) -= here->BSIM4v7_75);
-           (*(here->BSIM4v7BPspPtr) -= here->BSIM4v7_76);
-           (*(here->BSIM4v7BPbpPtr) -= here->BSIM4v7_77);
+           (*DEVmatSlot(here->BSIM4v7SPdpPtr, trash, &scratch) -= here->BSIM4v7_70);
+           (*DEVmatSlot(here->BSIM4v7SPgpPtr, trash, &scratch) += here->BSIM4v7_71);
+           (*DEVmatSlot(here->BSIM4v7SPspPtr, trash, &scratch) += here->BSIM4v7_72);
+           (*DEVmatSlot(here->BSIM4v7SPbpPtr, trash, &scratch) += here->BSIM4v7_73);
+           (*DEVmatSlot(here->BSIM4v7BPdpPtr, trash, &scratch) += here->BSIM4v7_74);
+           (*DEVmatSlot(here->BSIM4v7BPgpPtr, trash, &scratch) -= here->BSIM4v7_75);
+           (*DEVmatSlot(here->BSIM4v7BPspPtr, trash, &scratch) -= here->BSIM4v7_76);
+           (*DEVmatSlot(here->BSIM4v7BPbpPtr, trash, &scratch) -= here->BSIM4v7_77);
 
 
            if (here->BSIM4v7rbodyMod)
-           {   (*(here->BSIM4v7DPdbPtr) += here->BSIM4v7_78);
-               (*(here->BSIM4v7SPsbPtr) -= here->BSIM4v7_79);
-
-               (*(here->BSIM4v7DBdpPtr) += here->BSIM4v7_80);
-               (*(here->BSIM4v7DBdbPtr) += here->BSIM4v7_81);
-               (*(here->BSIM4v7DBbpPtr) -= here->BSIM4v7_82);
-               (*(here->BSIM4v7DBbPtr) -= here->BSIM4v7_83);
-
-               (*(here->BSIM4v7BPdbPtr) -= here->BSIM4v7_84);
-               (*(here->BSIM4v7BPbPtr) -= here->BSIM4v7_85);
-               (*(here->BSIM4v7BPsbPtr) -= here->BSIM4v7_86);
-               (*(here->BSIM4v7BPbpPtr) += here->BSIM4v7_87);
-
-               (*(here->BSIM4v7SBspPtr) += here->BSIM4v7_88);
-               (*(here->BSIM4v7SBbpPtr) -= here->BSIM4v7_89);
-               (*(here->BSIM4v7SBbPtr) -= here->BSIM4v7_90);
-               (*(here->BSIM4v7SBsbPtr) += here->BSIM4v7_91);
-
-               (*(here->BSIM4v7BdbPtr) -= here->BSIM4v7_92);
-               (*(here->BSIM4v7BbpPtr) -= here->BSIM4v7_93);
-               (*(here->BSIM4v7BsbPtr) -= here->BSIM4v7_94);
-               (*(here->BSIM4v7BbPtr) += here->BSIM4v7_95);
+           {   (*DEVmatSlot(here->BSIM4v7DPdbPtr, trash, &scratch) += here->BSIM4v7_78);
+               (*DEVmatSlot(here->BSIM4v7SPsbPtr, trash, &scratch) -= here->BSIM4v7_79);
+
+               (*DEVmatSlot(here->BSIM4v7DBdpPtr, trash, &scratch) += here->BSIM4v7_80);
+               (*DEVmatSlot(here->BSIM4v7DBdbPtr, trash, &scratch) += here->BSIM4v7_81);
+               (*DEVmatSlot(here->BSIM4v7DBbpPtr, trash, &scratch) -= here->BSIM4v7_82);
+               (*DEVmatSlot(here->BSIM4v7DBbPtr, trash, &scratch) -= here->BSIM4v7_83);
+
+               (*DEVmatSlot(here->BSIM4v7BPdbPtr, trash, &scratch) -= here->BSIM4v7_84);
+               (*DEVmatSlot(here->BSIM4v7BPbPtr, trash, &scratch) -= here->BSIM4v7_85);
+               (*DEVmatSlot(here->BSIM4v7BPsbPtr, trash, &scratch) -= here->BSIM4v7_86);
+               (*DEVmatSlot(here->BSIM4v7BPbpPtr, trash, &scratch) += here->BSIM4v7_87);
+
+               (*DEVmatSlot(here->BSIM4v7SBspPtr, trash, &scratch) += here->BSIM4v7_88);
+               (*DEVmatSlot(here->BSIM4v7SBbpPtr, trash, &scratch) -= here->BSIM4v7_89);
+               (*DEVmatSlot(here->BSIM4v7SBbPtr, trash, &scratch) -= here->BSIM4v7_90);
+               (*DEVmatSlot(here->BSIM4v7SBsbPtr, trash, &scratch) += here->BSIM4v7_91);
+
+               (*DEVmatSlot(here->BSIM4v7BdbPtr, trash, &scratch) -= here->BSIM4v7_92);
+               (*DEVmatSlot(here->BSIM4v7BbpPtr, trash, &scratch) -= here->BSIM4v7_93);
+               (*DEVmatSlot(here->BSIM4v7BsbPtr, trash, &scratch) -= here->BSIM4v7_94);
+               (*DEVmatSlot(here->BSIM4v7BbPtr, trash, &scratch) += here->BSIM4v7_95);
            }
 
            if (here->BSIM4v7trnqsMod)
-           {   (*(here->BSIM4v7QqPtr) += here->BSIM4v7_96);
-               (*(here->BSIM4v7QgpPtr) += here->BSIM4v7_97);
-               (*(here->BSIM4v7QdpPtr) += here->BSIM4v7_98);
-               (*(here->BSIM4v7QspPtr) += here->BSIM4v7_99);
-               (*(here->BSIM4v7QbpPtr) += here->BSIM4v7_100);
-
-               (*(here->BSIM4v7DPqPtr) += here->BSIM4v7_101);
-               (*(here->BSIM4v7SPqPtr) += here->BSIM4v7_102);
-               (*(here->BSIM4v7GPqPtr) -= here->BSIM4v7_103);
+           {   (*DEVmatSlot(here->BSIM4v7QqPtr, trash, &scratch) += here->BSIM4v7_96);
+               (*DEVmatSlot(here->BSIM4v7QgpPtr, trash, &scratch) += here->BSIM4v7_97);
+               (*DEVmatSlot(here->BSIM4v7QdpPtr, trash, &scratch) += here->BSIM4v7_98);
+               (*DEVmatSlot(here->BSIM4v7QspPtr, trash, &scratch) += here->BSIM4v7_99);
+               (*DEVmatSlot(here->BSIM4v7QbpPtr, trash, &scratch) += here->BSIM4v7_100);
+
+               (*DEVmatSlot(here->BSIM4v7DPqPtr, trash, &scratch) += here->BSIM4v7_101);
+               (*DEVmatSlot(here->BSIM4v7SPqPtr, trash, &scratch) += here->BSIM4v7_102);
+               (*DEVmatSlot(here->BSIM4v7GPqPtr, trash, &scratch) -= here->BSIM4v7_103);
            }
     }
 }
 
+void BSIM4v7LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    BSIM4v7model *model = (BSIM4v7model*)inModel;
+    int *ColorStart = model->BSIM4v7ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->BSIM4v7ColorCount; color++)
+        BSIM4v7LoadRhsMatRange(model->BSIM4v7InstanceArray, ColorStart[color],
+                               ColorStart[color + 1], 1, ckt, trash);
+
+    BSIM4v7LoadRhsMatRange(model->BSIM4v7InstanceArray, ColorStart[model->BSIM4v7ColorCount],
+                           model->BSIM4v7InstCount, 0, ckt, trash);
+}
+
 #endif
@@ -23,6 +23,7 @@ BSIM4v7mDelete(GENmodel *gen_model)
 
 #ifdef USE_OMP
     FREE(model->BSIM4v7InstanceArray);
+    FREE(model->BSIM4v7ColorStart);
 #endif
 
     struct bsim4SizeDependParam *p = model->pSizeDependParamKnot;
@@ -27,6 +27,7 @@
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "bsim4v7def.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
@@ -2598,6 +2599,8 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
         }
         model->BSIM4v7InstCount = 0;
         model->BSIM4v7InstanceArray = NULL;
+        model->BSIM4v7ColorCount = 0;
+        model->BSIM4v7ColorStart = NULL;
     }
     InstArray = TMALLOC(BSIM4v7instance*, InstCount);
     model = (BSIM4v7model*)inModel;
@@ -2615,6 +2618,11 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (BSIM4v7model*)inModel;
+    model->BSIM4v7ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->BSIM4v7ColorStart);
 #endif
 
     return(OK);
@@ -2632,6 +2640,7 @@ CKTcircuit *ckt)
 #ifdef USE_OMP
     model = (BSIM4v7model*)inModel;
     tfree(model->BSIM4v7InstanceArray);
+    tfree(model->BSIM4v7ColorStart);
 #endif
 
     for (model = (BSIM4v7model *)inModel; model != NULL;
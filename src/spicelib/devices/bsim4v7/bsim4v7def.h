@@ -1868,6 +1868,8 @@ typedef struct sBSIM4v7model
 #ifdef USE_OMP
     int BSIM4v7InstCount;
     struct sBSIM4v7instance **BSIM4v7InstanceArray;
+    int BSIM4v7ColorCount;
+    int *BSIM4v7ColorStart;
 #endif
 
     /* Flags */
@@ -28,6 +28,11 @@ extern int BSIM4v7noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int BSIM4v7unsetup(GENmodel*,CKTcircuit*);
 extern int BSIM4v7soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int BSIM4v7LoadOMP(GENinstance*,CKTcircuit*);
+extern void BSIM4v7LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int BSIM4v7bindCSC (GENmodel*, CKTcircuit*) ;
 extern int BSIM4v7bindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -67,6 +67,11 @@ SPICEdev BSIM4v7info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = BSIM4v7LoadOMP,
+    .DEVloadStamp = BSIM4v7LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = BSIM4v7bindCSC,
     .DEVbindCSCComplex = BSIM4v7bindCSCComplex,
@@ -2249,6 +2249,8 @@ typedef struct sB4SOImodel
 #ifdef USE_OMP
     int B4SOIInstCount;
     struct sB4SOIinstance **B4SOIInstanceArray;
+    int B4SOIColorCount;
+    int *B4SOIColorStart;
 #endif
 
     /* Flags */
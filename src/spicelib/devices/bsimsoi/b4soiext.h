@@ -30,6 +30,11 @@ extern int B4SOInoise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int B4SOIunsetup(GENmodel*,CKTcircuit*);
 extern int B4SOIsoaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int B4SOILoadOMP(GENinstance*,CKTcircuit*);
+extern void B4SOILoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int B4SOIbindCSC (GENmodel*, CKTcircuit*) ;
 extern int B4SOIbindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -65,6 +65,11 @@ SPICEdev B4SOIinfo = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = B4SOILoadOMP,
+    .DEVloadStamp = B4SOILoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = B4SOIbindCSC,
     .DEVbindCSCComplex = B4SOIbindCSCComplex,
@@ -63,11 +63,6 @@
 
 #define FLOG(A)  fabs(A) + 1e-14
 
-#ifdef USE_OMP
-int B4SOILoadOMP(B4SOIinstance *here, CKTcircuit *ckt);
-void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 /* B4SOIlimit(vnew,vold)
  *  limits the per-iteration change of any absolute voltage value
  */
@@ -116,7 +111,7 @@ B4SOIload(
 #pragma omp parallel for
     for (idx = 0; idx < model->B4SOIInstCount; idx++) {
         B4SOIinstance *here = InstArray[idx];
-        int local_error = B4SOILoadOMP(here, ckt);
+        int local_error = B4SOILoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -126,7 +121,8 @@ B4SOIload(
     return error;
 }
 
-int B4SOILoadOMP(B4SOIinstance *here, CKTcircuit *ckt) {
+int B4SOILoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+    B4SOIinstance *here = (B4SOIinstance *) inInst;
     B4SOImodel *model = B4SOImodPtr(here);
 #else
     register B4SOImodel *model = (B4SOImodel*)inModel;
@@ -10954,17 +10950,18 @@ Update to matrix will be done only when all instances of this model
 have their values calculated and stored. Thus there is no further 
 synchronisation required.*/
 
-void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+B4SOILoadRhsMatRange(B4SOIinstance **InstArray, int first, int last, int parallel,
+                     CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    B4SOIinstance **InstArray;
+    int idx;
     B4SOIinstance *here;
-    B4SOImodel *model = (B4SOImodel*)inModel;
+    B4SOImodel *model;
 
-    InstArray = model->B4SOIInstanceArray;
-    InstCount = model->B4SOIInstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for(idx = first; idx < last; idx++) {
+       double scratch;
 
-    for(idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = B4SOImodPtr(here);
         /* Update b for Ax = b */
@@ -10972,107 +10969,107 @@ void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
             /* v3.1 */
 
             /* v3.1 added ceqgcrg for RF */
-            (*(ckt->CKTrhs + here->B4SOIgNode) -= here->B4SOINode_1);
+            (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIgNode, &scratch) -= here->B4SOINode_1);
             /* v3.1 added ceqgcrg for RF end */
 
-            (*(ckt->CKTrhs + here->B4SOIdNodePrime) += here->B4SOINode_2);
+            (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIdNodePrime, &scratch) += here->B4SOINode_2);
             if (!here->B4SOIrbodyMod) {
-                (*(ckt->CKTrhs + here->B4SOIsNodePrime) += here->B4SOINode_3); /* v4.0 */
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIsNodePrime, &scratch) += here->B4SOINode_3); /* v4.0 */
             }
             else { /* v4.0 */
-                (*(ckt->CKTrhs + here->B4SOIsNodePrime) += here->B4SOINode_4);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIsNodePrime, &scratch) += here->B4SOINode_4);
             }
 
-            (*(ckt->CKTrhs + here->B4SOIeNode) -= here->B4SOINode_5);
+            (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIeNode, &scratch) -= here->B4SOINode_5);
 
             if (here->B4SOIrgateMod == 2)
-                (*(ckt->CKTrhs + here->B4SOIgNodeExt) -= here->B4SOINode_6);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIgNodeExt, &scratch) -= here->B4SOINode_6);
             else if (here->B4SOIrgateMod == 3)
-                (*(ckt->CKTrhs + here->B4SOIgNodeMid) -= here->B4SOINode_7);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIgNodeMid, &scratch) -= here->B4SOINode_7);
 
             if (here->B4SOIbodyMod == 1) {
-                (*(ckt->CKTrhs + here->B4SOIpNode) += here->B4SOINode_8);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIpNode, &scratch) += here->B4SOINode_8);
             }
 
             if ( here->B4SOIsoiMod != 2 )
             {if (!here->B4SOIrbodyMod)
-                (*(ckt->CKTrhs + here->B4SOIbNode) -= here->B4SOINode_9);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIbNode, &scratch) -= here->B4SOINode_9);
                 else /* v4.0 */
-                { (*(ckt->CKTrhs + here->B4SOIdbNode) -= here->B4SOINode_10);
-                    (*(ckt->CKTrhs + here->B4SOIbNode) -= here->B4SOINode_11);
-                    (*(ckt->CKTrhs + here->B4SOIsbNode) -= here->B4SOINode_12);
+                { (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIdbNode, &scratch) -= here->B4SOINode_10);
+                    (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIbNode, &scratch) -= here->B4SOINode_11);
+                    (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIsbNode, &scratch) -= here->B4SOINode_12);
                 }
             }
             
             if (here->B4SOINode_sh) {
-                (*(ckt->CKTrhs + here->B4SOItempNode) -= here->B4SOINode_13);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOItempNode, &scratch) -= here->B4SOINode_13);
             }
 
             if (model->B4SOIrdsMod)
-            {   (*(ckt->CKTrhs + here->B4SOIdNode) -= here->B4SOINode_14);
-                (*(ckt->CKTrhs + here->B4SOIsNode) += here->B4SOINode_15);
+            {   (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIdNode, &scratch) -= here->B4SOINode_14);
+                (*DEVrhsSlot(ckt->CKTrhs, here->B4SOIsNode, &scratch) += here->B4SOINode_15);
             }
 
 
             if (here->B4SOIdebugMod != 0)
             {
-                *(ckt->CKTrhs + here->B4SOIvbsNode) = here->B4SOIvbseff;
-                *(ckt->CKTrhs + here->B4SOIidsNode) = FLOG(here->B4SOIids);
-                *(ckt->CKTrhs + here->B4SOIicNode) = FLOG(here->B4SOIic);
-                *(ckt->CKTrhs + here->B4SOIibsNode) = FLOG(here->B4SOIibs);
-                *(ckt->CKTrhs + here->B4SOIibdNode) = FLOG(here->B4SOIibd);
-                *(ckt->CKTrhs + here->B4SOIiiiNode) = FLOG(here->B4SOIiii);
-                *(ckt->CKTrhs + here->B4SOIigNode) = here->B4SOIig;
-                *(ckt->CKTrhs + here->B4SOIgiggNode) = here->B4SOIgigg;
-                *(ckt->CKTrhs + here->B4SOIgigdNode) = here->B4SOIgigd;
-                *(ckt->CKTrhs + here->B4SOIgigbNode) = here->B4SOIgigb;
-                *(ckt->CKTrhs + here->B4SOIigidlNode) = here->B4SOIigidl;
-                *(ckt->CKTrhs + here->B4SOIitunNode) = here->B4SOIitun;
-                *(ckt->CKTrhs + here->B4SOIibpNode) = here->B4SOIibp;
-                *(ckt->CKTrhs + here->B4SOIcbbNode) = here->B4SOIcbb;
-                *(ckt->CKTrhs + here->B4SOIcbdNode) = here->B4SOIcbd;
-                *(ckt->CKTrhs + here->B4SOIcbgNode) = here->B4SOIcbg;
-                *(ckt->CKTrhs + here->B4SOIqbfNode) = here->B4SOIqbf;
-                *(ckt->CKTrhs + here->B4SOIqjsNode) = here->B4SOIqjs;
-                *(ckt->CKTrhs + here->B4SOIqjdNode) = here->B4SOIqjd;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIvbsNode, &scratch) = here->B4SOIvbseff;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIidsNode, &scratch) = FLOG(here->B4SOIids);
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIicNode, &scratch) = FLOG(here->B4SOIic);
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIibsNode, &scratch) = FLOG(here->B4SOIibs);
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIibdNode, &scratch) = FLOG(here->B4SOIibd);
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIiiiNode, &scratch) = FLOG(here->B4SOIiii);
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIigNode, &scratch) = here->B4SOIig;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIgiggNode, &scratch) = here->B4SOIgigg;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIgigdNode, &scratch) = here->B4SOIgigd;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIgigbNode, &scratch) = here->B4SOIgigb;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIigidlNode, &scratch) = here->B4SOIigidl;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIitunNode, &scratch) = here->B4SOIitun;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIibpNode, &scratch) = here->B4SOIibp;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIcbbNode, &scratch) = here->B4SOIcbb;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIcbdNode, &scratch) = here->B4SOIcbd;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIcbgNode, &scratch) = here->B4SOIcbg;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIqbfNode, &scratch) = here->B4SOIqbf;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIqjsNode, &scratch) = here->B4SOIqjs;
+                *DEVrhsSlot(ckt->CKTrhs, here->B4SOIqjdNode, &scratch) = here->B4SOIqjd;
 
             }
 
 
             if (here->B4SOIrgateMod == 1)
             {
-                *(here->B4SOIGEgePtr) += here->B4SOI_1;
-                *(here->B4SOIGgePtr) -= here->B4SOI_2;
-                *(here->B4SOIGEgPtr) -= here->B4SOI_3;
+                *DEVmatSlot(here->B4SOIGEgePtr, trash, &scratch) += here->B4SOI_1;
+                *DEVmatSlot(here->B4SOIGgePtr, trash, &scratch) -= here->B4SOI_2;
+                *DEVmatSlot(here->B4SOIGEgPtr, trash, &scratch) -= here->B4SOI_3;
             }
             else if (here->B4SOIrgateMod == 2)
             {
-                *(here->B4SOIGEgePtr) += here->B4SOI_4;
-                *(here->B4SOIGEgPtr) += here->B4SOI_5;
-                *(here->B4SOIGEdpPtr) += here->B4SOI_6;
-                *(here->B4SOIGEspPtr) += here->B4SOI_7;
-                *(here->B4SOIGgePtr) -= here->B4SOI_8;
+                *DEVmatSlot(here->B4SOIGEgePtr, trash, &scratch) += here->B4SOI_4;
+                *DEVmatSlot(here->B4SOIGEgPtr, trash, &scratch) += here->B4SOI_5;
+                *DEVmatSlot(here->B4SOIGEdpPtr, trash, &scratch) += here->B4SOI_6;
+                *DEVmatSlot(here->B4SOIGEspPtr, trash, &scratch) += here->B4SOI_7;
+                *DEVmatSlot(here->B4SOIGgePtr, trash, &scratch) -= here->B4SOI_8;
                 if (here->B4SOIsoiMod !=2) /* v3.2 */
-                    *(here->B4SOIGEbPtr) += here->B4SOI_9;
+                    *DEVmatSlot(here->B4SOIGEbPtr, trash, &scratch) += here->B4SOI_9;
             }
             else if (here->B4SOIrgateMod == 3)
             {
-                *(here->B4SOIGEgePtr) += here->B4SOI_10;
-                *(here->B4SOIGEgmPtr) -= here->B4SOI_11;
-                *(here->B4SOIGMgePtr) -= here->B4SOI_12;
-                *(here->B4SOIGMgmPtr) += here->B4SOI_13;
-
-                *(here->B4SOIGMdpPtr) += here->B4SOI_14;
-                *(here->B4SOIGMgPtr) += here->B4SOI_15;
-                *(here->B4SOIGMspPtr) += here->B4SOI_16;
-                *(here->B4SOIGMePtr) += here->B4SOI_17;
+                *DEVmatSlot(here->B4SOIGEgePtr, trash, &scratch) += here->B4SOI_10;
+                *DEVmatSlot(here->B4SOIGEgmPtr, trash, &scratch) -= here->B4SOI_11;
+                *DEVmatSlot(here->B4SOIGMgePtr, trash, &scratch) -= here->B4SOI_12;
+                *DEVmatSlot(here->B4SOIGMgmPtr, trash, &scratch) += here->B4SOI_13;
+
+                *DEVmatSlot(here->B4SOIGMdpPtr, trash, &scratch) += here->B4SOI_14;
+                *DEVmatSlot(here->B4SOIGMgPtr, trash, &scratch) += here->B4SOI_15;
+                *DEVmatSlot(here->B4SOIGMspPtr, trash, &scratch) += here->B4SOI_16;
+                *DEVmatSlot(here->B4SOIGMePtr, trash, &scratch) += here->B4SOI_17;
                 if (here->B4SOIsoiMod !=2) /* v3.2 */
-                    *(here->B4SOIGMbPtr) += here->B4SOI_18;
+                    *DEVmatSlot(here->B4SOIGMbPtr, trash, &scratch) += here->B4SOI_18;
 
-                *(here->B4SOIDPgmPtr) += here->B4SOI_19;
-                *(here->B4SOIGgmPtr) -= here->B4SOI_20;
-                *(here->B4SOISPgmPtr) += here->B4SOI_21;
-                *(here->B4SOIEgmPtr) += here->B4SOI_22;
+                *DEVmatSlot(here->B4SOIDPgmPtr, trash, &scratch) += here->B4SOI_19;
+                *DEVmatSlot(here->B4SOIGgmPtr, trash, &scratch) -= here->B4SOI_20;
+                *DEVmatSlot(here->B4SOISPgmPtr, trash, &scratch) += here->B4SOI_21;
+                *DEVmatSlot(here->B4SOIEgmPtr, trash, &scratch) += here->B4SOI_22;
             }
             /* v3.1 added for RF end*/
 
@@ -11080,170 +11077,170 @@ void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
             /* v3.0 */
             if (here->B4SOIsoiMod != 0) /* v3.2 */
             {
-                (*(here->B4SOIDPePtr) += here->B4SOI_23);
-                (*(here->B4SOISPePtr) += here->B4SOI_24);
+                (*DEVmatSlot(here->B4SOIDPePtr, trash, &scratch) += here->B4SOI_23);
+                (*DEVmatSlot(here->B4SOISPePtr, trash, &scratch) += here->B4SOI_24);
 
                 if (here->B4SOIsoiMod != 2) /* v3.2 */
                 {
-                    *(here->B4SOIGePtr) += here->B4SOI_25;
-                    *(here->B4SOIBePtr) -= here->B4SOI_26;
+                    *DEVmatSlot(here->B4SOIGePtr, trash, &scratch) += here->B4SOI_25;
+                    *DEVmatSlot(here->B4SOIBePtr, trash, &scratch) -= here->B4SOI_26;
                 }
             }
 
-            *(here->B4SOIEdpPtr) += here->B4SOI_27;
-            *(here->B4SOIEspPtr) += here->B4SOI_28;
-            *(here->B4SOIDPePtr) += here->B4SOI_29;
-            *(here->B4SOISPePtr) += here->B4SOI_30;
-            *(here->B4SOIEgPtr) += here->B4SOI_31;
-            *(here->B4SOIGePtr) += here->B4SOI_32;
+            *DEVmatSlot(here->B4SOIEdpPtr, trash, &scratch) += here->B4SOI_27;
+            *DEVmatSlot(here->B4SOIEspPtr, trash, &scratch) += here->B4SOI_28;
+            *DEVmatSlot(here->B4SOIDPePtr, trash, &scratch) += here->B4SOI_29;
+            *DEVmatSlot(here->B4SOISPePtr, trash, &scratch) += here->B4SOI_30;
+            *DEVmatSlot(here->B4SOIEgPtr, trash, &scratch) += here->B4SOI_31;
+            *DEVmatSlot(here->B4SOIGePtr, trash, &scratch) += here->B4SOI_32;
 
             /* v3.1 */
             if (here->B4SOIsoiMod != 2) /* v3.2 */
             {
-                (*(here->B4SOIEbPtr) -= here->B4SOI_33); /* 3.2 bug fix */
+                (*DEVmatSlot(here->B4SOIEbPtr, trash, &scratch) -= here->B4SOI_33); /* 3.2 bug fix */
 
                 /* v3.1 changed GbPtr for RF */
                 if ((here->B4SOIrgateMod == 0) || (here->B4SOIrgateMod == 1))
-                    (*(here->B4SOIGbPtr) -= here->B4SOI_34);
+                    (*DEVmatSlot(here->B4SOIGbPtr, trash, &scratch) -= here->B4SOI_34);
                 else /* v3.1 for rgateMod = 2 or 3 */
-                    *(here->B4SOIGbPtr) += here->B4SOI_35;
+                    *DEVmatSlot(here->B4SOIGbPtr, trash, &scratch) += here->B4SOI_35;
 
 
-                (*(here->B4SOIDPbPtr) -= here->B4SOI_36); /* v4.0 */
+                (*DEVmatSlot(here->B4SOIDPbPtr, trash, &scratch) -= here->B4SOI_36); /* v4.0 */
 
-                /*                      (*(here->B4SOIDPbPtr) -= (-gddpb - Gmbs + gcdgb + gcddb
+                /*                      (*DEVmatSlot(here->B4SOIDPbPtr, trash, &scratch) -= (-gddpb - Gmbs + gcdgb + gcddb
                                         + gcdeb + gcdsb) + gcdgmb
                                         + gIdtotb );
                                         */
 
-                (*(here->B4SOISPbPtr) -= here->B4SOI_37); /* v4.0 */
+                (*DEVmatSlot(here->B4SOISPbPtr, trash, &scratch) -= here->B4SOI_37); /* v4.0 */
 
-                /*                      (*(here->B4SOISPbPtr) -= (-gsspb + Gmbs + gcsgb + gcsdb
+                /*                      (*DEVmatSlot(here->B4SOISPbPtr, trash, &scratch) -= (-gsspb + Gmbs + gcsgb + gcsdb
                                         + gcseb + gcssb) + gcsgmb
                                         + Gmin + gIstotb);
                                         */
-                (*(here->B4SOIBePtr) += here->B4SOI_38); /* v3.0 */
-                (*(here->B4SOIBgPtr) += here->B4SOI_39);
-                (*(here->B4SOIBdpPtr) += here->B4SOI_40);
+                (*DEVmatSlot(here->B4SOIBePtr, trash, &scratch) += here->B4SOI_38); /* v3.0 */
+                (*DEVmatSlot(here->B4SOIBgPtr, trash, &scratch) += here->B4SOI_39);
+                (*DEVmatSlot(here->B4SOIBdpPtr, trash, &scratch) += here->B4SOI_40);
 
-                (*(here->B4SOIBspPtr) += here->B4SOI_41);
+                (*DEVmatSlot(here->B4SOIBspPtr, trash, &scratch) += here->B4SOI_41);
                 /*                    if (!here->B4SOIrbodyMod)
                 */
-                (*(here->B4SOIBbPtr) += here->B4SOI_42);
+                (*DEVmatSlot(here->B4SOIBbPtr, trash, &scratch) += here->B4SOI_42);
                 /*                    else
-                              (*(here->B4SOIBbPtr) += -gigb - (Giib - Gbpbs) - gcbgb
+                              (*DEVmatSlot(here->B4SOIBbPtr, trash, &scratch) += -gigb - (Giib - Gbpbs) - gcbgb
                               - gcbdb - gcbsb - gcbeb + Gmin) ;
                               */
                 /* v4.0 */
                 if (here->B4SOIrbodyMod) {
-                    (*(here->B4SOIDPdbPtr) += here->B4SOI_43);
-                    (*(here->B4SOISPsbPtr) += here->B4SOI_44);
-                    (*(here->B4SOIDBdpPtr) += here->B4SOI_45);
-                    (*(here->B4SOIDBdbPtr) += here->B4SOI_46);
-                    (*(here->B4SOIDBbPtr) -= here->B4SOI_47);
-                    (*(here->B4SOISBspPtr) += here->B4SOI_48);
-                    (*(here->B4SOISBbPtr) -= here->B4SOI_49);
-                    (*(here->B4SOISBsbPtr) += here->B4SOI_50);
-                    (*(here->B4SOIBdbPtr) -= here->B4SOI_51);
-                    (*(here->B4SOIBsbPtr) -= here->B4SOI_52);
-                    (*(here->B4SOIBbPtr) += here->B4SOI_53);
+                    (*DEVmatSlot(here->B4SOIDPdbPtr, trash, &scratch) += here->B4SOI_43);
+                    (*DEVmatSlot(here->B4SOISPsbPtr, trash, &scratch) += here->B4SOI_44);
+                    (*DEVmatSlot(here->B4SOIDBdpPtr, trash, &scratch) += here->B4SOI_45);
+                    (*DEVmatSlot(here->B4SOIDBdbPtr, trash, &scratch) += here->B4SOI_46);
+                    (*DEVmatSlot(here->B4SOIDBbPtr, trash, &scratch) -= here->B4SOI_47);
+                    (*DEVmatSlot(here->B4SOISBspPtr, trash, &scratch) += here->B4SOI_48);
+                    (*DEVmatSlot(here->B4SOISBbPtr, trash, &scratch) -= here->B4SOI_49);
+                    (*DEVmatSlot(here->B4SOISBsbPtr, trash, &scratch) += here->B4SOI_50);
+                    (*DEVmatSlot(here->B4SOIBdbPtr, trash, &scratch) -= here->B4SOI_51);
+                    (*DEVmatSlot(here->B4SOIBsbPtr, trash, &scratch) -= here->B4SOI_52);
+                    (*DEVmatSlot(here->B4SOIBbPtr, trash, &scratch) += here->B4SOI_53);
                 }
                 if (model->B4SOIrdsMod)
                 {
-                    (*(here->B4SOIDbPtr) += here->B4SOI_54);
-                    (*(here->B4SOISbPtr) += here->B4SOI_55);
+                    (*DEVmatSlot(here->B4SOIDbPtr, trash, &scratch) += here->B4SOI_54);
+                    (*DEVmatSlot(here->B4SOISbPtr, trash, &scratch) += here->B4SOI_55);
                 }
 
             }
             /* v3.1 */
             if (model->B4SOIrdsMod)
-            {   (*(here->B4SOIDgPtr) += here->B4SOI_56);
-                (*(here->B4SOIDspPtr) += here->B4SOI_57);
-                (*(here->B4SOISdpPtr) += here->B4SOI_58);
-                (*(here->B4SOISgPtr) += here->B4SOI_59);
+            {   (*DEVmatSlot(here->B4SOIDgPtr, trash, &scratch) += here->B4SOI_56);
+                (*DEVmatSlot(here->B4SOIDspPtr, trash, &scratch) += here->B4SOI_57);
+                (*DEVmatSlot(here->B4SOISdpPtr, trash, &scratch) += here->B4SOI_58);
+                (*DEVmatSlot(here->B4SOISgPtr, trash, &scratch) += here->B4SOI_59);
             }
 
-            (*(here->B4SOIEePtr) += here->B4SOI_60);
+            (*DEVmatSlot(here->B4SOIEePtr, trash, &scratch) += here->B4SOI_60);
 
             if (here->B4SOIrgateMod == 0)
             {
-                (*(here->B4SOIGgPtr) += here->B4SOI_61);
-                (*(here->B4SOIGdpPtr) += here->B4SOI_62);
-                (*(here->B4SOIGspPtr) += here->B4SOI_63);
+                (*DEVmatSlot(here->B4SOIGgPtr, trash, &scratch) += here->B4SOI_61);
+                (*DEVmatSlot(here->B4SOIGdpPtr, trash, &scratch) += here->B4SOI_62);
+                (*DEVmatSlot(here->B4SOIGspPtr, trash, &scratch) += here->B4SOI_63);
             }
             else if (here->B4SOIrgateMod == 1) /* v3.1 for RF */
             {
-                *(here->B4SOIGgPtr) += here->B4SOI_64;
-                *(here->B4SOIGdpPtr) += here->B4SOI_65;
-                *(here->B4SOIGspPtr) += here->B4SOI_66;
+                *DEVmatSlot(here->B4SOIGgPtr, trash, &scratch) += here->B4SOI_64;
+                *DEVmatSlot(here->B4SOIGdpPtr, trash, &scratch) += here->B4SOI_65;
+                *DEVmatSlot(here->B4SOIGspPtr, trash, &scratch) += here->B4SOI_66;
             }
             else /* v3.1 for RF rgateMod == 2 or 3 */
             {
-                *(here->B4SOIGgPtr) += here->B4SOI_67;
-                *(here->B4SOIGdpPtr) += here->B4SOI_68;
-                *(here->B4SOIGspPtr) += here->B4SOI_69;
+                *DEVmatSlot(here->B4SOIGgPtr, trash, &scratch) += here->B4SOI_67;
+                *DEVmatSlot(here->B4SOIGdpPtr, trash, &scratch) += here->B4SOI_68;
+                *DEVmatSlot(here->B4SOIGspPtr, trash, &scratch) += here->B4SOI_69;
             }
 
 
-            (*(here->B4SOIDPgPtr) += here->B4SOI_70); /* v4.0 */
-            (*(here->B4SOIDPdpPtr) += here->B4SOI_71); /* v4.0 */
-            (*(here->B4SOIDPspPtr) -= here->B4SOI_72);
+            (*DEVmatSlot(here->B4SOIDPgPtr, trash, &scratch) += here->B4SOI_70); /* v4.0 */
+            (*DEVmatSlot(here->B4SOIDPdpPtr, trash, &scratch) += here->B4SOI_71); /* v4.0 */
+            (*DEVmatSlot(here->B4SOIDPspPtr, trash, &scratch) -= here->B4SOI_72);
 
-            (*(here->B4SOIDPdPtr) -= here->B4SOI_73);
+            (*DEVmatSlot(here->B4SOIDPdPtr, trash, &scratch) -= here->B4SOI_73);
 
-            (*(here->B4SOISPgPtr) += here->B4SOI_74); /* v4.0 */
-            (*(here->B4SOISPdpPtr) -= here->B4SOI_75); /* v4.0 */
+            (*DEVmatSlot(here->B4SOISPgPtr, trash, &scratch) += here->B4SOI_74); /* v4.0 */
+            (*DEVmatSlot(here->B4SOISPdpPtr, trash, &scratch) -= here->B4SOI_75); /* v4.0 */
 
-            (*(here->B4SOISPspPtr) += here->B4SOI_76); /* v4.0 */
+            (*DEVmatSlot(here->B4SOISPspPtr, trash, &scratch) += here->B4SOI_76); /* v4.0 */
 
-            (*(here->B4SOISPsPtr) -= here->B4SOI_77);
+            (*DEVmatSlot(here->B4SOISPsPtr, trash, &scratch) -= here->B4SOI_77);
 
 
-            (*(here->B4SOIDdPtr) += here->B4SOI_78);
-            (*(here->B4SOIDdpPtr) -= here->B4SOI_79);
+            (*DEVmatSlot(here->B4SOIDdPtr, trash, &scratch) += here->B4SOI_78);
+            (*DEVmatSlot(here->B4SOIDdpPtr, trash, &scratch) -= here->B4SOI_79);
 
 
-            (*(here->B4SOISsPtr) += here->B4SOI_80);
-            (*(here->B4SOISspPtr) -= here->B4SOI_81);
+            (*DEVmatSlot(here->B4SOISsPtr, trash, &scratch) += here->B4SOI_80);
+            (*DEVmatSlot(here->B4SOISspPtr, trash, &scratch) -= here->B4SOI_81);
 
 
             if (here->B4SOIbodyMod == 1)  {
-                (*(here->B4SOIBpPtr) -= here->B4SOI_82);
-                (*(here->B4SOIPbPtr) += here->B4SOI_83);
-                (*(here->B4SOIPpPtr) += here->B4SOI_84);
+                (*DEVmatSlot(here->B4SOIBpPtr, trash, &scratch) -= here->B4SOI_82);
+                (*DEVmatSlot(here->B4SOIPbPtr, trash, &scratch) += here->B4SOI_83);
+                (*DEVmatSlot(here->B4SOIPpPtr, trash, &scratch) += here->B4SOI_84);
             }
 
             /* v4.1  Ig_agbcp2 stamping */
-            (*(here->B4SOIGgPtr) += here->B4SOI_85); /* FIXME m or not m ?? h_vogt */
+            (*DEVmatSlot(here->B4SOIGgPtr, trash, &scratch) += here->B4SOI_85); /* FIXME m or not m ?? h_vogt */
             if (here->B4SOIbodyMod == 1)  {
-                (*(here->B4SOIPpPtr) -= here->B4SOI_86);
-                (*(here->B4SOIPgPtr) -= here->B4SOI_87);
-                (*(here->B4SOIGpPtr) += here->B4SOI_88);
+                (*DEVmatSlot(here->B4SOIPpPtr, trash, &scratch) -= here->B4SOI_86);
+                (*DEVmatSlot(here->B4SOIPgPtr, trash, &scratch) -= here->B4SOI_87);
+                (*DEVmatSlot(here->B4SOIGpPtr, trash, &scratch) += here->B4SOI_88);
             }
             else if(here->B4SOIbodyMod == 2)
             {
-                (*(here->B4SOIBbPtr) -= here->B4SOI_89);
-                (*(here->B4SOIBgPtr) -= here->B4SOI_90);
-                (*(here->B4SOIGbPtr) += here->B4SOI_91);
+                (*DEVmatSlot(here->B4SOIBbPtr, trash, &scratch) -= here->B4SOI_89);
+                (*DEVmatSlot(here->B4SOIBgPtr, trash, &scratch) -= here->B4SOI_90);
+                (*DEVmatSlot(here->B4SOIGbPtr, trash, &scratch) += here->B4SOI_91);
             }
 
 
             if (here->B4SOINode_sh) /* selfheat */
             {
-                (*(here->B4SOIDPtempPtr) += here->B4SOI_92);
-                (*(here->B4SOISPtempPtr) += here->B4SOI_93);
-                (*(here->B4SOIBtempPtr) += here->B4SOI_94);
-                (*(here->B4SOIEtempPtr) +=here->B4SOI_95);
-                (*(here->B4SOIGtempPtr) += here->B4SOI_96);
-                (*(here->B4SOITemptempPtr) += here->B4SOI_97);
-                (*(here->B4SOITempgPtr) += here->B4SOI_98);
-                (*(here->B4SOITempbPtr) += here->B4SOI_99);
-                (*(here->B4SOITempdpPtr) += here->B4SOI_100);
-                (*(here->B4SOITempspPtr) += here->B4SOI_101);
+                (*DEVmatSlot(here->B4SOIDPtempPtr, trash, &scratch) += here->B4SOI_92);
+                (*DEVmatSlot(here->B4SOISPtempPtr, trash, &scratch) += here->B4SOI_93);
+                (*DEVmatSlot(here->B4SOIBtempPtr, trash, &scratch) += here->B4SOI_94);
+                (*DEVmatSlot(here->B4SOIEtempPtr, trash, &scratch) +=here->B4SOI_95);
+                (*DEVmatSlot(here->B4SOIGtempPtr, trash, &scratch) += here->B4SOI_96);
+                (*DEVmatSlot(here->B4SOITemptempPtr, trash, &scratch) += here->B4SOI_97);
+                (*DEVmatSlot(here->B4SOITempgPtr, trash, &scratch) += here->B4SOI_98);
+                (*DEVmatSlot(here->B4SOITempbPtr, trash, &scratch) += here->B4SOI_99);
+                (*DEVmatSlot(here->B4SOITempdpPtr, trash, &scratch) += here->B4SOI_100);
+                (*DEVmatSlot(here->B4SOITempspPtr, trash, &scratch) += here->B4SOI_101);
 
                 /* v3.0 */
                 if (here->B4SOIsoiMod != 0) /* v3.2 */
-                    (*(here->B4SOITempePtr) += here->B4SOI_102);
+                    (*DEVmatSlot(here->B4SOITempePtr, trash, &scratch) += here->B4SOI_102);
 
             }
 
@@ -11251,27 +11248,43 @@ void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
 
             if (here->B4SOIdebugMod != 0)
             {
-                *(here->B4SOIVbsPtr) += 1;
-                *(here->B4SOIIdsPtr) += 1;
-                *(here->B4SOIIcPtr) += 1;
-                *(here->B4SOIIbsPtr) += 1;
-                *(here->B4SOIIbdPtr) += 1;
-                *(here->B4SOIIiiPtr) += 1;
-                *(here->B4SOIIgPtr) += 1;
-                *(here->B4SOIGiggPtr) += 1;
-                *(here->B4SOIGigdPtr) += 1;
-                *(here->B4SOIGigbPtr) += 1;
-                *(here->B4SOIIgidlPtr) += 1;
-                *(here->B4SOIItunPtr) += 1;
-                *(here->B4SOIIbpPtr) += 1;
-                *(here->B4SOICbgPtr) += 1;
-                *(here->B4SOICbbPtr) += 1;
-                *(here->B4SOICbdPtr) += 1;
-                *(here->B4SOIQbfPtr) += 1;
-                *(here->B4SOIQjsPtr) += 1;
-                *(here->B4SOIQjdPtr) += 1;
+                *DEVmatSlot(here->B4SOIVbsPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIdsPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIcPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIbsPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIbdPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIiiPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIgPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIGiggPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIGigdPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIGigbPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIgidlPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIItunPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIIbpPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOICbgPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOICbbPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOICbdPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIQbfPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIQjsPtr, trash, &scratch) += 1;
+                *DEVmatSlot(here->B4SOIQjdPtr, trash, &scratch) += 1;
             }
     }
 }
 
+void B4SOILoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    B4SOImodel *model = (B4SOImodel*)inModel;
+    int *ColorStart = model->B4SOIColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->B4SOIColorCount; color++)
+        B4SOILoadRhsMatRange(model->B4SOIInstanceArray, ColorStart[color],
+                             ColorStart[color + 1], 1, ckt, trash);
+
+    B4SOILoadRhsMatRange(model->B4SOIInstanceArray, ColorStart[model->B4SOIColorCount],
+                         model->B4SOIInstCount, 0, ckt, trash);
+}
+
 #endif
@@ -28,6 +28,7 @@ B4SOImDelete(GENmodel *gen_model)
 #ifdef USE_OMP
     B4SOImodel *model = (B4SOImodel *) gen_model;
     FREE(model->B4SOIInstanceArray);
+    FREE(model->B4SOIColorStart);
 #endif
 
     return OK;
@@ -21,6 +21,7 @@
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "b4soidef.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
@@ -2735,6 +2736,8 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
         }
         model->B4SOIInstCount = 0;
         model->B4SOIInstanceArray = NULL;
+        model->B4SOIColorCount = 0;
+        model->B4SOIColorStart = NULL;
     }
     InstArray = TMALLOC(B4SOIinstance*, InstCount);
     model = (B4SOImodel*)inModel;
@@ -2752,6 +2755,11 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (B4SOImodel*)inModel;
+    model->B4SOIColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 7,
+                                             ckt->CKTmaxEqNum, &model->B4SOIColorStart);
 #endif
 
     return(OK);
@@ -2769,6 +2777,7 @@ B4SOIunsetup(
 #ifdef USE_OMP
     model = (B4SOImodel*)inModel;
     tfree(model->B4SOIInstanceArray);
+    tfree(model->B4SOIColorStart);
 #endif
 
     for (model = (B4SOImodel *)inModel; model != NULL;
@@ -42,6 +42,9 @@
 #include <string.h> /* for strcpy, strcat*/
 #if (!defined HAS_WINGUI) && (!defined __MINGW32__) && (!defined _MSC_VER)
 #include <dlfcn.h> /* to load libraries*/
+#ifdef SHARED_MODULE
+#include "../../misc/util.h" /* dlopen_copy() */
+#endif
 typedef void * funptr_t;
 #define FREE_DLERR_MSG(msg)
 #else /* ifdef HAS_WINGUI */
@@ -394,6 +397,27 @@ int add_udn(int n,Evt_Udn_Info_t **udns){
 }
 
 
+#ifdef SHARED_MODULE
+/* Several instances of shared ngspice may live in one process, see
+ * sharedspice_handle.c.  A code model library has a single pointer to the
+ * core functions (coreitf), which must not be taken over from another
+ * instance, nor left dangling when that one is unloaded.  Returns TRUE if
+ * the library has been set up by another instance. */
+static bool
+cm_foreign(void *lib)
+{
+    funptr_t fetch = dlsym(lib, "CMgetCoreItfPtr");
+    const struct coreInfo_t **core;
+
+    if (!fetch)
+        return FALSE;
+    core = (const struct coreInfo_t **) (*(struct coreInfo_t ** (*)(void)) fetch)();
+    return *core && *core != &coreInfo;
+}
+
+#endif
+
+
 int load_opus(const char *name)
 {
     void *lib = NULL;
@@ -417,6 +441,24 @@ int load_opus(const char *name)
         return 1;
     }
 
+#ifdef SHARED_MODULE
+    if (cm_foreign(lib)) {
+#if (!defined HAS_WINGUI) && (!defined __MINGW32__) && (!defined _MSC_VER)
+        dlclose(lib);
+        lib = dlopen_copy(name, "ngcm", RTLD_NOW);
+        if (!lib || cm_foreign(lib)) {
+            fprintf(stderr, "Error: cannot load a private copy of code model \"%s\"\n",
+                    name);
+            return 1;
+        }
+#else
+        fprintf(stderr, "Error: code model \"%s\" is in use by another ngspice instance\n",
+                name);
+        return 1;
+#endif
+    }
+#endif
+
 
     /* Get code models defined by the library */
     if ((fetch = dlsym(lib, "CMdevNum")) != (funptr_t) NULL) {
@@ -827,6 +827,113 @@ DEVpred(CKTcircuit *ckt, int loct)
 }
 
 
+#ifdef USE_OMP
+/* Colors available for parallel stamping, one bit per color in a node mask */
+#define DEV_MAX_COLORS 64
+/* Smaller colors do not pay for the overhead of a parallel loop */
+#define DEV_MIN_COLOR_SIZE 32
+
+/* Sort an array of device instances into colors for parallel stamping.
+ *
+ * Two instances of one color never share a (non-ground) terminal.  As the
+ * internal nodes of an instance are private to it, instances of one color
+ * never write to the same matrix element or rhs entry and may be stamped
+ * concurrently without locking.  'terms' is the number of terminal nodes
+ * found by GENnode(), 'size' the number of equations of the circuit.
+ *
+ * The array is reordered in place.  On return (*colorStart)[c] is the index
+ * of the first instance of color c, and (*colorStart)[ncolors] is the
+ * first index of a tail of instances which have to be stamped serially,
+ * either because no free color was left or their color was too small.
+ * Returns ncolors.
+ */
+int
+DEVcolorInstances(GENinstance **array, int count, int terms, int size,
+                  int **colorStart)
+{
+    unsigned long long *mask;
+    GENinstance **sorted;
+    int *color, *start;
+    int fill[DEV_MAX_COLORS + 1], map[DEV_MAX_COLORS + 1];
+    int i, j, c, ncolors;
+
+    if (count == 0) {
+        *colorStart = TMALLOC(int, 1);
+        return 0;
+    }
+
+    mask = TMALLOC(unsigned long long, size + 1);
+    color = TMALLOC(int, count);
+
+    for (c = 0; c <= DEV_MAX_COLORS; c++)
+        fill[c] = 0;
+
+    /* greedy first fit, DEV_MAX_COLORS denotes the serial tail */
+    for (i = 0; i < count; i++) {
+        int *node = GENnode(array[i]);
+        unsigned long long used = 0;
+
+        for (j = 0; j < terms; j++)
+            if (node[j] > 0 && node[j] <= size)
+                used |= mask[node[j]];
+
+        if (~used == 0) {
+            c = DEV_MAX_COLORS;
+        } else {
+            for (c = 0; used & (1ULL << c); c++)
+                ;
+            for (j = 0; j < terms; j++)
+                if (node[j] > 0 && node[j] <= size)
+                    mask[node[j]] |= 1ULL << c;
+        }
+
+        color[i] = c;
+        fill[c]++;
+    }
+
+    /* renumber the colors, moving small ones to the serial tail */
+    ncolors = 0;
+    for (c = 0; c < DEV_MAX_COLORS; c++)
+        if (fill[c] >= DEV_MIN_COLOR_SIZE) {
+            map[c] = ncolors++;
+        } else {
+            map[c] = -1;
+            fill[DEV_MAX_COLORS] += fill[c];
+        }
+
+    start = TMALLOC(int, ncolors + 2);
+    for (c = 0; c < DEV_MAX_COLORS; c++)
+        if (map[c] >= 0)
+            start[map[c] + 1] = fill[c];
+    start[ncolors + 1] = fill[DEV_MAX_COLORS];
+    for (c = 1; c <= ncolors + 1; c++)
+        start[c] += start[c - 1];
+
+    /* stable counting sort, start[c] advances to the begin of color c+1 */
+    sorted = TMALLOC(GENinstance *, count);
+    for (i = 0; i < count; i++) {
+        c = (color[i] < DEV_MAX_COLORS) ? map[color[i]] : -1;
+        if (c < 0)
+            c = ncolors;
+        sorted[start[c]++] = array[i];
+    }
+    memcpy(array, sorted, (size_t) count * sizeof(GENinstance *));
+
+    /* shift back */
+    for (c = ncolors; c > 0; c--)
+        start[c] = start[c - 1];
+    start[0] = 0;
+
+    tfree(sorted);
+    tfree(color);
+    tfree(mask);
+
+    *colorStart = start;
+    return ncolors;
+}
+#endif
+
+
 /* SOA check printout used in DEVsoaCheck functions */
 extern FILE *slogp;  /* soa log file ('--soa-log file' command line option) */
 
@@ -223,6 +223,44 @@ typedef struct sDIOinstance {
         double **DIOnVar;
 #endif /* NONOISE */
 
+#ifdef USE_OMP
+    /* per instance storage of results, to update matrix at a later stage */
+    int DIOstampRhsMat;
+    double DIOrhsCdeq;
+    double DIOrhsPosTh;
+    double DIOrhsPosPrimeTh;
+    double DIOrhsNegTh;
+    double DIOrhsTempTh;
+    double DIOrhsCdeqSW;
+    double DIOrhsPosThSW;
+    double DIOrhsPosSwPrimeThSW;
+    double DIOrhsNegThSW;
+    double DIOrhsTempThSW;
+    double DIOrhsCeqrr;
+    double DIOrhsCeqrrd;
+
+    double DIOgdLoad;
+    double DIOgdswLoad;
+    double DIOtempPosPt;
+    double DIOtempPosPrimePt;
+    double DIOtempNegPt;
+    double DIOtempTempPt;
+    double DIOposTempPt;
+    double DIOposPrimeTempPt;
+    double DIOnegTempPt;
+    double DIOtempPosSWPt;
+    double DIOtempPosSwPrimePt;
+    double DIOtempNegSWPt;
+    double DIOposTempSWPt;
+    double DIOposSwPrimeTempPt;
+    double DIOnegTempSWPt;
+    double DIOqpQpPt;
+    double DIOqpPosPrimePt;
+    double DIOqpNegPt;
+    double DIOposPrimeQpPt;
+    double DIOnegQpPt;
+#endif
+
 #ifdef KLU
     BindElement *DIOposPosPrimeBinding ;
     BindElement *DIOnegPosPrimeBinding ;
@@ -457,6 +495,13 @@ typedef struct sDIOmodel {       /* model structure for a diode */
     double DIOpolyMaskOffset;  /* Masking and etching effects in polysilicon (level=3) */
     double DIOmaskOffset;      /* Masking and etching effects (level=3) */
 
+#ifdef USE_OMP
+    int DIOInstCount;
+    struct sDIOinstance **DIOInstanceArray;
+    int DIOColorCount;
+    int *DIOColorStart;
+#endif
+
 } DIOmodel;
 
 /* device parameters */
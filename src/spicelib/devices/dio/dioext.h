@@ -10,6 +10,7 @@ extern int DIOconvTest(GENmodel *,CKTcircuit*);
 extern int DIOgetic(GENmodel*,CKTcircuit*);
 extern int DIOload(GENmodel*,CKTcircuit*);
 extern int DIOmAsk(CKTcircuit*,GENmodel*,int,IFvalue*);
+extern int DIOmDelete(GENmodel*);
 extern int DIOmParam(int,IFvalue*,GENmodel*);
 extern int DIOparam(int,IFvalue*,GENinstance*,IFvalue*);
 extern int DIOpzLoad(GENmodel*,CKTcircuit*,SPcomplex*);
@@ -27,6 +28,11 @@ extern int DIOnoise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int DIOdSetup(DIOmodel*,CKTcircuit*);
 extern int DIOsoaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int DIOLoadOMP(GENinstance*,CKTcircuit*);
+extern void DIOLoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int DIObindCSC (GENmodel*, CKTcircuit*) ;
 extern int DIObindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -44,7 +44,7 @@ SPICEdev DIOinfo = {
     .DEVacLoad = DIOacLoad,
     .DEVaccept = NULL,
     .DEVdestroy = NULL,
-    .DEVmodDelete = NULL,
+    .DEVmodDelete = DIOmDelete,
     .DEVdelete = NULL,
     .DEVsetic = DIOgetic,
     .DEVask = DIOask,
@@ -68,6 +68,11 @@ SPICEdev DIOinfo = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = DIOLoadOMP,
+    .DEVloadStamp = DIOLoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = DIObindCSC,
     .DEVbindCSCComplex = DIObindCSCComplex,
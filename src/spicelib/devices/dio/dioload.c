@@ -20,8 +20,34 @@ DIOload(GENmodel *inModel, CKTcircuit *ckt)
          * sparse matrix previously provided
          */
 {
+#ifdef USE_OMP
+    int idx;
+    DIOmodel *model = (DIOmodel*)inModel;
+    int error = 0;
+    DIOinstance **InstArray;
+    InstArray = model->DIOInstanceArray;
+
+#pragma omp parallel for
+    for (idx = 0; idx < model->DIOInstCount; idx++) {
+        DIOinstance *here = InstArray[idx];
+        int local_error = DIOLoadOMP(&here->gen, ckt);
+        if (local_error)
+            error = local_error;
+    }
+
+    DIOLoadRhsMat(inModel, ckt);
+
+    return error;
+}
+
+
+int DIOLoadOMP(GENinstance *inInst, CKTcircuit *ckt) {
+    DIOinstance *here = (DIOinstance *) inInst;
+    DIOmodel *model = DIOmodPtr(here);
+#else
     DIOmodel *model = (DIOmodel*)inModel;
     DIOinstance *here;
+#endif
     double arg;
     double argsw;
     double capd, capdsw=0.0;
@@ -70,16 +96,23 @@ DIOload(GENmodel *inModel, CKTcircuit *ckt)
     double vqp;
     double capsr, gqcsr, cqcsr;
 
+#ifndef USE_OMP
     /*  loop through all the diode models */
     for( ; model != NULL; model = DIOnextModel(model)) {
 
         /* loop through all the instances of the model */
         for (here = DIOinstances(model); here != NULL ;
                 here=DIOnextInstance(here)) {
+#endif
 
             int selfheat = ((here->DIOtempNode > 0) && (here->DIOthermal) && (model->DIOrth0Given));
             int revrec = ((here->DIOqpNode > 0) && (model->DIOsoftRevRecParam!=0) && (here->DIOtTransitTime!=0));
 
+#ifdef USE_OMP
+            /* only instances reaching the load section are stamped */
+            here->DIOstampRhsMat = 0;
+#endif
+
             /*
              *     this routine loads diodes for dc and transient analyses.
              */
@@ -91,7 +124,7 @@ DIOload(GENmodel *inModel, CKTcircuit *ckt)
 
             if(ckt->CKTsenInfo){
                 if((ckt->CKTsenInfo->SENstatus == PERTURBATION)
-                        && (here->DIOsenPertFlag == OFF))continue;
+                        && (here->DIOsenPertFlag == OFF)) goto line1000;
                 SenCond = here->DIOsenPertFlag;
 
 #ifdef SENSDEBUG
@@ -631,7 +664,7 @@ next1:
                             printf("capd = %.7e ,gd = %.7e \n",capd,gd);
 #endif /* SENSDEBUG */
                         }
-                        continue;
+                        goto line1000;
                     }
 
                     /*
@@ -648,7 +681,7 @@ next1:
                         printf("qd = %.7e, capd = %.7e,cd = %.7e\n",
                                 *(ckt->CKTstate0 + here->DIOcapCharge),capd,cd);
 #endif /* SENSDEBUG */
-                        continue;
+                        goto line1000;
                     }
 
                     if (ckt->CKTmode & MODEINITTRAN) {
@@ -736,7 +769,7 @@ next2:      *(ckt->CKTstate0 + here->DIOvoltage) = vd;
             *(ckt->CKTstate0 + here->DIOresConduct) = gdres;
             *(ckt->CKTstate0 + here->DIOcqcsr) = cqcsr;
             *(ckt->CKTstate0 + here->DIOgqcsr) = gqcsr;
-            if(SenCond)  continue;
+            if(SenCond) goto line1000;
 
 #ifndef NOBYPASS
             load:
@@ -780,6 +813,59 @@ next2:      *(ckt->CKTstate0 + here->DIOvoltage) = vd;
              *   load current vector
              */
             cdeq=cd-gd*vd;
+#ifdef USE_OMP
+            here->DIOstampRhsMat = 1;
+            here->DIOrhsCdeq = cdeq;
+            here->DIOgdLoad = gd;
+            if (selfheat) {
+                here->DIOrhsPosTh      =  dIrs_dT*delTemp;
+                here->DIOrhsPosPrimeTh =  dIdio_dT*delTemp - dIrs_dT*delTemp;
+                here->DIOrhsNegTh      = -dIdio_dT*delTemp;
+                here->DIOrhsTempTh     =  Ith - dIth_dVdio*vd - dIth_dVrs*vrs - dIth_dT*delTemp - ceqqth;
+                here->DIOtempPosPt      = -dIth_dVrs;
+                here->DIOtempPosPrimePt = -dIth_dVdio + dIth_dVrs;
+                here->DIOtempNegPt      =  dIth_dVdio;
+                here->DIOtempTempPt     = -dIth_dT + 1/model->DIOrth0 + gcTt;
+                here->DIOposTempPt      =  dIrs_dT;
+                here->DIOposPrimeTempPt =  dIdio_dT - dIrs_dT;
+                here->DIOnegTempPt      = -dIdio_dT;
+            }
+            if (model->DIOresistSWGiven) {
+                here->DIOrhsCdeqSW = cdsw-gdsw*vdsw;
+                here->DIOgdswLoad = gdsw;
+                if (selfheat) {
+                    here->DIOrhsPosThSW        =  dIrssw_dT*delTemp;
+                    here->DIOrhsPosSwPrimeThSW =  dIdioSw_dT*delTemp - dIrssw_dT*delTemp;
+                    here->DIOrhsNegThSW        = -dIdioSw_dT*delTemp;
+                    here->DIOrhsTempThSW       = -dIth_dVdioSw*vdsw - dIth_dVrssw*vrssw;
+                    here->DIOtempPosSWPt        = -dIth_dVrssw;
+                    here->DIOtempPosSwPrimePt   = -dIth_dVdioSw + dIth_dVrssw;
+                    here->DIOtempNegSWPt        =  dIth_dVdioSw;
+                    here->DIOposTempSWPt        =  dIrssw_dT;
+                    here->DIOposSwPrimeTempPt   =  dIdioSw_dT - dIrssw_dT;
+                    here->DIOnegTempSWPt        = -dIdioSw_dT;
+                }
+            }
+            if (revrec) {
+                double fac, dcrrdvd, grr;
+                double geqrrd;
+                /* QP subcircuit */
+                fac = here->DIOtTransitTime / model->DIOsoftRevRecParam;
+                dcrrdvd = fac*gdres;
+                grr = 1/model->DIOsoftRevRecParam;
+                here->DIOrhsCeqrr = -fac*cdres + cqcsr + dcrrdvd*vd - gqcsr*vqp;
+                here->DIOqpQpPt = grr + gqcsr;
+                here->DIOqpPosPrimePt = -dcrrdvd;
+                here->DIOqpNegPt = dcrrdvd;
+                /* Contribution to diode current */
+                here->DIOqpGain = (1 - model->DIOsoftRevRecParam) / here->DIOtTransitTime;
+                /* Linear contribution -(1-vp)/tau*ddt(Qp) */
+                geqrrd = here->DIOqpGain*gqcsr;
+                here->DIOrhsCeqrrd = here->DIOqpGain*cqcsr - geqrrd*vqp;
+                here->DIOposPrimeQpPt = geqrrd;
+                here->DIOnegQpPt = -geqrrd;
+            }
+#else
             *(ckt->CKTrhs + here->DIOnegNode) += cdeq;
             *(ckt->CKTrhs + here->DIOposPrimeNode) -= cdeq;
             if (selfheat) {
@@ -859,7 +945,119 @@ next2:      *(ckt->CKTstate0 + here->DIOvoltage) = vd;
                 *(here->DIOposPrimeQpPtr) += geqrrd;
                 *(here->DIOnegQpPtr) += -geqrrd;
             }
+#endif
+line1000: ;
+#ifndef USE_OMP
         }
     }
+#endif
     return(OK);
 }
+
+#ifdef USE_OMP
+static void
+DIOLoadRhsMatRange(DIOinstance **InstArray, int first, int last, int parallel,
+                   CKTcircuit *ckt, double *trash)
+{
+    int idx;
+    DIOinstance *here;
+    DIOmodel *model;
+
+#pragma omp parallel for private(here, model) if (parallel)
+    for (idx = first; idx < last; idx++) {
+        double scratch;
+        int selfheat, revrec;
+
+        here = InstArray[idx];
+        if (!here->DIOstampRhsMat)
+            continue;
+
+        model = DIOmodPtr(here);
+        selfheat = ((here->DIOtempNode > 0) && (here->DIOthermal) && (model->DIOrth0Given));
+        revrec = ((here->DIOqpNode > 0) && (model->DIOsoftRevRecParam!=0) && (here->DIOtTransitTime!=0));
+
+        /* Update b for Ax = b */
+        *DEVrhsSlot(ckt->CKTrhs, here->DIOnegNode, &scratch) += here->DIOrhsCdeq;
+        *DEVrhsSlot(ckt->CKTrhs, here->DIOposPrimeNode, &scratch) -= here->DIOrhsCdeq;
+        if (selfheat) {
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOposNode, &scratch)      += here->DIOrhsPosTh;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOposPrimeNode, &scratch) += here->DIOrhsPosPrimeTh;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOnegNode, &scratch)      += here->DIOrhsNegTh;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOtempNode, &scratch)     += here->DIOrhsTempTh;
+        }
+        if (model->DIOresistSWGiven) {
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOnegNode, &scratch) += here->DIOrhsCdeqSW;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOposSwPrimeNode, &scratch) -= here->DIOrhsCdeqSW;
+            if (selfheat) {
+                *DEVrhsSlot(ckt->CKTrhs, here->DIOposNode, &scratch)        += here->DIOrhsPosThSW;
+                *DEVrhsSlot(ckt->CKTrhs, here->DIOposSwPrimeNode, &scratch) += here->DIOrhsPosSwPrimeThSW;
+                *DEVrhsSlot(ckt->CKTrhs, here->DIOnegNode, &scratch)        += here->DIOrhsNegThSW;
+                *DEVrhsSlot(ckt->CKTrhs, here->DIOtempNode, &scratch)       += here->DIOrhsTempThSW;
+            }
+        }
+
+        /* Update A for Ax = b */
+        *DEVmatSlot(here->DIOposPosPtr, trash, &scratch) += here->DIOtConductance;
+        *DEVmatSlot(here->DIOnegNegPtr, trash, &scratch) += here->DIOgdLoad;
+        *DEVmatSlot(here->DIOposPrimePosPrimePtr, trash, &scratch) += (here->DIOgdLoad + here->DIOtConductance);
+        *DEVmatSlot(here->DIOposPosPrimePtr, trash, &scratch) -= here->DIOtConductance;
+        *DEVmatSlot(here->DIOnegPosPrimePtr, trash, &scratch) -= here->DIOgdLoad;
+        *DEVmatSlot(here->DIOposPrimePosPtr, trash, &scratch) -= here->DIOtConductance;
+        *DEVmatSlot(here->DIOposPrimeNegPtr, trash, &scratch) -= here->DIOgdLoad;
+        if (selfheat) {
+            (*DEVmatSlot(here->DIOtempPosPtr, trash, &scratch)      += here->DIOtempPosPt);
+            (*DEVmatSlot(here->DIOtempPosPrimePtr, trash, &scratch) += here->DIOtempPosPrimePt);
+            (*DEVmatSlot(here->DIOtempNegPtr, trash, &scratch)      += here->DIOtempNegPt);
+            (*DEVmatSlot(here->DIOtempTempPtr, trash, &scratch)     += here->DIOtempTempPt);
+            (*DEVmatSlot(here->DIOposTempPtr, trash, &scratch)      += here->DIOposTempPt);
+            (*DEVmatSlot(here->DIOposPrimeTempPtr, trash, &scratch) += here->DIOposPrimeTempPt);
+            (*DEVmatSlot(here->DIOnegTempPtr, trash, &scratch)      += here->DIOnegTempPt);
+        }
+        if (model->DIOresistSWGiven) {
+            *DEVmatSlot(here->DIOposPosPtr, trash, &scratch) += here->DIOtConductanceSW;
+            *DEVmatSlot(here->DIOnegNegPtr, trash, &scratch) += here->DIOgdswLoad;
+            *DEVmatSlot(here->DIOposSwPrimePosSwPrimePtr, trash, &scratch) += (here->DIOgdswLoad + here->DIOtConductanceSW);
+            *DEVmatSlot(here->DIOposPosSwPrimePtr, trash, &scratch) -= here->DIOtConductanceSW;
+            *DEVmatSlot(here->DIOnegPosSwPrimePtr, trash, &scratch) -= here->DIOgdswLoad;
+            *DEVmatSlot(here->DIOposSwPrimePosPtr, trash, &scratch) -= here->DIOtConductanceSW;
+            *DEVmatSlot(here->DIOposSwPrimeNegPtr, trash, &scratch) -= here->DIOgdswLoad;
+
+            if (selfheat) {
+                (*DEVmatSlot(here->DIOtempPosPtr, trash, &scratch)        += here->DIOtempPosSWPt);
+                (*DEVmatSlot(here->DIOtempPosSwPrimePtr, trash, &scratch) += here->DIOtempPosSwPrimePt);
+                (*DEVmatSlot(here->DIOtempNegPtr, trash, &scratch)        += here->DIOtempNegSWPt);
+                (*DEVmatSlot(here->DIOposTempPtr, trash, &scratch)        += here->DIOposTempSWPt);
+                (*DEVmatSlot(here->DIOposSwPrimeTempPtr, trash, &scratch) += here->DIOposSwPrimeTempPt);
+                (*DEVmatSlot(here->DIOnegTempPtr, trash, &scratch)        += here->DIOnegTempSWPt);
+            }
+        }
+
+        if (revrec) {
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOqpNode, &scratch) -= here->DIOrhsCeqrr;
+            *DEVmatSlot(here->DIOqpQpPtr, trash, &scratch)       += here->DIOqpQpPt;
+            *DEVmatSlot(here->DIOqpPosPrimePtr, trash, &scratch) += here->DIOqpPosPrimePt;
+            *DEVmatSlot(here->DIOqpNegPtr, trash, &scratch)      += here->DIOqpNegPt;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOposPrimeNode, &scratch) -= here->DIOrhsCeqrrd;
+            *DEVrhsSlot(ckt->CKTrhs, here->DIOnegNode, &scratch) += here->DIOrhsCeqrrd;
+            *DEVmatSlot(here->DIOposPrimeQpPtr, trash, &scratch) += here->DIOposPrimeQpPt;
+            *DEVmatSlot(here->DIOnegQpPtr, trash, &scratch) += here->DIOnegQpPt;
+        }
+    }
+}
+
+void DIOLoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    DIOmodel *model = (DIOmodel*)inModel;
+    int *ColorStart = model->DIOColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->DIOColorCount; color++)
+        DIOLoadRhsMatRange(model->DIOInstanceArray, ColorStart[color],
+                           ColorStart[color + 1], 1, ckt, trash);
+
+    DIOLoadRhsMatRange(model->DIOInstanceArray, ColorStart[model->DIOColorCount],
+                       model->DIOInstCount, 0, ckt, trash);
+}
+#endif
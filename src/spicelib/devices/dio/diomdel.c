@@ -0,0 +1,25 @@
+/**********
+Copyright 1990 Regents of the University of California.  All rights reserved.
+Author: 1985 Thomas L. Quarles
+**********/
+
+#include "ngspice/ngspice.h"
+#include "diodefs.h"
+#include "ngspice/sperror.h"
+#include "ngspice/suffix.h"
+
+
+int
+DIOmDelete(GENmodel *gen_model)
+{
+#ifdef USE_OMP
+    DIOmodel *model = (DIOmodel*) gen_model;
+
+    FREE(model->DIOInstanceArray);
+    FREE(model->DIOColorStart);
+#else
+    NG_IGNORE(gen_model);
+#endif
+
+    return OK;
+}
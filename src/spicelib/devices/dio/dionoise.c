@@ -135,6 +135,12 @@ DIOnoise(int mode, int operation, GENmodel *genmodel, CKTcircuit *ckt,
                         noizDens[DIOTOTNOIZ] += noizDens[DIORSSWNOIZ] +
                             noizDens[DIOIDSWNOIZ] +
                             noizDens[DIOFLSWNOIZ];
+                    } else {
+                        /* no sidewall diode, its sources are integrated nevertheless */
+                        for (i = DIORSSWNOIZ; i <= DIOFLSWNOIZ; i++) {
+                            noizDens[i] = 0.0;
+                            lnNdens[i] = log(N_MINLOG);
+                        }
                     }
 
                     lnNdens[DIOTOTNOIZ] =
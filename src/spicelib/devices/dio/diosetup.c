@@ -13,6 +13,7 @@ Modified by Paolo Nenzi 2003, Dietmar Warning 2012 and Arpad Buermen 2025
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "diodefs.h"
+#include "ngspice/devdefs.h"
 #include "ngspice/sperror.h"
 #include "ngspice/suffix.h"
 #include "ngspice/fteext.h"
@@ -26,6 +27,10 @@ DIOsetup(SMPmatrix *matrix, GENmodel *inModel, CKTcircuit *ckt, int *states)
     int error;
     CKTnode *tmp;
     double scale;
+#ifdef USE_OMP
+    int idx, InstCount;
+    DIOinstance **InstArray;
+#endif
 
     if (!cp_getvar("scale", CP_REAL, &scale, 0))
         scale = 1;
@@ -476,6 +481,47 @@ do { if((here->ptr = SMPmakeElt(matrix, here->first, here->second)) == NULL){\
             }
         }
     }
+#ifdef USE_OMP
+    InstCount = 0;
+    model = (DIOmodel*)inModel;
+    /* loop through all the diode models
+       to count the number of instances */
+
+    for( ; model != NULL; model = DIOnextModel(model))
+    {
+        /* loop through all the instances of the model */
+        for (here = DIOinstances(model); here != NULL ;
+             here=DIOnextInstance(here))
+        {
+            InstCount++;
+        }
+        model->DIOInstCount = 0;
+        model->DIOInstanceArray = NULL;
+        model->DIOColorCount = 0;
+        model->DIOColorStart = NULL;
+    }
+    InstArray = TMALLOC(DIOinstance*, InstCount);
+    model = (DIOmodel*)inModel;
+    /* store this in the first model only */
+    model->DIOInstCount = InstCount;
+    model->DIOInstanceArray = InstArray;
+    idx = 0;
+    for( ; model != NULL; model = DIOnextModel(model))
+    {
+        /* loop through all the instances of the model */
+        for (here = DIOinstances(model); here != NULL ;
+             here=DIOnextInstance(here))
+        {
+            InstArray[idx] = here;
+            idx++;
+        }
+    }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (DIOmodel*)inModel;
+    model->DIOColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 3,
+                                             ckt->CKTmaxEqNum, &model->DIOColorStart);
+#endif
     return(OK);
 }
 
@@ -487,6 +533,12 @@ DIOunsetup(
     DIOmodel *model;
     DIOinstance *here;
 
+#ifdef USE_OMP
+    model = (DIOmodel*)inModel;
+    tfree(model->DIOInstanceArray);
+    tfree(model->DIOColorStart);
+#endif
+
     for (model = (DIOmodel *)inModel; model != NULL;
         model = DIOnextModel(model))
     {
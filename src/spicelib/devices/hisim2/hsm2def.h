@@ -1326,6 +1326,8 @@ typedef struct sHSM2model {       	/* model structure for a resistor */
 #ifdef USE_OMP
     int HSM2InstCount;
     struct sHSM2instance **HSM2InstanceArray;
+    int HSM2ColorCount;
+    int *HSM2ColorStart;
 #endif
 
   /* flag for model */
@@ -37,6 +37,11 @@ extern int HSM2trunc(GENmodel*,CKTcircuit*,double*);
 extern int HSM2noise(int,int,GENmodel*,CKTcircuit*,Ndata*,double*);
 extern int HSM2soaCheck(CKTcircuit *, GENmodel *);
 
+#ifdef USE_OMP
+extern int HSM2LoadOMP(GENinstance*,CKTcircuit*);
+extern void HSM2LoadRhsMat(GENmodel*,CKTcircuit*);
+#endif
+
 #ifdef KLU
 extern int HSM2bindCSC (GENmodel*, CKTcircuit*) ;
 extern int HSM2bindCSCComplex (GENmodel*, CKTcircuit*) ;
@@ -67,6 +67,11 @@ SPICEdev HSM2info = {
     .DEVacct = NULL,
 #endif
 
+#ifdef USE_OMP
+    .DEVloadInstance = HSM2LoadOMP,
+    .DEVloadStamp = HSM2LoadRhsMat,
+#endif
+
 #ifdef KLU
     .DEVbindCSC = HSM2bindCSC,
     .DEVbindCSCComplex = HSM2bindCSCComplex,
@@ -89,11 +89,6 @@ static double vsum0 = 1.0e5 ;
 #endif
 #endif
 
-#ifdef USE_OMP
-int HSM2LoadOMP(HSM2instance *here, CKTcircuit *ckt);
-void HSM2LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt);
-#endif
-
 static void ShowPhysVals
 (
  HSM2instance *here,
@@ -235,7 +230,7 @@ int HSM2load(
 #pragma omp parallel for
     for (idx = 0; idx < model->HSM2InstCount; idx++) {
         HSM2instance *here = InstArray[idx];
-        int local_error = HSM2LoadOMP(here, ckt);
+        int local_error = HSM2LoadOMP(&here->gen, ckt);
         if (local_error)
             error = local_error;
     }
@@ -245,8 +240,9 @@ int HSM2load(
     return error;
 }
 
-int HSM2LoadOMP(HSM2instance *here, CKTcircuit *ckt)
+int HSM2LoadOMP(GENinstance *inInst, CKTcircuit *ckt)
 {
+  HSM2instance *here = (HSM2instance *) inInst;
   HSM2model *model = HSM2modPtr(here);
 #else
   HSM2model *model = (HSM2model*)inModel;
@@ -1494,125 +1490,142 @@ vsum0 = vsum ;
 }
 
 #ifdef USE_OMP
-void HSM2LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+static void
+HSM2LoadRhsMatRange(HSM2instance **InstArray, int first, int last, int parallel,
+                    CKTcircuit *ckt, double *trash)
 {
-    int InstCount, idx;
-    HSM2instance **InstArray;
+    int idx;
     HSM2instance *here;
-    HSM2model *model = (HSM2model*)inModel;
+    HSM2model *model;
 
-    InstArray = model->HSM2InstanceArray;
-    InstCount = model->HSM2InstCount;
+#pragma omp parallel for private(here, model) if (parallel)
+    for (idx = first; idx < last; idx++) {
+       double scratch;
 
-    for (idx = 0; idx < InstCount; idx++) {
        here = InstArray[idx];
        model = HSM2modPtr(here);
         /* Update b for Ax = b */
-        *(ckt->CKTrhs + here->HSM2dNodePrime) += here->HSM2rhsdPrime;
-        *(ckt->CKTrhs + here->HSM2gNodePrime) -= here->HSM2rhsgPrime;
+        *DEVrhsSlot(ckt->CKTrhs, here->HSM2dNodePrime, &scratch) += here->HSM2rhsdPrime;
+        *DEVrhsSlot(ckt->CKTrhs, here->HSM2gNodePrime, &scratch) -= here->HSM2rhsgPrime;
 
         if ( !here->HSM2_corbnet ) {
-          *(ckt->CKTrhs + here->HSM2bNodePrime) += here->HSM2rhsbPrime;
-          *(ckt->CKTrhs + here->HSM2sNodePrime) += here->HSM2rhssPrime;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2bNodePrime, &scratch) += here->HSM2rhsbPrime;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2sNodePrime, &scratch) += here->HSM2rhssPrime;
         } else {
-          *(ckt->CKTrhs + here->HSM2dbNode) -= here->HSM2rhsdb;
-          *(ckt->CKTrhs + here->HSM2bNodePrime) += here->HSM2rhsbPrime;
-          *(ckt->CKTrhs + here->HSM2sbNode) -= here->HSM2rhssb;
-          *(ckt->CKTrhs + here->HSM2sNodePrime) += here->HSM2rhssPrime;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2dbNode, &scratch) -= here->HSM2rhsdb;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2bNodePrime, &scratch) += here->HSM2rhsbPrime;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2sbNode, &scratch) -= here->HSM2rhssb;
+          *DEVrhsSlot(ckt->CKTrhs, here->HSM2sNodePrime, &scratch) += here->HSM2rhssPrime;
        }
 
        /* Update A for Ax = b */
        if (here->HSM2_corg == 1) {
-         *(here->HSM2GgPtr) += here->HSM2_1;
-         *(here->HSM2GPgPtr) -= here->HSM2_2;
-         *(here->HSM2GgpPtr) -= here->HSM2_3;
-         *(here->HSM2GPgpPtr) += here->HSM2_4;
-         *(here->HSM2GPdpPtr) += here->HSM2_5;
-         *(here->HSM2GPspPtr) += here->HSM2_6;
-         *(here->HSM2GPbpPtr) += here->HSM2_7;
+         *DEVmatSlot(here->HSM2GgPtr, trash, &scratch) += here->HSM2_1;
+         *DEVmatSlot(here->HSM2GPgPtr, trash, &scratch) -= here->HSM2_2;
+         *DEVmatSlot(here->HSM2GgpPtr, trash, &scratch) -= here->HSM2_3;
+         *DEVmatSlot(here->HSM2GPgpPtr, trash, &scratch) += here->HSM2_4;
+         *DEVmatSlot(here->HSM2GPdpPtr, trash, &scratch) += here->HSM2_5;
+         *DEVmatSlot(here->HSM2GPspPtr, trash, &scratch) += here->HSM2_6;
+         *DEVmatSlot(here->HSM2GPbpPtr, trash, &scratch) += here->HSM2_7;
        } else {
-         *(here->HSM2GPgpPtr) += here->HSM2_8;
-         *(here->HSM2GPdpPtr) += here->HSM2_9;
-         *(here->HSM2GPspPtr) += here->HSM2_10;
-         *(here->HSM2GPbpPtr) += here->HSM2_11;
+         *DEVmatSlot(here->HSM2GPgpPtr, trash, &scratch) += here->HSM2_8;
+         *DEVmatSlot(here->HSM2GPdpPtr, trash, &scratch) += here->HSM2_9;
+         *DEVmatSlot(here->HSM2GPspPtr, trash, &scratch) += here->HSM2_10;
+         *DEVmatSlot(here->HSM2GPbpPtr, trash, &scratch) += here->HSM2_11;
        }
 
-       *(here->HSM2DPdpPtr) += here->HSM2_12;
+       *DEVmatSlot(here->HSM2DPdpPtr, trash, &scratch) += here->HSM2_12;
 
-       *(here->HSM2DPdPtr) -= here->HSM2_13;
-       *(here->HSM2DPgpPtr) += here->HSM2_14;
-       *(here->HSM2DPspPtr) -= here->HSM2_15;
-       *(here->HSM2DPbpPtr) -= here->HSM2_16;
+       *DEVmatSlot(here->HSM2DPdPtr, trash, &scratch) -= here->HSM2_13;
+       *DEVmatSlot(here->HSM2DPgpPtr, trash, &scratch) += here->HSM2_14;
+       *DEVmatSlot(here->HSM2DPspPtr, trash, &scratch) -= here->HSM2_15;
+       *DEVmatSlot(here->HSM2DPbpPtr, trash, &scratch) -= here->HSM2_16;
 
-       *(here->HSM2DdpPtr) -= here->HSM2_17;
-       *(here->HSM2DdPtr) += here->HSM2_18;
+       *DEVmatSlot(here->HSM2DdpPtr, trash, &scratch) -= here->HSM2_17;
+       *DEVmatSlot(here->HSM2DdPtr, trash, &scratch) += here->HSM2_18;
 
-       *(here->HSM2SPdpPtr) -= here->HSM2_19;
-       *(here->HSM2SPgpPtr) += here->HSM2_20;
-       *(here->HSM2SPspPtr) += here->HSM2_21;
+       *DEVmatSlot(here->HSM2SPdpPtr, trash, &scratch) -= here->HSM2_19;
+       *DEVmatSlot(here->HSM2SPgpPtr, trash, &scratch) += here->HSM2_20;
+       *DEVmatSlot(here->HSM2SPspPtr, trash, &scratch) += here->HSM2_21;
 
-       *(here->HSM2SPsPtr) -= here->HSM2_22;
-       *(here->HSM2SPbpPtr) -= here->HSM2_23;
+       *DEVmatSlot(here->HSM2SPsPtr, trash, &scratch) -= here->HSM2_22;
+       *DEVmatSlot(here->HSM2SPbpPtr, trash, &scratch) -= here->HSM2_23;
 
-       *(here->HSM2SspPtr) -= here->HSM2_24;
-       *(here->HSM2SsPtr) += here->HSM2_25;
+       *DEVmatSlot(here->HSM2SspPtr, trash, &scratch) -= here->HSM2_24;
+       *DEVmatSlot(here->HSM2SsPtr, trash, &scratch) += here->HSM2_25;
 
-       *(here->HSM2BPdpPtr) += here->HSM2_26;
-       *(here->HSM2BPgpPtr) += here->HSM2_27;
-       *(here->HSM2BPspPtr) += here->HSM2_28;
-       *(here->HSM2BPbpPtr) += here->HSM2_29;
+       *DEVmatSlot(here->HSM2BPdpPtr, trash, &scratch) += here->HSM2_26;
+       *DEVmatSlot(here->HSM2BPgpPtr, trash, &scratch) += here->HSM2_27;
+       *DEVmatSlot(here->HSM2BPspPtr, trash, &scratch) += here->HSM2_28;
+       *DEVmatSlot(here->HSM2BPbpPtr, trash, &scratch) += here->HSM2_29;
 
        if (model->HSM2_cogidl) {
          /* stamp GIDL */
-         *(here->HSM2DPdpPtr) += here->HSM2_30;
-         *(here->HSM2DPgpPtr) += here->HSM2_31;
-         *(here->HSM2DPspPtr) -= here->HSM2_32;
+         *DEVmatSlot(here->HSM2DPdpPtr, trash, &scratch) += here->HSM2_30;
+         *DEVmatSlot(here->HSM2DPgpPtr, trash, &scratch) += here->HSM2_31;
+         *DEVmatSlot(here->HSM2DPspPtr, trash, &scratch) -= here->HSM2_32;
 
-         *(here->HSM2DPbpPtr) += here->HSM2_33;
-         *(here->HSM2BPdpPtr) -= here->HSM2_34;
-         *(here->HSM2BPgpPtr) -= here->HSM2_35;
-         *(here->HSM2BPspPtr) += here->HSM2_36;
+         *DEVmatSlot(here->HSM2DPbpPtr, trash, &scratch) += here->HSM2_33;
+         *DEVmatSlot(here->HSM2BPdpPtr, trash, &scratch) -= here->HSM2_34;
+         *DEVmatSlot(here->HSM2BPgpPtr, trash, &scratch) -= here->HSM2_35;
+         *DEVmatSlot(here->HSM2BPspPtr, trash, &scratch) += here->HSM2_36;
 
-         *(here->HSM2BPbpPtr) -= here->HSM2_37;
+         *DEVmatSlot(here->HSM2BPbpPtr, trash, &scratch) -= here->HSM2_37;
          /* stamp GISL */
-         *(here->HSM2SPdpPtr) -= here->HSM2_38;
+         *DEVmatSlot(here->HSM2SPdpPtr, trash, &scratch) -= here->HSM2_38;
 
-         *(here->HSM2SPgpPtr) += here->HSM2_39;
-         *(here->HSM2SPspPtr) += here->HSM2_40;
-         *(here->HSM2SPbpPtr) += here->HSM2_41;
-         *(here->HSM2BPdpPtr) += here->HSM2_42;
+         *DEVmatSlot(here->HSM2SPgpPtr, trash, &scratch) += here->HSM2_39;
+         *DEVmatSlot(here->HSM2SPspPtr, trash, &scratch) += here->HSM2_40;
+         *DEVmatSlot(here->HSM2SPbpPtr, trash, &scratch) += here->HSM2_41;
+         *DEVmatSlot(here->HSM2BPdpPtr, trash, &scratch) += here->HSM2_42;
 
-         *(here->HSM2BPgpPtr) -= here->HSM2_43;
-         *(here->HSM2BPspPtr) -= here->HSM2_44;
-         *(here->HSM2BPbpPtr) -= here->HSM2_45;
+         *DEVmatSlot(here->HSM2BPgpPtr, trash, &scratch) -= here->HSM2_43;
+         *DEVmatSlot(here->HSM2BPspPtr, trash, &scratch) -= here->HSM2_44;
+         *DEVmatSlot(here->HSM2BPbpPtr, trash, &scratch) -= here->HSM2_45;
        }
 
        if (here->HSM2_corbnet) { /* body resistance network */
-         *(here->HSM2DPdbPtr) += here->HSM2_46;
-         *(here->HSM2SPsbPtr) -= here->HSM2_47;
+         *DEVmatSlot(here->HSM2DPdbPtr, trash, &scratch) += here->HSM2_46;
+         *DEVmatSlot(here->HSM2SPsbPtr, trash, &scratch) -= here->HSM2_47;
 
-         *(here->HSM2DBdpPtr) += here->HSM2_48;
-         *(here->HSM2DBdbPtr) += here->HSM2_49;
+         *DEVmatSlot(here->HSM2DBdpPtr, trash, &scratch) += here->HSM2_48;
+         *DEVmatSlot(here->HSM2DBdbPtr, trash, &scratch) += here->HSM2_49;
 
-         *(here->HSM2DBbpPtr) -= here->HSM2_50;
-         *(here->HSM2DBbPtr) -= here->HSM2_51;
+         *DEVmatSlot(here->HSM2DBbpPtr, trash, &scratch) -= here->HSM2_50;
+         *DEVmatSlot(here->HSM2DBbPtr, trash, &scratch) -= here->HSM2_51;
 
-         *(here->HSM2BPdbPtr) -= here->HSM2_52;
-         *(here->HSM2BPbPtr) -= here->HSM2_53;
-         *(here->HSM2BPsbPtr) -= here->HSM2_54;
-         *(here->HSM2BPbpPtr) += here->HSM2_55;
+         *DEVmatSlot(here->HSM2BPdbPtr, trash, &scratch) -= here->HSM2_52;
+         *DEVmatSlot(here->HSM2BPbPtr, trash, &scratch) -= here->HSM2_53;
+         *DEVmatSlot(here->HSM2BPsbPtr, trash, &scratch) -= here->HSM2_54;
+         *DEVmatSlot(here->HSM2BPbpPtr, trash, &scratch) += here->HSM2_55;
 
-         *(here->HSM2SBspPtr) += here->HSM2_56;
-         *(here->HSM2SBbpPtr) -= here->HSM2_57;
-         *(here->HSM2SBbPtr) -= here->HSM2_58;
-         *(here->HSM2SBsbPtr) += here->HSM2_59;
+         *DEVmatSlot(here->HSM2SBspPtr, trash, &scratch) += here->HSM2_56;
+         *DEVmatSlot(here->HSM2SBbpPtr, trash, &scratch) -= here->HSM2_57;
+         *DEVmatSlot(here->HSM2SBbPtr, trash, &scratch) -= here->HSM2_58;
+         *DEVmatSlot(here->HSM2SBsbPtr, trash, &scratch) += here->HSM2_59;
 
 
-         *(here->HSM2BdbPtr) -= here->HSM2_60;
-         *(here->HSM2BbpPtr) -= here->HSM2_61;
-         *(here->HSM2BsbPtr) -= here->HSM2_62;
-         *(here->HSM2BbPtr) += here->HSM2_63;
+         *DEVmatSlot(here->HSM2BdbPtr, trash, &scratch) -= here->HSM2_60;
+         *DEVmatSlot(here->HSM2BbpPtr, trash, &scratch) -= here->HSM2_61;
+         *DEVmatSlot(here->HSM2BsbPtr, trash, &scratch) -= here->HSM2_62;
+         *DEVmatSlot(here->HSM2BbPtr, trash, &scratch) += here->HSM2_63;
        }
     }
 }
+
+void HSM2LoadRhsMat(GENmodel *inModel, CKTcircuit *ckt)
+{
+    HSM2model *model = (HSM2model*)inModel;
+    int *ColorStart = model->HSM2ColorStart;
+    int color;
+    double *trash = SMPmakeElt(ckt->CKTmatrix, 0, 0);
+
+    /* instances of one color have no node in common */
+    for (color = 0; color < model->HSM2ColorCount; color++)
+        HSM2LoadRhsMatRange(model->HSM2InstanceArray, ColorStart[color],
+                            ColorStart[color + 1], 1, ckt, trash);
+
+    HSM2LoadRhsMatRange(model->HSM2InstanceArray, ColorStart[model->HSM2ColorCount],
+                        model->HSM2InstCount, 0, ckt, trash);
+}
 #endif
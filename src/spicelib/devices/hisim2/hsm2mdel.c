@@ -68,6 +68,7 @@ HSM2mDelete(GENmodel *gen_model)
 #ifdef USE_OMP
     HSM2model *model = (HSM2model *) gen_model;
     FREE(model->HSM2InstanceArray);
+    FREE(model->HSM2ColorStart);
 #endif
 
     return OK;
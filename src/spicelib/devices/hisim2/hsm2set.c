@@ -58,6 +58,7 @@ to others."
 #include "ngspice/smpdefs.h"
 #include "ngspice/cktdefs.h"
 #include "hsm2def.h"
+#include "ngspice/devdefs.h"
 #include "hsm2evalenv.h"
 #include "ngspice/const.h"
 #include "ngspice/sperror.h"
@@ -1275,6 +1276,8 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
         }
         model->HSM2InstCount = 0;
         model->HSM2InstanceArray = NULL;
+        model->HSM2ColorCount = 0;
+        model->HSM2ColorStart = NULL;
     }
     InstArray = TMALLOC(HSM2instance*, InstCount);
     model = (HSM2model*)inModel;
@@ -1292,6 +1295,11 @@ do { if((here->ptr = SMPmakeElt(matrix,here->first,here->second))==(double *)NUL
             idx++;
         }
     }
+
+    /* sort the instances into colors which can be stamped concurrently */
+    model = (HSM2model*)inModel;
+    model->HSM2ColorCount = DEVcolorInstances((GENinstance **) InstArray, InstCount, 4,
+                                             ckt->CKTmaxEqNum, &model->HSM2ColorStart);
 #endif
 
   return(OK);
@@ -245,8 +245,9 @@ ISRCaccept(CKTcircuit *ckt, GENmodel *inModel)
 
                             if (ckt->CKTtime == 0) {
                                 /* initialzing here again needed for repeated calls to tran command */
-                                state->RTScapTime = RTScapTime = exprand(RTSCAPT);
-                                state->RTSemTime = RTSemTime = RTScapTime + exprand(RTSEMT);
+                                state->rts.index = 0;
+                                state->RTScapTime = RTScapTime = trnoise_state_exprand(state, RTSCAPT);
+                                state->RTSemTime = RTSemTime = RTScapTime + trnoise_state_exprand(state, RTSEMT);
                                 if (ckt->CKTbreak) {
                                     error = CKTsetBreak(ckt, RTScapTime);
                                     if(error)
@@ -264,8 +265,8 @@ ISRCaccept(CKTcircuit *ckt, GENmodel *inModel)
 
                             if(AlmostEqualUlps(RTSemTime, ckt->CKTtime, 3)) {
                                 /* new values */
-                                RTScapTime = here -> ISRCtrnoise_state ->RTScapTime = ckt->CKTtime + exprand(RTSCAPT);
-                                here -> ISRCtrnoise_state ->RTSemTime = RTScapTime + exprand(RTSEMT);
+                                RTScapTime = here -> ISRCtrnoise_state ->RTScapTime = ckt->CKTtime + trnoise_state_exprand(state, RTSCAPT);
+                                here -> ISRCtrnoise_state ->RTSemTime = RTScapTime + trnoise_state_exprand(state, RTSEMT);
 
                                 if (ckt->CKTbreak) {
                                     error = CKTsetBreak(ckt, RTScapTime);
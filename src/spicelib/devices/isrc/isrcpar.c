@@ -214,7 +214,7 @@ ISRCparam(int param, IFvalue *value, GENinstance *inst, IFvalue *select)
                with the new parameters. So free the old state first. */
             trnoise_state_free(here->ISRCtrnoise_state);
             here->ISRCtrnoise_state =
-                trnoise_state_init(NA, TS, NALPHA, NAMP, RTSAM, RTSCAPT, RTSEMT);
+                trnoise_state_init(here->ISRCname, NA, TS, NALPHA, NAMP, RTSAM, RTSCAPT, RTSEMT);
         }
         break;
 
@@ -243,7 +243,7 @@ ISRCparam(int param, IFvalue *value, GENinstance *inst, IFvalue *select)
                with the new parameters. So free the old state first. */
             tfree(here->ISRCtrrandom_state);
             here->ISRCtrrandom_state =
-                trrandom_state_init(rndtype, TS, TD, PARAM1, PARAM2);
+                trrandom_state_init(here->ISRCname, rndtype, TS, TD, PARAM1, PARAM2);
         }
         break;
 
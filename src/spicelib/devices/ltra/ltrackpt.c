@@ -0,0 +1,76 @@
+/**********
+Checkpoint of the lossy transmission line
+**********/
+
+/* The voltages and currents at the ends of the lines for all time points
+   so far, see CKTckptSave() */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cktdefs.h"
+#include "ltradefs.h"
+#include "ngspice/sperror.h"
+#include "ngspice/suffix.h"
+
+
+int
+LTRAcheckpoint(GENmodel *inModel, CKTcircuit *ckt, CKTckpt *ck)
+{
+    LTRAmodel *model = (LTRAmodel *) inModel;
+    LTRAinstance *here;
+    size_t n = (size_t) (ckt->CKTtimeIndex + 1) * sizeof(double);
+
+    for (; model != NULL; model = LTRAnextModel(model))
+        for (here = LTRAinstances(model); here != NULL; here = LTRAnextInstance(here)) {
+            CKTckptPutName(ck, here->LTRAname);
+            CKTckptPut(ck, &here->LTRAinput1, sizeof(double));
+            CKTckptPut(ck, &here->LTRAinput2, sizeof(double));
+            CKTckptPut(ck, here->LTRAv1, n);
+            CKTckptPut(ck, here->LTRAi1, n);
+            CKTckptPut(ck, here->LTRAv2, n);
+            CKTckptPut(ck, here->LTRAi2, n);
+        }
+
+    return OK;
+}
+
+
+/* Called after the time points have been restored */
+int
+LTRArestore(GENmodel *inModel, CKTcircuit *ckt, CKTckpt *ck)
+{
+    LTRAmodel *model = (LTRAmodel *) inModel;
+    LTRAinstance *here;
+    int size = MAX(ckt->CKTtimeListSize, ckt->CKTtimeIndex + 1);
+    size_t n = (size_t) (ckt->CKTtimeIndex + 1) * sizeof(double);
+
+    if (!ckt->CKTtimePoints)
+        return E_CHECKPOINT;
+
+    for (; model != NULL; model = LTRAnextModel(model)) {
+
+        /* the coefficients are computed anew at every time point */
+        model->LTRAmodelListSize = MAX(100, size);
+        model->LTRAh1dashCoeffs = TREALLOC(double, model->LTRAh1dashCoeffs, model->LTRAmodelListSize);
+        model->LTRAh2Coeffs = TREALLOC(double, model->LTRAh2Coeffs, model->LTRAmodelListSize);
+        model->LTRAh3dashCoeffs = TREALLOC(double, model->LTRAh3dashCoeffs, model->LTRAmodelListSize);
+
+        for (here = LTRAinstances(model); here != NULL; here = LTRAnextInstance(here)) {
+            here->LTRAinstListSize = MAX(10, size);
+            here->LTRAv1 = TREALLOC(double, here->LTRAv1, here->LTRAinstListSize);
+            here->LTRAi1 = TREALLOC(double, here->LTRAi1, here->LTRAinstListSize);
+            here->LTRAv2 = TREALLOC(double, here->LTRAv2, here->LTRAinstListSize);
+            here->LTRAi2 = TREALLOC(double, here->LTRAi2, here->LTRAinstListSize);
+
+            if (CKTckptGetName(ck, here->LTRAname) ||
+                CKTckptGet(ck, &here->LTRAinput1, sizeof(double)) ||
+                CKTckptGet(ck, &here->LTRAinput2, sizeof(double)) ||
+                CKTckptGet(ck, here->LTRAv1, n) ||
+                CKTckptGet(ck, here->LTRAi1, n) ||
+                CKTckptGet(ck, here->LTRAv2, n) ||
+                CKTckptGet(ck, here->LTRAi2, n))
+                return E_CHECKPOINT;
+        }
+    }
+
+    return OK;
+}
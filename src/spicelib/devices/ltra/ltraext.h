@@ -16,6 +16,8 @@ extern int LTRAsetup(SMPmatrix*,GENmodel*,CKTcircuit*,int*);
 extern int LTRAunsetup(GENmodel*,CKTcircuit*);
 extern int LTRAtemp(GENmodel*,CKTcircuit*);
 extern int LTRAtrunc(GENmodel*,CKTcircuit*,double*);
+extern int LTRAcheckpoint(GENmodel*,CKTcircuit*,CKTckpt*);
+extern int LTRArestore(GENmodel*,CKTcircuit*,CKTckpt*);
 
 extern int LTRAlinInterp(double,double,double,double*,double*);
 
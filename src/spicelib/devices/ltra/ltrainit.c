@@ -72,6 +72,9 @@ SPICEdev LTRAinfo = {
     .DEVbindCSCComplex = LTRAbindCSCComplex,
     .DEVbindCSCComplexToReal = LTRAbindCSCComplexToReal,
 #endif
+
+    .DEVcheckpoint = LTRAcheckpoint,
+    .DEVrestore = LTRArestore,
 };
 
 
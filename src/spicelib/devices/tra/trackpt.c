@@ -0,0 +1,62 @@
+/**********
+Checkpoint of the lossless transmission line
+**********/
+
+/* The delay tables of the lines, see CKTckptSave() */
+
+#include "ngspice/ngspice.h"
+#include "ngspice/cktdefs.h"
+#include "tradefs.h"
+#include "ngspice/sperror.h"
+#include "ngspice/suffix.h"
+
+
+int
+TRAcheckpoint(GENmodel *inModel, CKTcircuit *ckt, CKTckpt *ck)
+{
+    TRAmodel *model = (TRAmodel *) inModel;
+    TRAinstance *here;
+
+    NG_IGNORE(ckt);
+
+    for (; model != NULL; model = TRAnextModel(model))
+        for (here = TRAinstances(model); here != NULL; here = TRAnextInstance(here)) {
+            CKTckptPutName(ck, here->TRAname);
+            CKTckptPut(ck, &here->TRAinput1, sizeof(double));
+            CKTckptPut(ck, &here->TRAinput2, sizeof(double));
+            CKTckptPut(ck, &here->TRAsizeDelay, sizeof(int));
+            CKTckptPut(ck, here->TRAdelays,
+                       3 * (size_t) (here->TRAsizeDelay + 1) * sizeof(double));
+        }
+
+    return OK;
+}
+
+
+int
+TRArestore(GENmodel *inModel, CKTcircuit *ckt, CKTckpt *ck)
+{
+    TRAmodel *model = (TRAmodel *) inModel;
+    TRAinstance *here;
+    int size;
+
+    NG_IGNORE(ckt);
+
+    for (; model != NULL; model = TRAnextModel(model))
+        for (here = TRAinstances(model); here != NULL; here = TRAnextInstance(here)) {
+            if (CKTckptGetName(ck, here->TRAname) ||
+                CKTckptGet(ck, &here->TRAinput1, sizeof(double)) ||
+                CKTckptGet(ck, &here->TRAinput2, sizeof(double)) ||
+                CKTckptGet(ck, &size, sizeof(int)) || size < 0)
+                return E_CHECKPOINT;
+            if (size > here->TRAallocDelay) {
+                here->TRAallocDelay = size;
+                here->TRAdelays = TREALLOC(double, here->TRAdelays, (here->TRAallocDelay + 1) * 3);
+            }
+            here->TRAsizeDelay = size;
+            if (CKTckptGet(ck, here->TRAdelays, 3 * (size_t) (size + 1) * sizeof(double)))
+                return E_CHECKPOINT;
+        }
+
+    return OK;
+}
@@ -6,9 +6,11 @@ Author: 1985 Thomas L. Quarles
 extern int TRAacLoad(GENmodel*,CKTcircuit*);
 extern int TRAaccept(CKTcircuit*,GENmodel*);
 extern int TRAask(CKTcircuit*,GENinstance*,int,IFvalue*,IFvalue*);
+extern int TRAcheckpoint(GENmodel*,CKTcircuit*,CKTckpt*);
 extern int TRAload(GENmodel*,CKTcircuit*);
 extern int TRAmAsk(CKTcircuit*,GENmodel*,int,IFvalue*);
 extern int TRAparam(int,IFvalue*,GENinstance*,IFvalue*);
+extern int TRArestore(GENmodel*,CKTcircuit*,CKTckpt*);
 extern int TRAsetup(SMPmatrix*,GENmodel*,CKTcircuit*,int*);
 extern int TRAunsetup(GENmodel*,CKTcircuit*);
 extern int TRAtemp(GENmodel*,CKTcircuit*);
@@ -72,6 +72,9 @@ SPICEdev TRAinfo = {
     .DEVbindCSCComplex = TRAbindCSCComplex,
     .DEVbindCSCComplexToReal = TRAbindCSCComplexToReal,
 #endif
+
+    .DEVcheckpoint = TRAcheckpoint,
+    .DEVrestore = TRArestore,
 };
 
 
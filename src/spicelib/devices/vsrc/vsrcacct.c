@@ -262,9 +262,10 @@ VSRCaccept(CKTcircuit *ckt, GENmodel *inModel)
 
                         if (ckt->CKTtime == 0) {
                             /* initialzing here again needed for repeated calls to tran command */
-                            state->RTScapTime = exprand(state->RTSCAPT);
+                            state->rts.index = 0;
+                            state->RTScapTime = trnoise_state_exprand(state, state->RTSCAPT);
                             state->RTSemTime =
-                                state->RTScapTime + exprand(state->RTSEMT);
+                                state->RTScapTime + trnoise_state_exprand(state, state->RTSEMT);
                             error = CKTsetBreak(ckt, state->RTScapTime);
                             if(error)
                                 return(error);
@@ -289,9 +290,9 @@ VSRCaccept(CKTcircuit *ckt, GENmodel *inModel)
                             /* new values */
 
                             state->RTScapTime =
-                                ckt->CKTtime + exprand(state->RTSCAPT);
+                                ckt->CKTtime + trnoise_state_exprand(state, state->RTSCAPT);
                             state->RTSemTime =
-                                state->RTScapTime + exprand(state->RTSEMT);
+                                state->RTScapTime + trnoise_state_exprand(state, state->RTSEMT);
                             error = CKTsetBreak(ckt, state->RTScapTime);
                             if(error)
                                 return(error);
@@ -21,6 +21,7 @@ extern double PTfudge_factor;
 
 static int PTeval(INPparseNode * tree, double gmin, double *res,
 		  double *vals);
+static int PTexec(PTtape *tape, double *vals);
 
 
 
@@ -43,6 +44,29 @@ IFeval(IFparseTree * tree, double gmin, double *result, double *vals,
 	printf("\tvar%d = %lg\n", i, vals[i]);
 #endif
 
+    if (myTree->tape) {
+        PTtape *tape = myTree->tape;
+
+        PTfudge_factor = gmin * 1.0e-20;
+        if ((err = PTexec(tape, vals)) != OK) {
+            if (ft_ngdebug) {
+                INPptPrint("calling PTexec, tree = ", tree);
+                printf("values:");
+                for (i = 0; i < myTree->p.numVars; i++)
+                    printf("\tvar%d = %lg\n", i, vals[i]);
+            }
+            if (ft_stricterror)
+                controlled_exit(EXIT_BAD);
+            return err;
+        }
+
+        *result = tape->regs[tape->result];
+        for (i = 0; i < myTree->p.numVars; i++)
+            derivs[i] = tape->regs[tape->derivs[i]];
+
+        return (OK);
+    }
+
     if ((err = PTeval(myTree->tree, gmin, result, vals)) != OK) {
         if (ft_ngdebug) {
             INPptPrint("calling PTeval, tree = ", tree);
@@ -188,3 +212,541 @@ PTeval(INPparseNode * tree, double gmin, double *res, double *vals)
 
     return (OK);
 }
+
+
+/*
+ * The compiled form of the parse trees.
+ *
+ * PTcompile() walks the function tree and then the derivative trees,
+ * emitting one instruction per node into a common tape.  Nodes already
+ * compiled (the derivative trees share many subtrees with the function)
+ * and instructions with the same operation and operands reuse the
+ * register computed before.  Operations on constants are done here,
+ * except those which depend on gmin, are stateful or would fail.  The
+ * branches of a ternary are compiled behind jumps, so that only the
+ * selected one is evaluated, as PTeval() does.
+ */
+
+enum {
+    PTI_CONST,          /* only used as a key, constants are preloaded */
+    PTI_VAR,            /* dst = vals[a] */
+    PTI_TIME,           /* dst = CKTtime ... of (CKTcircuit *) data */
+    PTI_TEMPERATURE,
+    PTI_FREQUENCY,
+    PTI_PLUS,           /* dst = a + b */
+    PTI_MINUS,
+    PTI_TIMES,
+    PTI_BINARY,         /* dst = function(a, b), an operator */
+    PTI_FUNC2,          /* dst = function(a, b), pow(), min() ... */
+    PTI_UNARY,          /* dst = function(a) */
+    PTI_UNARY_DATA,     /* dst = function(a, data) */
+    PTI_MOVE,           /* dst = a */
+    PTI_JZ,             /* if (a == 0) jump to b */
+    PTI_JMP             /* jump to b */
+};
+
+struct ptmemo {
+    const INPparseNode *node;   /* compiled node, NULL for an instruction */
+    int op, a, b;
+    void (*function)(void);
+    void *data;
+    double constant;
+    unsigned int hash;
+    int reg;
+    int next;
+};
+
+struct ptcomp {
+    PTinstr *code;
+    int ncode, code_size;
+    double *regs;
+    char *known;                /* register holds a constant */
+    int nregs, regs_size;
+    struct ptmemo *memo;        /* in order of insertion */
+    int nmemo, memo_size;
+    int *bucket;
+    unsigned int mask;
+    bool failed;
+};
+
+
+static unsigned int
+pt_mix(unsigned int h, size_t v)
+{
+    h ^= (unsigned int) v + 0x9e3779b9u + (h << 6) + (h >> 2);
+    if (sizeof(size_t) > sizeof(unsigned int))
+        h ^= (unsigned int) (v >> 16 >> 16) + 0x9e3779b9u + (h << 6) + (h >> 2);
+    return h;
+}
+
+
+static unsigned int
+pt_hash_instr(int op, int a, int b, void (*function)(void), void *data,
+              double constant)
+{
+    unsigned int h = (unsigned int) op;
+    size_t bits = 0;
+
+    memcpy(&bits, &constant, MIN(sizeof(bits), sizeof(constant)));
+    h = pt_mix(h, (size_t) a);
+    h = pt_mix(h, (size_t) b);
+    h = pt_mix(h, (size_t) function);
+    h = pt_mix(h, (size_t) data);
+    return pt_mix(h, bits);
+}
+
+
+/* The chains are rebuilt in order of insertion, so that the newest entry
+ * is always at the head of its chain, which pt_forget() relies on. */
+
+static void
+pt_rehash(struct ptcomp *c, unsigned int nbuckets)
+{
+    int i;
+
+    tfree(c->bucket);
+    c->bucket = TMALLOC(int, nbuckets);
+    c->mask = nbuckets - 1;
+    for (i = 0; i < (int) nbuckets; i++)
+        c->bucket[i] = -1;
+    for (i = 0; i < c->nmemo; i++) {
+        struct ptmemo *m = &c->memo[i];
+        m->next = c->bucket[m->hash & c->mask];
+        c->bucket[m->hash & c->mask] = i;
+    }
+}
+
+
+static void
+pt_remember(struct ptcomp *c, struct ptmemo *key, int reg)
+{
+    struct ptmemo *m;
+
+    if (c->nmemo >= c->memo_size) {
+        c->memo_size *= 2;
+        c->memo = TREALLOC(struct ptmemo, c->memo, c->memo_size);
+    }
+    m = &c->memo[c->nmemo];
+    *m = *key;
+    m->reg = reg;
+    m->next = c->bucket[m->hash & c->mask];
+    c->bucket[m->hash & c->mask] = c->nmemo++;
+
+    if ((unsigned int) c->nmemo > 2 * (c->mask + 1))
+        pt_rehash(c, 2 * (c->mask + 1));
+}
+
+
+/* Drop what was remembered since mark, when leaving a ternary branch */
+
+static void
+pt_forget(struct ptcomp *c, int mark)
+{
+    while (c->nmemo > mark) {
+        struct ptmemo *m = &c->memo[--c->nmemo];
+        c->bucket[m->hash & c->mask] = m->next;
+    }
+}
+
+
+static int
+pt_lookup(struct ptcomp *c, struct ptmemo *key)
+{
+    int i;
+
+    for (i = c->bucket[key->hash & c->mask]; i >= 0; i = c->memo[i].next) {
+        struct ptmemo *m = &c->memo[i];
+        if (m->hash != key->hash || m->node != key->node)
+            continue;
+        if (key->node)
+            return m->reg;
+        if (m->op == key->op && m->a == key->a && m->b == key->b &&
+            m->function == key->function && m->data == key->data &&
+            memcmp(&m->constant, &key->constant, sizeof(double)) == 0)
+            return m->reg;
+    }
+    return -1;
+}
+
+
+static int
+pt_newreg(struct ptcomp *c, double value, bool known)
+{
+    if (c->nregs >= c->regs_size) {
+        c->regs_size *= 2;
+        c->regs = TREALLOC(double, c->regs, c->regs_size);
+        c->known = TREALLOC(char, c->known, c->regs_size);
+    }
+    c->regs[c->nregs] = value;
+    c->known[c->nregs] = known;
+    return c->nregs++;
+}
+
+
+static int
+pt_code(struct ptcomp *c, int op, int dst, int a, int b,
+        void (*function)(void), void *data, const char *funcname)
+{
+    PTinstr *ip;
+
+    if (c->ncode >= c->code_size) {
+        c->code_size *= 2;
+        c->code = TREALLOC(PTinstr, c->code, c->code_size);
+    }
+    ip = &c->code[c->ncode];
+    ip->op = op;
+    ip->dst = dst;
+    ip->a = a;
+    ip->b = b;
+    ip->function = function;
+    ip->data = data;
+    ip->funcname = funcname;
+    return c->ncode++;
+}
+
+
+static int
+pt_const(struct ptcomp *c, double value)
+{
+    struct ptmemo key;
+    int reg;
+
+    memset(&key, 0, sizeof(key));
+    key.op = PTI_CONST;
+    key.constant = value;
+    key.hash = pt_hash_instr(PTI_CONST, 0, 0, NULL, NULL, value);
+
+    if ((reg = pt_lookup(c, &key)) >= 0)
+        return reg;
+
+    reg = pt_newreg(c, value, TRUE);
+    pt_remember(c, &key, reg);
+    return reg;
+}
+
+
+/* Emit an instruction unless the same has been emitted before, or, with
+ * fold set, compute it here if its operands are constant. */
+
+static int
+pt_emit(struct ptcomp *c, int op, int a, int b, void (*function)(void),
+        void *data, const char *funcname, bool fold)
+{
+    struct ptmemo key;
+    int reg;
+
+    if ((op == PTI_PLUS || op == PTI_TIMES) && a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+
+    if (fold && c->known[a] && (b < 0 || c->known[b])) {
+        double value;
+        switch (op) {
+        case PTI_PLUS:
+            value = c->regs[a] + c->regs[b];
+            break;
+        case PTI_MINUS:
+            value = c->regs[a] - c->regs[b];
+            break;
+        case PTI_TIMES:
+            value = c->regs[a] * c->regs[b];
+            break;
+        case PTI_BINARY:
+        case PTI_FUNC2:
+            value = PTbinary(function) (c->regs[a], c->regs[b]);
+            break;
+        default:
+            value = PTunary(function) (c->regs[a]);
+            break;
+        }
+        /* leave the error message to the evaluation */
+        if (value != HUGE)
+            return pt_const(c, value);
+    }
+
+    memset(&key, 0, sizeof(key));
+    key.op = op;
+    key.a = a;
+    key.b = b;
+    key.function = function;
+    key.data = data;
+    key.hash = pt_hash_instr(op, a, b, function, data, 0.0);
+
+    if ((reg = pt_lookup(c, &key)) >= 0)
+        return reg;
+
+    reg = pt_newreg(c, 0.0, FALSE);
+    pt_code(c, op, reg, a, b, function, data, funcname);
+    pt_remember(c, &key, reg);
+    return reg;
+}
+
+
+static int pt_node(struct ptcomp *c, const INPparseNode *p);
+
+
+static int
+pt_tern(struct ptcomp *c, const INPparseNode *p)
+{
+    int cond, dst, jz, jmp, mark;
+
+    cond = pt_node(c, p->left);
+    if (c->failed)
+        return 0;
+
+    /*FIXME > 0.0, >= 0.5, != 0.0 or what ? */
+    if (c->known[cond])
+        return pt_node(c, (c->regs[cond] != 0.0) ? p->right->left : p->right->right);
+
+    dst = pt_newreg(c, 0.0, FALSE);
+    mark = c->nmemo;
+
+    jz = pt_code(c, PTI_JZ, -1, cond, 0, NULL, NULL, NULL);
+    pt_code(c, PTI_MOVE, dst, pt_node(c, p->right->left), -1, NULL, NULL, NULL);
+    pt_forget(c, mark);
+
+    jmp = pt_code(c, PTI_JMP, -1, -1, 0, NULL, NULL, NULL);
+    c->code[jz].b = c->ncode;
+    pt_code(c, PTI_MOVE, dst, pt_node(c, p->right->right), -1, NULL, NULL, NULL);
+    pt_forget(c, mark);
+
+    c->code[jmp].b = c->ncode;
+    return dst;
+}
+
+
+static int
+pt_node(struct ptcomp *c, const INPparseNode *p)
+{
+    struct ptmemo key;
+    int reg, a, b;
+
+    if (c->failed)
+        return 0;
+
+    memset(&key, 0, sizeof(key));
+    key.node = p;
+    key.hash = pt_mix(0, (size_t) p);
+
+    if ((reg = pt_lookup(c, &key)) >= 0)
+        return reg;
+
+    switch (p->type) {
+    case PT_CONSTANT:
+        reg = pt_const(c, p->constant);
+        break;
+
+    case PT_VAR:
+        reg = pt_emit(c, PTI_VAR, p->valueIndex, -1, NULL, NULL, NULL, FALSE);
+        break;
+
+    case PT_TIME:
+        reg = pt_emit(c, PTI_TIME, -1, -1, NULL, p->data, NULL, FALSE);
+        break;
+
+    case PT_TEMPERATURE:
+        reg = pt_emit(c, PTI_TEMPERATURE, -1, -1, NULL, p->data, NULL, FALSE);
+        break;
+
+    case PT_FREQUENCY:
+        reg = pt_emit(c, PTI_FREQUENCY, -1, -1, NULL, p->data, NULL, FALSE);
+        break;
+
+    case PT_FUNCTION:
+        switch (p->funcnum) {
+        case PTF_POW:
+        case PTF_PWR:
+        case PTF_MIN:
+        case PTF_MAX:
+            a = pt_node(c, p->left->left);
+            b = pt_node(c, p->left->right);
+            if (c->failed)
+                return 0;
+            /* pwr() adds the gmin dependent fudge factor */
+            reg = pt_emit(c, PTI_FUNC2, a, b, p->function, NULL, p->funcname,
+                          p->funcnum != PTF_PWR);
+            break;
+        default:
+            a = pt_node(c, p->left);
+            if (c->failed)
+                return 0;
+            reg = pt_emit(c, p->data ? PTI_UNARY_DATA : PTI_UNARY, a, -1,
+                          p->function, p->data, p->funcname, !p->data);
+            break;
+        }
+        break;
+
+    case PT_TERN:
+        reg = pt_tern(c, p);
+        break;
+
+    case PT_PLUS:
+    case PT_MINUS:
+    case PT_TIMES:
+    case PT_DIVIDE:
+    case PT_POWER:
+        a = pt_node(c, p->left);
+        b = pt_node(c, p->right);
+        if (c->failed)
+            return 0;
+        if (p->type == PT_PLUS)
+            reg = pt_emit(c, PTI_PLUS, a, b, NULL, NULL, p->funcname, TRUE);
+        else if (p->type == PT_MINUS)
+            reg = pt_emit(c, PTI_MINUS, a, b, NULL, NULL, p->funcname, TRUE);
+        else if (p->type == PT_TIMES)
+            reg = pt_emit(c, PTI_TIMES, a, b, NULL, NULL, p->funcname, TRUE);
+        else    /* division adds the gmin dependent fudge factor */
+            reg = pt_emit(c, PTI_BINARY, a, b, p->function, NULL, p->funcname,
+                          p->type == PT_POWER);
+        break;
+
+    default:
+        c->failed = TRUE;
+        return 0;
+    }
+
+    if (c->failed)
+        return 0;
+
+    pt_remember(c, &key, reg);
+    return reg;
+}
+
+
+/* Compile the function tree and its derivatives, NULL if this is not
+ * possible, then the trees are evaluated by PTeval(). */
+
+PTtape *
+PTcompile(INPparseNode *tree, INPparseNode **derivs, int numVars)
+{
+    struct ptcomp c;
+    PTtape *tape = NULL;
+    int i, result, *dregs;
+
+    memset(&c, 0, sizeof(c));
+    c.code_size = c.regs_size = c.memo_size = 32;
+    c.code = TMALLOC(PTinstr, c.code_size);
+    c.regs = TMALLOC(double, c.regs_size);
+    c.known = TMALLOC(char, c.regs_size);
+    c.memo = TMALLOC(struct ptmemo, c.memo_size);
+    pt_rehash(&c, 64);
+
+    dregs = TMALLOC(int, numVars + 1);
+
+    result = pt_node(&c, tree);
+    for (i = 0; i < numVars && !c.failed; i++)
+        dregs[i] = pt_node(&c, derivs[i]);
+
+    if (!c.failed) {
+        tape = TMALLOC(PTtape, 1);
+        tape->ncode = c.ncode;
+        tape->code = TREALLOC(PTinstr, c.code, MAX(c.ncode, 1));
+        tape->nregs = c.nregs;
+        tape->regs = TREALLOC(double, c.regs, MAX(c.nregs, 1));
+        tape->result = result;
+        tape->derivs = dregs;
+    } else {
+        tfree(c.code);
+        tfree(c.regs);
+        tfree(dregs);
+    }
+
+    tfree(c.known);
+    tfree(c.memo);
+    tfree(c.bucket);
+
+    return tape;
+}
+
+
+void
+PTfreeTape(PTtape *tape)
+{
+    if (!tape)
+        return;
+
+    tfree(tape->code);
+    tfree(tape->regs);
+    tfree(tape->derivs);
+    tfree(tape);
+}
+
+
+static int
+PTexec(PTtape *tape, double *vals)
+{
+    double *r = tape->regs;
+    const PTinstr *code = tape->code;
+    int pc = 0;
+
+    while (pc < tape->ncode) {
+        const PTinstr *ip = &code[pc++];
+        double v;
+
+        switch (ip->op) {
+        case PTI_VAR:
+            r[ip->dst] = vals[ip->a];
+            continue;
+        case PTI_TIME:
+            r[ip->dst] = ((CKTcircuit*) ip->data) -> CKTtime;
+            continue;
+        case PTI_TEMPERATURE:
+            r[ip->dst] = ((CKTcircuit*) ip->data) -> CKTtemp - CONSTCtoK;
+            continue;
+        case PTI_FREQUENCY:
+            r[ip->dst] = (((CKTcircuit*) ip->data) -> CKTomega)/2./M_PI;
+            continue;
+        case PTI_MOVE:
+            r[ip->dst] = r[ip->a];
+            continue;
+        case PTI_JZ:
+            if (r[ip->a] == 0.0)
+                pc = ip->b;
+            continue;
+        case PTI_JMP:
+            pc = ip->b;
+            continue;
+
+        case PTI_PLUS:
+            v = r[ip->a] + r[ip->b];
+            break;
+        case PTI_MINUS:
+            v = r[ip->a] - r[ip->b];
+            break;
+        case PTI_TIMES:
+            v = r[ip->a] * r[ip->b];
+            break;
+        case PTI_BINARY:
+        case PTI_FUNC2:
+            v = PTbinary(ip->function) (r[ip->a], r[ip->b]);
+            break;
+        case PTI_UNARY:
+            v = PTunary(ip->function) (r[ip->a]);
+            break;
+        case PTI_UNARY_DATA:
+            v = PTunary_with_private(ip->function) (r[ip->a], ip->data);
+            break;
+
+        default:
+            fprintf(stderr, "Internal Error: bad instruction %d\n", ip->op);
+            return (E_PANIC);
+        }
+
+        if (v == HUGE) {
+            if (ip->op == PTI_UNARY || ip->op == PTI_UNARY_DATA)
+                fprintf(stderr, "Error: %g out of range for %s\n",
+                        r[ip->a], ip->funcname);
+            else
+                fprintf(stderr, "%sError: %g, %g out of range for %s\n",
+                        (ip->op == PTI_FUNC2) ? "" : "\n",
+                        r[ip->a], r[ip->b], ip->funcname);
+            return (E_PARMVAL);
+        }
+
+        r[ip->dst] = v;
+    }
+
+    return (OK);
+}
@@ -23,13 +23,7 @@ Author: 1985 Thomas L. Quarles
 static IFparm *
 find_instance_parameter(char *name, IFdevice *device)
 {
-    IFparm *p = device->instanceParms;
-    IFparm *p_end = p + *(device->numInstanceParms);
-
-    for (; p < p_end; p++)
-        if (strcmp(name, p->keyword) == 0)
-            return p;
-    return NULL;
+    return INPlookParm(name, device->instanceParms, *(device->numInstanceParms));
 }
 
 
@@ -45,28 +45,14 @@ extern NGHASHPTR modtabhash;
 static IFparm *
 find_model_parameter(const char *name, IFdevice *device)
 {
-    IFparm *p = device->modelParms;
-    IFparm *p_end = p + *(device->numModelParms);
-
-    for (; p < p_end; p++)
-        if (strcmp(name, p->keyword) == 0)
-            return p;
-
-    return NULL;
+    return INPlookParm(name, device->modelParms, *(device->numModelParms));
 }
 
 
 static IFparm *
 find_instance_parameter(const char *name, IFdevice *device)
 {
-    IFparm *p = device->instanceParms;
-    IFparm *p_end = p + *(device->numInstanceParms);
-
-    for (; p < p_end; p++)
-        if (strcmp(name, p->keyword) == 0)
-            return p;
-
-    return NULL;
+    return INPlookParm(name, device->instanceParms, *(device->numInstanceParms));
 }
 
 
@@ -8,11 +8,13 @@ Author: 1985 Thomas L. Quarles
 #include <string.h>
 
 extern INPmodel *modtab;
+extern NGHASHPTR modtabhash;
 
 
 /*-----------------------------------------------------------------
  * This fcn accepts a pointer to the model name, and returns
  * the INPmodel * if it exist in the model table.
+ * The hash table modtabhash holds the same models as modtab.
  *----------------------------------------------------------------*/
 
 INPmodel *
@@ -20,6 +22,9 @@ INPlookMod(const char *name)
 {
     INPmodel *i;
 
+    if (modtabhash)
+        return nghash_find(modtabhash, (void *) name);
+
     for (i = modtab; i; i = i->INPnextModel)
         if (strcmp(i->INPmodName, name) == 0)
             return i;
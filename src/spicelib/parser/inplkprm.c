@@ -0,0 +1,80 @@
+/**********
+Keyword lookup in device parameter tables
+**********/
+
+#include "ngspice/ngspice.h"
+#include "ngspice/ifsim.h"
+#include "ngspice/hash.h"
+#include "ngspice/inpdefs.h"
+#include <string.h>
+
+/* Tables with fewer keywords than this are searched linearly. */
+#define PARMHASH_MIN 16
+
+struct parmhash {
+    IFparm *table;
+    int num;
+    NGHASHPTR keywords;
+};
+
+/* maps an IFparm table address to its keyword hash */
+static NGHASHPTR parmtables = NULL;
+
+
+static struct parmhash *
+parmhash_build(IFparm *table, int numParms)
+{
+    struct parmhash *ph = TMALLOC(struct parmhash, 1);
+    int i;
+
+    ph->table = table;
+    ph->num = numParms;
+    ph->keywords = nghash_init(numParms);
+    /* a keyword may occur more than once (aliases), the first one wins,
+       as with the linear search */
+    nghash_unique(ph->keywords, TRUE);
+    for (i = 0; i < numParms; i++)
+        nghash_insert(ph->keywords, table[i].keyword, &table[i]);
+
+    return ph;
+}
+
+
+/*-----------------------------------------------------------------
+ * Look up a parameter keyword in a device parameter table.
+ * Large tables get a keyword hash, built on first use and kept
+ * for the whole session.
+ *----------------------------------------------------------------*/
+
+IFparm *
+INPlookParm(const char *name, IFparm *table, int numParms)
+{
+    struct parmhash *ph;
+
+    if (!table)
+        return NULL;
+
+    if (numParms < PARMHASH_MIN) {
+        IFparm *p, *p_end = table + numParms;
+        for (p = table; p < p_end; p++)
+            if (strcmp(name, p->keyword) == 0)
+                return p;
+        return NULL;
+    }
+
+    if (!parmtables)
+        parmtables = nghash_init_pointer(NGHASH_MIN_SIZE);
+
+    ph = nghash_find(parmtables, table);
+    if (!ph || ph->num != numParms) {
+        if (ph) {
+            nghash_delete(parmtables, table);
+            nghash_free(ph->keywords, NULL, NULL);
+            tfree(ph);
+        }
+        ph = parmhash_build(table, numParms);
+        nghash_insert(parmtables, table, ph);
+    }
+
+    return nghash_find(ph->keywords, (void *) name);
+}
@@ -13,6 +13,7 @@ Author: 1987 Wayne A. Christopher, U. C. Berkeley CAD Group
 #include "ngspice/inpdefs.h"
 #include "ngspice/inpptree.h"
 #include "ngspice/randnumb.h"
+#include "ngspice/cpextern.h"
 #include "inpxx.h"
 
 #include "inpptree-parser.h"
@@ -237,6 +238,10 @@ INPgetTree(char **line, INPparseTree ** pt, CKTcircuit *ckt, INPtables * tab)
         for (i = 0; i < numvalues; i++)
             (*pt)->derivs[i] = inc_usage(PTdifferentiate(p, i));
 
+        /* noexprtape leaves the tape out, IFeval() then walks the trees,
+           which the regression tests compare against */
+        if (!cp_getvar("noexprtape", CP_BOOL, NULL, 0))
+            (*pt)->tape = PTcompile((*pt)->tree, (*pt)->derivs, numvalues);
     }
 
     values = NULL;
@@ -1619,6 +1624,8 @@ void INPfreeTree(IFparseTree *ptree)
     if (!pt)
         return;
 
+    PTfreeTape(pt->tape);
+
     for (i = 0; i < pt->p.numVars; i++)
         dec_usage(pt->derivs[i]);
 
@@ -1688,13 +1695,44 @@ void free_tree(INPparseNode *pt)
     txfree(pt);
 }
 
+/* the random streams of gauss(), see INPrndstream() */
+static bool rnd_named = FALSE;
+static unsigned int rnd_name, rnd_count;
+
+
+/* With variable rndstream set, the n-th gauss() of the trees parsed next
+   draws from the n-th stream of name.param, name being the (expanded)
+   model or instance name, like the random functions of numparam and of
+   B sources.  A NULL name ends this. */
+void
+INPrndstream(const char *name, const char *param)
+{
+    char *full;
+
+    rnd_named = (name != NULL);
+    if (!rnd_named)
+        return;
+
+    full = tprintf("%s.%s", name, param);
+    rnd_name = rndstream_hash(full);
+    rnd_count = 0;
+    tfree(full);
+}
+
+
 static double
 gauss(double nominal_val, double rel_variation, double sigma)
 {
     double stdvar;
+    struct rndstream rs;
+
     if (rel_variation <= 0 || sigma <= 0)
         return nominal_val;
     stdvar = nominal_val * rel_variation / sigma;
+
+    if (rnd_named && rndstream_init(&rs, rnd_name, rnd_count++))
+        return (nominal_val + stdvar * rndstream_gauss(&rs));
+
     return (nominal_val + stdvar * gauss1());
 }
 
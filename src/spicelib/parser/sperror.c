@@ -107,6 +107,9 @@ const char *SPerror(int type)
     case E_NOF2SRC:
 	msg = "no F2 source for IM disto analysis";
 	break;
+    case E_CHECKPOINT:
+	msg = "checkpoint does not fit the circuit";
+	break;
     case OK:
 	return (NULL);
     default: